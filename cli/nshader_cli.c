@@ -22,13 +22,35 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+// strdup() and usleep() are hidden by glibc in strict C11 mode
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
 #include <nshader.h>
 #include <nshader/nshader_compiler.h>
+#include <nshader/nshader_server.h>
+#include <nshader/nshader_watcher.h>
+
+#include "nshader_json.h"
 
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
 
 // #############################################################################
 // Version
@@ -40,6 +62,13 @@ SOFTWARE.
 // Utilities
 // #############################################################################
 
+// Stage names used on the command line, in manifests and in JSON output
+static const char* const g_stage_names[NSHADER_STAGE_TYPE_COUNT] = {
+  "vertex",    // NSHADER_STAGE_TYPE_VERTEX
+  "fragment",  // NSHADER_STAGE_TYPE_FRAGMENT
+  "compute",   // NSHADER_STAGE_TYPE_COMPUTE
+};
+
 static char* read_file_to_string(const char* filepath) {
   FILE* file = fopen(filepath, "rb");
   if (!file) {
@@ -65,6 +94,29 @@ static char* read_file_to_string(const char* filepath) {
   return buffer;
 }
 
+static void* read_file_to_buffer(const char* filepath, size_t* out_size) {
+  FILE* file = fopen(filepath, "rb");
+  if (!file) {
+    fprintf(stderr, "Error: Could not open file '%s'\n", filepath);
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  void* buffer = malloc(size > 0 ? (size_t)size : 1);
+  if (!buffer) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+    fclose(file);
+    return NULL;
+  }
+
+  *out_size = size > 0 ? fread(buffer, 1, (size_t)size, file) : 0;
+  fclose(file);
+  return buffer;
+}
+
 static bool write_blob_to_file(const char* filepath, const void* data, size_t size) {
   FILE* file = fopen(filepath, "wb");
   if (!file) {
@@ -83,6 +135,188 @@ static bool write_blob_to_file(const char* filepath, const void* data, size_t si
   return true;
 }
 
+// Growable list of paths, each owned by the list
+typedef struct path_list_t {
+  char** paths;
+  size_t count;
+  size_t capacity;
+} path_list_t;
+
+static bool path_list_add(path_list_t* list, char* path) {
+  if (list->count == list->capacity) {
+    size_t capacity = list->capacity ? list->capacity * 2 : 64;
+    char** paths = (char**)realloc(list->paths, capacity * sizeof(char*));
+    if (!paths) {
+      free(path);
+      return false;
+    }
+    list->paths = paths;
+    list->capacity = capacity;
+  }
+  list->paths[list->count++] = path;
+  return true;
+}
+
+static void path_list_free(path_list_t* list) {
+  for (size_t i = 0; i < list->count; i++) {
+    free(list->paths[i]);
+  }
+  free(list->paths);
+  memset(list, 0, sizeof(*list));
+}
+
+static int compare_paths(const void* a, const void* b) {
+  return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+static bool has_extension(const char* path, const char* extension) {
+  size_t path_len = strlen(path);
+  size_t extension_len = strlen(extension);
+  return path_len > extension_len && strcmp(path + path_len - extension_len, extension) == 0;
+}
+
+// dir followed by name, with a separator unless dir already ends in one
+static char* join_path(const char* dir, const char* name) {
+  size_t dir_len = strlen(dir);
+  size_t name_len = strlen(name);
+  bool separator = dir_len > 0 && dir[dir_len - 1] != '/' && dir[dir_len - 1] != '\\';
+  char* path = (char*)malloc(dir_len + name_len + 2);
+  if (!path) {
+    return NULL;
+  }
+  memcpy(path, dir, dir_len);
+  if (separator) {
+    path[dir_len++] = '/';
+  }
+  memcpy(path + dir_len, name, name_len + 1);
+  return path;
+}
+
+static bool is_directory(const char* path) {
+  struct stat info;
+  return stat(path, &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+static uint64_t get_file_size(const char* path) {
+  struct stat info;
+  return stat(path, &info) == 0 ? (uint64_t)info.st_size : 0;
+}
+
+#define FNV1A_BASIS 0xcbf29ce484222325ull
+
+// Continue a 64-bit FNV-1a hash, new hashes start from FNV1A_BASIS
+static uint64_t hash_fnv1a(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Create the directories leading up to a file, existing ones are skipped
+static void create_parent_dirs(const char* path) {
+  char* dir = strdup(path);
+  for (char* c = dir + 1; *c; c++) {
+    if (*c != '/' && *c != '\\') {
+      continue;
+    }
+    char separator = *c;
+    *c = '\0';
+#ifdef _WIN32
+    _mkdir(dir);
+#else
+    mkdir(dir, 0777);
+#endif
+    *c = separator;
+  }
+  free(dir);
+}
+
+// Add every file below dir ending in extension, recursing into subdirectories
+static void list_files_recursive(const char* dir, const char* extension, path_list_t* list) {
+#ifdef _WIN32
+  char* pattern = join_path(dir, "*");
+  WIN32_FIND_DATAA data;
+  HANDLE find = pattern ? FindFirstFileA(pattern, &data) : INVALID_HANDLE_VALUE;
+  free(pattern);
+  if (find == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  do {
+    const char* name = data.cFileName;
+    bool directory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+  DIR* handle = opendir(dir);
+  if (!handle) {
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(handle)) != NULL) {
+    const char* name = entry->d_name;
+#endif
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+      continue;
+    }
+    char* path = join_path(dir, name);
+    if (!path) {
+      continue;
+    }
+#ifndef _WIN32
+    bool directory = is_directory(path);
+#endif
+    if (directory) {
+      list_files_recursive(path, extension, list);
+      free(path);
+    } else if (has_extension(path, extension)) {
+      path_list_add(list, path);
+    } else {
+      free(path);
+    }
+#ifdef _WIN32
+  } while (FindNextFileA(find, &data));
+  FindClose(find);
+#else
+  }
+  closedir(handle);
+#endif
+}
+
+// Every .nshader file below dir, sorted so output does not depend on the file system
+static void list_shader_files(const char* dir, path_list_t* list) {
+  list_files_recursive(dir, ".nshader", list);
+  if (list->count > 1) {
+    qsort(list->paths, list->count, sizeof(char*), compare_paths);
+  }
+}
+
+// Parse a comma separated list of backend names as used by extract
+// Returns false on an unknown name
+static bool parse_backend_mask(const char* list, uint32_t* out_mask) {
+  uint32_t mask = 0;
+  const char* name = list;
+  while (*name) {
+    size_t len = strcspn(name, ",");
+    bool found = false;
+    for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+      const char* backend_name = nshader_backend_to_extension((nshader_backend_t)backend) + 1;
+      if (strlen(backend_name) == len && strncmp(name, backend_name, len) == 0) {
+        mask |= 1u << backend;
+        found = true;
+      }
+    }
+    if (!found) {
+      fprintf(stderr, "Error: Unknown backend '%.*s'\n", (int)len, name);
+      return false;
+    }
+    name += len;
+    if (*name == ',') {
+      name++;
+    }
+  }
+  *out_mask = mask;
+  return true;
+}
+
 // #############################################################################
 // Help Messages
 // #############################################################################
@@ -95,10 +329,26 @@ static void print_help(void) {
   printf("COMMANDS:\n");
   printf("  compile <input.hlsl> -o <output.nshader>\n");
   printf("      Compile HLSL shader to nshader format\n\n");
-  printf("  info <shader.nshader>\n");
+  printf("  info <shader.nshader>... [--json]\n");
   printf("      Display shader information\n\n");
   printf("  extract <shader.nshader> <backend> <stage> -o <output>\n");
   printf("      Extract a specific backend and stage to a file\n\n");
+  printf("  verify <shader.nshader>...\n");
+  printf("      Check structure and stored checksums\n\n");
+  printf("  strip <shader.nshader|dir> --keep <backends> -o <output>\n");
+  printf("      Drop backends and debug info for per-platform files\n\n");
+  printf("  stats <dir>...\n");
+  printf("      Size breakdown across a shader library\n\n");
+  printf("  diff <old.nshader> <new.nshader> -o <update.nspatch>\n");
+  printf("      Write the blob-level changes between two versions of a shader\n\n");
+  printf("  patch <old.nshader> <update.nspatch> -o <new.nshader>\n");
+  printf("      Rebuild the new version of a shader from the old one and a patch\n\n");
+  printf("  build <manifest.json> [-j <threads>]\n");
+  printf("      Compile every shader listed in a manifest, skipping up-to-date outputs\n\n");
+  printf("  watch <dir> -o <outdir>\n");
+  printf("      Recompile shaders whenever their sources or includes change\n\n");
+  printf("  serve --socket <path>\n");
+  printf("      Run a compile server for compile --server\n\n");
   printf("  help\n");
   printf("      Display this help message\n\n");
   printf("  version\n");
@@ -122,6 +372,8 @@ static void print_compile_help(void) {
   printf("  --vertex <entry>      Vertex shader entry point\n");
   printf("  --fragment <entry>    Fragment shader entry point\n");
   printf("  --compute <entry>     Compute shader entry point\n\n");
+  printf("  A single stage also accepts a comma separated list of entry points, which\n");
+  printf("  are compiled in parallel into <entry>.nshader files below the -o directory.\n\n");
   printf("OPTIONS:\n");
   printf("  -D <NAME[=VALUE]>         Add preprocessor define (applies to all stages)\n");
   printf("  --D-vertex <NAME[=VALUE]>   Add define for vertex stage only\n");
@@ -130,7 +382,11 @@ static void print_compile_help(void) {
   printf("  -I <directory>            Include directory for shader code\n");
   printf("  --debug                   Enable debug information\n");
   printf("  --debug-name <name>       Set debug name\n");
-  printf("  --preserve-bindings       Don't cull unused resource bindings\n\n");
+  printf("  --preserve-bindings       Don't cull unused resource bindings\n");
+  printf("  --checksums               Store CRC-32C checksums for nshader verify\n");
+  printf("  --reproducible            Strip debug info for bit-identical output\n");
+  printf("  --strip-spirv             Strip SPIR-V debug info before translating to other backends\n");
+  printf("  --server <socket>         Compile through a running nshader serve\n\n");
   printf("BACKEND CONTROL:\n");
   printf("  --disable-dxil        Disable DirectX IL backend\n");
   printf("  --disable-dxbc        Disable DirectX Bytecode backend\n");
@@ -147,6 +403,8 @@ static void print_compile_help(void) {
   printf("  nshader compile common.hlsl -o out.nshader \\\n");
   printf("                  --vertex VSMain \\\n");
   printf("                  --fragment PSMain --fragment-source custom_pixel.hlsl\n\n");
+  printf("  # One file per compute kernel of a shared source\n");
+  printf("  nshader compile Tonemap.comp.hlsl --compute Reinhard,Aces,Filmic -o tonemap\n\n");
   printf("  # Stage-specific defines\n");
   printf("  nshader compile shader.hlsl -o out.nshader \\\n");
   printf("                  --vertex VSMain --D-vertex INSTANCED=1 \\\n");
@@ -156,9 +414,12 @@ static void print_compile_help(void) {
 static void print_info_help(void) {
   printf("nshader info - Display shader information\n\n");
   printf("USAGE:\n");
-  printf("  nshader info <shader.nshader> [options]\n\n");
+  printf("  nshader info <shader.nshader>... [options]\n\n");
   printf("OPTIONS:\n");
   printf("  -v, --verbose         Show detailed information\n");
+  printf("  --json                Print a JSON array with one object per shader\n");
+  printf("  --ndjson              Print one JSON object per line and shader\n\n");
+  printf("Blob payloads are not read, only the shader metadata.\n");
 }
 
 static void print_extract_help(void) {
@@ -176,6 +437,113 @@ static void print_extract_help(void) {
   printf("  compute               Compute shader stage\n");
 }
 
+static void print_verify_help(void) {
+  printf("nshader verify - Check structure and stored checksums\n\n");
+  printf("USAGE:\n");
+  printf("  nshader verify <shader.nshader>...\n\n");
+  printf("Every file is validated without loading it, then loaded with checksum\n");
+  printf("verification when it was compiled with --checksums.\n");
+  printf("Exits with 1 if any file fails.\n");
+}
+
+static void print_build_help(void) {
+  printf("nshader build - Compile every shader listed in a manifest\n\n");
+  printf("USAGE:\n");
+  printf("  nshader build <manifest.json> [options]\n\n");
+  printf("All shaders are compiled in one process on parallel threads. Shaders whose\n");
+  printf("output is newer than the manifest, their sources and their includes are\n");
+  printf("skipped. See the CLI documentation for the manifest format.\n\n");
+  printf("OPTIONS:\n");
+  printf("  -j <threads>              Shaders compiled in parallel (default: one per core)\n");
+  printf("  --force                   Rebuild up-to-date outputs too\n");
+  printf("  --checksums               Store CRC-32C checksums for nshader verify\n");
+  printf("  --reproducible            Strip debug info for bit-identical output\n");
+  printf("  --strip-spirv             Strip SPIR-V debug info before translating to other backends\n");
+}
+
+static void print_strip_help(void) {
+  printf("nshader strip - Drop backends and debug info for per-platform files\n\n");
+  printf("USAGE:\n");
+  printf("  nshader strip <shader.nshader> -o <output.nshader> [options]\n");
+  printf("  nshader strip <dir> -o <outdir> [options]\n\n");
+  printf("A directory is processed recursively on parallel threads, every .nshader\n");
+  printf("file is written to the same relative path below the output directory.\n\n");
+  printf("OPTIONS:\n");
+  printf("  -o <output>               Output file, or output directory (required)\n");
+  printf("  --keep <backends>         Comma separated backends to keep: dxil, dxbc, msl, spv\n");
+  printf("                            (default: all)\n");
+  printf("  --keep-debug              Keep SPIR-V debug instructions\n");
+  printf("  --strip-names             Drop vertex and fragment input/output names\n");
+  printf("  --checksums               Store CRC-32C checksums for nshader verify\n");
+  printf("                            (default: kept when the input has them)\n");
+  printf("  --no-checksums            Drop stored checksums\n");
+  printf("  -j <threads>              Files processed in parallel (default: one per core)\n\n");
+  printf("EXAMPLES:\n");
+  printf("  nshader strip shader.nshader --keep spv -o shader.vk.nshader\n");
+  printf("  nshader strip shaders --keep dxil,dxbc -o shaders_d3d\n");
+}
+
+static void print_stats_help(void) {
+  printf("nshader stats - Size breakdown across a shader library\n\n");
+  printf("USAGE:\n");
+  printf("  nshader stats <dir|shader.nshader>... [options]\n\n");
+  printf("Directories are searched recursively for .nshader files, which are read\n");
+  printf("on parallel threads. Only the metadata is read unless --duplicates is given.\n\n");
+  printf("OPTIONS:\n");
+  printf("  -n <count>                Number of largest shaders listed (default: 10)\n");
+  printf("  --duplicates              Read blob payloads to find identical blobs\n");
+  printf("  -j <threads>              Files read in parallel (default: one per core)\n");
+}
+
+static void print_diff_help(void) {
+  printf("nshader diff - Write the blob-level changes between two versions of a shader\n\n");
+  printf("USAGE:\n");
+  printf("  nshader diff <old.nshader> <new.nshader> -o <update.nspatch>\n\n");
+  printf("The patch holds the metadata of the new shader, and for every blob nothing\n");
+  printf("when it is unchanged, a delta against the old blob, or the new blob.\n");
+  printf("It only applies to the exact old shader it was created from.\n");
+}
+
+static void print_patch_help(void) {
+  printf("nshader patch - Rebuild the new version of a shader from a patch\n\n");
+  printf("USAGE:\n");
+  printf("  nshader patch <old.nshader> <update.nspatch> -o <new.nshader>\n\n");
+  printf("Fails without writing anything if the old shader is not the one the patch\n");
+  printf("was created from, or if the result does not match the recorded hash.\n");
+}
+
+static void print_serve_help(void) {
+  printf("nshader serve - Run a compile server\n\n");
+  printf("USAGE:\n");
+  printf("  nshader serve --socket <path> [options]\n\n");
+  printf("Keeps the compiler initialized and compiled shaders cached, and answers\n");
+  printf("nshader compile --server <path> requests over a Unix domain socket.\n");
+  printf("Runs until interrupted with Ctrl+C.\n\n");
+  printf("OPTIONS:\n");
+  printf("  --socket <path>           Socket path (required)\n");
+  printf("  -j <threads>              Requests served in parallel (default: one per core)\n");
+  printf("  --cache-size <MiB>        Memory for cached shaders (default: 256)\n");
+}
+
+static void print_watch_help(void) {
+  printf("nshader watch - Recompile shaders whenever their sources or includes change\n\n");
+  printf("USAGE:\n");
+  printf("  nshader watch <dir> -o <outdir> [options]\n\n");
+  printf("Every <name>.vert.hlsl, <name>.frag.hlsl and <name>.comp.hlsl file in <dir>\n");
+  printf("is compiled to <outdir>/<name>.nshader, files sharing a name form one shader.\n");
+  printf("Runs until interrupted with Ctrl+C.\n\n");
+  printf("OPTIONS:\n");
+  printf("  -o <outdir>               Output directory (required)\n");
+  printf("  -I <directory>            Include directory for shader code\n");
+  printf("  -D <NAME[=VALUE]>         Add preprocessor define\n");
+  printf("  --entry <name>            Entry point of every stage (default: main)\n");
+  printf("  --checksums               Store CRC-32C checksums for nshader verify\n");
+  printf("  --reproducible            Strip debug info for bit-identical output\n");
+  printf("  --strip-spirv             Strip SPIR-V debug info before translating to other backends\n");
+  printf("  --debounce <ms>           Quiet time before rebuilding (default: 100)\n");
+  printf("  -j <threads>              Shaders compiled in parallel (default: one per core)\n");
+}
+
 // #############################################################################
 // Compile Command
 // #############################################################################
@@ -191,6 +559,7 @@ typedef struct compile_args_t {
   const char* compute_source;
   const char* include_dir;
   const char* debug_name;
+  const char* server;
 
   nshader_compiler_define_t* defines;
   size_t num_defines;
@@ -210,24 +579,213 @@ typedef struct compile_args_t {
   bool disable_dxbc;
   bool disable_msl;
   bool disable_spv;
+  bool checksums;
+  bool reproducible;
+  bool strip_spirv;
 } compile_args_t;
 
+// A define needs a non-empty name before an optional "=VALUE"
+static bool is_valid_define(const char* str) {
+  return *str != '\0' && *str != '=';
+}
+
+// Split "NAME[=VALUE]", false if an allocation failed
 static bool parse_define(const char* str, char** name, char** value) {
+  *name = NULL;
+  *value = NULL;
   const char* eq = strchr(str, '=');
+  size_t name_len = eq ? (size_t)(eq - str) : strlen(str);
+  *name = (char*)malloc(name_len + 1);
   if (eq) {
-    size_t name_len = eq - str;
-    *name = (char*)malloc(name_len + 1);
-    memcpy(*name, str, name_len);
-    (*name)[name_len] = '\0';
-
     *value = strdup(eq + 1);
-  } else {
-    *name = strdup(str);
+  }
+  if (!*name || (eq && !*value)) {
+    free(*name);
+    free(*value);
+    *name = NULL;
     *value = NULL;
+    return false;
+  }
+  memcpy(*name, str, name_len);
+  (*name)[name_len] = '\0';
+  return true;
+}
+
+// Append a "NAME[=VALUE]" string to a define array, reporting malformed
+// defines and failed allocations. The array is left intact on failure.
+static bool add_define(nshader_compiler_define_t** defines, size_t* num_defines, const char* str) {
+  if (!is_valid_define(str)) {
+    fprintf(stderr, "Error: Invalid define '%s', expected NAME[=VALUE]\n", str);
+    return false;
+  }
+  nshader_compiler_define_t* grown = (nshader_compiler_define_t*)realloc(*defines, sizeof(nshader_compiler_define_t) * (*num_defines + 1));
+  if (!grown) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+    return false;
+  }
+  *defines = grown;
+  char* name, *value;
+  if (!parse_define(str, &name, &value)) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+    return false;
   }
+  grown[*num_defines].name = name;
+  grown[*num_defines].value = value;
+  (*num_defines)++;
   return true;
 }
 
+static void free_compile_defines(compile_args_t* args) {
+  // Free global defines
+  for (size_t i = 0; i < args->num_defines; i++) {
+    free((char*)args->defines[i].name);
+    free((char*)args->defines[i].value);
+  }
+  free(args->defines);
+
+  // Free stage-specific defines
+  for (size_t i = 0; i < args->num_vertex_defines; i++) {
+    free((char*)args->vertex_defines[i].name);
+    free((char*)args->vertex_defines[i].value);
+  }
+  free(args->vertex_defines);
+
+  for (size_t i = 0; i < args->num_fragment_defines; i++) {
+    free((char*)args->fragment_defines[i].name);
+    free((char*)args->fragment_defines[i].value);
+  }
+  free(args->fragment_defines);
+
+  for (size_t i = 0; i < args->num_compute_defines; i++) {
+    free((char*)args->compute_defines[i].name);
+    free((char*)args->compute_defines[i].value);
+  }
+  free(args->compute_defines);
+}
+
+// One entry point of a comma separated list, compiled to <outdir>/<entry>.nshader
+typedef struct entry_point_job_t {
+  char* output;
+  nshader_error_list_t errors;
+  bool written;  // Compiled and written to output
+} entry_point_job_t;
+
+typedef struct entry_point_jobs_t {
+  entry_point_job_t* jobs;
+  const char* const* entry_points;
+  const nshader_write_options_t* write_options;
+} entry_point_jobs_t;
+
+// Called on the compiling threads, every call touches its own job
+static void on_entry_point_result(void* user, const nshader_compiler_result_t* result) {
+  entry_point_jobs_t* jobs = (entry_point_jobs_t*)user;
+  entry_point_job_t* job = &jobs->jobs[result->index];
+
+  if (!result->shader) {
+    for (size_t i = 0; i < result->errors->num_errors; i++) {
+      nshader_error_list_push(&job->errors, result->errors->errors[i]);
+    }
+    return;
+  }
+
+  create_parent_dirs(job->output);
+  if (nshader_write_to_path_ex(result->shader, job->output, jobs->write_options)) {
+    printf("Compiled %s -> %s (%.0f ms)\n", jobs->entry_points[result->index], job->output, (double)result->compile_ns / 1e6);
+    fflush(stdout);
+    job->written = true;
+  } else {
+    nshader_error_list_push(&job->errors, "Failed to write output file");
+  }
+  nshader_destroy(result->shader);
+}
+
+// Compile every entry point of a comma separated list from the same stage
+// setup on parallel threads, each into its own file below output_dir
+static int compile_entry_point_list(const nshader_compiler_config_t* config, const nshader_compiler_stage_setup_t* stage, const char* list, const char* output_dir, const nshader_write_options_t* write_options) {
+  path_list_t entry_points = {0};
+  for (const char* name = list; *name;) {
+    size_t len = strcspn(name, ",");
+    if (len > 0) {
+      char* entry_point = (char*)malloc(len + 1);
+      if (!entry_point) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        path_list_free(&entry_points);
+        return 1;
+      }
+      memcpy(entry_point, name, len);
+      entry_point[len] = '\0';
+      if (!path_list_add(&entry_points, entry_point)) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        path_list_free(&entry_points);
+        return 1;
+      }
+    }
+    name += len;
+    if (*name == ',') {
+      name++;
+    }
+  }
+
+  entry_point_job_t* jobs = (entry_point_job_t*)calloc(entry_points.count ? entry_points.count : 1, sizeof(entry_point_job_t));
+  if (!jobs) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+    path_list_free(&entry_points);
+    return 1;
+  }
+  for (size_t i = 0; i < entry_points.count; i++) {
+    char* file_name = (char*)malloc(strlen(entry_points.paths[i]) + sizeof(".nshader"));
+    if (file_name) {
+      strcpy(file_name, entry_points.paths[i]);
+      strcat(file_name, ".nshader");
+      jobs[i].output = join_path(output_dir, file_name);
+      free(file_name);
+    }
+    if (!jobs[i].output) {
+      fprintf(stderr, "Error: Memory allocation failed\n");
+      for (size_t j = 0; j < i; j++) {
+        free(jobs[j].output);
+      }
+      free(jobs);
+      path_list_free(&entry_points);
+      return 1;
+    }
+  }
+
+  printf("Compiling %zu entry points...\n", entry_points.count);
+  entry_point_jobs_t results;
+  results.jobs = jobs;
+  results.entry_points = (const char* const*)entry_points.paths;
+  results.write_options = write_options;
+  nshader_compiler_compile_entry_points(config, stage, (const char* const*)entry_points.paths,
+    entry_points.count, 0, on_entry_point_result, &results);
+
+  // Report failures in list order, a job succeeded only once its output was written
+  size_t succeeded = 0;
+  for (size_t i = 0; i < entry_points.count; i++) {
+    if (jobs[i].written && jobs[i].errors.num_errors == 0) {
+      succeeded++;
+    }
+    if (jobs[i].errors.num_errors > 0) {
+      fprintf(stderr, "Compilation of %s failed:\n", entry_points.paths[i]);
+      for (size_t j = 0; j < jobs[i].errors.num_errors; j++) {
+        fprintf(stderr, "  %s\n", jobs[i].errors.errors[j]);
+      }
+    }
+    nshader_error_list_free(&jobs[i].errors);
+    free(jobs[i].output);
+  }
+  free(jobs);
+
+  size_t num_entry_points = entry_points.count;
+  path_list_free(&entry_points);
+  if (num_entry_points == 0 || succeeded < num_entry_points) {
+    fprintf(stderr, "%zu of %zu entry points failed\n", num_entry_points - succeeded, num_entry_points);
+    return 1;
+  }
+  printf("Compilation successful!\n");
+  return 0;
+}
+
 static int cmd_compile(int argc, char** argv) {
   compile_args_t args = {0};
 
@@ -283,53 +841,37 @@ static int cmd_compile(int argc, char** argv) {
         fprintf(stderr, "Error: -D requires an argument\n");
         return 1;
       }
-      args.defines = (nshader_compiler_define_t*)realloc(args.defines,
-        sizeof(nshader_compiler_define_t) * (args.num_defines + 1));
-
-      char* name, *value;
-      parse_define(argv[i], &name, &value);
-      args.defines[args.num_defines].name = name;
-      args.defines[args.num_defines].value = value;
-      args.num_defines++;
+      if (!add_define(&args.defines, &args.num_defines, argv[i])) {
+        free_compile_defines(&args);
+        return 1;
+      }
     } else if (strcmp(argv[i], "--D-vertex") == 0) {
       if (++i >= argc) {
         fprintf(stderr, "Error: --D-vertex requires an argument\n");
         return 1;
       }
-      args.vertex_defines = (nshader_compiler_define_t*)realloc(args.vertex_defines,
-        sizeof(nshader_compiler_define_t) * (args.num_vertex_defines + 1));
-
-      char* name, *value;
-      parse_define(argv[i], &name, &value);
-      args.vertex_defines[args.num_vertex_defines].name = name;
-      args.vertex_defines[args.num_vertex_defines].value = value;
-      args.num_vertex_defines++;
+      if (!add_define(&args.vertex_defines, &args.num_vertex_defines, argv[i])) {
+        free_compile_defines(&args);
+        return 1;
+      }
     } else if (strcmp(argv[i], "--D-fragment") == 0) {
       if (++i >= argc) {
         fprintf(stderr, "Error: --D-fragment requires an argument\n");
         return 1;
       }
-      args.fragment_defines = (nshader_compiler_define_t*)realloc(args.fragment_defines,
-        sizeof(nshader_compiler_define_t) * (args.num_fragment_defines + 1));
-
-      char* name, *value;
-      parse_define(argv[i], &name, &value);
-      args.fragment_defines[args.num_fragment_defines].name = name;
-      args.fragment_defines[args.num_fragment_defines].value = value;
-      args.num_fragment_defines++;
+      if (!add_define(&args.fragment_defines, &args.num_fragment_defines, argv[i])) {
+        free_compile_defines(&args);
+        return 1;
+      }
     } else if (strcmp(argv[i], "--D-compute") == 0) {
       if (++i >= argc) {
         fprintf(stderr, "Error: --D-compute requires an argument\n");
         return 1;
       }
-      args.compute_defines = (nshader_compiler_define_t*)realloc(args.compute_defines,
-        sizeof(nshader_compiler_define_t) * (args.num_compute_defines + 1));
-
-      char* name, *value;
-      parse_define(argv[i], &name, &value);
-      args.compute_defines[args.num_compute_defines].name = name;
-      args.compute_defines[args.num_compute_defines].value = value;
-      args.num_compute_defines++;
+      if (!add_define(&args.compute_defines, &args.num_compute_defines, argv[i])) {
+        free_compile_defines(&args);
+        return 1;
+      }
     } else if (strcmp(argv[i], "-I") == 0) {
       if (++i >= argc) {
         fprintf(stderr, "Error: -I requires an argument\n");
@@ -344,6 +886,12 @@ static int cmd_compile(int argc, char** argv) {
         return 1;
       }
       args.debug_name = argv[i];
+    } else if (strcmp(argv[i], "--server") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: --server requires an argument\n");
+        return 1;
+      }
+      args.server = argv[i];
     } else if (strcmp(argv[i], "--preserve-bindings") == 0) {
       args.preserve_bindings = true;
     } else if (strcmp(argv[i], "--disable-dxil") == 0) {
@@ -354,6 +902,12 @@ static int cmd_compile(int argc, char** argv) {
       args.disable_msl = true;
     } else if (strcmp(argv[i], "--disable-spv") == 0) {
       args.disable_spv = true;
+    } else if (strcmp(argv[i], "--checksums") == 0) {
+      args.checksums = true;
+    } else if (strcmp(argv[i], "--reproducible") == 0) {
+      args.reproducible = true;
+    } else if (strcmp(argv[i], "--strip-spirv") == 0) {
+      args.strip_spirv = true;
     } else if (argv[i][0] != '-') {
       if (!args.input_file) {
         args.input_file = argv[i];
@@ -380,6 +934,27 @@ static int cmd_compile(int argc, char** argv) {
     return 1;
   }
 
+  // A comma separated entry point list compiles one file per entry point
+  const char* entry_list = NULL;
+  const char* stage_entries[3] = {args.vertex_entry, args.fragment_entry, args.compute_entry};
+  int num_stage_entries = 0;
+  for (int i = 0; i < 3; i++) {
+    if (stage_entries[i]) {
+      num_stage_entries++;
+      if (strchr(stage_entries[i], ',')) {
+        entry_list = stage_entries[i];
+      }
+    }
+  }
+  if (entry_list && num_stage_entries > 1) {
+    fprintf(stderr, "Error: A list of entry points requires a single stage\n");
+    return 1;
+  }
+  if (entry_list && args.server) {
+    fprintf(stderr, "Error: --server does not support a list of entry points\n");
+    return 1;
+  }
+
   // Validate that each stage has a source file (either default or stage-specific)
   if (args.vertex_entry && !args.input_file && !args.vertex_source) {
     fprintf(stderr, "Error: Vertex stage requires a source file (use <input.hlsl> or --vertex-source)\n");
@@ -488,13 +1063,30 @@ static int cmd_compile(int argc, char** argv) {
   config.enable_debug = args.debug;
   config.debug_name = args.debug_name;
   config.preserve_unused_bindings = args.preserve_bindings;
+  config.reproducible = args.reproducible;
+  config.strip_spirv = args.strip_spirv;
   config.defines = args.defines;
   config.num_defines = args.num_defines;
 
+  nshader_write_options_t write_options = {0};
+  write_options.checksums = args.checksums;
+
+  // Every entry point of a list goes to its own file, -o names the directory
+  if (entry_list) {
+    int result = compile_entry_point_list(&config, &stages[0], entry_list, args.output_file, &write_options);
+    free(default_source);
+    free(vertex_source);
+    free(fragment_source);
+    free(compute_source);
+    free_compile_defines(&args);
+    return result;
+  }
+
   // Compile shader
   printf("Compiling shader...\n");
   nshader_error_list_t errors = {0};
-  nshader_t* shader = nshader_compiler_compile_hlsl(&config, &errors);
+  nshader_t* shader = args.server ? nshader_server_compile(args.server, &config, &errors)
+                                  : nshader_compiler_compile_hlsl(&config, &errors);
 
   if (!shader) {
     fprintf(stderr, "Compilation failed:\n");
@@ -506,33 +1098,7 @@ static int cmd_compile(int argc, char** argv) {
     free(vertex_source);
     free(fragment_source);
     free(compute_source);
-
-    // Free global defines
-    for (size_t i = 0; i < args.num_defines; i++) {
-      free((char*)args.defines[i].name);
-      free((char*)args.defines[i].value);
-    }
-    free(args.defines);
-
-    // Free stage-specific defines
-    for (size_t i = 0; i < args.num_vertex_defines; i++) {
-      free((char*)args.vertex_defines[i].name);
-      free((char*)args.vertex_defines[i].value);
-    }
-    free(args.vertex_defines);
-
-    for (size_t i = 0; i < args.num_fragment_defines; i++) {
-      free((char*)args.fragment_defines[i].name);
-      free((char*)args.fragment_defines[i].value);
-    }
-    free(args.fragment_defines);
-
-    for (size_t i = 0; i < args.num_compute_defines; i++) {
-      free((char*)args.compute_defines[i].name);
-      free((char*)args.compute_defines[i].value);
-    }
-    free(args.compute_defines);
-
+    free_compile_defines(&args);
     return 1;
   }
 
@@ -540,7 +1106,7 @@ static int cmd_compile(int argc, char** argv) {
 
   // Write output
   printf("Writing output: %s\n", args.output_file);
-  bool success = nshader_write_to_path(shader, args.output_file);
+  bool success = nshader_write_to_path_ex(shader, args.output_file, &write_options);
 
   if (!success) {
     fprintf(stderr, "Error: Failed to write output file\n");
@@ -549,33 +1115,7 @@ static int cmd_compile(int argc, char** argv) {
     free(vertex_source);
     free(fragment_source);
     free(compute_source);
-
-    // Free global defines
-    for (size_t i = 0; i < args.num_defines; i++) {
-      free((char*)args.defines[i].name);
-      free((char*)args.defines[i].value);
-    }
-    free(args.defines);
-
-    // Free stage-specific defines
-    for (size_t i = 0; i < args.num_vertex_defines; i++) {
-      free((char*)args.vertex_defines[i].name);
-      free((char*)args.vertex_defines[i].value);
-    }
-    free(args.vertex_defines);
-
-    for (size_t i = 0; i < args.num_fragment_defines; i++) {
-      free((char*)args.fragment_defines[i].name);
-      free((char*)args.fragment_defines[i].value);
-    }
-    free(args.fragment_defines);
-
-    for (size_t i = 0; i < args.num_compute_defines; i++) {
-      free((char*)args.compute_defines[i].name);
-      free((char*)args.compute_defines[i].value);
-    }
-    free(args.compute_defines);
-
+    free_compile_defines(&args);
     return 1;
   }
 
@@ -587,32 +1127,7 @@ static int cmd_compile(int argc, char** argv) {
   free(vertex_source);
   free(fragment_source);
   free(compute_source);
-
-  // Free global defines
-  for (size_t i = 0; i < args.num_defines; i++) {
-    free((char*)args.defines[i].name);
-    free((char*)args.defines[i].value);
-  }
-  free(args.defines);
-
-  // Free stage-specific defines
-  for (size_t i = 0; i < args.num_vertex_defines; i++) {
-    free((char*)args.vertex_defines[i].name);
-    free((char*)args.vertex_defines[i].value);
-  }
-  free(args.vertex_defines);
-
-  for (size_t i = 0; i < args.num_fragment_defines; i++) {
-    free((char*)args.fragment_defines[i].name);
-    free((char*)args.fragment_defines[i].value);
-  }
-  free(args.fragment_defines);
-
-  for (size_t i = 0; i < args.num_compute_defines; i++) {
-    free((char*)args.compute_defines[i].name);
-    free((char*)args.compute_defines[i].value);
-  }
-  free(args.compute_defines);
+  free_compile_defines(&args);
 
   return 0;
 }
@@ -634,53 +1149,14 @@ static void print_stage_bindings(const char* label, const nshader_stage_binding_
   }
 }
 
-static int cmd_info(int argc, char** argv) {
-  const char* input_file = NULL;
-  bool verbose = false;
-
-  // Parse arguments
-  for (int i = 2; i < argc; i++) {
-    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
-      print_info_help();
-      return 0;
-    } else if (strcmp(argv[i], "--verbose") == 0 || strcmp(argv[i], "-v") == 0) {
-      verbose = true;
-    } else if (argv[i][0] != '-') {
-      if (!input_file) {
-        input_file = argv[i];
-      } else {
-        fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
-        return 1;
-      }
-    } else {
-      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
-      return 1;
-    }
-  }
+static void print_info_text(const char* path, const nshader_info_t* info, bool verbose) {
+  printf("Shader: %s\n", path);
+  printf("Type: %s\n", info->type == NSHADER_SHADER_TYPE_GRAPHICS ? "Graphics" : "Compute");
 
-  if (!input_file) {
-    fprintf(stderr, "Error: Input file required\n");
-    print_info_help();
-    return 1;
-  }
-
-  // Read shader
-  nshader_t* shader = nshader_read_from_path(input_file);
-  if (!shader) {
-    fprintf(stderr, "Error: Could not read shader file '%s'\n", input_file);
-    return 1;
-  }
-
-  const nshader_info_t* info = nshader_get_info(shader);
-
-  // Print basic info
-  printf("Shader: %s\n", input_file);
-  printf("Type: %s\n", info->type == NSHADER_SHADER_TYPE_GRAPHICS ? "Graphics" : "Compute");
-
-  // Print backends
-  printf("Backends (%zu):\n", info->num_backends);
-  for (size_t i = 0; i < info->num_backends; i++) {
-    printf("  - %s\n", nshader_backend_to_string(info->backends[i]));
+  // Print backends
+  printf("Backends (%zu):\n", info->num_backends);
+  for (size_t i = 0; i < info->num_backends; i++) {
+    printf("  - %s\n", nshader_backend_to_string(info->backends[i]));
   }
 
   // Print stages
@@ -729,9 +1205,206 @@ static int cmd_info(int argc, char** argv) {
       }
     }
   }
+}
 
-  nshader_destroy(shader);
-  return 0;
+static void write_bindings_json(json_writer_t* writer, const char* key, const nshader_stage_binding_t* bindings, size_t count) {
+  json_write_key(writer, key);
+  json_write_begin_array(writer);
+  for (size_t i = 0; i < count; i++) {
+    json_write_begin_object(writer);
+    json_write_key(writer, "location");
+    json_write_uint(writer, bindings[i].location);
+    json_write_key(writer, "name");
+    json_write_string(writer, bindings[i].name);
+    json_write_key(writer, "type");
+    json_write_string(writer, nshader_binding_type_to_string(bindings[i].type));
+    json_write_key(writer, "vector_size");
+    json_write_uint(writer, bindings[i].vector_size);
+    json_write_end_object(writer);
+  }
+  json_write_end_array(writer);
+}
+
+static void write_count_json(json_writer_t* writer, const char* key, uint32_t value) {
+  json_write_key(writer, key);
+  json_write_uint(writer, value);
+}
+
+// One shader object, or {"path", "error"} if shader is NULL
+static void write_info_json(json_writer_t* writer, const char* path, const nshader_t* shader) {
+  json_write_begin_object(writer);
+  json_write_key(writer, "path");
+  json_write_string(writer, path);
+  if (!shader) {
+    json_write_key(writer, "error");
+    json_write_string(writer, "could not read shader file");
+    json_write_end_object(writer);
+    return;
+  }
+
+  const nshader_info_t* info = nshader_get_info(shader);
+  json_write_key(writer, "type");
+  json_write_string(writer, info->type == NSHADER_SHADER_TYPE_GRAPHICS ? "graphics" : "compute");
+
+  // Stored content hash, hi word first
+  nshader_hash_t hash;
+  json_write_key(writer, "hash");
+  if (nshader_hash(shader, &hash)) {
+    char hex[33];
+    snprintf(hex, sizeof(hex), "%016llx%016llx", (unsigned long long)hash.hi, (unsigned long long)hash.lo);
+    json_write_string(writer, hex);
+  } else {
+    json_write_null(writer);
+  }
+
+  // Backends by their extract names (extension without the dot)
+  json_write_key(writer, "backends");
+  json_write_begin_array(writer);
+  for (size_t i = 0; i < info->num_backends; i++) {
+    json_write_string(writer, nshader_backend_to_extension(info->backends[i]) + 1);
+  }
+  json_write_end_array(writer);
+
+  json_write_key(writer, "stages");
+  json_write_begin_array(writer);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    const nshader_stage_t* stage = &info->stages[i];
+    json_write_begin_object(writer);
+    json_write_key(writer, "stage");
+    json_write_string(writer, (size_t)stage->type < NSHADER_STAGE_TYPE_COUNT ? g_stage_names[stage->type] : NULL);
+    json_write_key(writer, "entry_point");
+    json_write_string(writer, stage->entry_point);
+    switch (stage->type) {
+      case NSHADER_STAGE_TYPE_VERTEX: {
+        const nshader_stage_metadata_vertex_t* meta = &stage->metadata.vertex;
+        write_count_json(writer, "samplers", meta->num_samplers);
+        write_count_json(writer, "storage_textures", meta->num_storage_textures);
+        write_count_json(writer, "storage_buffers", meta->num_storage_buffers);
+        write_count_json(writer, "uniform_buffers", meta->num_uniform_buffers);
+        write_bindings_json(writer, "inputs", meta->inputs, meta->input_count);
+        write_bindings_json(writer, "outputs", meta->outputs, meta->output_count);
+        break;
+      }
+      case NSHADER_STAGE_TYPE_FRAGMENT: {
+        const nshader_stage_metadata_fragment_t* meta = &stage->metadata.fragment;
+        write_count_json(writer, "samplers", meta->num_samplers);
+        write_count_json(writer, "storage_textures", meta->num_storage_textures);
+        write_count_json(writer, "storage_buffers", meta->num_storage_buffers);
+        write_count_json(writer, "uniform_buffers", meta->num_uniform_buffers);
+        write_bindings_json(writer, "inputs", meta->inputs, meta->input_count);
+        write_bindings_json(writer, "outputs", meta->outputs, meta->output_count);
+        break;
+      }
+      case NSHADER_STAGE_TYPE_COMPUTE: {
+        const nshader_stage_metadata_compute_t* meta = &stage->metadata.compute;
+        write_count_json(writer, "samplers", meta->num_samplers);
+        write_count_json(writer, "readonly_storage_textures", meta->num_readonly_storage_textures);
+        write_count_json(writer, "readonly_storage_buffers", meta->num_readonly_storage_buffers);
+        write_count_json(writer, "readwrite_storage_textures", meta->num_readwrite_storage_textures);
+        write_count_json(writer, "readwrite_storage_buffers", meta->num_readwrite_storage_buffers);
+        write_count_json(writer, "uniform_buffers", meta->num_uniform_buffers);
+        json_write_key(writer, "threadcount");
+        json_write_begin_array(writer);
+        json_write_uint(writer, meta->threadcount_x);
+        json_write_uint(writer, meta->threadcount_y);
+        json_write_uint(writer, meta->threadcount_z);
+        json_write_end_array(writer);
+        break;
+      }
+      default:
+        break;
+    }
+    json_write_end_object(writer);
+  }
+  json_write_end_array(writer);
+
+  json_write_end_object(writer);
+}
+
+typedef enum info_format_t {
+  INFO_FORMAT_TEXT,
+  INFO_FORMAT_JSON,    // One array holding every shader
+  INFO_FORMAT_NDJSON,  // One object per line
+} info_format_t;
+
+static int cmd_info(int argc, char** argv) {
+  bool verbose = false;
+  info_format_t format = INFO_FORMAT_TEXT;
+  int num_inputs = 0;
+
+  // Parse arguments
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_info_help();
+      return 0;
+    } else if (strcmp(argv[i], "--verbose") == 0 || strcmp(argv[i], "-v") == 0) {
+      verbose = true;
+    } else if (strcmp(argv[i], "--json") == 0) {
+      format = INFO_FORMAT_JSON;
+    } else if (strcmp(argv[i], "--ndjson") == 0) {
+      format = INFO_FORMAT_NDJSON;
+    } else if (argv[i][0] != '-') {
+      num_inputs++;
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (num_inputs == 0) {
+    fprintf(stderr, "Error: Input file required\n");
+    print_info_help();
+    return 1;
+  }
+
+  // Only the metadata is needed, blob payloads are seeked past
+  nshader_read_options_t read_options = {0};
+  read_options.skip_blobs = true;
+
+  json_writer_t writer;
+  json_writer_init(&writer, stdout);
+  if (format == INFO_FORMAT_JSON) {
+    json_write_begin_array(&writer);
+  }
+
+  int failed = 0;
+  bool first = true;
+  for (int i = 2; i < argc; i++) {
+    if (argv[i][0] == '-') continue;
+    const char* input_file = argv[i];
+
+    nshader_t* shader = nshader_read_from_path_ex(input_file, &read_options);
+    if (!shader) {
+      failed++;
+      if (format == INFO_FORMAT_TEXT) {
+        fprintf(stderr, "Error: Could not read shader file '%s'\n", input_file);
+        continue;
+      }
+    }
+
+    if (format == INFO_FORMAT_TEXT) {
+      if (!first) {
+        printf("\n");
+      }
+      print_info_text(input_file, nshader_get_info(shader), verbose);
+    } else if (format == INFO_FORMAT_JSON) {
+      write_info_json(&writer, input_file, shader);
+    } else {
+      json_writer_init(&writer, stdout);
+      write_info_json(&writer, input_file, shader);
+      fputc('\n', stdout);
+    }
+    first = false;
+
+    nshader_destroy(shader);
+  }
+
+  if (format == INFO_FORMAT_JSON) {
+    json_write_end_array(&writer);
+    fputc('\n', stdout);
+  }
+
+  return failed > 0 ? 1 : 0;
 }
 
 // #############################################################################
@@ -852,37 +1525,1570 @@ static int cmd_extract(int argc, char** argv) {
 }
 
 // #############################################################################
-// Main
+// Verify Command
 // #############################################################################
 
-int main(int argc, char** argv) {
-  if (argc < 2) {
-    print_help();
+static bool verify_file(const char* filepath) {
+  size_t size = 0;
+  void* buffer = read_file_to_buffer(filepath, &size);
+  if (!buffer) {
+    return false;
+  }
+
+  nshader_validate_report_t report;
+  if (!nshader_validate_memory(buffer, size, &report)) {
+    printf("%s: FAILED (%s at offset %zu)\n", filepath, nshader_validate_status_to_string(report.status), report.error_offset);
+    free(buffer);
+    return false;
+  }
+
+  if (!report.has_checksums) {
+    printf("%s: OK (structure only, no checksums stored)\n", filepath);
+    free(buffer);
+    return true;
+  }
+
+  nshader_read_options_t options = {0};
+  options.verify = NSHADER_VERIFY_ON_LOAD;
+  nshader_t* shader = nshader_read_from_memory_ex(buffer, size, &options);
+  free(buffer);
+  if (!shader) {
+    printf("%s: FAILED (checksum mismatch)\n", filepath);
+    return false;
+  }
+  nshader_destroy(shader);
+
+  printf("%s: OK (%u blobs, %llu bytes verified)\n", filepath, report.num_blobs, (unsigned long long)report.blob_bytes);
+  return true;
+}
+
+static int cmd_verify(int argc, char** argv) {
+  int num_files = 0;
+  int num_failed = 0;
+
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_verify_help();
+      return 0;
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+
+  for (int i = 2; i < argc; i++) {
+    num_files++;
+    if (!verify_file(argv[i])) {
+      num_failed++;
+    }
+  }
+
+  if (num_files == 0) {
+    fprintf(stderr, "Error: Input file required\n");
+    print_verify_help();
     return 1;
   }
 
-  const char* command = argv[1];
+  return num_failed > 0 ? 1 : 0;
+}
 
-  if (strcmp(command, "help") == 0 || strcmp(command, "--help") == 0 || strcmp(command, "-h") == 0) {
-    print_help();
-    return 0;
+// #############################################################################
+// Watch Command
+// #############################################################################
+
+static volatile sig_atomic_t g_interrupted = 0;
+
+static void on_interrupt(int signal_number) {
+  (void)signal_number;
+  g_interrupted = 1;
+}
+
+static void sleep_ms(unsigned int ms) {
+#ifdef _WIN32
+  Sleep(ms);
+#else
+  usleep(ms * 1000);
+#endif
+}
+
+static void on_watch_event(void* user, const nshader_watcher_event_t* event) {
+  (void)user;
+  if (event->success) {
+    printf("Built %s -> %s (generation %u)\n", event->name, event->output_path, event->generation);
+  } else {
+    fprintf(stderr, "Failed %s:\n", event->name);
+    for (size_t i = 0; i < event->errors->num_errors; i++) {
+      fprintf(stderr, "  %s\n", event->errors->errors[i]);
+    }
   }
+  fflush(stdout);
+}
 
-  if (strcmp(command, "version") == 0 || strcmp(command, "--version") == 0) {
-    printf("nshader version %s\n", NSHADER_CLI_VERSION);
-    return 0;
+static int cmd_watch(int argc, char** argv) {
+  const char* source_dir = NULL;
+  const char* output_dir = NULL;
+  const char* include_dir = NULL;
+  const char* entry_point = NULL;
+  nshader_compiler_define_t* defines = NULL;
+  size_t num_defines = 0;
+  bool checksums = false;
+  bool reproducible = false;
+  bool strip_spirv = false;
+  unsigned long debounce_ms = 0;
+  unsigned long num_threads = 0;
+  int result = 1;
+
+  // Parse arguments
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_watch_help();
+      result = 0;
+      goto cleanup;
+    } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-I") == 0 || strcmp(argv[i], "-D") == 0 ||
+               strcmp(argv[i], "--entry") == 0 || strcmp(argv[i], "--debounce") == 0 || strcmp(argv[i], "-j") == 0) {
+      const char* option = argv[i];
+      if (++i >= argc) {
+        fprintf(stderr, "Error: %s requires an argument\n", option);
+        goto cleanup;
+      }
+      if (strcmp(option, "-o") == 0) {
+        output_dir = argv[i];
+      } else if (strcmp(option, "-I") == 0) {
+        include_dir = argv[i];
+      } else if (strcmp(option, "--entry") == 0) {
+        entry_point = argv[i];
+      } else if (strcmp(option, "--debounce") == 0) {
+        debounce_ms = strtoul(argv[i], NULL, 10);
+      } else if (strcmp(option, "-j") == 0) {
+        num_threads = strtoul(argv[i], NULL, 10);
+      } else {
+        if (!add_define(&defines, &num_defines, argv[i])) {
+          goto cleanup;
+        }
+      }
+    } else if (strcmp(argv[i], "--checksums") == 0) {
+      checksums = true;
+    } else if (strcmp(argv[i], "--reproducible") == 0) {
+      reproducible = true;
+    } else if (strcmp(argv[i], "--strip-spirv") == 0) {
+      strip_spirv = true;
+    } else if (argv[i][0] != '-') {
+      if (!source_dir) {
+        source_dir = argv[i];
+      } else {
+        fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
+        goto cleanup;
+      }
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      goto cleanup;
+    }
   }
 
-  if (strcmp(command, "compile") == 0) {
-    return cmd_compile(argc, argv);
+  if (!source_dir || !output_dir) {
+    fprintf(stderr, "Error: Source directory and output directory (-o) required\n");
+    print_watch_help();
+    goto cleanup;
   }
 
-  if (strcmp(command, "info") == 0) {
-    return cmd_info(argc, argv);
+  nshader_compiler_config_t compiler = {0};
+  compiler.defines = defines;
+  compiler.num_defines = num_defines;
+  compiler.reproducible = reproducible;
+  compiler.strip_spirv = strip_spirv;
+
+  nshader_write_options_t write_options = {0};
+  write_options.checksums = checksums;
+
+  nshader_watcher_config_t config = {0};
+  config.source_dir = source_dir;
+  config.output_dir = output_dir;
+  config.include_dir = include_dir;
+  config.entry_point = entry_point;
+  config.compiler = &compiler;
+  config.write_options = &write_options;
+  config.debounce_ms = (uint32_t)debounce_ms;
+  config.num_threads = (uint32_t)num_threads;
+  config.callback = on_watch_event;
+
+  printf("Watching %s\n", source_dir);
+  nshader_watcher_t* watcher = nshader_watcher_create(&config);
+  if (!watcher) {
+    fprintf(stderr, "Error: Could not watch directory '%s'\n", source_dir);
+    goto cleanup;
   }
 
-  if (strcmp(command, "extract") == 0) {
-    return cmd_extract(argc, argv);
+  signal(SIGINT, on_interrupt);
+  while (!g_interrupted) {
+    sleep_ms(100);
+  }
+  printf("Stopping\n");
+  nshader_watcher_destroy(watcher);
+  result = 0;
+
+cleanup:
+  for (size_t i = 0; i < num_defines; i++) {
+    free((char*)defines[i].name);
+    free((char*)defines[i].value);
+  }
+  free(defines);
+  return result;
+}
+
+// #############################################################################
+// Serve Command
+// #############################################################################
+
+static int cmd_serve(int argc, char** argv) {
+  const char* socket_path = NULL;
+  unsigned long num_threads = 0;
+  unsigned long cache_mib = 0;
+
+  // Parse arguments
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_serve_help();
+      return 0;
+    } else if (strcmp(argv[i], "--socket") == 0 || strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--cache-size") == 0) {
+      const char* option = argv[i];
+      if (++i >= argc) {
+        fprintf(stderr, "Error: %s requires an argument\n", option);
+        return 1;
+      }
+      if (strcmp(option, "--socket") == 0) {
+        socket_path = argv[i];
+      } else if (strcmp(option, "-j") == 0) {
+        num_threads = strtoul(argv[i], NULL, 10);
+      } else {
+        cache_mib = strtoul(argv[i], NULL, 10);
+      }
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (!socket_path) {
+    fprintf(stderr, "Error: Socket path (--socket) required\n");
+    print_serve_help();
+    return 1;
+  }
+
+  nshader_server_config_t config = {0};
+  config.socket_path = socket_path;
+  config.num_threads = (uint32_t)num_threads;
+  config.cache_size = (size_t)cache_mib * 1024 * 1024;
+
+  nshader_server_t* server = nshader_server_create(&config);
+  if (!server) {
+    fprintf(stderr, "Error: Could not serve on '%s' (in use, or not supported on this platform)\n", socket_path);
+    return 1;
+  }
+  printf("Serving on %s\n", socket_path);
+  fflush(stdout);
+
+  signal(SIGINT, on_interrupt);
+  signal(SIGTERM, on_interrupt);
+  while (!g_interrupted) {
+    sleep_ms(100);
+  }
+
+  nshader_server_stats_t stats;
+  nshader_server_get_stats(server, &stats);
+  nshader_server_destroy(server);
+  printf("Stopped after %llu requests (%llu cache hits, %llu failed)\n",
+         (unsigned long long)stats.requests, (unsigned long long)stats.cache_hits, (unsigned long long)stats.failures);
+  return 0;
+}
+
+// #############################################################################
+// Build Command
+// #############################################################################
+
+typedef enum build_status_t {
+  BUILD_STATUS_PENDING,
+  BUILD_STATUS_UP_TO_DATE,
+  BUILD_STATUS_BUILT,
+  BUILD_STATUS_FAILED
+} build_status_t;
+
+// One manifest entry, strings are owned unless noted
+typedef struct build_target_t {
+  char* output;
+  char* include_dir;
+  char* source_paths[NSHADER_STAGE_TYPE_COUNT];   // NULL for absent stages
+  char* sources[NSHADER_STAGE_TYPE_COUNT];        // Source code, read when the target is stale
+  const char* entry_points[NSHADER_STAGE_TYPE_COUNT];  // Owned by the manifest document
+  nshader_compiler_define_t* stage_defines[NSHADER_STAGE_TYPE_COUNT];
+  size_t num_stage_defines[NSHADER_STAGE_TYPE_COUNT];
+  nshader_compiler_define_t* defines;             // Manifest defines followed by the entry's own
+  size_t num_defines;
+  nshader_compiler_stage_setup_t stages[NSHADER_STAGE_TYPE_COUNT];
+  uint64_t config_hash;                           // Everything besides the sources the output depends on
+
+  build_status_t status;
+  char** errors;
+  size_t num_errors;
+  uint64_t compile_ns;
+} build_target_t;
+
+typedef struct build_results_t {
+  build_target_t* targets;
+  const size_t* target_indices;  // Target of each compiled config
+  const nshader_write_options_t* write_options;
+} build_results_t;
+
+static double get_seconds(void) {
+  struct timespec now;
+  timespec_get(&now, TIME_UTC);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static bool is_absolute_path(const char* path) {
+  return path[0] == '/' || path[0] == '\\' || (path[0] != '\0' && path[1] == ':');
+}
+
+// Paths in a manifest are relative to the directory containing it
+static char* resolve_manifest_path(const char* manifest_dir, const char* path) {
+  if (manifest_dir[0] == '\0' || is_absolute_path(path)) {
+    return strdup(path);
+  }
+  return join_path(manifest_dir, path);
+}
+
+static bool get_modify_time(const char* path, time_t* out_time) {
+  struct stat info;
+  if (stat(path, &info) != 0) {
+    return false;
+  }
+  *out_time = info.st_mtime;
+  return true;
+}
+
+static void track_newest_dependency(void* user, const char* path, bool exists) {
+  time_t* newest = (time_t*)user;
+  time_t modify_time;
+  if (exists && get_modify_time(path, &modify_time) && modify_time > *newest) {
+    *newest = modify_time;
+  }
+}
+
+static uint64_t hash_build_string(uint64_t hash, const char* string) {
+  // Terminators keep neighbouring strings apart, NULL differs from ""
+  return string ? hash_fnv1a(hash, string, strlen(string) + 1) : hash_fnv1a(hash, "\xff", 1);
+}
+
+static uint64_t hash_build_defines(uint64_t hash, const nshader_compiler_define_t* defines, size_t num_defines) {
+  hash = hash_fnv1a(hash, &num_defines, sizeof(num_defines));
+  for (size_t i = 0; i < num_defines; i++) {
+    hash = hash_build_string(hash, defines[i].name);
+    hash = hash_build_string(hash, defines[i].value);
+  }
+  return hash;
+}
+
+static uint64_t hash_build_config(const build_target_t* target, const nshader_compiler_config_t* options, const nshader_write_options_t* write_options) {
+  uint64_t hash = hash_build_string(FNV1A_BASIS, target->include_dir);
+  hash = hash_build_defines(hash, target->defines, target->num_defines);
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    hash = hash_build_string(hash, target->source_paths[stage]);
+    if (target->source_paths[stage]) {
+      hash = hash_build_string(hash, target->entry_points[stage]);
+      hash = hash_build_defines(hash, target->stage_defines[stage], target->num_stage_defines[stage]);
+    }
+  }
+  const uint8_t flags[] = { options->reproducible, options->strip_spirv, write_options->checksums };
+  return hash_fnv1a(hash, flags, sizeof(flags));
+}
+
+// The config hash of a built output is kept next to it in <output>.stamp
+static char* get_stamp_path(const char* output) {
+  size_t length = strlen(output);
+  char* path = (char*)malloc(length + sizeof(".stamp"));
+  if (path) {
+    memcpy(path, output, length);
+    memcpy(path + length, ".stamp", sizeof(".stamp"));
+  }
+  return path;
+}
+
+static bool read_stamp(const char* output, uint64_t* out_hash) {
+  char* path = get_stamp_path(output);
+  FILE* file = path ? fopen(path, "r") : NULL;
+  free(path);
+  if (!file) {
+    return false;
+  }
+  unsigned long long hash;
+  bool ok = fscanf(file, "%llx", &hash) == 1;
+  fclose(file);
+  *out_hash = (uint64_t)hash;
+  return ok;
+}
+
+// Without a stamp the next build rebuilds the output, so failing is harmless
+static void write_stamp(const char* output, uint64_t hash) {
+  char* path = get_stamp_path(output);
+  FILE* file = path ? fopen(path, "w") : NULL;
+  free(path);
+  if (file) {
+    fprintf(file, "%016llx\n", (unsigned long long)hash);
+    fclose(file);
+  }
+}
+
+static void remove_stamp(const char* output) {
+  char* path = get_stamp_path(output);
+  if (path) {
+    remove(path);
+    free(path);
+  }
+}
+
+// A target is up to date when its output was built with the same config and
+// is newer than the manifest, every stage source and everything they include.
+// Times have a resolution of one second, so inputs from the same second as
+// the output count as newer.
+static bool is_up_to_date(const build_target_t* target, time_t manifest_time) {
+  time_t output_time;
+  uint64_t stamp_hash;
+  if (!get_modify_time(target->output, &output_time) || !read_stamp(target->output, &stamp_hash) || stamp_hash != target->config_hash) {
+    return false;
+  }
+  time_t newest = manifest_time;
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    if (!target->source_paths[stage]) {
+      continue;
+    }
+    time_t source_time;
+    if (!get_modify_time(target->source_paths[stage], &source_time)) {
+      return false;
+    }
+    if (source_time > newest) {
+      newest = source_time;
+    }
+    nshader_compiler_scan_dependencies(target->source_paths[stage], target->include_dir, track_newest_dependency, &newest);
+  }
+  return newest < output_time;
+}
+
+static void add_build_error(build_target_t* target, const char* message) {
+  char** errors = (char**)realloc(target->errors, sizeof(char*) * (target->num_errors + 1));
+  if (!errors) {
+    return;
+  }
+  target->errors = errors;
+  char* copy = strdup(message);
+  if (copy) {
+    target->errors[target->num_errors++] = copy;
+  }
+}
+
+// Called on the compiling threads, every call touches its own target
+static void on_build_result(void* user, const nshader_compiler_result_t* result) {
+  build_results_t* results = (build_results_t*)user;
+  build_target_t* target = &results->targets[results->target_indices[result->index]];
+  target->compile_ns = result->compile_ns;
+
+  if (!result->shader) {
+    for (size_t i = 0; i < result->errors->num_errors; i++) {
+      add_build_error(target, result->errors->errors[i]);
+    }
+    target->status = BUILD_STATUS_FAILED;
+    return;
+  }
+
+  // A failed write may leave a partial output, which must not pass as up to date
+  create_parent_dirs(target->output);
+  remove_stamp(target->output);
+  if (nshader_write_to_path_ex(result->shader, target->output, results->write_options)) {
+    target->status = BUILD_STATUS_BUILT;
+    write_stamp(target->output, target->config_hash);
+    printf("Built %s (%.0f ms)\n", target->output, (double)result->compile_ns / 1e6);
+    fflush(stdout);
+  } else {
+    add_build_error(target, "Failed to write output file");
+    target->status = BUILD_STATUS_FAILED;
+  }
+  nshader_destroy(result->shader);
+}
+
+// Append an array of "NAME[=VALUE]" strings to a define array
+static bool parse_manifest_defines(const json_value_t* list, const char* where, nshader_compiler_define_t** defines, size_t* num_defines) {
+  if (!list) {
+    return true;
+  }
+  if (list->type != JSON_ARRAY) {
+    fprintf(stderr, "Error: %s.defines must be an array of strings\n", where);
+    return false;
+  }
+  for (size_t i = 0; i < list->count; i++) {
+    if (list->items[i].type != JSON_STRING) {
+      fprintf(stderr, "Error: %s.defines must be an array of strings\n", where);
+      return false;
+    }
+    if (!is_valid_define(list->items[i].string)) {
+      fprintf(stderr, "Error: %s.defines has invalid define '%s', expected NAME[=VALUE]\n", where, list->items[i].string);
+      return false;
+    }
+    if (!add_define(defines, num_defines, list->items[i].string)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void free_defines(nshader_compiler_define_t* defines, size_t num_defines) {
+  for (size_t i = 0; i < num_defines; i++) {
+    free((char*)defines[i].name);
+    free((char*)defines[i].value);
+  }
+  free(defines);
+}
+
+static void free_build_target(build_target_t* target) {
+  free(target->output);
+  free(target->include_dir);
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    free(target->source_paths[stage]);
+    free(target->sources[stage]);
+    free_defines(target->stage_defines[stage], target->num_stage_defines[stage]);
+  }
+  free_defines(target->defines, target->num_defines);
+  for (size_t i = 0; i < target->num_errors; i++) {
+    free(target->errors[i]);
+  }
+  free(target->errors);
+}
+
+static const char* get_manifest_string(const json_value_t* object, const char* key, const char* where, bool* ok) {
+  const json_value_t* value = json_get(object, key);
+  if (!value) {
+    return NULL;
+  }
+  if (value->type != JSON_STRING) {
+    fprintf(stderr, "Error: %s.%s must be a string, not %s\n", where, key, json_type_to_string(value->type));
+    *ok = false;
+    return NULL;
+  }
+  return value->string;
+}
+
+static bool get_manifest_bool(const json_value_t* object, const char* key, const char* where, bool* out_value) {
+  const json_value_t* value = json_get(object, key);
+  if (!value) {
+    return true;
+  }
+  if (value->type != JSON_BOOL) {
+    fprintf(stderr, "Error: %s.%s must be a boolean, not %s\n", where, key, json_type_to_string(value->type));
+    return false;
+  }
+  *out_value = value->boolean;
+  return true;
+}
+
+// Fill a target from one entry of the "shaders" array
+static bool parse_manifest_target(const json_value_t* manifest, const json_value_t* entry, size_t index, const char* manifest_dir, build_target_t* target) {
+  char where[64];
+  snprintf(where, sizeof(where), "shaders[%zu]", index);
+  if (entry->type != JSON_OBJECT) {
+    fprintf(stderr, "Error: %s must be an object\n", where);
+    return false;
+  }
+
+  bool ok = true;
+  const char* output = get_manifest_string(entry, "output", where, &ok);
+  const char* entry_point = get_manifest_string(entry, "entry", where, &ok);
+  const char* include_dir = get_manifest_string(entry, "include_dir", where, &ok);
+  if (!include_dir) {
+    include_dir = get_manifest_string(manifest, "include_dir", "manifest", &ok);
+  }
+  if (!ok) {
+    return false;
+  }
+  if (!output) {
+    fprintf(stderr, "Error: %s.output is required\n", where);
+    return false;
+  }
+  target->output = resolve_manifest_path(manifest_dir, output);
+  target->include_dir = include_dir ? resolve_manifest_path(manifest_dir, include_dir) : NULL;
+
+  if (!parse_manifest_defines(json_get(manifest, "defines"), "manifest", &target->defines, &target->num_defines) ||
+      !parse_manifest_defines(json_get(entry, "defines"), where, &target->defines, &target->num_defines)) {
+    return false;
+  }
+
+  // Each stage is a source path, or an object with source, entry and defines
+  bool has_stage = false;
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    const json_value_t* value = json_get(entry, g_stage_names[stage]);
+    if (!value) {
+      continue;
+    }
+    char stage_where[96];
+    snprintf(stage_where, sizeof(stage_where), "%s.%s", where, g_stage_names[stage]);
+
+    const char* source = NULL;
+    const char* stage_entry_point = NULL;
+    if (value->type == JSON_STRING) {
+      source = value->string;
+    } else if (value->type == JSON_OBJECT) {
+      source = get_manifest_string(value, "source", stage_where, &ok);
+      stage_entry_point = get_manifest_string(value, "entry", stage_where, &ok);
+      if (!ok || !parse_manifest_defines(json_get(value, "defines"), stage_where, &target->stage_defines[stage], &target->num_stage_defines[stage])) {
+        return false;
+      }
+    } else {
+      fprintf(stderr, "Error: %s must be a path or an object\n", stage_where);
+      return false;
+    }
+    if (!source) {
+      fprintf(stderr, "Error: %s.source is required\n", stage_where);
+      return false;
+    }
+
+    target->source_paths[stage] = resolve_manifest_path(manifest_dir, source);
+    target->entry_points[stage] = stage_entry_point ? stage_entry_point : (entry_point ? entry_point : "main");
+    has_stage = true;
+  }
+
+  if (!has_stage) {
+    fprintf(stderr, "Error: %s needs a vertex, fragment or compute stage\n", where);
+    return false;
+  }
+  return true;
+}
+
+// Read the sources of a stale target and describe it as a compiler config
+static bool prepare_build_target(build_target_t* target, const nshader_compiler_config_t* options, nshader_compiler_config_t* out_config) {
+  size_t num_stages = 0;
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    if (!target->source_paths[stage]) {
+      continue;
+    }
+    target->sources[stage] = read_file_to_string(target->source_paths[stage]);
+    if (!target->sources[stage]) {
+      char message[512];
+      snprintf(message, sizeof(message), "Could not read %s source '%s'", g_stage_names[stage], target->source_paths[stage]);
+      add_build_error(target, message);
+      return false;
+    }
+    nshader_compiler_stage_setup_t* setup = &target->stages[num_stages++];
+    setup->stage_type = (nshader_stage_type_t)stage;
+    setup->entry_point = target->entry_points[stage];
+    setup->source_code = target->sources[stage];
+    setup->defines = target->stage_defines[stage];
+    setup->num_defines = target->num_stage_defines[stage];
+  }
+
+  *out_config = *options;
+  out_config->stages = target->stages;
+  out_config->num_stages = num_stages;
+  out_config->include_dir = target->include_dir;
+  out_config->defines = target->defines;
+  out_config->num_defines = target->num_defines;
+  return true;
+}
+
+static int cmd_build(int argc, char** argv) {
+  const char* manifest_path = NULL;
+  unsigned long num_threads = 0;
+  bool force = false;
+  bool checksums = false;
+  bool reproducible = false;
+  bool strip_spirv = false;
+
+  // Parse arguments
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_build_help();
+      return 0;
+    } else if (strcmp(argv[i], "-j") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: -j requires an argument\n");
+        return 1;
+      }
+      num_threads = strtoul(argv[i], NULL, 10);
+    } else if (strcmp(argv[i], "--force") == 0) {
+      force = true;
+    } else if (strcmp(argv[i], "--checksums") == 0) {
+      checksums = true;
+    } else if (strcmp(argv[i], "--reproducible") == 0) {
+      reproducible = true;
+    } else if (strcmp(argv[i], "--strip-spirv") == 0) {
+      strip_spirv = true;
+    } else if (argv[i][0] != '-') {
+      if (!manifest_path) {
+        manifest_path = argv[i];
+      } else {
+        fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
+        return 1;
+      }
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (!manifest_path) {
+    fprintf(stderr, "Error: Manifest file required\n");
+    print_build_help();
+    return 1;
+  }
+
+  double start_time = get_seconds();
+
+  // Load the manifest
+  char* text = read_file_to_string(manifest_path);
+  if (!text) {
+    return 1;
+  }
+  char parse_error[128];
+  json_value_t* manifest = json_parse(text, parse_error, sizeof(parse_error));
+  free(text);
+  if (!manifest) {
+    fprintf(stderr, "Error: %s: %s\n", manifest_path, parse_error);
+    return 1;
+  }
+
+  const json_value_t* shaders = json_get(manifest, "shaders");
+  if (!shaders || shaders->type != JSON_ARRAY) {
+    fprintf(stderr, "Error: %s: Manifest needs a \"shaders\" array\n", manifest_path);
+    json_free(manifest);
+    return 1;
+  }
+
+  time_t manifest_time = 0;
+  get_modify_time(manifest_path, &manifest_time);
+
+  int result = 1;
+  size_t num_targets = shaders->count;
+  build_target_t* targets = (build_target_t*)calloc(num_targets ? num_targets : 1, sizeof(build_target_t));
+  nshader_compiler_config_t* configs = (nshader_compiler_config_t*)calloc(num_targets ? num_targets : 1, sizeof(nshader_compiler_config_t));
+  size_t* target_indices = (size_t*)calloc(num_targets ? num_targets : 1, sizeof(size_t));
+  char* manifest_dir = strdup(manifest_path);
+  if (!targets || !configs || !target_indices || !manifest_dir) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+    num_targets = 0;
+    goto cleanup;
+  }
+
+  size_t dir_len = strlen(manifest_dir);
+  while (dir_len > 0 && manifest_dir[dir_len - 1] != '/' && manifest_dir[dir_len - 1] != '\\') {
+    dir_len--;
+  }
+  manifest_dir[dir_len > 1 ? dir_len - 1 : dir_len] = '\0';
+
+  // Flags turn options on, so the manifest can not turn off what the command line enables
+  bool manifest_checksums = false, manifest_reproducible = false, manifest_strip_spirv = false;
+  bool ok = get_manifest_bool(manifest, "checksums", "manifest", &manifest_checksums) &&
+            get_manifest_bool(manifest, "reproducible", "manifest", &manifest_reproducible) &&
+            get_manifest_bool(manifest, "strip_spirv", "manifest", &manifest_strip_spirv);
+  for (size_t i = 0; ok && i < num_targets; i++) {
+    ok = parse_manifest_target(manifest, &shaders->items[i], i, manifest_dir, &targets[i]);
+  }
+  if (!ok) {
+    goto cleanup;
+  }
+
+  nshader_compiler_config_t options = {0};
+  options.reproducible = reproducible || manifest_reproducible;
+  options.strip_spirv = strip_spirv || manifest_strip_spirv;
+
+  nshader_write_options_t write_options = {0};
+  write_options.checksums = checksums || manifest_checksums;
+
+  // Skip up-to-date targets, and describe the others for the compiler
+  size_t num_configs = 0;
+  for (size_t i = 0; i < num_targets; i++) {
+    build_target_t* target = &targets[i];
+    target->config_hash = hash_build_config(target, &options, &write_options);
+    if (!force && is_up_to_date(target, manifest_time)) {
+      target->status = BUILD_STATUS_UP_TO_DATE;
+    } else if (!prepare_build_target(target, &options, &configs[num_configs])) {
+      target->status = BUILD_STATUS_FAILED;
+    } else {
+      target_indices[num_configs++] = i;
+    }
+  }
+
+  // Compile everything in this process, with one compiler initialization
+  double compile_start = get_seconds();
+  if (num_configs > 0) {
+    build_results_t results = {targets, target_indices, &write_options};
+    nshader_compiler_compile_batch(configs, num_configs, (uint32_t)num_threads, on_build_result, &results);
+  }
+  double compile_seconds = get_seconds() - compile_start;
+
+  // Report failures in manifest order, then the summary
+  size_t num_built = 0, num_up_to_date = 0, num_failed = 0;
+  uint64_t total_compile_ns = 0;
+  for (size_t i = 0; i < num_targets; i++) {
+    build_target_t* target = &targets[i];
+    total_compile_ns += target->compile_ns;
+    if (target->status == BUILD_STATUS_BUILT) {
+      num_built++;
+    } else if (target->status == BUILD_STATUS_UP_TO_DATE) {
+      num_up_to_date++;
+    } else {
+      num_failed++;
+      fprintf(stderr, "Failed %s:\n", target->output);
+      for (size_t e = 0; e < target->num_errors; e++) {
+        fprintf(stderr, "  %s\n", target->errors[e]);
+      }
+    }
+  }
+
+  printf("\nBuild summary:\n");
+  printf("  Built:        %zu\n", num_built);
+  printf("  Up to date:   %zu\n", num_up_to_date);
+  printf("  Failed:       %zu\n", num_failed);
+  printf("  Compile time: %.2f s (%.2f s summed over shaders)\n", compile_seconds, (double)total_compile_ns / 1e9);
+  printf("  Total time:   %.2f s\n", get_seconds() - start_time);
+  result = num_failed > 0 ? 1 : 0;
+
+cleanup:
+  for (size_t i = 0; i < num_targets; i++) {
+    free_build_target(&targets[i]);
+  }
+  free(targets);
+  free(configs);
+  free(target_indices);
+  free(manifest_dir);
+  json_free(manifest);
+  return result;
+}
+
+// #############################################################################
+// Strip Command
+// #############################################################################
+
+typedef struct strip_job_t {
+  const char* input;
+  char* output;
+  bool debug_info;                               // Remove SPIR-V debug instructions
+  bool names;                                    // Remove input and output names
+  bool keep_checksums;                           // Store checksums if the input has them
+  const nshader_write_options_t* write_options;
+  uint64_t input_size;
+  uint64_t output_size;
+  const char* error;                             // NULL once written
+} strip_job_t;
+
+// Whether a shader file stores checksums, the header at its start tells
+static bool file_has_checksums(const char* path) {
+  uint8_t header[64];
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+  size_t size = fread(header, 1, sizeof(header), file);
+  fclose(file);
+
+  nshader_validate_report_t report;
+  nshader_validate_memory(header, size, &report);
+  return report.has_checksums;
+}
+
+// Strip and write a shader read with the backend mask applied, frees shader
+static void strip_shader(strip_job_t* job, nshader_t* shader) {
+  if (!shader) {
+    job->error = "Could not read shader file";
+    return;
+  }
+
+  if (nshader_get_info(shader)->num_backends == 0) {
+    job->error = "None of the backends to keep";
+  } else if (job->debug_info && !nshader_strip_debug_info(shader)) {
+    job->error = "Could not strip debug info";
+  } else if (job->names && !nshader_strip_names(shader)) {
+    job->error = "Could not strip names";
+  } else {
+    nshader_write_options_t write_options = *job->write_options;
+    write_options.checksums |= job->keep_checksums && file_has_checksums(job->input);
+    create_parent_dirs(job->output);
+    if (nshader_write_to_path_ex(shader, job->output, &write_options)) {
+      job->input_size = get_file_size(job->input);
+      job->output_size = get_file_size(job->output);
+      job->error = NULL;
+    } else {
+      job->error = "Could not write output file";
+    }
+  }
+  nshader_destroy(shader);
+}
+
+static void on_strip_loaded(void* user, nshader_load_id_t id, nshader_load_status_t status, nshader_t* shader) {
+  (void)id;
+  strip_shader((strip_job_t*)user, status == NSHADER_LOAD_STATUS_OK ? shader : NULL);
+}
+
+static int cmd_strip(int argc, char** argv) {
+  const char* input = NULL;
+  const char* output = NULL;
+  uint32_t keep_mask = 0;
+  bool debug_info = true;
+  bool names = false;
+  bool checksums = false;
+  bool keep_checksums = true;
+  unsigned long num_threads = 0;
+
+  // Parse arguments
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_strip_help();
+      return 0;
+    } else if (strcmp(argv[i], "-o") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: -o requires an argument\n");
+        return 1;
+      }
+      output = argv[i];
+    } else if (strcmp(argv[i], "--keep") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: --keep requires an argument\n");
+        return 1;
+      }
+      if (!parse_backend_mask(argv[i], &keep_mask)) {
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--keep-debug") == 0) {
+      debug_info = false;
+    } else if (strcmp(argv[i], "--strip-names") == 0) {
+      names = true;
+    } else if (strcmp(argv[i], "--checksums") == 0) {
+      checksums = true;
+      keep_checksums = true;
+    } else if (strcmp(argv[i], "--no-checksums") == 0) {
+      checksums = false;
+      keep_checksums = false;
+    } else if (strcmp(argv[i], "-j") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: -j requires an argument\n");
+        return 1;
+      }
+      num_threads = strtoul(argv[i], NULL, 10);
+    } else if (argv[i][0] != '-') {
+      if (!input) {
+        input = argv[i];
+      } else {
+        fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
+        return 1;
+      }
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (!input || !output) {
+    fprintf(stderr, "Error: Input and output (-o) required\n");
+    print_strip_help();
+    return 1;
+  }
+
+  // Other backends are skipped while reading, so their blobs never hit memory
+  nshader_read_options_t read_options = {0};
+  read_options.backend_mask = keep_mask;
+  nshader_write_options_t write_options = {0};
+  write_options.checksums = checksums;
+
+  // Collect the files, mirroring a directory below the output directory
+  path_list_t inputs = {0};
+  bool directory = is_directory(input);
+  if (directory) {
+    list_shader_files(input, &inputs);
+    if (inputs.count == 0) {
+      fprintf(stderr, "Error: No .nshader files in '%s'\n", input);
+      return 1;
+    }
+  } else {
+    path_list_add(&inputs, strdup(input));
+  }
+
+  strip_job_t* jobs = (strip_job_t*)calloc(inputs.count, sizeof(strip_job_t));
+  if (!jobs) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+    path_list_free(&inputs);
+    return 1;
+  }
+  for (size_t i = 0; i < inputs.count; i++) {
+    strip_job_t* job = &jobs[i];
+    job->input = inputs.paths[i];
+    if (directory) {
+      const char* relative = inputs.paths[i] + strlen(input);
+      while (*relative == '/' || *relative == '\\') {
+        relative++;
+      }
+      job->output = join_path(output, relative);
+    } else {
+      job->output = strdup(output);
+    }
+    job->debug_info = debug_info;
+    job->names = names;
+    job->keep_checksums = keep_checksums;
+    job->write_options = &write_options;
+    job->error = "Could not queue file";
+  }
+
+  if (!directory) {
+    strip_shader(&jobs[0], nshader_read_from_path_ex(jobs[0].input, &read_options));
+  } else {
+    // Files are read, stripped and written on the loader threads
+    nshader_loader_config_t loader_config = {0};
+    loader_config.num_threads = (uint32_t)num_threads;
+    nshader_loader_t* loader = nshader_loader_create(&loader_config);
+    nshader_load_desc_t* descs = (nshader_load_desc_t*)calloc(inputs.count, sizeof(nshader_load_desc_t));
+    if (loader && descs) {
+      for (size_t i = 0; i < inputs.count; i++) {
+        descs[i].path = jobs[i].input;
+        descs[i].callback = on_strip_loaded;
+        descs[i].user = &jobs[i];
+      }
+      nshader_load_async_batch(loader, descs, inputs.count, &read_options, NULL);
+      nshader_loader_wait_idle(loader);
+    }
+    free(descs);
+    nshader_loader_destroy(loader);
+  }
+
+  // Report in input order
+  size_t num_failed = 0;
+  uint64_t input_bytes = 0;
+  uint64_t output_bytes = 0;
+  for (size_t i = 0; i < inputs.count; i++) {
+    strip_job_t* job = &jobs[i];
+    if (job->error) {
+      fprintf(stderr, "Error: %s: %s\n", job->input, job->error);
+      num_failed++;
+      continue;
+    }
+    printf("Stripped %s -> %s (%llu -> %llu bytes)\n", job->input, job->output,
+      (unsigned long long)job->input_size, (unsigned long long)job->output_size);
+    input_bytes += job->input_size;
+    output_bytes += job->output_size;
+  }
+  if (directory) {
+    printf("%zu stripped, %zu failed: %llu -> %llu bytes\n", inputs.count - num_failed, num_failed,
+      (unsigned long long)input_bytes, (unsigned long long)output_bytes);
+  }
+
+  for (size_t i = 0; i < inputs.count; i++) {
+    free(jobs[i].output);
+  }
+  free(jobs);
+  path_list_free(&inputs);
+  return num_failed > 0 ? 1 : 0;
+}
+
+// #############################################################################
+// Stats Command
+// #############################################################################
+
+typedef struct stats_file_t {
+  const char* path;
+  bool duplicates;                                                     // Hash blob payloads
+  bool ok;
+  uint64_t file_size;
+  uint64_t blob_bytes;
+  uint32_t blob_sizes[NSHADER_STAGE_TYPE_COUNT][NSHADER_BACKEND_COUNT];
+  uint64_t blob_hashes[NSHADER_STAGE_TYPE_COUNT][NSHADER_BACKEND_COUNT];  // With duplicates only
+} stats_file_t;
+
+// Blob identity for duplicate detection
+typedef struct stats_blob_t {
+  uint64_t hash;
+  uint32_t size;
+  uint32_t backend;
+} stats_blob_t;
+
+#define STATS_HISTOGRAM_BUCKETS 16  // Powers of two from 1 KiB, the last one is open
+#define STATS_HISTOGRAM_WIDTH 40
+
+static void on_stats_loaded(void* user, nshader_load_id_t id, nshader_load_status_t status, nshader_t* shader) {
+  (void)id;
+  stats_file_t* file = (stats_file_t*)user;
+  if (status != NSHADER_LOAD_STATUS_OK) {
+    return;
+  }
+
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+      size_t size = nshader_get_blob_size(shader, (nshader_stage_type_t)stage, (nshader_backend_t)backend);
+      file->blob_sizes[stage][backend] = (uint32_t)size;
+      file->blob_bytes += size;
+      const nshader_blob_t* blob = file->duplicates ? nshader_get_blob(shader, (nshader_stage_type_t)stage, (nshader_backend_t)backend) : NULL;
+      if (blob) {
+        file->blob_hashes[stage][backend] = hash_fnv1a(FNV1A_BASIS, blob->data, blob->size);
+      }
+    }
+  }
+  file->file_size = get_file_size(file->path);
+  file->ok = true;
+  nshader_destroy(shader);
+}
+
+static void format_bytes(uint64_t bytes, char* out, size_t out_size) {
+  if (bytes < 1024) {
+    snprintf(out, out_size, "%llu B", (unsigned long long)bytes);
+  } else if (bytes < 1024 * 1024) {
+    snprintf(out, out_size, "%.1f KiB", (double)bytes / 1024.0);
+  } else {
+    snprintf(out, out_size, "%.1f MiB", (double)bytes / (1024.0 * 1024.0));
+  }
+}
+
+static double percent_of(uint64_t part, uint64_t total) {
+  return total ? 100.0 * (double)part / (double)total : 0.0;
+}
+
+static int compare_stats_blobs(const void* a, const void* b) {
+  const stats_blob_t* x = (const stats_blob_t*)a;
+  const stats_blob_t* y = (const stats_blob_t*)b;
+  if (x->backend != y->backend) return x->backend < y->backend ? -1 : 1;
+  if (x->size != y->size) return x->size < y->size ? -1 : 1;
+  if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+  return 0;
+}
+
+// Largest files first, ties in path order
+static int compare_stats_files(const void* a, const void* b) {
+  const stats_file_t* x = *(const stats_file_t* const*)a;
+  const stats_file_t* y = *(const stats_file_t* const*)b;
+  if (x->file_size != y->file_size) return x->file_size > y->file_size ? -1 : 1;
+  return strcmp(x->path, y->path);
+}
+
+static int stats_histogram_bucket(uint64_t size) {
+  int bucket = 0;
+  for (uint64_t limit = 1024; size >= limit && bucket < STATS_HISTOGRAM_BUCKETS - 1; limit *= 2) {
+    bucket++;
+  }
+  return bucket;
+}
+
+// Duplicate blobs of the same backend, only the first copy of each is needed
+static void print_stats_duplicates(const stats_file_t* files, size_t num_files, uint64_t blob_bytes) {
+  size_t num_blobs = 0;
+  for (size_t i = 0; i < num_files; i++) {
+    for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+      for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+        num_blobs += files[i].ok && files[i].blob_sizes[stage][backend] > 0;
+      }
+    }
+  }
+  stats_blob_t* blobs = (stats_blob_t*)malloc((num_blobs ? num_blobs : 1) * sizeof(stats_blob_t));
+  if (!blobs) {
+    return;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i < num_files; i++) {
+    for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+      for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+        if (files[i].ok && files[i].blob_sizes[stage][backend] > 0) {
+          blobs[count].hash = files[i].blob_hashes[stage][backend];
+          blobs[count].size = files[i].blob_sizes[stage][backend];
+          blobs[count].backend = (uint32_t)backend;
+          count++;
+        }
+      }
+    }
+  }
+  qsort(blobs, count, sizeof(stats_blob_t), compare_stats_blobs);
+
+  size_t num_duplicates = 0;
+  uint64_t duplicate_bytes = 0;
+  for (size_t i = 1; i < count; i++) {
+    if (compare_stats_blobs(&blobs[i - 1], &blobs[i]) == 0) {
+      num_duplicates++;
+      duplicate_bytes += blobs[i].size;
+    }
+  }
+  free(blobs);
+
+  char bytes[32];
+  format_bytes(duplicate_bytes, bytes, sizeof(bytes));
+  printf("\nDuplicate blobs: %zu of %zu, %s could be shared (%.1f%% of blob bytes)\n",
+    num_duplicates, count, bytes, percent_of(duplicate_bytes, blob_bytes));
+}
+
+static int cmd_stats(int argc, char** argv) {
+  unsigned long top_count = 10;
+  unsigned long num_threads = 0;
+  bool duplicates = false;
+  path_list_t paths = {0};
+
+  // Parse arguments
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      print_stats_help();
+      path_list_free(&paths);
+      return 0;
+    } else if (strcmp(argv[i], "-n") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: -n requires an argument\n");
+        path_list_free(&paths);
+        return 1;
+      }
+      top_count = strtoul(argv[i], NULL, 10);
+    } else if (strcmp(argv[i], "-j") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: -j requires an argument\n");
+        path_list_free(&paths);
+        return 1;
+      }
+      num_threads = strtoul(argv[i], NULL, 10);
+    } else if (strcmp(argv[i], "--duplicates") == 0) {
+      duplicates = true;
+    } else if (argv[i][0] != '-') {
+      if (is_directory(argv[i])) {
+        list_shader_files(argv[i], &paths);
+      } else {
+        path_list_add(&paths, strdup(argv[i]));
+      }
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      path_list_free(&paths);
+      return 1;
+    }
+  }
+
+  if (paths.count == 0) {
+    fprintf(stderr, "Error: No .nshader files given\n");
+    print_stats_help();
+    return 1;
+  }
+
+  double start_time = get_seconds();
+
+  stats_file_t* files = (stats_file_t*)calloc(paths.count, sizeof(stats_file_t));
+  nshader_load_desc_t* descs = (nshader_load_desc_t*)calloc(paths.count, sizeof(nshader_load_desc_t));
+  nshader_loader_config_t loader_config = {0};
+  loader_config.num_threads = (uint32_t)num_threads;
+  nshader_loader_t* loader = files && descs ? nshader_loader_create(&loader_config) : NULL;
+  if (!loader) {
+    fprintf(stderr, "Error: Could not create loader\n");
+    free(files);
+    free(descs);
+    path_list_free(&paths);
+    return 1;
+  }
+
+  // Payloads are only read when they are hashed
+  nshader_read_options_t read_options = {0};
+  read_options.skip_blobs = !duplicates;
+  for (size_t i = 0; i < paths.count; i++) {
+    files[i].path = paths.paths[i];
+    files[i].duplicates = duplicates;
+    descs[i].path = paths.paths[i];
+    descs[i].callback = on_stats_loaded;
+    descs[i].user = &files[i];
+  }
+  nshader_load_async_batch(loader, descs, paths.count, &read_options, NULL);
+  nshader_loader_wait_idle(loader);
+  nshader_loader_destroy(loader);
+  free(descs);
+
+  // Totals per backend and per stage
+  size_t num_read = 0;
+  uint64_t file_bytes = 0;
+  uint64_t blob_bytes = 0;
+  uint64_t backend_bytes[NSHADER_BACKEND_COUNT] = {0};
+  size_t backend_blobs[NSHADER_BACKEND_COUNT] = {0};
+  uint64_t stage_bytes[NSHADER_STAGE_TYPE_COUNT] = {0};
+  size_t stage_blobs[NSHADER_STAGE_TYPE_COUNT] = {0};
+  size_t histogram[STATS_HISTOGRAM_BUCKETS] = {0};
+  for (size_t i = 0; i < paths.count; i++) {
+    const stats_file_t* file = &files[i];
+    if (!file->ok) {
+      fprintf(stderr, "Error: Could not read shader file '%s'\n", file->path);
+      continue;
+    }
+    num_read++;
+    file_bytes += file->file_size;
+    blob_bytes += file->blob_bytes;
+    histogram[stats_histogram_bucket(file->file_size)]++;
+    for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+      for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+        uint32_t size = file->blob_sizes[stage][backend];
+        if (size == 0) continue;
+        backend_bytes[backend] += size;
+        backend_blobs[backend]++;
+        stage_bytes[stage] += size;
+        stage_blobs[stage]++;
+      }
+    }
+  }
+
+  char bytes[32];
+  format_bytes(file_bytes, bytes, sizeof(bytes));
+  printf("Shaders: %zu (%zu failed), %s in %.2f s\n", num_read, paths.count - num_read, bytes, get_seconds() - start_time);
+  format_bytes(blob_bytes, bytes, sizeof(bytes));
+  printf("Blobs: %s (%.1f%%)\n", bytes, percent_of(blob_bytes, file_bytes));
+  format_bytes(file_bytes - blob_bytes, bytes, sizeof(bytes));
+  printf("Metadata and padding: %s (%.1f%%)\n", bytes, percent_of(file_bytes - blob_bytes, file_bytes));
+
+  printf("\nBy backend:\n");
+  for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+    format_bytes(backend_bytes[backend], bytes, sizeof(bytes));
+    printf("  %-10s %6zu blobs %12s %5.1f%%\n", nshader_backend_to_string((nshader_backend_t)backend),
+      backend_blobs[backend], bytes, percent_of(backend_bytes[backend], blob_bytes));
+  }
+  printf("\nBy stage:\n");
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    format_bytes(stage_bytes[stage], bytes, sizeof(bytes));
+    printf("  %-10s %6zu blobs %12s %5.1f%%\n", nshader_stage_type_to_string((nshader_stage_type_t)stage),
+      stage_blobs[stage], bytes, percent_of(stage_bytes[stage], blob_bytes));
+  }
+
+  if (duplicates) {
+    print_stats_duplicates(files, paths.count, blob_bytes);
+  }
+
+  // Largest shaders
+  const stats_file_t** sorted = (const stats_file_t**)malloc(paths.count * sizeof(stats_file_t*));
+  if (sorted && top_count > 0 && num_read > 0) {
+    size_t count = 0;
+    for (size_t i = 0; i < paths.count; i++) {
+      if (files[i].ok) sorted[count++] = &files[i];
+    }
+    qsort(sorted, count, sizeof(stats_file_t*), compare_stats_files);
+    printf("\nLargest shaders:\n");
+    for (size_t i = 0; i < count && i < top_count; i++) {
+      format_bytes(sorted[i]->file_size, bytes, sizeof(bytes));
+      printf("  %12s  %s\n", bytes, sorted[i]->path);
+    }
+  }
+  free(sorted);
+
+  // Size histogram over the non-empty range of buckets
+  int first_bucket = STATS_HISTOGRAM_BUCKETS;
+  int last_bucket = -1;
+  size_t max_bucket = 0;
+  for (int bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; bucket++) {
+    if (histogram[bucket] == 0) continue;
+    if (bucket < first_bucket) first_bucket = bucket;
+    last_bucket = bucket;
+    if (histogram[bucket] > max_bucket) max_bucket = histogram[bucket];
+  }
+  if (last_bucket >= 0) {
+    printf("\nFile sizes:\n");
+  }
+  for (int bucket = first_bucket; bucket <= last_bucket; bucket++) {
+    char label[32];
+    char low[16];
+    char high[16];
+    format_bytes(bucket == 0 ? 0 : 512ull << bucket, low, sizeof(low));
+    format_bytes(1024ull << bucket, high, sizeof(high));
+    if (bucket == STATS_HISTOGRAM_BUCKETS - 1) {
+      snprintf(label, sizeof(label), ">= %s", low);
+    } else {
+      snprintf(label, sizeof(label), "< %s", high);
+    }
+    int width = (int)((histogram[bucket] * STATS_HISTOGRAM_WIDTH + max_bucket - 1) / max_bucket);
+    printf("  %12s %6zu %.*s\n", label, histogram[bucket], width, "########################################");
+  }
+
+  bool failed = num_read != paths.count;
+  free(files);
+  path_list_free(&paths);
+  return failed ? 1 : 0;
+}
+
+// #############################################################################
+// Diff and Patch Commands
+// #############################################################################
+
+// Both commands take two inputs and -o, help_fn prints the command help
+static bool parse_two_inputs(int argc, char** argv, void (*help_fn)(void), const char** out_first, const char** out_second, const char** out_output, bool* out_help) {
+  *out_help = false;
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      help_fn();
+      *out_help = true;
+      return true;
+    } else if (strcmp(argv[i], "-o") == 0) {
+      if (++i >= argc) {
+        fprintf(stderr, "Error: -o requires an argument\n");
+        return false;
+      }
+      *out_output = argv[i];
+    } else if (argv[i][0] != '-') {
+      if (!*out_first) {
+        *out_first = argv[i];
+      } else if (!*out_second) {
+        *out_second = argv[i];
+      } else {
+        fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
+        return false;
+      }
+    } else {
+      fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+      return false;
+    }
+  }
+
+  if (!*out_first || !*out_second || !*out_output) {
+    fprintf(stderr, "Error: Two inputs and output (-o) required\n");
+    help_fn();
+    return false;
+  }
+  return true;
+}
+
+static int cmd_diff(int argc, char** argv) {
+  const char* old_path = NULL;
+  const char* new_path = NULL;
+  const char* output = NULL;
+  bool help = false;
+  if (!parse_two_inputs(argc, argv, print_diff_help, &old_path, &new_path, &output, &help)) {
+    return 1;
+  }
+  if (help) {
+    return 0;
+  }
+
+  nshader_t* old_shader = nshader_read_from_path(old_path);
+  if (!old_shader) {
+    fprintf(stderr, "Error: Could not read '%s'\n", old_path);
+    return 1;
+  }
+  nshader_t* new_shader = nshader_read_from_path(new_path);
+  if (!new_shader) {
+    fprintf(stderr, "Error: Could not read '%s'\n", new_path);
+    nshader_destroy(old_shader);
+    return 1;
+  }
+
+  FILE* file = fopen(output, "wb");
+  bool success = false;
+  if (!file) {
+    fprintf(stderr, "Error: Could not open file '%s' for writing\n", output);
+  } else {
+    nshader_io_t io = nshader_io_from_file(file);
+    success = nshader_diff_to_io(old_shader, new_shader, &io);
+    long patch_size = ftell(file);
+    success = fclose(file) == 0 && success;
+    if (success) {
+      printf("Wrote %s (%ld bytes, new shader %llu bytes)\n", output, patch_size,
+        (unsigned long long)get_file_size(new_path));
+    } else {
+      fprintf(stderr, "Error: Could not write patch '%s'\n", output);
+      remove(output);
+    }
+  }
+
+  nshader_destroy(new_shader);
+  nshader_destroy(old_shader);
+  return success ? 0 : 1;
+}
+
+static int cmd_patch(int argc, char** argv) {
+  const char* old_path = NULL;
+  const char* patch_path = NULL;
+  const char* output = NULL;
+  bool help = false;
+  if (!parse_two_inputs(argc, argv, print_patch_help, &old_path, &patch_path, &output, &help)) {
+    return 1;
+  }
+  if (help) {
+    return 0;
+  }
+
+  nshader_t* old_shader = nshader_read_from_path(old_path);
+  if (!old_shader) {
+    fprintf(stderr, "Error: Could not read '%s'\n", old_path);
+    return 1;
+  }
+  size_t patch_size = 0;
+  void* patch = read_file_to_buffer(patch_path, &patch_size);
+  if (!patch) {
+    nshader_destroy(old_shader);
+    return 1;
+  }
+
+  nshader_t* new_shader = nshader_patch(old_shader, patch, patch_size);
+  free(patch);
+  nshader_destroy(old_shader);
+  if (!new_shader) {
+    fprintf(stderr, "Error: '%s' is not a valid patch for '%s'\n", patch_path, old_path);
+    return 1;
+  }
+
+  bool success = nshader_write_to_path(new_shader, output);
+  nshader_destroy(new_shader);
+  if (!success) {
+    fprintf(stderr, "Error: Could not write '%s'\n", output);
+    return 1;
+  }
+  printf("Wrote %s (%llu bytes)\n", output, (unsigned long long)get_file_size(output));
+  return 0;
+}
+
+// #############################################################################
+// Main
+// #############################################################################
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    print_help();
+    return 1;
+  }
+
+  const char* command = argv[1];
+
+  if (strcmp(command, "help") == 0 || strcmp(command, "--help") == 0 || strcmp(command, "-h") == 0) {
+    print_help();
+    return 0;
+  }
+
+  if (strcmp(command, "version") == 0 || strcmp(command, "--version") == 0) {
+    printf("nshader version %s\n", NSHADER_CLI_VERSION);
+    return 0;
+  }
+
+  if (strcmp(command, "compile") == 0) {
+    return cmd_compile(argc, argv);
+  }
+
+  if (strcmp(command, "info") == 0) {
+    return cmd_info(argc, argv);
+  }
+
+  if (strcmp(command, "extract") == 0) {
+    return cmd_extract(argc, argv);
+  }
+
+  if (strcmp(command, "verify") == 0) {
+    return cmd_verify(argc, argv);
+  }
+
+  if (strcmp(command, "build") == 0) {
+    return cmd_build(argc, argv);
+  }
+
+  if (strcmp(command, "strip") == 0) {
+    return cmd_strip(argc, argv);
+  }
+
+  if (strcmp(command, "stats") == 0) {
+    return cmd_stats(argc, argv);
+  }
+
+  if (strcmp(command, "diff") == 0) {
+    return cmd_diff(argc, argv);
+  }
+
+  if (strcmp(command, "patch") == 0) {
+    return cmd_patch(argc, argv);
+  }
+
+  if (strcmp(command, "serve") == 0) {
+    return cmd_serve(argc, argv);
+  }
+
+  if (strcmp(command, "watch") == 0) {
+    return cmd_watch(argc, argv);
   }
 
   fprintf(stderr, "Error: Unknown command '%s'\n", command);
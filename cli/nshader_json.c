@@ -0,0 +1,492 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "nshader_json.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nesting limit, keeps the recursive parser off the end of the stack
+#define JSON_MAX_DEPTH 64
+
+typedef struct json_parser_t {
+  const char* cursor;
+  const char* begin;
+  char* error;
+  size_t error_size;
+  bool failed;
+} json_parser_t;
+
+static void json_fail(json_parser_t* parser, const char* message) {
+  if (parser->failed) {
+    return;
+  }
+  parser->failed = true;
+  int line = 1;
+  for (const char* c = parser->begin; c < parser->cursor; c++) {
+    if (*c == '\n') {
+      line++;
+    }
+  }
+  if (parser->error && parser->error_size > 0) {
+    snprintf(parser->error, parser->error_size, "line %d: %s", line, message);
+  }
+}
+
+static void json_skip_whitespace(json_parser_t* parser) {
+  while (*parser->cursor == ' ' || *parser->cursor == '\t' || *parser->cursor == '\n' || *parser->cursor == '\r') {
+    parser->cursor++;
+  }
+}
+
+static void json_free_contents(json_value_t* value) {
+  free(value->string);
+  for (size_t i = 0; i < value->count; i++) {
+    json_free_contents(&value->items[i]);
+    if (value->keys) {
+      free(value->keys[i]);
+    }
+  }
+  free(value->items);
+  free(value->keys);
+}
+
+static int json_hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool json_parse_hex4(json_parser_t* parser, unsigned int* out_code) {
+  unsigned int code = 0;
+  for (int i = 0; i < 4; i++) {
+    int digit = json_hex_digit(parser->cursor[i]);
+    if (digit < 0) {
+      json_fail(parser, "invalid \\u escape");
+      return false;
+    }
+    code = (code << 4) | (unsigned int)digit;
+  }
+  parser->cursor += 4;
+  *out_code = code;
+  return true;
+}
+
+// Strings are decoded to UTF-8, the result is never longer than the source
+static char* json_parse_string(json_parser_t* parser) {
+  const char* start = ++parser->cursor;
+  const char* end = start;
+  while (*end && *end != '"') {
+    if (*end == '\\' && end[1]) {
+      end++;
+    }
+    end++;
+  }
+  if (*end != '"') {
+    json_fail(parser, "unterminated string");
+    return NULL;
+  }
+
+  char* string = (char*)malloc((size_t)(end - start) + 1);
+  if (!string) {
+    json_fail(parser, "out of memory");
+    return NULL;
+  }
+  char* out = string;
+  while (parser->cursor < end) {
+    char c = *parser->cursor++;
+    if ((unsigned char)c < 0x20) {
+      json_fail(parser, "control character in string");
+      free(string);
+      return NULL;
+    }
+    if (c != '\\') {
+      *out++ = c;
+      continue;
+    }
+    c = *parser->cursor++;
+    switch (c) {
+      case '"': *out++ = '"'; break;
+      case '\\': *out++ = '\\'; break;
+      case '/': *out++ = '/'; break;
+      case 'b': *out++ = '\b'; break;
+      case 'f': *out++ = '\f'; break;
+      case 'n': *out++ = '\n'; break;
+      case 'r': *out++ = '\r'; break;
+      case 't': *out++ = '\t'; break;
+      case 'u': {
+        unsigned int code;
+        if (!json_parse_hex4(parser, &code)) {
+          free(string);
+          return NULL;
+        }
+        // Surrogate pair, encoded as one 4-byte sequence
+        if (code >= 0xD800 && code <= 0xDBFF && parser->cursor[0] == '\\' && parser->cursor[1] == 'u') {
+          parser->cursor += 2;
+          unsigned int low;
+          if (!json_parse_hex4(parser, &low)) {
+            free(string);
+            return NULL;
+          }
+          if (low < 0xDC00 || low > 0xDFFF) {
+            json_fail(parser, "invalid surrogate pair");
+            free(string);
+            return NULL;
+          }
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (code < 0x80) {
+          *out++ = (char)code;
+        } else if (code < 0x800) {
+          *out++ = (char)(0xC0 | (code >> 6));
+          *out++ = (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+          *out++ = (char)(0xE0 | (code >> 12));
+          *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+          *out++ = (char)(0x80 | (code & 0x3F));
+        } else {
+          *out++ = (char)(0xF0 | (code >> 18));
+          *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+          *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+          *out++ = (char)(0x80 | (code & 0x3F));
+        }
+        break;
+      }
+      default:
+        json_fail(parser, "invalid escape sequence");
+        free(string);
+        return NULL;
+    }
+  }
+  *out = '\0';
+  parser->cursor = end + 1;
+  return string;
+}
+
+static bool json_parse_value(json_parser_t* parser, json_value_t* value, int depth);
+
+// Append an element to an array or object, returns the new slot
+static json_value_t* json_push(json_parser_t* parser, json_value_t* value, size_t* capacity) {
+  if (value->count == *capacity) {
+    size_t new_capacity = *capacity ? *capacity * 2 : 4;
+    json_value_t* items = (json_value_t*)realloc(value->items, new_capacity * sizeof(json_value_t));
+    if (!items) {
+      json_fail(parser, "out of memory");
+      return NULL;
+    }
+    value->items = items;
+    if (value->type == JSON_OBJECT) {
+      char** keys = (char**)realloc(value->keys, new_capacity * sizeof(char*));
+      if (!keys) {
+        json_fail(parser, "out of memory");
+        return NULL;
+      }
+      value->keys = keys;
+    }
+    *capacity = new_capacity;
+  }
+  json_value_t* item = &value->items[value->count];
+  memset(item, 0, sizeof(*item));
+  return item;
+}
+
+static bool json_parse_container(json_parser_t* parser, json_value_t* value, int depth) {
+  bool object = *parser->cursor == '{';
+  char close = object ? '}' : ']';
+  value->type = object ? JSON_OBJECT : JSON_ARRAY;
+  parser->cursor++;
+  size_t capacity = 0;
+
+  json_skip_whitespace(parser);
+  if (*parser->cursor == close) {
+    parser->cursor++;
+    return true;
+  }
+
+  for (;;) {
+    json_value_t* item = json_push(parser, value, &capacity);
+    if (!item) {
+      return false;
+    }
+
+    if (object) {
+      json_skip_whitespace(parser);
+      if (*parser->cursor != '"') {
+        json_fail(parser, "expected member name");
+        return false;
+      }
+      char* key = json_parse_string(parser);
+      if (!key) {
+        return false;
+      }
+      json_skip_whitespace(parser);
+      if (*parser->cursor != ':') {
+        free(key);
+        json_fail(parser, "expected ':'");
+        return false;
+      }
+      parser->cursor++;
+      value->keys[value->count] = key;
+    }
+
+    // Counted before parsing, so a partial item is freed with the container
+    value->count++;
+    if (!json_parse_value(parser, item, depth + 1)) {
+      return false;
+    }
+
+    json_skip_whitespace(parser);
+    if (*parser->cursor == ',') {
+      parser->cursor++;
+    } else if (*parser->cursor == close) {
+      parser->cursor++;
+      return true;
+    } else {
+      json_fail(parser, object ? "expected ',' or '}'" : "expected ',' or ']'");
+      return false;
+    }
+  }
+}
+
+static bool json_parse_literal(json_parser_t* parser, const char* literal) {
+  size_t len = strlen(literal);
+  if (strncmp(parser->cursor, literal, len) != 0) {
+    json_fail(parser, "invalid literal");
+    return false;
+  }
+  parser->cursor += len;
+  return true;
+}
+
+static bool json_parse_value(json_parser_t* parser, json_value_t* value, int depth) {
+  if (depth > JSON_MAX_DEPTH) {
+    json_fail(parser, "nesting too deep");
+    return false;
+  }
+  json_skip_whitespace(parser);
+  char c = *parser->cursor;
+  if (c == '{' || c == '[') {
+    return json_parse_container(parser, value, depth);
+  }
+  if (c == '"') {
+    value->type = JSON_STRING;
+    value->string = json_parse_string(parser);
+    return value->string != NULL;
+  }
+  if (c == 't' || c == 'f') {
+    value->type = JSON_BOOL;
+    value->boolean = c == 't';
+    return json_parse_literal(parser, c == 't' ? "true" : "false");
+  }
+  if (c == 'n') {
+    value->type = JSON_NULL;
+    return json_parse_literal(parser, "null");
+  }
+  if (c == '-' || (c >= '0' && c <= '9')) {
+    char* end = NULL;
+    value->type = JSON_NUMBER;
+    value->number = strtod(parser->cursor, &end);
+    if (end == parser->cursor) {
+      json_fail(parser, "invalid number");
+      return false;
+    }
+    parser->cursor = end;
+    return true;
+  }
+  json_fail(parser, c ? "unexpected character" : "unexpected end of input");
+  return false;
+}
+
+json_value_t* json_parse(const char* text, char* error, size_t error_size) {
+  json_value_t* value = (json_value_t*)calloc(1, sizeof(json_value_t));
+  if (!value) {
+    return NULL;
+  }
+
+  json_parser_t parser = {text, text, error, error_size, false};
+  if (json_parse_value(&parser, value, 0)) {
+    json_skip_whitespace(&parser);
+    if (*parser.cursor) {
+      json_fail(&parser, "unexpected data after the document");
+    }
+  }
+  if (parser.failed) {
+    json_free(value);
+    return NULL;
+  }
+  return value;
+}
+
+void json_free(json_value_t* value) {
+  if (!value) {
+    return;
+  }
+  json_free_contents(value);
+  free(value);
+}
+
+const json_value_t* json_get(const json_value_t* value, const char* key) {
+  if (!value || value->type != JSON_OBJECT) {
+    return NULL;
+  }
+  for (size_t i = 0; i < value->count; i++) {
+    if (strcmp(value->keys[i], key) == 0) {
+      return &value->items[i];
+    }
+  }
+  return NULL;
+}
+
+const char* json_type_to_string(json_type_t type) {
+  switch (type) {
+    case JSON_NULL: return "null";
+    case JSON_BOOL: return "boolean";
+    case JSON_NUMBER: return "number";
+    case JSON_STRING: return "string";
+    case JSON_ARRAY: return "array";
+    case JSON_OBJECT: return "object";
+  }
+  return "unknown";
+}
+
+// #############################################################################
+// Writer
+// #############################################################################
+
+void json_writer_init(json_writer_t* writer, FILE* file) {
+  memset(writer, 0, sizeof(*writer));
+  writer->file = file;
+}
+
+// Write the separator owed before a value at the current level
+static void json_write_separator(json_writer_t* writer) {
+  if (writer->after_key) {
+    writer->after_key = false;
+    return;
+  }
+  if (writer->has_items[writer->depth]) {
+    fputc(',', writer->file);
+  }
+  writer->has_items[writer->depth] = true;
+}
+
+static void json_write_escaped(json_writer_t* writer, const char* str) {
+  FILE* file = writer->file;
+  fputc('"', file);
+  const char* run = str;
+  for (const char* c = str; *c; c++) {
+    unsigned char ch = (unsigned char)*c;
+    if (ch >= 0x20 && ch != '"' && ch != '\\') {
+      continue;
+    }
+
+    // Flush the unescaped run before the character
+    fwrite(run, 1, (size_t)(c - run), file);
+    run = c + 1;
+    switch (ch) {
+      case '"': fputs("\\\"", file); break;
+      case '\\': fputs("\\\\", file); break;
+      case '\n': fputs("\\n", file); break;
+      case '\r': fputs("\\r", file); break;
+      case '\t': fputs("\\t", file); break;
+      default: fprintf(file, "\\u%04x", ch); break;
+    }
+  }
+  fwrite(run, 1, strlen(run), file);
+  fputc('"', file);
+}
+
+static void json_write_begin(json_writer_t* writer, char open) {
+  json_write_separator(writer);
+  if (writer->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+    writer->failed = true;
+    return;
+  }
+  fputc(open, writer->file);
+  writer->depth++;
+  writer->has_items[writer->depth] = false;
+}
+
+static void json_write_end(json_writer_t* writer, char close) {
+  if (writer->depth == 0 || writer->after_key) {
+    writer->failed = true;
+    return;
+  }
+  fputc(close, writer->file);
+  writer->depth--;
+}
+
+void json_write_begin_object(json_writer_t* writer) {
+  json_write_begin(writer, '{');
+}
+
+void json_write_end_object(json_writer_t* writer) {
+  json_write_end(writer, '}');
+}
+
+void json_write_begin_array(json_writer_t* writer) {
+  json_write_begin(writer, '[');
+}
+
+void json_write_end_array(json_writer_t* writer) {
+  json_write_end(writer, ']');
+}
+
+void json_write_key(json_writer_t* writer, const char* key) {
+  json_write_separator(writer);
+  json_write_escaped(writer, key);
+  fputc(':', writer->file);
+  writer->after_key = true;
+}
+
+void json_write_string(json_writer_t* writer, const char* value) {
+  if (!value) {
+    json_write_null(writer);
+    return;
+  }
+  json_write_separator(writer);
+  json_write_escaped(writer, value);
+}
+
+void json_write_uint(json_writer_t* writer, uint64_t value) {
+  json_write_separator(writer);
+  fprintf(writer->file, "%" PRIu64, value);
+}
+
+void json_write_bool(json_writer_t* writer, bool value) {
+  json_write_separator(writer);
+  fputs(value ? "true" : "false", writer->file);
+}
+
+void json_write_null(json_writer_t* writer) {
+  json_write_separator(writer);
+  fputs("null", writer->file);
+}
+
+bool json_writer_finish(const json_writer_t* writer) {
+  return !writer->failed && writer->depth == 0 && !writer->after_key;
+}
@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Minimal JSON reader for CLI input files such as build manifests, and a
+// streaming writer for machine-readable output
+
+typedef enum json_type_t {
+  JSON_NULL,
+  JSON_BOOL,
+  JSON_NUMBER,
+  JSON_STRING,
+  JSON_ARRAY,
+  JSON_OBJECT
+} json_type_t;
+
+typedef struct json_value_t {
+  json_type_t type;
+  bool boolean;
+  double number;
+  char* string;                 // JSON_STRING, null terminated
+  struct json_value_t* items;   // JSON_ARRAY elements or JSON_OBJECT values
+  char** keys;                  // JSON_OBJECT keys, one per item
+  size_t count;
+} json_value_t;
+
+// Parse a null terminated document
+// Returns NULL on failure and writes a message with the line number to error
+json_value_t* json_parse(const char* text, char* error, size_t error_size);
+
+void json_free(json_value_t* value);
+
+// Member of an object, NULL if value is not an object or has no such key
+const json_value_t* json_get(const json_value_t* value, const char* key);
+
+// Name of a type for error messages
+const char* json_type_to_string(json_type_t type);
+
+// Streaming writer, values go straight to the file without allocating.
+// Separators are inserted automatically: call json_write_key() before every
+// object member and the value functions for array items.
+#define JSON_WRITER_MAX_DEPTH 32
+
+typedef struct json_writer_t {
+  FILE* file;
+  int depth;
+  bool has_items[JSON_WRITER_MAX_DEPTH];  // A value was written at this level
+  bool after_key;                         // The next value belongs to a key
+  bool failed;                            // Nesting too deep or unbalanced
+} json_writer_t;
+
+void json_writer_init(json_writer_t* writer, FILE* file);
+
+void json_write_begin_object(json_writer_t* writer);
+void json_write_end_object(json_writer_t* writer);
+void json_write_begin_array(json_writer_t* writer);
+void json_write_end_array(json_writer_t* writer);
+void json_write_key(json_writer_t* writer, const char* key);
+
+// NULL strings are written as null
+void json_write_string(json_writer_t* writer, const char* value);
+void json_write_uint(json_writer_t* writer, uint64_t value);
+void json_write_bool(json_writer_t* writer, bool value);
+void json_write_null(json_writer_t* writer);
+
+// Returns true if every container was closed and nothing failed
+bool json_writer_finish(const json_writer_t* writer);
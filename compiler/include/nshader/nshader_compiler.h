@@ -144,10 +144,16 @@ typedef struct nshader_compiler_config_t {
   bool enable_debug;              // Enable debug info
   const char* debug_name;         // Debug name (can be NULL)
   bool preserve_unused_bindings;  // Don't cull unused resources
+  bool reproducible;              // Ignore enable_debug and debug_name, so the output only depends on the sources
+  bool strip_spirv;               // Strip SPIR-V debug instructions and names before translating it to the other
+                                  // backends and storing it, reflected binding names are kept
 
   // Array of preprocessor defines (applied on all stages)
   const nshader_compiler_define_t* defines;
   size_t num_defines;
+
+  // Allocator owning the returned shader (NULL for nshader_default_allocator())
+  const nshader_allocator_t* allocator;
 } nshader_compiler_config_t;
 
 // #############################################################################
@@ -169,6 +175,92 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
     const nshader_compiler_config_t* config,
     nshader_error_list_t* out_errors);  // Optional
 
+// #############################################################################
+// Compiler lifetime
+// #############################################################################
+
+// Every compile initializes SDL_shadercross and shuts it down again when it
+// is the only one running. Tools compiling many shaders one after another
+// call nshader_compiler_init() once so it stays loaded in between.
+// Reference counted and thread safe, pair every successful call with
+// nshader_compiler_quit().
+NSHADER_API bool nshader_compiler_init(void);
+NSHADER_API void nshader_compiler_quit(void);
+
+// #############################################################################
+// Batch compilation
+// #############################################################################
+
+typedef struct nshader_compiler_result_t {
+  size_t index;                        // Index of the config in the batch
+  nshader_t* shader;                   // Compiled shader, NULL on failure, owned by the callback
+  const nshader_error_list_t* errors;  // Errors of the compile, valid during the callback
+  uint64_t compile_ns;                 // Time spent compiling, in nanoseconds
+} nshader_compiler_result_t;
+
+typedef void (*nshader_compiler_result_fn)(void* user, const nshader_compiler_result_t* result);
+
+// Compile count configs on up to num_threads threads (0 for one per core,
+// at most 8), the calling thread included, with one compiler initialization
+// for the whole batch.
+// The callback runs once per config on the thread that compiled it, so it
+// must be thread safe, and takes ownership of result->shader.
+// Returns the number of successful compiles, after every callback returned.
+NSHADER_API size_t nshader_compiler_compile_batch(
+    const nshader_compiler_config_t* configs,
+    size_t count,
+    uint32_t num_threads,
+    nshader_compiler_result_fn callback,
+    void* user);
+
+// Compile several entry points of the same stage type from one source, e.g.
+// a file defining a family of compute kernels. Every entry point becomes its
+// own single-stage shader, compiled from stage with its entry_point replaced.
+// config supplies the shared options (its stages are ignored); the source and
+// define arrays are shared by all compiles without copies. Entry points are
+// compiled like nshader_compiler_compile_batch(), with result->index the
+// index into entry_points.
+// Returns the number of successful compiles, after every callback returned.
+NSHADER_API size_t nshader_compiler_compile_entry_points(
+    const nshader_compiler_config_t* config,
+    const nshader_compiler_stage_setup_t* stage,
+    const char* const* entry_points,
+    size_t num_entry_points,
+    uint32_t num_threads,
+    nshader_compiler_result_fn callback,
+    void* user);
+
+// #############################################################################
+// Dependencies
+// #############################################################################
+
+// Called once per file a source depends on. Includes that were not found are
+// reported with exists set to false, under the path they are looked up at
+// first, so that creating them can be noticed.
+typedef void (*nshader_compiler_dependency_fn)(void* user, const char* path, bool exists);
+
+// Find the files a source file includes, directly or indirectly, by scanning
+// its #include directives. Quoted names are resolved next to the including
+// file first and then in include_dir (can be NULL), angle-bracket names the
+// other way around. Conditional compilation is not evaluated, so files the
+// compiler skips can be reported too.
+// Returns false if source_path is not a readable file.
+NSHADER_API bool nshader_compiler_scan_dependencies(
+    const char* source_path,
+    const char* include_dir,
+    nshader_compiler_dependency_fn callback,
+    void* user);
+
+// Same for source code in memory, as passed to the compiler. Quoted names
+// are resolved against source_dir instead of a source location, or against
+// the working directory if source_dir is NULL.
+NSHADER_API void nshader_compiler_scan_source_dependencies(
+    const char* source_code,
+    const char* source_dir,
+    const char* include_dir,
+    nshader_compiler_dependency_fn callback,
+    void* user);
+
 // #############################################################################
 NSHADER_HEADER_END;
 // #############################################################################
\ No newline at end of file
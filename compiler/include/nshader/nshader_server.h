@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <nshader/nshader_compiler.h>
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Compile server: a long-running process that keeps the compiler initialized
+// and caches compiled shaders, serving compile requests of other processes
+// over a Unix domain socket. Build steps forward their compiles to it
+// instead of initializing the compiler themselves.
+// Not available on Windows, where create and compile always fail.
+typedef struct nshader_server_t nshader_server_t;
+
+typedef struct nshader_server_config_t {
+  const char* socket_path;  // Path of the socket, a stale socket file is replaced
+  uint32_t num_threads;     // Requests served in parallel, 0 for one per core up to 8
+  size_t cache_size;        // Bytes of compiled shaders kept in memory, 0 for 256 MiB
+} nshader_server_config_t;
+
+typedef struct nshader_server_stats_t {
+  uint64_t requests;     // Compile requests received
+  uint64_t cache_hits;   // Requests answered from the cache
+  uint64_t failures;     // Requests that failed to compile or could not be decoded
+  size_t cache_entries;  // Shaders currently cached
+  size_t cache_bytes;    // Size of the cached shaders
+} nshader_server_stats_t;
+
+// Start serving on config->socket_path, returns once the socket accepts connections.
+// Returns NULL if the socket cannot be created or another server is listening on it.
+NSHADER_API nshader_server_t* nshader_server_create(const nshader_server_config_t* config);
+
+// Stop serving, finish the requests in flight and remove the socket file
+NSHADER_API void nshader_server_destroy(nshader_server_t* server);
+
+NSHADER_API void nshader_server_get_stats(nshader_server_t* server, nshader_server_stats_t* out_stats);
+
+// Compile through the server listening on socket_path, with the same result
+// as nshader_compiler_compile_hlsl(). The server compiles in its own working
+// directory, so config->include_dir is sent as an absolute path and includes
+// should resolve through it. A cached result is reused while the sources,
+// options and every included file are unchanged.
+// Returns NULL on failure, connection errors are added to out_errors.
+NSHADER_API nshader_t* nshader_server_compile(
+    const char* socket_path,
+    const nshader_compiler_config_t* config,
+    nshader_error_list_t* out_errors);  // Optional
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
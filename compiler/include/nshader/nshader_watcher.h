@@ -0,0 +1,112 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <nshader/nshader_compiler.h>
+#include <nshader/nshader_writer.h>
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Hot-reload service: watches a directory of HLSL sources, recompiles the
+// shaders whose sources or includes changed and publishes the new builds.
+//
+// Sources follow the <name>.<stage>.hlsl convention of the samples, with
+// stage one of vert, frag or comp. All files of a name form one shader:
+// Sprite.vert.hlsl and Sprite.frag.hlsl build the graphics shader "Sprite".
+typedef struct nshader_watcher_t nshader_watcher_t;
+
+// Latest build of one shader, owned by the watcher
+typedef struct nshader_watcher_handle_t nshader_watcher_handle_t;
+
+// A reference keeping one build alive while it is in use
+typedef struct nshader_watcher_ref_t {
+  const nshader_t* shader;
+  uint32_t generation;  // Build number of the shader, starting at 1
+  void* version;        // Internal
+} nshader_watcher_ref_t;
+
+// Result of one build, passed to the callback
+typedef struct nshader_watcher_event_t {
+  const char* name;                    // Shader name, e.g. "Sprite"
+  const char* output_path;             // File written, NULL without output_dir or on failure
+  bool success;
+  uint32_t generation;                 // Generation published on success
+  const nshader_error_list_t* errors;  // Compiler errors on failure
+} nshader_watcher_event_t;
+
+typedef void (*nshader_watcher_callback_fn)(void* user, const nshader_watcher_event_t* event);
+
+typedef struct nshader_watcher_config_t {
+  const char* source_dir;   // Directory scanned for <name>.<stage>.hlsl files (not recursive)
+  const char* output_dir;   // Directory receiving <name>.nshader, NULL to only publish in memory
+  const char* include_dir;  // Include directory for the compiler and dependency scanning (can be NULL)
+  const char* entry_point;  // Entry point of every stage, NULL for "main"
+
+  // Options applied to every compile (can be NULL), its stages and
+  // include_dir are replaced. Copied, but the defines and allocator it
+  // points to must outlive the watcher.
+  const nshader_compiler_config_t* compiler;
+
+  // Options used for output files (can be NULL), copied
+  const nshader_write_options_t* write_options;
+
+  uint32_t debounce_ms;     // Quiet time after the last change before rebuilding, 0 for 100
+  uint32_t poll_ms;         // Interval of the modification time scan without inotify, 0 for 250
+  uint32_t num_threads;     // Shaders compiled in parallel, 0 for one per core up to 8
+
+  // Called on the watcher thread after every build, and on the calling
+  // thread for the initial builds (can be NULL)
+  nshader_watcher_callback_fn callback;
+  void* user;
+} nshader_watcher_config_t;
+
+// Build every shader of source_dir once, then start watching it.
+// Builds that fail are reported through the callback and retried on the next change.
+// Returns NULL if the directory cannot be read or the watcher cannot start.
+NSHADER_API nshader_watcher_t* nshader_watcher_create(const nshader_watcher_config_t* config);
+
+// Stop watching and free every build. References must be released first.
+NSHADER_API void nshader_watcher_destroy(nshader_watcher_t* watcher);
+
+// Handle of a shader by name, NULL if no source of that name was found.
+// Handles stay valid until the watcher is destroyed.
+NSHADER_API nshader_watcher_handle_t* nshader_watcher_get_handle(nshader_watcher_t* watcher, const char* name);
+
+// Generation of the latest build, 0 before the first successful one.
+// Lock free, cheap enough to poll every frame.
+NSHADER_API uint32_t nshader_watcher_handle_get_generation(const nshader_watcher_handle_t* handle);
+
+// Reference the latest build. Lock free.
+// Returns false before the first successful build.
+NSHADER_API bool nshader_watcher_handle_acquire(nshader_watcher_handle_t* handle, nshader_watcher_ref_t* out_ref);
+
+// Release a reference, the build is freed once it was replaced and unreferenced
+NSHADER_API void nshader_watcher_ref_release(nshader_watcher_ref_t* ref);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
@@ -23,7 +23,11 @@ SOFTWARE.
 */
 
 #include <nshader/nshader_compiler.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_strip.h>
 #include "nshader_type_internal.h"
+#include "nshader_base_internal.h"
+#include "nshader_shadercross.h"
 #include <SDL3_shadercross/SDL_shadercross.h>
 #include <SDL3/SDL.h>
 #include <string.h>
@@ -38,7 +42,8 @@ NSHADER_API void nshader_error_list_push(nshader_error_list_t* error_list, const
   }
 
   size_t new_count = error_list->num_errors + 1;
-  const char** new_errors = (const char**)nshader_realloc(
+  const char** new_errors = (const char**)nshader_realloc_tagged(
+    NSHADER_ALLOC_TAG_ERROR_LIST,
     (void*)error_list->errors,
     new_count * sizeof(char*)
   );
@@ -49,7 +54,7 @@ NSHADER_API void nshader_error_list_push(nshader_error_list_t* error_list, const
 
   // Duplicate the error message
   size_t len = strlen(msg);
-  char* error_copy = (char*)nshader_malloc(len + 1);
+  char* error_copy = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_ERROR_LIST, len + 1);
   if (!error_copy) {
     return;
   }
@@ -91,35 +96,6 @@ static SDL_ShaderCross_ShaderStage nshader_stage_to_sdl(nshader_stage_type_t sta
   }
 }
 
-static nshader_binding_type_t sdl_iovar_type_to_nshader(SDL_ShaderCross_IOVarType type) {
-  switch (type) {
-    case SDL_SHADERCROSS_IOVAR_TYPE_INT8:
-      return NSHADER_BINDING_TYPE_INT8;
-    case SDL_SHADERCROSS_IOVAR_TYPE_UINT8:
-      return NSHADER_BINDING_TYPE_UINT8;
-    case SDL_SHADERCROSS_IOVAR_TYPE_INT16:
-      return NSHADER_BINDING_TYPE_INT16;
-    case SDL_SHADERCROSS_IOVAR_TYPE_UINT16:
-      return NSHADER_BINDING_TYPE_UINT16;
-    case SDL_SHADERCROSS_IOVAR_TYPE_INT32:
-      return NSHADER_BINDING_TYPE_INT32;
-    case SDL_SHADERCROSS_IOVAR_TYPE_UINT32:
-      return NSHADER_BINDING_TYPE_UINT32;
-    case SDL_SHADERCROSS_IOVAR_TYPE_INT64:
-      return NSHADER_BINDING_TYPE_INT64;
-    case SDL_SHADERCROSS_IOVAR_TYPE_UINT64:
-      return NSHADER_BINDING_TYPE_UINT64;
-    case SDL_SHADERCROSS_IOVAR_TYPE_FLOAT16:
-      return NSHADER_BINDING_TYPE_FLOAT16;
-    case SDL_SHADERCROSS_IOVAR_TYPE_FLOAT32:
-      return NSHADER_BINDING_TYPE_FLOAT32;
-    case SDL_SHADERCROSS_IOVAR_TYPE_FLOAT64:
-      return NSHADER_BINDING_TYPE_FLOAT64;
-    default:
-      return NSHADER_BINDING_TYPE_FLOAT32;
-  }
-}
-
 // #############################################################################
 // Stage Compilation
 // #############################################################################
@@ -178,7 +154,7 @@ static void free_compiled_stage(compiled_stage_t* stage) {
   }
 
   if (stage->spv_data) {
-    SDL_free(stage->spv_data);
+    nshader_free(stage->spv_data);
   }
 
   if (stage->graphics_metadata) {
@@ -199,7 +175,8 @@ static bool compile_stage_to_spirv(
   // Create properties for compilation
   SDL_PropertiesID props = SDL_CreateProperties();
 
-  if (config->enable_debug) {
+  // Debug info embeds names and paths that differ between hosts
+  if (config->enable_debug && !config->reproducible) {
     SDL_SetBooleanProperty(props, SDL_SHADERCROSS_PROP_SHADER_DEBUG_ENABLE_BOOLEAN, true);
 
     if (config->debug_name) {
@@ -216,7 +193,8 @@ static bool compile_stage_to_spirv(
   size_t total_defines = config->num_defines + stage_setup->num_defines;
 
   if (total_defines > 0) {
-    sdl_defines = (SDL_ShaderCross_HLSL_Define*)nshader_calloc(
+    sdl_defines = (SDL_ShaderCross_HLSL_Define*)nshader_calloc_tagged(
+      NSHADER_ALLOC_TAG_COMPILER_DEFINES,
       total_defines + 1,
       sizeof(SDL_ShaderCross_HLSL_Define)
     );
@@ -277,7 +255,7 @@ static bool compile_stage_to_spirv(
 
   // Duplicate entry point
   size_t entry_len = strlen(stage_setup->entry_point);
-  out_stage->entry_point = (char*)nshader_malloc(entry_len + 1);
+  out_stage->entry_point = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_COMPILER_STAGING, entry_len + 1);
   if (out_stage->entry_point) {
     memcpy(out_stage->entry_point, stage_setup->entry_point, entry_len + 1);
   }
@@ -285,6 +263,22 @@ static bool compile_stage_to_spirv(
   return true;
 }
 
+// Remove debug instructions from the SPIR-V in place, so the backends
+// translate and the SPV blob stores the smaller module
+static bool strip_spirv(
+    compiled_stage_t* stage,
+    nshader_error_list_t* out_errors) {
+
+  size_t size = nshader_spirv_strip_debug_info(stage->spirv_data, stage->spirv_size, stage->spirv_data, stage->spirv_size);
+  if (size == 0) {
+    nshader_error_list_push(out_errors, "Failed to strip SPIRV: malformed module");
+    return false;
+  }
+
+  stage->spirv_size = size;
+  return true;
+}
+
 static bool compile_backends(
     const nshader_compiler_config_t* config,
     compiled_stage_t* stage,
@@ -348,7 +342,7 @@ static bool compile_backends(
 
   // Keep SPIRV
   if (!config->disable_spv) {
-    stage->spv_data = (uint8_t*)nshader_malloc(stage->spirv_size);
+    stage->spv_data = (uint8_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_COMPILER_STAGING, stage->spirv_size);
     if (stage->spv_data) {
       memcpy(stage->spv_data, stage->spirv_data, stage->spirv_size);
       stage->spv_size = stage->spirv_size;
@@ -407,7 +401,7 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
   }
 
   // Initialize SDL_shadercross
-  if (!SDL_ShaderCross_Init()) {
+  if (!nshader_shadercross_init()) {
     if (out_errors) {
       nshader_error_list_push(out_errors, "Failed to initialize SDL_shadercross");
     }
@@ -415,7 +409,8 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
   }
 
   // Allocate compiled stages
-  compiled_stage_t* stages = (compiled_stage_t*)nshader_calloc(
+  compiled_stage_t* stages = (compiled_stage_t*)nshader_calloc_tagged(
+    NSHADER_ALLOC_TAG_COMPILER_STAGING,
     config->num_stages,
     sizeof(compiled_stage_t)
   );
@@ -424,7 +419,7 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
     if (out_errors) {
       nshader_error_list_push(out_errors, "Failed to allocate memory for compiled stages");
     }
-    SDL_ShaderCross_Quit();
+    nshader_shadercross_quit();
     return NULL;
   }
 
@@ -436,12 +431,18 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
       break;
     }
 
-    if (!compile_backends(config, &stages[i], out_errors)) {
+    // Reflect before stripping, binding names come from the debug instructions
+    if (!reflect_stage_metadata(&stages[i], out_errors)) {
       compilation_failed = true;
       break;
     }
 
-    if (!reflect_stage_metadata(&stages[i], out_errors)) {
+    if (config->strip_spirv && !strip_spirv(&stages[i], out_errors)) {
+      compilation_failed = true;
+      break;
+    }
+
+    if (!compile_backends(config, &stages[i], out_errors)) {
       compilation_failed = true;
       break;
     }
@@ -453,46 +454,43 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
       free_compiled_stage(&stages[i]);
     }
     nshader_free(stages);
-    SDL_ShaderCross_Quit();
+    nshader_shadercross_quit();
     return NULL;
   }
 
   // Create nshader_t object
-  nshader_t* shader = (nshader_t*)nshader_calloc(1, sizeof(nshader_t));
+  const nshader_allocator_t* allocator = config->allocator ? config->allocator : nshader_default_allocator();
+  nshader_t* shader = (nshader_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_SHADER, 1, sizeof(nshader_t), _Alignof(nshader_t));
   if (!shader) {
     if (out_errors) {
       nshader_error_list_push(out_errors, "Failed to allocate nshader_t object");
     }
-    for (size_t i = 0; i < config->num_stages; ++i) {
-      free_compiled_stage(&stages[i]);
-    }
-    nshader_free(stages);
-    SDL_ShaderCross_Quit();
-    return NULL;
+    goto error;
   }
+  shader->allocator = *allocator;
+  shader->metadata_tag = NSHADER_ALLOC_TAG_COMPILER_OUTPUT;
+  shader->blob_tag = NSHADER_ALLOC_TAG_COMPILER_OUTPUT;
+  allocator = &shader->allocator;
 
   // Determine shader type from first stage
   shader->info.type = nshader_stage_type_to_shader_type(stages[0].stage_type);
 
   // Allocate stage info
-  shader->info.num_stages = config->num_stages;
-  shader->info.stages = (nshader_stage_t*)nshader_calloc(
+  shader->info.stages = (nshader_stage_t*)nshader_allocator_calloc(
+    allocator,
+    NSHADER_ALLOC_TAG_SHADER,
     config->num_stages,
-    sizeof(nshader_stage_t)
+    sizeof(nshader_stage_t),
+    _Alignof(nshader_stage_t)
   );
 
   if (!shader->info.stages) {
     if (out_errors) {
       nshader_error_list_push(out_errors, "Failed to allocate stage info");
     }
-    nshader_free(shader);
-    for (size_t i = 0; i < config->num_stages; ++i) {
-      free_compiled_stage(&stages[i]);
-    }
-    nshader_free(stages);
-    SDL_ShaderCross_Quit();
-    return NULL;
+    goto error;
   }
+  shader->info.num_stages = config->num_stages;
 
   // Determine available backends
   nshader_backend_t available_backends[NSHADER_BACKEND_COUNT];
@@ -511,25 +509,21 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
     available_backends[num_backends++] = NSHADER_BACKEND_SPV;
   }
 
-  shader->info.num_backends = num_backends;
-  shader->info.backends = (nshader_backend_t*)nshader_malloc(
-    num_backends * sizeof(nshader_backend_t)
+  shader->info.backends = (nshader_backend_t*)nshader_allocator_alloc(
+    allocator,
+    NSHADER_ALLOC_TAG_SHADER,
+    num_backends * sizeof(nshader_backend_t),
+    _Alignof(nshader_backend_t)
   );
 
   if (!shader->info.backends) {
     if (out_errors) {
       nshader_error_list_push(out_errors, "Failed to allocate backend info");
     }
-    nshader_free(shader->info.stages);
-    nshader_free(shader);
-    for (size_t i = 0; i < config->num_stages; ++i) {
-      free_compiled_stage(&stages[i]);
-    }
-    nshader_free(stages);
-    SDL_ShaderCross_Quit();
-    return NULL;
+    goto error;
   }
 
+  shader->info.num_backends = num_backends;
   memcpy(shader->info.backends, available_backends, num_backends * sizeof(nshader_backend_t));
 
   // Fill in stage metadata and blobs
@@ -538,131 +532,32 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
     nshader_stage_t* stage_info = &shader->info.stages[stage_idx];
 
     stage_info->type = compiled->stage_type;
-    stage_info->entry_point = compiled->entry_point;
-    compiled->entry_point = NULL; // Transfer ownership
+    stage_info->entry_point = nshader_allocator_strdup(allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, compiled->entry_point);
+    if (!stage_info->entry_point) {
+      if (out_errors) {
+        nshader_error_list_push(out_errors, "Failed to allocate entry point");
+      }
+      goto error;
+    }
 
     // Fill metadata based on stage type
+    bool metadata_ok;
     if (compiled->stage_type == NSHADER_STAGE_TYPE_COMPUTE) {
-      SDL_ShaderCross_ComputePipelineMetadata* sdl_meta = compiled->compute_metadata;
-      stage_info->metadata.compute.num_samplers = sdl_meta->num_samplers;
-      stage_info->metadata.compute.num_readonly_storage_textures = sdl_meta->num_readonly_storage_textures;
-      stage_info->metadata.compute.num_readonly_storage_buffers = sdl_meta->num_readonly_storage_buffers;
-      stage_info->metadata.compute.num_readwrite_storage_textures = sdl_meta->num_readwrite_storage_textures;
-      stage_info->metadata.compute.num_readwrite_storage_buffers = sdl_meta->num_readwrite_storage_buffers;
-      stage_info->metadata.compute.num_uniform_buffers = sdl_meta->num_uniform_buffers;
-      stage_info->metadata.compute.threadcount_x = sdl_meta->threadcount_x;
-      stage_info->metadata.compute.threadcount_y = sdl_meta->threadcount_y;
-      stage_info->metadata.compute.threadcount_z = sdl_meta->threadcount_z;
+      metadata_ok = nshader_from_sdl_compute_metadata(compiled->compute_metadata, &stage_info->metadata);
     } else {
-      SDL_ShaderCross_GraphicsShaderMetadata* sdl_meta = compiled->graphics_metadata;
-
-      // Common metadata for vertex and fragment
-      if (compiled->stage_type == NSHADER_STAGE_TYPE_VERTEX) {
-        stage_info->metadata.vertex.num_samplers = sdl_meta->resource_info.num_samplers;
-        stage_info->metadata.vertex.num_storage_textures = sdl_meta->resource_info.num_storage_textures;
-        stage_info->metadata.vertex.num_storage_buffers = sdl_meta->resource_info.num_storage_buffers;
-        stage_info->metadata.vertex.num_uniform_buffers = sdl_meta->resource_info.num_uniform_buffers;
-
-        // Copy inputs
-        stage_info->metadata.vertex.input_count = sdl_meta->num_inputs;
-        if (sdl_meta->num_inputs > 0) {
-          stage_info->metadata.vertex.inputs = (nshader_stage_binding_t*)nshader_calloc(
-            sdl_meta->num_inputs,
-            sizeof(nshader_stage_binding_t)
-          );
-
-          for (uint32_t i = 0; i < sdl_meta->num_inputs; ++i) {
-            SDL_ShaderCross_IOVarMetadata* sdl_var = &sdl_meta->inputs[i];
-            nshader_stage_binding_t* binding = &stage_info->metadata.vertex.inputs[i];
-
-            size_t name_len = strlen(sdl_var->name);
-            binding->name = (char*)nshader_malloc(name_len + 1);
-            memcpy(binding->name, sdl_var->name, name_len + 1);
-            binding->location = sdl_var->location;
-            binding->vector_size = sdl_var->vector_size;
-            binding->type = sdl_iovar_type_to_nshader(sdl_var->vector_type);
-          }
-        }
-
-        // Copy outputs
-        stage_info->metadata.vertex.output_count = sdl_meta->num_outputs;
-        if (sdl_meta->num_outputs > 0) {
-          stage_info->metadata.vertex.outputs = (nshader_stage_binding_t*)nshader_calloc(
-            sdl_meta->num_outputs,
-            sizeof(nshader_stage_binding_t)
-          );
-
-          for (uint32_t i = 0; i < sdl_meta->num_outputs; ++i) {
-            SDL_ShaderCross_IOVarMetadata* sdl_var = &sdl_meta->outputs[i];
-            nshader_stage_binding_t* binding = &stage_info->metadata.vertex.outputs[i];
-
-            size_t name_len = strlen(sdl_var->name);
-            binding->name = (char*)nshader_malloc(name_len + 1);
-            memcpy(binding->name, sdl_var->name, name_len + 1);
-            binding->location = sdl_var->location;
-            binding->vector_size = sdl_var->vector_size;
-            binding->type = sdl_iovar_type_to_nshader(sdl_var->vector_type);
-          }
-        }
-      } else if (compiled->stage_type == NSHADER_STAGE_TYPE_FRAGMENT) {
-        stage_info->metadata.fragment.num_samplers = sdl_meta->resource_info.num_samplers;
-        stage_info->metadata.fragment.num_storage_textures = sdl_meta->resource_info.num_storage_textures;
-        stage_info->metadata.fragment.num_storage_buffers = sdl_meta->resource_info.num_storage_buffers;
-        stage_info->metadata.fragment.num_uniform_buffers = sdl_meta->resource_info.num_uniform_buffers;
-
-        // Copy inputs
-        stage_info->metadata.fragment.input_count = sdl_meta->num_inputs;
-        if (sdl_meta->num_inputs > 0) {
-          stage_info->metadata.fragment.inputs = (nshader_stage_binding_t*)nshader_calloc(
-            sdl_meta->num_inputs,
-            sizeof(nshader_stage_binding_t)
-          );
-
-          for (uint32_t i = 0; i < sdl_meta->num_inputs; ++i) {
-            SDL_ShaderCross_IOVarMetadata* sdl_var = &sdl_meta->inputs[i];
-            nshader_stage_binding_t* binding = &stage_info->metadata.fragment.inputs[i];
-
-            size_t name_len = strlen(sdl_var->name);
-            binding->name = (char*)nshader_malloc(name_len + 1);
-            memcpy(binding->name, sdl_var->name, name_len + 1);
-            binding->location = sdl_var->location;
-            binding->vector_size = sdl_var->vector_size;
-            binding->type = sdl_iovar_type_to_nshader(sdl_var->vector_type);
-          }
-        }
-
-        // Copy outputs
-        stage_info->metadata.fragment.output_count = sdl_meta->num_outputs;
-        if (sdl_meta->num_outputs > 0) {
-          stage_info->metadata.fragment.outputs = (nshader_stage_binding_t*)nshader_calloc(
-            sdl_meta->num_outputs,
-            sizeof(nshader_stage_binding_t)
-          );
-
-          for (uint32_t i = 0; i < sdl_meta->num_outputs; ++i) {
-            SDL_ShaderCross_IOVarMetadata* sdl_var = &sdl_meta->outputs[i];
-            nshader_stage_binding_t* binding = &stage_info->metadata.fragment.outputs[i];
-
-            size_t name_len = strlen(sdl_var->name);
-            binding->name = (char*)nshader_malloc(name_len + 1);
-            memcpy(binding->name, sdl_var->name, name_len + 1);
-            binding->location = sdl_var->location;
-            binding->vector_size = sdl_var->vector_size;
-            binding->type = sdl_iovar_type_to_nshader(sdl_var->vector_type);
-          }
-        }
+      metadata_ok = nshader_from_sdl_graphics_metadata(allocator, compiled->graphics_metadata, compiled->stage_type, &stage_info->metadata);
+    }
+
+    if (!metadata_ok) {
+      if (out_errors) {
+        nshader_error_list_push(out_errors, "Failed to convert stage metadata");
       }
+      goto error;
     }
 
     // Store blobs for each backend
     for (size_t backend_idx = 0; backend_idx < num_backends; ++backend_idx) {
       nshader_backend_t backend = available_backends[backend_idx];
-      nshader_blob_t* blob = (nshader_blob_t*)nshader_malloc(sizeof(nshader_blob_t));
-
-      if (!blob) {
-        continue;
-      }
-
       uint8_t* data_to_copy = NULL;
       size_t size_to_copy = 0;
 
@@ -687,19 +582,27 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
           break;
       }
 
-      if (data_to_copy && size_to_copy > 0) {
-        uint8_t* blob_data = (uint8_t*)nshader_malloc(size_to_copy);
-        if (blob_data) {
-          memcpy(blob_data, data_to_copy, size_to_copy);
-          blob->data = blob_data;
-          blob->size = size_to_copy;
-          shader->blobs[compiled->stage_type][backend] = blob;
-        } else {
-          nshader_free(blob);
-        }
-      } else {
-        nshader_free(blob);
+      if (!data_to_copy || size_to_copy == 0) {
+        continue;
+      }
+
+      nshader_blob_t* blob = (nshader_blob_t*)nshader_allocator_calloc(
+        allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, 1, sizeof(nshader_blob_t), _Alignof(nshader_blob_t));
+      if (!blob) {
+        continue;
+      }
+
+      // Same payload alignment as blobs read from a file
+      uint8_t* blob_data = (uint8_t*)nshader_allocator_alloc(allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, size_to_copy, NSHADER_DEFAULT_BLOB_ALIGNMENT);
+      if (!blob_data) {
+        nshader_allocator_free(allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, blob, sizeof(nshader_blob_t));
+        continue;
       }
+
+      memcpy(blob_data, data_to_copy, size_to_copy);
+      blob->data = blob_data;
+      blob->size = size_to_copy;
+      shader->blobs[compiled->stage_type][backend] = blob;
     }
   }
 
@@ -709,7 +612,19 @@ NSHADER_API nshader_t* nshader_compiler_compile_hlsl(
   }
   nshader_free(stages);
 
-  SDL_ShaderCross_Quit();
+  nshader_shadercross_quit();
+
+  // Cache the content hash so that writing and cache lookups never rehash
+  shader->has_hash = nshader_hash(shader, &shader->hash);
 
   return shader;
+
+error:
+  nshader_destroy(shader);
+  for (size_t i = 0; i < config->num_stages; ++i) {
+    free_compiled_stage(&stages[i]);
+  }
+  nshader_free(stages);
+  nshader_shadercross_quit();
+  return NULL;
 }
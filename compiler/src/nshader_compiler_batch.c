@@ -0,0 +1,189 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_compiler.h>
+#include "nshader_base_internal.h"
+#include "nshader_shadercross.h"
+#include <SDL3/SDL.h>
+#include <limits.h>
+
+#define BATCH_MAX_DEFAULT_THREADS 8
+#define BATCH_MAX_THREADS 64
+
+// #############################################################################
+// Compiler Lifetime
+// #############################################################################
+
+NSHADER_API bool nshader_compiler_init(void) {
+  return nshader_shadercross_init();
+}
+
+NSHADER_API void nshader_compiler_quit(void) {
+  nshader_shadercross_quit();
+}
+
+// #############################################################################
+// Batch Compilation
+// #############################################################################
+
+typedef struct compile_batch_t {
+  const nshader_compiler_config_t* configs;
+  int count;
+  nshader_compiler_result_fn callback;
+  void* user;
+  SDL_AtomicInt next;
+  SDL_AtomicInt compiled;
+} compile_batch_t;
+
+static int compile_batch_worker(void* data) {
+  compile_batch_t* batch = (compile_batch_t*)data;
+  for (;;) {
+    int index = SDL_AddAtomicInt(&batch->next, 1);
+    if (index >= batch->count) {
+      break;
+    }
+
+    nshader_error_list_t errors = {0};
+    Uint64 start = SDL_GetTicksNS();
+    nshader_t* shader = nshader_compiler_compile_hlsl(&batch->configs[index], &errors);
+
+    nshader_compiler_result_t result;
+    result.index = (size_t)index;
+    result.shader = shader;
+    result.errors = &errors;
+    result.compile_ns = SDL_GetTicksNS() - start;
+    if (shader) {
+      SDL_AddAtomicInt(&batch->compiled, 1);
+    }
+    batch->callback(batch->user, &result);
+    nshader_error_list_free(&errors);
+  }
+  return 0;
+}
+
+NSHADER_API size_t nshader_compiler_compile_batch(
+    const nshader_compiler_config_t* configs,
+    size_t count,
+    uint32_t num_threads,
+    nshader_compiler_result_fn callback,
+    void* user) {
+  if (!configs || !callback || count == 0 || count > (size_t)INT_MAX) {
+    return 0;
+  }
+
+  // One initialization for the whole batch instead of one per compile,
+  // a failure shows up as errors of the individual compiles
+  bool initialized = nshader_shadercross_init();
+
+  compile_batch_t batch;
+  batch.configs = configs;
+  batch.count = (int)count;
+  batch.callback = callback;
+  batch.user = user;
+  SDL_SetAtomicInt(&batch.next, 0);
+  SDL_SetAtomicInt(&batch.compiled, 0);
+
+  if (num_threads == 0) {
+    int num_cores = SDL_GetNumLogicalCPUCores();
+    num_threads = num_cores > 0 ? (uint32_t)num_cores : 1;
+    if (num_threads > BATCH_MAX_DEFAULT_THREADS) {
+      num_threads = BATCH_MAX_DEFAULT_THREADS;
+    }
+  }
+  if (num_threads > BATCH_MAX_THREADS) {
+    num_threads = BATCH_MAX_THREADS;
+  }
+  if (num_threads > count) {
+    num_threads = (uint32_t)count;
+  }
+
+  // The calling thread works too, so a thread that fails to start only
+  // costs parallelism
+  SDL_Thread* threads[BATCH_MAX_THREADS];
+  uint32_t num_started = 0;
+  for (uint32_t i = 1; i < num_threads; i++) {
+    SDL_Thread* thread = SDL_CreateThread(compile_batch_worker, "nshader_compile", &batch);
+    if (!thread) {
+      break;
+    }
+    threads[num_started++] = thread;
+  }
+  compile_batch_worker(&batch);
+  for (uint32_t i = 0; i < num_started; i++) {
+    SDL_WaitThread(threads[i], NULL);
+  }
+
+  if (initialized) {
+    nshader_shadercross_quit();
+  }
+  return (size_t)SDL_GetAtomicInt(&batch.compiled);
+}
+
+// #############################################################################
+// Entry Point Libraries
+// #############################################################################
+
+NSHADER_API size_t nshader_compiler_compile_entry_points(
+    const nshader_compiler_config_t* config,
+    const nshader_compiler_stage_setup_t* stage,
+    const char* const* entry_points,
+    size_t num_entry_points,
+    uint32_t num_threads,
+    nshader_compiler_result_fn callback,
+    void* user) {
+  if (!config || !stage || !entry_points || !callback || num_entry_points == 0 || num_entry_points > (size_t)INT_MAX) {
+    return 0;
+  }
+  for (size_t i = 0; i < num_entry_points; i++) {
+    if (!entry_points[i]) {
+      return 0;
+    }
+  }
+
+  nshader_compiler_config_t* configs = (nshader_compiler_config_t*)nshader_calloc_tagged(
+    NSHADER_ALLOC_TAG_COMPILER_STAGING, num_entry_points, sizeof(nshader_compiler_config_t));
+  nshader_compiler_stage_setup_t* stages = (nshader_compiler_stage_setup_t*)nshader_calloc_tagged(
+    NSHADER_ALLOC_TAG_COMPILER_STAGING, num_entry_points, sizeof(nshader_compiler_stage_setup_t));
+  if (!configs || !stages) {
+    nshader_free(configs);
+    nshader_free(stages);
+    return 0;
+  }
+
+  // Each config differs only in the entry point, everything else points at
+  // the caller's source and define arrays
+  for (size_t i = 0; i < num_entry_points; i++) {
+    stages[i] = *stage;
+    stages[i].entry_point = entry_points[i];
+    configs[i] = *config;
+    configs[i].stages = &stages[i];
+    configs[i].num_stages = 1;
+  }
+
+  size_t compiled = nshader_compiler_compile_batch(configs, num_entry_points, num_threads, callback, user);
+
+  nshader_free(stages);
+  nshader_free(configs);
+  return compiled;
+}
@@ -0,0 +1,258 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_compiler.h>
+#include "nshader_base_internal.h"
+#include <SDL3/SDL.h>
+#include <string.h>
+
+// Limits of include scanning, deeper or larger graphs are not followed further
+#define DEPENDENCIES_MAX_DEPTH 32
+#define DEPENDENCIES_MAX_FILES 1024
+
+typedef struct dependency_scan_t {
+  const char* include_dir;
+  nshader_compiler_dependency_fn callback;
+  void* user;
+  char** visited;
+  size_t num_visited;
+} dependency_scan_t;
+
+// #############################################################################
+// Paths
+// #############################################################################
+
+static char* dependency_strndup(const char* str, size_t len) {
+  char* copy = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_COMPILER_STAGING, len + 1);
+  if (copy) {
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+  }
+  return copy;
+}
+
+static bool is_separator(char c) {
+  return c == '/' || c == '\\';
+}
+
+// dir/name, or name alone when dir is empty
+static char* join_path(const char* dir, size_t dir_len, const char* name, size_t name_len) {
+  bool separator = dir_len > 0 && !is_separator(dir[dir_len - 1]);
+  char* path = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_COMPILER_STAGING, dir_len + separator + name_len + 1);
+  if (!path) {
+    return NULL;
+  }
+  memcpy(path, dir, dir_len);
+  if (separator) {
+    path[dir_len] = '/';
+  }
+  memcpy(path + dir_len + separator, name, name_len);
+  path[dir_len + separator + name_len] = '\0';
+  return path;
+}
+
+// Length of the directory part of a path, without the last separator
+static size_t dir_length(const char* path) {
+  size_t len = strlen(path);
+  while (len > 0 && !is_separator(path[len - 1])) {
+    len--;
+  }
+  return len > 1 ? len - 1 : len;  // Keep the separator of a root directory
+}
+
+static bool is_file(const char* path) {
+  SDL_PathInfo info;
+  return SDL_GetPathInfo(path, &info) && info.type == SDL_PATHTYPE_FILE;
+}
+
+// #############################################################################
+// Scanning
+// #############################################################################
+
+static void scan_file(dependency_scan_t* scan, const char* path, int depth);
+
+// Resolve one include like the compiler does: quoted names next to the
+// including file first, then in the include directory
+static void add_include(dependency_scan_t* scan, const char* including, const char* name, size_t name_len, bool quoted, int depth) {
+  char* local = join_path(including, dir_length(including), name, name_len);
+  char* global = scan->include_dir ? join_path(scan->include_dir, strlen(scan->include_dir), name, name_len) : NULL;
+  char* candidates[2];
+  candidates[0] = quoted ? local : global;
+  candidates[1] = quoted ? global : local;
+
+  // A missing include is reported under its first candidate
+  char* chosen = NULL;
+  bool exists = false;
+  for (int i = 0; i < 2 && !chosen; i++) {
+    if (candidates[i] && is_file(candidates[i])) {
+      chosen = candidates[i];
+      exists = true;
+    }
+  }
+  if (!chosen) {
+    chosen = candidates[0] ? candidates[0] : candidates[1];
+  }
+  for (int i = 0; i < 2; i++) {
+    if (candidates[i] != chosen) {
+      nshader_free(candidates[i]);
+    }
+  }
+  if (!chosen) {
+    return;
+  }
+
+  for (size_t i = 0; i < scan->num_visited; i++) {
+    if (strcmp(scan->visited[i], chosen) == 0) {
+      nshader_free(chosen);
+      return;
+    }
+  }
+  if (scan->num_visited >= DEPENDENCIES_MAX_FILES) {
+    nshader_free(chosen);
+    return;
+  }
+  char** visited = (char**)nshader_realloc_tagged(NSHADER_ALLOC_TAG_COMPILER_STAGING, scan->visited, (scan->num_visited + 1) * sizeof(char*));
+  if (!visited) {
+    nshader_free(chosen);
+    return;
+  }
+  scan->visited = visited;
+  scan->visited[scan->num_visited++] = chosen;
+
+  // Report before reading, so a caller recording file state sees a write
+  // racing with the scan on its next check
+  scan->callback(scan->user, chosen, exists);
+  if (exists) {
+    scan_file(scan, chosen, depth + 1);
+  }
+}
+
+// Find the #include directives of the text of a file, path is "" for
+// sources that only exist in memory and have no directory
+static void scan_text(dependency_scan_t* scan, const char* path, const char* text, size_t size, int depth) {
+  const char* cursor = text;
+  const char* end = text + size;
+  while (cursor < end) {
+    const char* line_end = memchr(cursor, '\n', (size_t)(end - cursor));
+    if (!line_end) {
+      line_end = end;
+    }
+
+    const char* c = cursor;
+    while (c < line_end && (*c == ' ' || *c == '\t')) c++;
+    if (c < line_end && *c == '#') {
+      c++;
+      while (c < line_end && (*c == ' ' || *c == '\t')) c++;
+      if ((size_t)(line_end - c) > 7 && strncmp(c, "include", 7) == 0) {
+        c += 7;
+        while (c < line_end && (*c == ' ' || *c == '\t')) c++;
+        if (c < line_end && (*c == '"' || *c == '<')) {
+          char close = *c == '"' ? '"' : '>';
+          const char* name_begin = ++c;
+          while (c < line_end && *c != close) c++;
+          if (c < line_end && c > name_begin) {
+            add_include(scan, path, name_begin, (size_t)(c - name_begin), close == '"', depth);
+          }
+        }
+      }
+    }
+    cursor = line_end + 1;
+  }
+}
+
+static void scan_file(dependency_scan_t* scan, const char* path, int depth) {
+  if (depth >= DEPENDENCIES_MAX_DEPTH) {
+    return;
+  }
+  size_t size = 0;
+  char* text = (char*)SDL_LoadFile(path, &size);
+  if (text) {
+    scan_text(scan, path, text, size, depth);
+    SDL_free(text);
+  }
+}
+
+static void free_visited(dependency_scan_t* scan) {
+  for (size_t i = 0; i < scan->num_visited; i++) {
+    nshader_free(scan->visited[i]);
+  }
+  nshader_free(scan->visited);
+}
+
+// #############################################################################
+// Public API
+// #############################################################################
+
+NSHADER_API bool nshader_compiler_scan_dependencies(
+    const char* source_path,
+    const char* include_dir,
+    nshader_compiler_dependency_fn callback,
+    void* user) {
+  if (!source_path || !callback || !is_file(source_path)) {
+    return false;
+  }
+
+  dependency_scan_t scan = {0};
+  scan.include_dir = include_dir;
+  scan.callback = callback;
+  scan.user = user;
+
+  // The source itself counts as visited, so an include of it is not reported
+  scan.visited = (char**)nshader_malloc_tagged(NSHADER_ALLOC_TAG_COMPILER_STAGING, sizeof(char*));
+  if (!scan.visited) {
+    return false;
+  }
+  scan.visited[0] = dependency_strndup(source_path, strlen(source_path));
+  if (!scan.visited[0]) {
+    nshader_free(scan.visited);
+    return false;
+  }
+  scan.num_visited = 1;
+
+  scan_file(&scan, source_path, 0);
+  free_visited(&scan);
+  return true;
+}
+
+NSHADER_API void nshader_compiler_scan_source_dependencies(
+    const char* source_code,
+    const char* source_dir,
+    const char* include_dir,
+    nshader_compiler_dependency_fn callback,
+    void* user) {
+  if (!source_code || !callback) {
+    return;
+  }
+
+  // Quoted names resolve as for a file in source_dir, the name itself is never used
+  char* path = source_dir ? join_path(source_dir, strlen(source_dir), "-", 1) : NULL;
+
+  dependency_scan_t scan = {0};
+  scan.include_dir = include_dir;
+  scan.callback = callback;
+  scan.user = user;
+  scan_text(&scan, path ? path : "", source_code, strlen(source_code), 0);
+  free_visited(&scan);
+  nshader_free(path);
+}
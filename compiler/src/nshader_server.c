@@ -0,0 +1,969 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include <nshader/nshader_server.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_base_internal.h"
+#include <SDL3/SDL.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#define SERVER_SOCKETS 1
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define SERVER_DEFAULT_CACHE_SIZE ((size_t)256 * 1024 * 1024)
+#define SERVER_MAX_DEFAULT_THREADS 8
+#define SERVER_MAX_THREADS 64
+
+// Interval at which idle threads check for destruction
+#define SERVER_WAKE_MS 100
+
+// Largest message accepted, guards allocations against corrupt sizes
+#define SERVER_MAX_MESSAGE_SIZE ((uint32_t)512 * 1024 * 1024)
+
+// Wire protocol, every integer is a little-endian uint32:
+//   message  = magic, version, size, payload[size]
+//   request  = type, flags, string debug_name, string include_dir,
+//              string source_dir, defines, num_stages, num_stages * stage
+//   stage    = stage_type, string entry_point, string source_code, defines
+//   defines  = count, count * (string name, string value)
+//   string   = length, bytes[length], '\0', or SERVER_NULL_STRING for NULL
+//   response = status, then the nshader file for SERVER_STATUS_OK, or
+//              count, count * string error messages
+#define SERVER_MAGIC 0x5653534E  // "NSSV" in little-endian
+#define SERVER_PROTOCOL_VERSION 3  // 2 adds SERVER_FLAG_STRIP_SPIRV, 3 adds source_dir
+#define SERVER_HEADER_SIZE 12
+#define SERVER_NULL_STRING 0xFFFFFFFFu
+
+#define SERVER_REQUEST_COMPILE 1
+
+#define SERVER_STATUS_OK 0
+#define SERVER_STATUS_FAILED 1       // Compile errors follow
+#define SERVER_STATUS_BAD_REQUEST 2  // The request could not be decoded
+
+// Bits of the request flags, one per boolean compiler option
+#define SERVER_FLAG_DISABLE_DXIL (1u << 0)
+#define SERVER_FLAG_DISABLE_DXBC (1u << 1)
+#define SERVER_FLAG_DISABLE_MSL (1u << 2)
+#define SERVER_FLAG_DISABLE_SPV (1u << 3)
+#define SERVER_FLAG_ENABLE_DEBUG (1u << 4)
+#define SERVER_FLAG_PRESERVE_UNUSED_BINDINGS (1u << 5)
+#define SERVER_FLAG_REPRODUCIBLE (1u << 6)
+#define SERVER_FLAG_STRIP_SPIRV (1u << 7)
+
+// #############################################################################
+// Message encoding
+// #############################################################################
+
+typedef struct wire_writer_t {
+  uint8_t* data;
+  size_t size;
+  size_t capacity;
+  bool failed;
+} wire_writer_t;
+
+typedef struct wire_reader_t {
+  const uint8_t* data;
+  size_t size;
+  size_t offset;
+  bool failed;
+} wire_reader_t;
+
+static uint8_t* wire_reserve(wire_writer_t* writer, size_t size) {
+  if (writer->failed) {
+    return NULL;
+  }
+  if (size > writer->capacity - writer->size) {
+    size_t capacity = writer->capacity ? writer->capacity : 256;
+    while (capacity - writer->size < size) {
+      capacity *= 2;
+    }
+    uint8_t* data = (uint8_t*)nshader_realloc_tagged(NSHADER_ALLOC_TAG_SERVER, writer->data, capacity);
+    if (!data) {
+      writer->failed = true;
+      return NULL;
+    }
+    writer->data = data;
+    writer->capacity = capacity;
+  }
+  uint8_t* out = writer->data + writer->size;
+  writer->size += size;
+  return out;
+}
+
+static void wire_store_u32(uint8_t* out, uint32_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+  out[2] = (uint8_t)(value >> 16);
+  out[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t wire_load_u32(const uint8_t* in) {
+  return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static void wire_put_u32(wire_writer_t* writer, uint32_t value) {
+  uint8_t* out = wire_reserve(writer, 4);
+  if (out) {
+    wire_store_u32(out, value);
+  }
+}
+
+static void wire_put_string(wire_writer_t* writer, const char* string) {
+  if (!string) {
+    wire_put_u32(writer, SERVER_NULL_STRING);
+    return;
+  }
+  size_t len = strlen(string);
+  if (len >= SERVER_NULL_STRING) {
+    writer->failed = true;
+    return;
+  }
+  wire_put_u32(writer, (uint32_t)len);
+  uint8_t* out = wire_reserve(writer, len + 1);
+  if (out) {
+    memcpy(out, string, len + 1);
+  }
+}
+
+static void wire_put_defines(wire_writer_t* writer, const nshader_compiler_define_t* defines, size_t count) {
+  wire_put_u32(writer, (uint32_t)count);
+  for (size_t i = 0; i < count; i++) {
+    wire_put_string(writer, defines[i].name);
+    wire_put_string(writer, defines[i].value);
+  }
+}
+
+// Start a message, the size is filled in by wire_end_message()
+static void wire_begin_message(wire_writer_t* writer) {
+  writer->size = 0;
+  wire_put_u32(writer, SERVER_MAGIC);
+  wire_put_u32(writer, SERVER_PROTOCOL_VERSION);
+  wire_put_u32(writer, 0);
+}
+
+static bool wire_end_message(wire_writer_t* writer) {
+  if (writer->failed || writer->size - SERVER_HEADER_SIZE > SERVER_MAX_MESSAGE_SIZE) {
+    return false;
+  }
+  wire_store_u32(writer->data + 8, (uint32_t)(writer->size - SERVER_HEADER_SIZE));
+  return true;
+}
+
+static uint32_t wire_get_u32(wire_reader_t* reader) {
+  if (reader->failed || reader->size - reader->offset < 4) {
+    reader->failed = true;
+    return 0;
+  }
+  uint32_t value = wire_load_u32(reader->data + reader->offset);
+  reader->offset += 4;
+  return value;
+}
+
+// Strings are used in place, the terminator is part of the message
+static const char* wire_get_string(wire_reader_t* reader) {
+  uint32_t len = wire_get_u32(reader);
+  if (reader->failed || len == SERVER_NULL_STRING) {
+    return NULL;
+  }
+  if (reader->size - reader->offset <= len || reader->data[reader->offset + len] != '\0') {
+    reader->failed = true;
+    return NULL;
+  }
+  const char* string = (const char*)reader->data + reader->offset;
+  reader->offset += (size_t)len + 1;
+  return string;
+}
+
+static nshader_compiler_define_t* wire_get_defines(wire_reader_t* reader, size_t* out_count) {
+  uint32_t count = wire_get_u32(reader);
+  *out_count = 0;
+  // Every define takes at least 8 bytes, larger counts are corrupt
+  if (reader->failed || count == 0 || count > (reader->size - reader->offset) / 8) {
+    reader->failed = reader->failed || count != 0;
+    return NULL;
+  }
+  nshader_compiler_define_t* defines = (nshader_compiler_define_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_SERVER, count, sizeof(nshader_compiler_define_t));
+  if (!defines) {
+    reader->failed = true;
+    return NULL;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    defines[i].name = wire_get_string(reader);
+    defines[i].value = wire_get_string(reader);
+    if (!defines[i].name) {
+      reader->failed = true;
+    }
+  }
+  *out_count = count;
+  return defines;
+}
+
+static void encode_request(wire_writer_t* writer, const nshader_compiler_config_t* config, const char* include_dir, const char* source_dir) {
+  uint32_t flags = 0;
+  flags |= config->disable_dxil ? SERVER_FLAG_DISABLE_DXIL : 0;
+  flags |= config->disable_dxbc ? SERVER_FLAG_DISABLE_DXBC : 0;
+  flags |= config->disable_msl ? SERVER_FLAG_DISABLE_MSL : 0;
+  flags |= config->disable_spv ? SERVER_FLAG_DISABLE_SPV : 0;
+  flags |= config->enable_debug ? SERVER_FLAG_ENABLE_DEBUG : 0;
+  flags |= config->preserve_unused_bindings ? SERVER_FLAG_PRESERVE_UNUSED_BINDINGS : 0;
+  flags |= config->reproducible ? SERVER_FLAG_REPRODUCIBLE : 0;
+  flags |= config->strip_spirv ? SERVER_FLAG_STRIP_SPIRV : 0;
+
+  wire_begin_message(writer);
+  wire_put_u32(writer, SERVER_REQUEST_COMPILE);
+  wire_put_u32(writer, flags);
+  wire_put_string(writer, config->debug_name);
+  wire_put_string(writer, include_dir);
+  wire_put_string(writer, source_dir);
+  wire_put_defines(writer, config->defines, config->num_defines);
+  wire_put_u32(writer, (uint32_t)config->num_stages);
+  for (size_t i = 0; i < config->num_stages; i++) {
+    const nshader_compiler_stage_setup_t* stage = &config->stages[i];
+    wire_put_u32(writer, (uint32_t)stage->stage_type);
+    wire_put_string(writer, stage->entry_point);
+    wire_put_string(writer, stage->source_code);
+    wire_put_defines(writer, stage->defines, stage->num_defines);
+  }
+}
+
+// Decoded compile request, strings point into the message
+typedef struct server_request_t {
+  nshader_compiler_config_t config;
+  const char* source_dir;  // Working directory of the client, quoted includes resolve against it
+  nshader_compiler_stage_setup_t stages[NSHADER_STAGE_TYPE_COUNT];
+} server_request_t;
+
+static void free_request(server_request_t* request) {
+  nshader_free((void*)request->config.defines);
+  for (size_t i = 0; i < NSHADER_STAGE_TYPE_COUNT; i++) {
+    nshader_free((void*)request->stages[i].defines);
+  }
+}
+
+static bool decode_request(const uint8_t* payload, size_t size, server_request_t* out_request) {
+  memset(out_request, 0, sizeof(*out_request));
+  wire_reader_t reader = {payload, size, 0, false};
+  if (wire_get_u32(&reader) != SERVER_REQUEST_COMPILE) {
+    return false;
+  }
+
+  nshader_compiler_config_t* config = &out_request->config;
+  uint32_t flags = wire_get_u32(&reader);
+  config->disable_dxil = (flags & SERVER_FLAG_DISABLE_DXIL) != 0;
+  config->disable_dxbc = (flags & SERVER_FLAG_DISABLE_DXBC) != 0;
+  config->disable_msl = (flags & SERVER_FLAG_DISABLE_MSL) != 0;
+  config->disable_spv = (flags & SERVER_FLAG_DISABLE_SPV) != 0;
+  config->enable_debug = (flags & SERVER_FLAG_ENABLE_DEBUG) != 0;
+  config->preserve_unused_bindings = (flags & SERVER_FLAG_PRESERVE_UNUSED_BINDINGS) != 0;
+  config->reproducible = (flags & SERVER_FLAG_REPRODUCIBLE) != 0;
+  config->strip_spirv = (flags & SERVER_FLAG_STRIP_SPIRV) != 0;
+  config->debug_name = wire_get_string(&reader);
+  config->include_dir = wire_get_string(&reader);
+  out_request->source_dir = wire_get_string(&reader);
+  config->defines = wire_get_defines(&reader, &config->num_defines);
+
+  uint32_t num_stages = wire_get_u32(&reader);
+  if (num_stages > NSHADER_STAGE_TYPE_COUNT) {
+    reader.failed = true;
+  }
+  for (uint32_t i = 0; i < num_stages && !reader.failed; i++) {
+    nshader_compiler_stage_setup_t* stage = &out_request->stages[i];
+    uint32_t stage_type = wire_get_u32(&reader);
+    stage->stage_type = (nshader_stage_type_t)stage_type;
+    stage->entry_point = wire_get_string(&reader);
+    stage->source_code = wire_get_string(&reader);
+    stage->defines = wire_get_defines(&reader, &stage->num_defines);
+    if (stage_type >= NSHADER_STAGE_TYPE_COUNT || !stage->entry_point || !stage->source_code) {
+      reader.failed = true;
+    }
+  }
+  config->stages = out_request->stages;
+  config->num_stages = num_stages;
+
+  if (reader.failed || reader.offset != reader.size) {
+    free_request(out_request);
+    return false;
+  }
+  return true;
+}
+
+// #############################################################################
+// Sockets
+// #############################################################################
+
+#if SERVER_SOCKETS
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+static void set_no_sigpipe(int fd) {
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+  (void)fd;
+#endif
+}
+
+static bool make_address(const char* path, struct sockaddr_un* out_address) {
+  memset(out_address, 0, sizeof(*out_address));
+  out_address->sun_family = AF_UNIX;
+  size_t len = strlen(path);
+  if (len == 0 || len >= sizeof(out_address->sun_path)) {
+    return false;
+  }
+  memcpy(out_address->sun_path, path, len + 1);
+  return true;
+}
+
+// Receive exactly size bytes. With a stop flag, waits in slices so that a
+// server being destroyed does not hang on an idle client.
+static bool recv_all(int fd, void* data, size_t size, SDL_AtomicInt* stop) {
+  uint8_t* out = (uint8_t*)data;
+  while (size > 0) {
+    if (stop) {
+      if (SDL_GetAtomicInt(stop)) {
+        return false;
+      }
+      struct pollfd pfd = {fd, POLLIN, 0};
+      int ready = poll(&pfd, 1, SERVER_WAKE_MS);
+      if (ready == 0 || (ready < 0 && errno == EINTR)) {
+        continue;
+      }
+      if (ready < 0) {
+        return false;
+      }
+    }
+    ssize_t received = recv(fd, out, size, 0);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      return false;
+    }
+    out += received;
+    size -= (size_t)received;
+  }
+  return true;
+}
+
+static bool send_all(int fd, const void* data, size_t size) {
+  const uint8_t* in = (const uint8_t*)data;
+  while (size > 0) {
+    ssize_t sent = send(fd, in, size, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    in += sent;
+    size -= (size_t)sent;
+  }
+  return true;
+}
+
+// Read one message, returns its payload
+static uint8_t* recv_message(int fd, uint32_t* out_size, SDL_AtomicInt* stop) {
+  uint8_t header[SERVER_HEADER_SIZE];
+  if (!recv_all(fd, header, sizeof(header), stop)) {
+    return NULL;
+  }
+  uint32_t size = wire_load_u32(header + 8);
+  if (wire_load_u32(header) != SERVER_MAGIC || wire_load_u32(header + 4) != SERVER_PROTOCOL_VERSION || size > SERVER_MAX_MESSAGE_SIZE) {
+    return NULL;
+  }
+  uint8_t* payload = (uint8_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_SERVER, size ? size : 1);
+  if (!payload) {
+    return NULL;
+  }
+  if (!recv_all(fd, payload, size, stop)) {
+    nshader_free(payload);
+    return NULL;
+  }
+  *out_size = size;
+  return payload;
+}
+
+#endif
+
+// #############################################################################
+// Server
+// #############################################################################
+
+#if SERVER_SOCKETS
+
+// State of a file a cached shader was compiled from
+typedef struct cache_dependency_t {
+  char* path;
+  bool exists;
+  Uint64 size;
+  SDL_Time modify_time;
+} cache_dependency_t;
+
+typedef struct cache_dependency_list_t {
+  cache_dependency_t* items;
+  size_t count;
+} cache_dependency_list_t;
+
+typedef struct cache_entry_t {
+  uint64_t key;                // Hash of the request
+  uint8_t* request;            // Request payload, compared on lookup
+  size_t request_size;
+  uint8_t* shader_data;        // Serialized nshader
+  size_t shader_size;
+  cache_dependency_list_t dependencies;
+  struct cache_entry_t* prev;  // Least recently used order, most recent first
+  struct cache_entry_t* next;
+} cache_entry_t;
+
+struct nshader_server_t {
+  char* socket_path;
+  int listen_fd;
+  size_t cache_capacity;
+  bool compiler_initialized;
+
+  SDL_Mutex* mutex;  // Guards the cache and the stats
+  cache_entry_t* newest;
+  cache_entry_t* oldest;
+  nshader_server_stats_t stats;
+
+  SDL_AtomicInt stop;
+  SDL_Thread* threads[SERVER_MAX_THREADS];
+  uint32_t num_threads;
+};
+
+static uint64_t hash_request(const uint8_t* data, size_t size) {
+  // FNV-1a
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+static void stat_dependency(cache_dependency_t* dependency) {
+  SDL_PathInfo info;
+  dependency->exists = SDL_GetPathInfo(dependency->path, &info) && info.type == SDL_PATHTYPE_FILE;
+  dependency->size = dependency->exists ? info.size : 0;
+  dependency->modify_time = dependency->exists ? info.modify_time : 0;
+}
+
+static void free_dependencies(cache_dependency_list_t* list) {
+  for (size_t i = 0; i < list->count; i++) {
+    nshader_free(list->items[i].path);
+  }
+  nshader_free(list->items);
+  list->items = NULL;
+  list->count = 0;
+}
+
+static void add_dependency(void* user, const char* path, bool exists) {
+  (void)exists;
+  cache_dependency_list_t* list = (cache_dependency_list_t*)user;
+  for (size_t i = 0; i < list->count; i++) {
+    if (strcmp(list->items[i].path, path) == 0) {
+      return;
+    }
+  }
+  size_t len = strlen(path);
+  char* copy = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_SERVER, len + 1);
+  cache_dependency_t* items = (cache_dependency_t*)nshader_realloc_tagged(NSHADER_ALLOC_TAG_SERVER, list->items, (list->count + 1) * sizeof(cache_dependency_t));
+  if (!copy || !items) {
+    nshader_free(copy);
+    if (items) {
+      list->items = items;
+    }
+    return;
+  }
+  memcpy(copy, path, len + 1);
+  list->items = items;
+  list->items[list->count].path = copy;
+  stat_dependency(&list->items[list->count]);
+  list->count++;
+}
+
+static bool dependencies_unchanged(const cache_dependency_list_t* list) {
+  for (size_t i = 0; i < list->count; i++) {
+    cache_dependency_t current = list->items[i];
+    stat_dependency(&current);
+    if (current.exists != list->items[i].exists || current.size != list->items[i].size || current.modify_time != list->items[i].modify_time) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void unlink_entry(nshader_server_t* server, cache_entry_t* entry) {
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    server->newest = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    server->oldest = entry->prev;
+  }
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+static void link_newest(nshader_server_t* server, cache_entry_t* entry) {
+  entry->prev = NULL;
+  entry->next = server->newest;
+  if (server->newest) {
+    server->newest->prev = entry;
+  } else {
+    server->oldest = entry;
+  }
+  server->newest = entry;
+}
+
+static void free_entry(cache_entry_t* entry) {
+  nshader_free(entry->request);
+  nshader_free(entry->shader_data);
+  free_dependencies(&entry->dependencies);
+  nshader_free(entry);
+}
+
+static void remove_entry(nshader_server_t* server, cache_entry_t* entry) {
+  unlink_entry(server, entry);
+  server->stats.cache_entries--;
+  server->stats.cache_bytes -= entry->shader_size;
+  free_entry(entry);
+}
+
+// Copy a cached shader into the response if the request was compiled
+// before and none of its files changed since. Called with the mutex held.
+static bool lookup_cache(nshader_server_t* server, uint64_t key, const uint8_t* request, size_t request_size, wire_writer_t* response) {
+  for (cache_entry_t* entry = server->newest; entry; entry = entry->next) {
+    if (entry->key != key || entry->request_size != request_size || memcmp(entry->request, request, request_size) != 0) {
+      continue;
+    }
+    if (!dependencies_unchanged(&entry->dependencies)) {
+      remove_entry(server, entry);
+      return false;
+    }
+    uint8_t* out = wire_reserve(response, entry->shader_size);
+    if (!out) {
+      return false;
+    }
+    memcpy(out, entry->shader_data, entry->shader_size);
+    unlink_entry(server, entry);
+    link_newest(server, entry);
+    return true;
+  }
+  return false;
+}
+
+// Add a compiled shader, evicting the least recently used ones beyond the
+// capacity. Takes ownership of the dependencies. Called with the mutex held.
+static void insert_cache(nshader_server_t* server, uint64_t key, const uint8_t* request, size_t request_size, const uint8_t* shader_data, size_t shader_size, cache_dependency_list_t* dependencies) {
+  if (shader_size > server->cache_capacity) {
+    free_dependencies(dependencies);
+    return;
+  }
+  cache_entry_t* entry = (cache_entry_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_SERVER, 1, sizeof(cache_entry_t));
+  if (!entry) {
+    free_dependencies(dependencies);
+    return;
+  }
+  entry->request = (uint8_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_SERVER, request_size ? request_size : 1);
+  entry->shader_data = (uint8_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_SERVER, shader_size);
+  entry->dependencies = *dependencies;
+  memset(dependencies, 0, sizeof(*dependencies));
+  if (!entry->request || !entry->shader_data) {
+    free_entry(entry);
+    return;
+  }
+  entry->key = key;
+  memcpy(entry->request, request, request_size);
+  entry->request_size = request_size;
+  memcpy(entry->shader_data, shader_data, shader_size);
+  entry->shader_size = shader_size;
+
+  while (server->oldest && server->stats.cache_bytes + shader_size > server->cache_capacity) {
+    remove_entry(server, server->oldest);
+  }
+  link_newest(server, entry);
+  server->stats.cache_entries++;
+  server->stats.cache_bytes += shader_size;
+}
+
+static void put_errors(wire_writer_t* response, uint32_t status, const nshader_error_list_t* errors) {
+  wire_put_u32(response, status);
+  wire_put_u32(response, (uint32_t)errors->num_errors);
+  for (size_t i = 0; i < errors->num_errors; i++) {
+    wire_put_string(response, errors->errors[i]);
+  }
+}
+
+static void handle_request(nshader_server_t* server, const uint8_t* payload, size_t size, wire_writer_t* response) {
+  wire_begin_message(response);
+
+  server_request_t request;
+  if (!decode_request(payload, size, &request)) {
+    nshader_error_list_t errors = {0};
+    nshader_error_list_push(&errors, "Malformed compile request");
+    put_errors(response, SERVER_STATUS_BAD_REQUEST, &errors);
+    nshader_error_list_free(&errors);
+    SDL_LockMutex(server->mutex);
+    server->stats.requests++;
+    server->stats.failures++;
+    SDL_UnlockMutex(server->mutex);
+    return;
+  }
+
+  uint64_t key = hash_request(payload, size);
+  wire_put_u32(response, SERVER_STATUS_OK);
+  size_t shader_offset = response->size;
+
+  SDL_LockMutex(server->mutex);
+  server->stats.requests++;
+  bool hit = lookup_cache(server, key, payload, size, response);
+  if (hit) {
+    server->stats.cache_hits++;
+  }
+  SDL_UnlockMutex(server->mutex);
+  if (hit) {
+    free_request(&request);
+    return;
+  }
+
+  // Record the included files before compiling, so that an edit racing
+  // with the compile invalidates the entry
+  cache_dependency_list_t dependencies = {0};
+  for (size_t i = 0; i < request.config.num_stages; i++) {
+    nshader_compiler_scan_source_dependencies(request.stages[i].source_code, request.source_dir, request.config.include_dir, add_dependency, &dependencies);
+  }
+
+  nshader_error_list_t errors = {0};
+  nshader_t* shader = nshader_compiler_compile_hlsl(&request.config, &errors);
+  free_request(&request);
+
+  size_t shader_size = shader ? nshader_write_to_memory(shader, NULL, 0) : 0;
+  uint8_t* out = shader_size ? wire_reserve(response, shader_size) : NULL;
+  if (!out || nshader_write_to_memory(shader, out, shader_size) != shader_size) {
+    if (shader && errors.num_errors == 0) {
+      nshader_error_list_push(&errors, "Failed to serialize the compiled shader");
+    }
+    response->failed = false;
+    wire_begin_message(response);
+    put_errors(response, SERVER_STATUS_FAILED, &errors);
+    nshader_destroy(shader);
+    nshader_error_list_free(&errors);
+    free_dependencies(&dependencies);
+    SDL_LockMutex(server->mutex);
+    server->stats.failures++;
+    SDL_UnlockMutex(server->mutex);
+    return;
+  }
+  nshader_destroy(shader);
+  nshader_error_list_free(&errors);
+
+  SDL_LockMutex(server->mutex);
+  insert_cache(server, key, payload, size, response->data + shader_offset, shader_size, &dependencies);
+  SDL_UnlockMutex(server->mutex);
+}
+
+// Answer requests until the client disconnects
+static void serve_connection(nshader_server_t* server, int fd) {
+  wire_writer_t response = {0};
+  for (;;) {
+    uint32_t size = 0;
+    uint8_t* payload = recv_message(fd, &size, &server->stop);
+    if (!payload) {
+      break;
+    }
+    handle_request(server, payload, size, &response);
+    nshader_free(payload);
+    if (!wire_end_message(&response) || !send_all(fd, response.data, response.size)) {
+      break;
+    }
+  }
+  nshader_free(response.data);
+}
+
+static int server_worker(void* data) {
+  nshader_server_t* server = (nshader_server_t*)data;
+  while (!SDL_GetAtomicInt(&server->stop)) {
+    struct pollfd pfd = {server->listen_fd, POLLIN, 0};
+    if (poll(&pfd, 1, SERVER_WAKE_MS) <= 0) {
+      continue;
+    }
+    // The listening socket is non-blocking, another thread may have taken
+    // the connection
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0) {
+      continue;
+    }
+    int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0) {
+      fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+    }
+    set_no_sigpipe(fd);
+    serve_connection(server, fd);
+    close(fd);
+  }
+  return 0;
+}
+
+// A socket file nobody accepts connections on is left over from a server
+// that did not shut down cleanly
+static bool is_server_listening(const struct sockaddr_un* address) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return false;
+  }
+  bool listening = connect(fd, (const struct sockaddr*)address, sizeof(*address)) == 0;
+  close(fd);
+  return listening;
+}
+
+#endif
+
+NSHADER_API nshader_server_t* nshader_server_create(const nshader_server_config_t* config) {
+#if SERVER_SOCKETS
+  struct sockaddr_un address;
+  if (!config || !config->socket_path || !make_address(config->socket_path, &address)) {
+    return NULL;
+  }
+
+  struct stat info;
+  if (stat(config->socket_path, &info) == 0) {
+    if (!S_ISSOCK(info.st_mode) || is_server_listening(&address)) {
+      return NULL;
+    }
+    unlink(config->socket_path);
+  }
+
+  nshader_server_t* server = (nshader_server_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_SERVER, 1, sizeof(nshader_server_t));
+  if (!server) {
+    return NULL;
+  }
+  server->listen_fd = -1;
+  server->cache_capacity = config->cache_size ? config->cache_size : SERVER_DEFAULT_CACHE_SIZE;
+  SDL_SetAtomicInt(&server->stop, 0);
+
+  size_t path_len = strlen(config->socket_path);
+  server->socket_path = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_SERVER, path_len + 1);
+  server->mutex = SDL_CreateMutex();
+  if (!server->socket_path || !server->mutex) {
+    goto error;
+  }
+  memcpy(server->socket_path, config->socket_path, path_len + 1);
+
+  // Kept initialized for the lifetime of the server, so compiles never pay for it
+  server->compiler_initialized = nshader_compiler_init();
+
+  server->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server->listen_fd < 0) {
+    goto error;
+  }
+  if (bind(server->listen_fd, (const struct sockaddr*)&address, sizeof(address)) != 0) {
+    close(server->listen_fd);
+    server->listen_fd = -1;
+    goto error;
+  }
+  int flags = fcntl(server->listen_fd, F_GETFL);
+  if (flags < 0 || fcntl(server->listen_fd, F_SETFL, flags | O_NONBLOCK) != 0 || listen(server->listen_fd, SOMAXCONN) != 0) {
+    goto error;
+  }
+
+  uint32_t num_threads = config->num_threads;
+  if (num_threads == 0) {
+    int num_cores = SDL_GetNumLogicalCPUCores();
+    num_threads = num_cores > 0 ? (uint32_t)num_cores : 1;
+    if (num_threads > SERVER_MAX_DEFAULT_THREADS) {
+      num_threads = SERVER_MAX_DEFAULT_THREADS;
+    }
+  }
+  if (num_threads > SERVER_MAX_THREADS) {
+    num_threads = SERVER_MAX_THREADS;
+  }
+  for (uint32_t i = 0; i < num_threads; i++) {
+    SDL_Thread* thread = SDL_CreateThread(server_worker, "nshader_server", server);
+    if (!thread) {
+      break;
+    }
+    server->threads[server->num_threads++] = thread;
+  }
+  if (server->num_threads == 0) {
+    goto error;
+  }
+  return server;
+
+error:
+  nshader_server_destroy(server);
+  return NULL;
+#else
+  (void)config;
+  return NULL;
+#endif
+}
+
+NSHADER_API void nshader_server_destroy(nshader_server_t* server) {
+#if SERVER_SOCKETS
+  if (!server) {
+    return;
+  }
+  SDL_SetAtomicInt(&server->stop, 1);
+  for (uint32_t i = 0; i < server->num_threads; i++) {
+    SDL_WaitThread(server->threads[i], NULL);
+  }
+  if (server->listen_fd >= 0) {
+    close(server->listen_fd);
+    unlink(server->socket_path);
+  }
+  while (server->newest) {
+    remove_entry(server, server->newest);
+  }
+  if (server->compiler_initialized) {
+    nshader_compiler_quit();
+  }
+  SDL_DestroyMutex(server->mutex);
+  nshader_free(server->socket_path);
+  nshader_free(server);
+#else
+  (void)server;
+#endif
+}
+
+NSHADER_API void nshader_server_get_stats(nshader_server_t* server, nshader_server_stats_t* out_stats) {
+  if (!out_stats) {
+    return;
+  }
+  memset(out_stats, 0, sizeof(*out_stats));
+#if SERVER_SOCKETS
+  if (server) {
+    SDL_LockMutex(server->mutex);
+    *out_stats = server->stats;
+    SDL_UnlockMutex(server->mutex);
+  }
+#else
+  (void)server;
+#endif
+}
+
+// #############################################################################
+// Client
+// #############################################################################
+
+NSHADER_API nshader_t* nshader_server_compile(
+    const char* socket_path,
+    const nshader_compiler_config_t* config,
+    nshader_error_list_t* out_errors) {
+#if SERVER_SOCKETS
+  struct sockaddr_un address;
+  if (!socket_path || !config || !make_address(socket_path, &address)) {
+    nshader_error_list_push(out_errors, "Invalid compile server socket path");
+    return NULL;
+  }
+
+  // The server runs in its own working directory, send paths it can resolve
+  char* include_dir = config->include_dir ? realpath(config->include_dir, NULL) : NULL;
+  char* source_dir = realpath(".", NULL);
+  wire_writer_t message = {0};
+  encode_request(&message, config, include_dir ? include_dir : config->include_dir, source_dir);
+  free(include_dir);
+  free(source_dir);
+  if (!wire_end_message(&message)) {
+    nshader_free(message.data);
+    nshader_error_list_push(out_errors, "Failed to encode the compile request");
+    return NULL;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (const struct sockaddr*)&address, sizeof(address)) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    nshader_free(message.data);
+    nshader_error_list_push(out_errors, "Could not connect to the compile server");
+    return NULL;
+  }
+  set_no_sigpipe(fd);
+
+  uint32_t size = 0;
+  uint8_t* payload = NULL;
+  if (send_all(fd, message.data, message.size)) {
+    payload = recv_message(fd, &size, NULL);
+  }
+  close(fd);
+  nshader_free(message.data);
+  if (!payload) {
+    nshader_error_list_push(out_errors, "Compile server closed the connection");
+    return NULL;
+  }
+
+  nshader_t* shader = NULL;
+  wire_reader_t reader = {payload, size, 0, false};
+  uint32_t status = wire_get_u32(&reader);
+  if (!reader.failed && status == SERVER_STATUS_OK) {
+    nshader_read_options_t options = {0};
+    options.allocator = config->allocator;
+    shader = nshader_read_from_memory_ex(payload + reader.offset, size - reader.offset, &options);
+    if (!shader) {
+      nshader_error_list_push(out_errors, "Compile server returned an invalid shader");
+    }
+  } else if (!reader.failed) {
+    uint32_t count = wire_get_u32(&reader);
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+      const char* error = wire_get_string(&reader);
+      if (error) {
+        nshader_error_list_push(out_errors, error);
+      }
+    }
+  }
+  if (reader.failed) {
+    nshader_error_list_push(out_errors, "Malformed compile server response");
+  }
+  nshader_free(payload);
+  return shader;
+#else
+  (void)socket_path;
+  (void)config;
+  nshader_error_list_push(out_errors, "The compile server is not supported on this platform");
+  return NULL;
+#endif
+}
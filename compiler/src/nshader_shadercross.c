@@ -23,9 +23,55 @@ SOFTWARE.
 */
 
 #include "nshader_shadercross.h"
+#include "nshader_base_internal.h"
 #include <nshader/nshader_base.h>
+#include <SDL3/SDL_mutex.h>
 #include <string.h>
 
+// Initialization count, guarded by g_init_mutex. SDL_ShaderCross_Init() loads
+// shader compiler libraries, so waiting threads sleep instead of spinning.
+// The mutex is created on first use and lives until the process exits.
+static SDL_InitState g_init_mutex_state;
+static SDL_Mutex* g_init_mutex = NULL;
+static int g_init_count = 0;
+
+static bool lock_init_mutex(void) {
+  if (SDL_ShouldInit(&g_init_mutex_state)) {
+    g_init_mutex = SDL_CreateMutex();
+    SDL_SetInitialized(&g_init_mutex_state, g_init_mutex != NULL);
+  }
+  if (!g_init_mutex) {
+    return false;
+  }
+  SDL_LockMutex(g_init_mutex);
+  return true;
+}
+
+NSHADER_API bool nshader_shadercross_init(void) {
+  if (!lock_init_mutex()) {
+    return false;
+  }
+  bool ok = true;
+  if (g_init_count == 0) {
+    ok = SDL_ShaderCross_Init();
+  }
+  if (ok) {
+    g_init_count++;
+  }
+  SDL_UnlockMutex(g_init_mutex);
+  return ok;
+}
+
+NSHADER_API void nshader_shadercross_quit(void) {
+  if (!lock_init_mutex()) {
+    return;
+  }
+  if (g_init_count > 0 && --g_init_count == 0) {
+    SDL_ShaderCross_Quit();
+  }
+  SDL_UnlockMutex(g_init_mutex);
+}
+
 // Type mapping: SDL_shadercross -> nshader
 NSHADER_API nshader_binding_type_t nshader_from_sdl_iovar_type(SDL_ShaderCross_IOVarType sdl_type) {
   switch (sdl_type) {
@@ -112,19 +158,18 @@ NSHADER_API SDL_ShaderCross_ShaderStage nshader_to_sdl_shader_stage(nshader_stag
   }
 }
 
-static char* duplicate_string(const char* str) {
-  if (!str) {
-    return NULL;
+static void free_bindings(const nshader_allocator_t* allocator, nshader_stage_binding_t* bindings, size_t count) {
+  if (!bindings) {
+    return;
   }
-  size_t len = strlen(str);
-  char* copy = (char*)nshader_malloc(len + 1);
-  if (copy) {
-    memcpy(copy, str, len + 1);
+  for (size_t i = 0; i < count; i++) {
+    nshader_allocator_free_string(allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, bindings[i].name);
   }
-  return copy;
+  nshader_allocator_free(allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, bindings, count * sizeof(nshader_stage_binding_t));
 }
 
 static bool convert_bindings(
+  const nshader_allocator_t* allocator,
   const SDL_ShaderCross_IOVarMetadata* sdl_bindings,
   uint32_t count,
   nshader_stage_binding_t** out_bindings,
@@ -136,19 +181,18 @@ static bool convert_bindings(
     return true;
   }
 
-  nshader_stage_binding_t* bindings = (nshader_stage_binding_t*)nshader_calloc(count, sizeof(nshader_stage_binding_t));
+  nshader_stage_binding_t* bindings = (nshader_stage_binding_t*)nshader_allocator_calloc(
+    allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, count, sizeof(nshader_stage_binding_t), _Alignof(nshader_stage_binding_t));
   if (!bindings) {
     return false;
   }
 
   for (uint32_t i = 0; i < count; i++) {
-    bindings[i].name = duplicate_string(sdl_bindings[i].name);
-    if (!bindings[i].name && sdl_bindings[i].name) {
-      // Cleanup on error
-      for (uint32_t j = 0; j < i; j++) {
-        nshader_free(bindings[j].name);
-      }
-      nshader_free(bindings);
+    // Names are always allocated so they can be freed with their length
+    const char* name = sdl_bindings[i].name ? sdl_bindings[i].name : "";
+    bindings[i].name = nshader_allocator_strdup(allocator, NSHADER_ALLOC_TAG_COMPILER_OUTPUT, name);
+    if (!bindings[i].name) {
+      free_bindings(allocator, bindings, count);
       return false;
     }
     bindings[i].location = sdl_bindings[i].location;
@@ -163,6 +207,7 @@ static bool convert_bindings(
 
 // Convert SDL_shadercross graphics shader metadata to nshader stage metadata
 NSHADER_API bool nshader_from_sdl_graphics_metadata(
+  const nshader_allocator_t* allocator,
   const SDL_ShaderCross_GraphicsShaderMetadata* sdl_metadata,
   nshader_stage_type_t stage_type,
   nshader_stage_metadata_t* nshader_metadata) {
@@ -181,18 +226,17 @@ NSHADER_API bool nshader_from_sdl_graphics_metadata(
       vert->num_storage_buffers = sdl_metadata->resource_info.num_storage_buffers;
       vert->num_uniform_buffers = sdl_metadata->resource_info.num_uniform_buffers;
 
-      if (!convert_bindings(sdl_metadata->inputs, sdl_metadata->num_inputs,
+      if (!convert_bindings(allocator, sdl_metadata->inputs, sdl_metadata->num_inputs,
                            &vert->inputs, &vert->input_count)) {
         return false;
       }
 
-      if (!convert_bindings(sdl_metadata->outputs, sdl_metadata->num_outputs,
+      if (!convert_bindings(allocator, sdl_metadata->outputs, sdl_metadata->num_outputs,
                            &vert->outputs, &vert->output_count)) {
         // Cleanup inputs on error
-        for (size_t i = 0; i < vert->input_count; i++) {
-          nshader_free(vert->inputs[i].name);
-        }
-        nshader_free(vert->inputs);
+        free_bindings(allocator, vert->inputs, vert->input_count);
+        vert->inputs = NULL;
+        vert->input_count = 0;
         return false;
       }
       break;
@@ -204,18 +248,17 @@ NSHADER_API bool nshader_from_sdl_graphics_metadata(
       frag->num_storage_buffers = sdl_metadata->resource_info.num_storage_buffers;
       frag->num_uniform_buffers = sdl_metadata->resource_info.num_uniform_buffers;
 
-      if (!convert_bindings(sdl_metadata->inputs, sdl_metadata->num_inputs,
+      if (!convert_bindings(allocator, sdl_metadata->inputs, sdl_metadata->num_inputs,
                            &frag->inputs, &frag->input_count)) {
         return false;
       }
 
-      if (!convert_bindings(sdl_metadata->outputs, sdl_metadata->num_outputs,
+      if (!convert_bindings(allocator, sdl_metadata->outputs, sdl_metadata->num_outputs,
                            &frag->outputs, &frag->output_count)) {
         // Cleanup inputs on error
-        for (size_t i = 0; i < frag->input_count; i++) {
-          nshader_free(frag->inputs[i].name);
-        }
-        nshader_free(frag->inputs);
+        free_bindings(allocator, frag->inputs, frag->input_count);
+        frag->inputs = NULL;
+        frag->input_count = 0;
         return false;
       }
       break;
@@ -31,6 +31,11 @@ SOFTWARE.
 NSHADER_HEADER_BEGIN;
 // #############################################################################
 
+// Reference counted SDL_ShaderCross_Init() and SDL_ShaderCross_Quit(), so
+// that compiles running on several threads share one initialization
+NSHADER_API bool nshader_shadercross_init(void);
+NSHADER_API void nshader_shadercross_quit(void);
+
 // Type mapping: SDL_shadercross -> nshader
 NSHADER_API nshader_binding_type_t nshader_from_sdl_iovar_type(SDL_ShaderCross_IOVarType sdl_type);
 NSHADER_API nshader_stage_type_t nshader_from_sdl_shader_stage(SDL_ShaderCross_ShaderStage sdl_stage);
@@ -40,7 +45,9 @@ NSHADER_API SDL_ShaderCross_IOVarType nshader_to_sdl_iovar_type(nshader_binding_
 NSHADER_API SDL_ShaderCross_ShaderStage nshader_to_sdl_shader_stage(nshader_stage_type_t nshader_stage);
 
 // Convert SDL_shadercross graphics shader metadata to nshader stage metadata
+// Binding arrays and names are allocated with allocator (NULL for the default)
 NSHADER_API bool nshader_from_sdl_graphics_metadata(
+  const nshader_allocator_t* allocator,
   const SDL_ShaderCross_GraphicsShaderMetadata* sdl_metadata,
   nshader_stage_type_t stage_type,
   nshader_stage_metadata_t* nshader_metadata);
@@ -0,0 +1,856 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_watcher.h>
+#include <nshader/nshader_reader.h>
+#include "nshader_base_internal.h"
+#include "nshader_shadercross.h"
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+#define WATCHER_INOTIFY 1
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#define WATCHER_DEFAULT_DEBOUNCE_MS 100
+#define WATCHER_DEFAULT_POLL_MS 250
+#define WATCHER_MAX_DEFAULT_THREADS 8
+#define WATCHER_MAX_THREADS 64
+
+// Interval at which the thread checks for destruction while waiting on inotify
+#define WATCHER_WAKE_MS 100
+
+// #############################################################################
+// Internal types
+// #############################################################################
+
+// One published build. A reader racing with a publish may still touch the
+// reference count of a replaced version, so versions are only freed by the
+// next publish while no reader is between loading current and its reference.
+typedef struct watch_version_t {
+  nshader_t* shader;            // Freed when refs drops to zero
+  uint32_t generation;
+  SDL_AtomicInt refs;           // One held by the handle while current, one per reference
+  struct watch_version_t* older;
+} watch_version_t;
+
+struct nshader_watcher_handle_t {
+  void* current;                // watch_version_t*, accessed atomically, NULL before the first build
+  watch_version_t* versions;    // Versions not freed yet, newest first
+  SDL_AtomicInt readers;        // Acquires that may hold a version pointer without a reference
+  SDL_AtomicInt generation;     // Generation of current, 0 before the first build
+};
+
+// A file a shader depends on and the state it was last seen in
+typedef struct watch_file_t {
+  char* path;
+  bool exists;
+  Uint64 size;
+  SDL_Time modify_time;
+} watch_file_t;
+
+typedef struct watch_file_list_t {
+  watch_file_t* files;
+  size_t count;
+  size_t capacity;
+} watch_file_list_t;
+
+typedef struct watch_unit_t {
+  char* name;
+  char* stage_paths[NSHADER_STAGE_TYPE_COUNT];  // Source of each stage, NULL if absent
+  watch_file_list_t files;                      // Stage sources and their includes
+  bool dirty;
+  nshader_watcher_handle_t handle;
+
+  // Result of the last build, reported by the watcher thread
+  bool success;
+  uint32_t generation;
+  char* output_path;
+  nshader_error_list_t errors;
+} watch_unit_t;
+
+struct nshader_watcher_t {
+  char* source_dir;
+  char* output_dir;
+  char* include_dir;
+  char* entry_point;
+  nshader_compiler_config_t compiler;
+  bool has_write_options;
+  nshader_write_options_t write_options;
+  uint32_t debounce_ms;
+  uint32_t poll_ms;
+  uint32_t num_threads;
+  nshader_watcher_callback_fn callback;
+  void* user;
+
+  // Units are only added by the thread running scans, the mutex guards the
+  // array against nshader_watcher_get_handle()
+  SDL_Mutex* mutex;
+  watch_unit_t** units;
+  size_t num_units;
+  size_t capacity;
+
+  SDL_Thread* thread;
+  SDL_AtomicInt stop;
+
+#if WATCHER_INOTIFY
+  int inotify_fd;
+  char** watched_dirs;
+  size_t num_watched_dirs;
+#endif
+};
+
+// #############################################################################
+// Strings and paths
+// #############################################################################
+
+static char* watcher_strndup(const char* str, size_t len) {
+  char* copy = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_WATCHER, len + 1);
+  if (copy) {
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+  }
+  return copy;
+}
+
+static char* watcher_strdup(const char* str) {
+  return str ? watcher_strndup(str, strlen(str)) : NULL;
+}
+
+static bool is_separator(char c) {
+  return c == '/' || c == '\\';
+}
+
+// dir/name, or name alone when dir is empty
+static char* join_path(const char* dir, size_t dir_len, const char* name) {
+  size_t name_len = strlen(name);
+  bool separator = dir_len > 0 && !is_separator(dir[dir_len - 1]);
+  char* path = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_WATCHER, dir_len + separator + name_len + 1);
+  if (!path) {
+    return NULL;
+  }
+  memcpy(path, dir, dir_len);
+  if (separator) {
+    path[dir_len] = '/';
+  }
+  memcpy(path + dir_len + separator, name, name_len + 1);
+  return path;
+}
+
+// Length of the directory part of a path, without the last separator
+static size_t dir_length(const char* path) {
+  size_t len = strlen(path);
+  while (len > 0 && !is_separator(path[len - 1])) {
+    len--;
+  }
+  return len > 1 ? len - 1 : len;  // Keep the separator of a root directory
+}
+
+// #############################################################################
+// Versions and handles
+// #############################################################################
+
+// The version itself is left to free_replaced_versions(), which may free it
+// as soon as refs is zero
+static void release_version(watch_version_t* version) {
+  nshader_t* shader = version->shader;
+  if (SDL_AddAtomicInt(&version->refs, -1) == 1) {
+    nshader_destroy(shader);
+  }
+}
+
+// Free replaced versions whose last reference is gone. Readers that started
+// after current was replaced never see them, so waiting for no reader to be
+// in flight is enough. Versions skipped here are freed by a later publish.
+static void free_replaced_versions(nshader_watcher_handle_t* handle) {
+  if (SDL_GetAtomicInt(&handle->readers) != 0) {
+    return;
+  }
+  watch_version_t** link = &handle->versions->older;
+  while (*link) {
+    watch_version_t* version = *link;
+    if (SDL_GetAtomicInt(&version->refs) == 0) {
+      *link = version->older;
+      nshader_free(version);
+    } else {
+      link = &version->older;
+    }
+  }
+}
+
+static bool publish(nshader_watcher_handle_t* handle, nshader_t* shader, uint32_t* out_generation) {
+  watch_version_t* version = (watch_version_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_WATCHER, 1, sizeof(watch_version_t));
+  if (!version) {
+    return false;
+  }
+  version->shader = shader;
+  version->generation = handle->versions ? handle->versions->generation + 1 : 1;
+  SDL_SetAtomicInt(&version->refs, 1);
+  version->older = handle->versions;
+  handle->versions = version;
+
+  watch_version_t* previous = (watch_version_t*)SDL_SetAtomicPointer(&handle->current, version);
+  SDL_SetAtomicInt(&handle->generation, (int)version->generation);
+  if (previous) {
+    release_version(previous);
+  }
+  free_replaced_versions(handle);
+  *out_generation = version->generation;
+  return true;
+}
+
+static void free_versions(nshader_watcher_handle_t* handle) {
+  watch_version_t* version = handle->versions;
+  while (version) {
+    watch_version_t* older = version->older;
+    if (SDL_GetAtomicInt(&version->refs) > 0) {
+      nshader_destroy(version->shader);
+    }
+    nshader_free(version);
+    version = older;
+  }
+  handle->versions = NULL;
+  SDL_SetAtomicPointer(&handle->current, NULL);
+  SDL_SetAtomicInt(&handle->generation, 0);
+}
+
+// #############################################################################
+// Dependency tracking
+// #############################################################################
+
+static void stat_file(watch_file_t* file) {
+  SDL_PathInfo info;
+  file->exists = SDL_GetPathInfo(file->path, &info) && info.type == SDL_PATHTYPE_FILE;
+  file->size = file->exists ? info.size : 0;
+  file->modify_time = file->exists ? info.modify_time : 0;
+}
+
+static void free_file_list(watch_file_list_t* list) {
+  for (size_t i = 0; i < list->count; i++) {
+    nshader_free(list->files[i].path);
+  }
+  nshader_free(list->files);
+  list->files = NULL;
+  list->count = 0;
+  list->capacity = 0;
+}
+
+static bool has_file(const watch_file_list_t* list, const char* path) {
+  for (size_t i = 0; i < list->count; i++) {
+    if (strcmp(list->files[i].path, path) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Add a file and record its current state, takes ownership of path
+static watch_file_t* add_file(watch_file_list_t* list, char* path) {
+  if (list->count == list->capacity) {
+    size_t capacity = list->capacity ? list->capacity * 2 : 8;
+    watch_file_t* files = (watch_file_t*)nshader_realloc_tagged(NSHADER_ALLOC_TAG_WATCHER, list->files, capacity * sizeof(watch_file_t));
+    if (!files) {
+      nshader_free(path);
+      return NULL;
+    }
+    list->files = files;
+    list->capacity = capacity;
+  }
+  watch_file_t* file = &list->files[list->count++];
+  file->path = path;
+  stat_file(file);
+  return file;
+}
+
+// Track a dependency found by the scan, if no other stage tracks it yet
+static void add_dependency(void* user, const char* path, bool exists) {
+  (void)exists;
+  watch_file_list_t* list = (watch_file_list_t*)user;
+  if (!has_file(list, path)) {
+    add_file(list, watcher_strdup(path));
+  }
+}
+
+// #############################################################################
+// Units
+// #############################################################################
+
+static const char* const g_stage_suffixes[NSHADER_STAGE_TYPE_COUNT] = {
+  ".vert.hlsl",  // NSHADER_STAGE_TYPE_VERTEX
+  ".frag.hlsl",  // NSHADER_STAGE_TYPE_FRAGMENT
+  ".comp.hlsl",  // NSHADER_STAGE_TYPE_COMPUTE
+};
+
+static watch_unit_t* find_unit(const nshader_watcher_t* watcher, const char* name, size_t name_len) {
+  for (size_t i = 0; i < watcher->num_units; i++) {
+    watch_unit_t* unit = watcher->units[i];
+    if (strlen(unit->name) == name_len && strncmp(unit->name, name, name_len) == 0) {
+      return unit;
+    }
+  }
+  return NULL;
+}
+
+static watch_unit_t* add_unit(nshader_watcher_t* watcher, const char* name, size_t name_len) {
+  watch_unit_t* unit = (watch_unit_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_WATCHER, 1, sizeof(watch_unit_t));
+  if (!unit) {
+    return NULL;
+  }
+  unit->name = watcher_strndup(name, name_len);
+  if (!unit->name) {
+    nshader_free(unit);
+    return NULL;
+  }
+
+  SDL_LockMutex(watcher->mutex);
+  if (watcher->num_units == watcher->capacity) {
+    size_t capacity = watcher->capacity ? watcher->capacity * 2 : 16;
+    watch_unit_t** units = (watch_unit_t**)nshader_realloc_tagged(NSHADER_ALLOC_TAG_WATCHER, watcher->units, capacity * sizeof(watch_unit_t*));
+    if (!units) {
+      SDL_UnlockMutex(watcher->mutex);
+      nshader_free(unit->name);
+      nshader_free(unit);
+      return NULL;
+    }
+    watcher->units = units;
+    watcher->capacity = capacity;
+  }
+  watcher->units[watcher->num_units++] = unit;
+  SDL_UnlockMutex(watcher->mutex);
+  return unit;
+}
+
+static void free_unit(watch_unit_t* unit) {
+  free_versions(&unit->handle);
+  free_file_list(&unit->files);
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    nshader_free(unit->stage_paths[stage]);
+  }
+  nshader_free(unit->output_path);
+  nshader_error_list_free(&unit->errors);
+  nshader_free(unit->name);
+  nshader_free(unit);
+}
+
+typedef struct dir_scan_t {
+  nshader_watcher_t* watcher;
+  bool changed;
+} dir_scan_t;
+
+// Pick up <name>.<stage>.hlsl files that are not part of a unit yet
+static SDL_EnumerationResult SDLCALL scan_dir_entry(void* userdata, const char* dirname, const char* fname) {
+  dir_scan_t* scan = (dir_scan_t*)userdata;
+  nshader_watcher_t* watcher = scan->watcher;
+  size_t len = strlen(fname);
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    size_t suffix_len = strlen(g_stage_suffixes[stage]);
+    if (len <= suffix_len || strcmp(fname + len - suffix_len, g_stage_suffixes[stage]) != 0) {
+      continue;
+    }
+
+    size_t name_len = len - suffix_len;
+    watch_unit_t* unit = find_unit(watcher, fname, name_len);
+    if (!unit) {
+      unit = add_unit(watcher, fname, name_len);
+    }
+    if (unit && !unit->stage_paths[stage]) {
+      unit->stage_paths[stage] = join_path(dirname, strlen(dirname), fname);
+      unit->dirty = true;
+      scan->changed = true;
+    }
+    break;
+  }
+  return SDL_ENUM_CONTINUE;
+}
+
+// Find new sources and compare every tracked file with its last state,
+// marks the units that need a rebuild. Returns true if anything changed.
+static bool scan_changes(nshader_watcher_t* watcher) {
+  dir_scan_t scan = {watcher, false};
+  SDL_EnumerateDirectory(watcher->source_dir, scan_dir_entry, &scan);
+
+  for (size_t i = 0; i < watcher->num_units; i++) {
+    watch_unit_t* unit = watcher->units[i];
+    for (size_t f = 0; f < unit->files.count; f++) {
+      watch_file_t* file = &unit->files.files[f];
+      watch_file_t current = *file;
+      stat_file(&current);
+      if (current.exists != file->exists || current.size != file->size || current.modify_time != file->modify_time) {
+        *file = current;
+        unit->dirty = true;
+        scan.changed = true;
+      }
+    }
+  }
+  return scan.changed;
+}
+
+#if WATCHER_INOTIFY
+static void watch_dir(nshader_watcher_t* watcher, const char* dir, size_t len) {
+  if (watcher->inotify_fd < 0) {
+    return;
+  }
+  char* path = len > 0 ? watcher_strndup(dir, len) : watcher_strdup(".");
+  if (!path) {
+    return;
+  }
+  for (size_t i = 0; i < watcher->num_watched_dirs; i++) {
+    if (strcmp(watcher->watched_dirs[i], path) == 0) {
+      nshader_free(path);
+      return;
+    }
+  }
+  char** dirs = (char**)nshader_realloc_tagged(NSHADER_ALLOC_TAG_WATCHER, watcher->watched_dirs, (watcher->num_watched_dirs + 1) * sizeof(char*));
+  if (!dirs) {
+    nshader_free(path);
+    return;
+  }
+  watcher->watched_dirs = dirs;
+  watcher->watched_dirs[watcher->num_watched_dirs++] = path;
+
+  // Editors often save by renaming a new file over the old one
+  uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM;
+  inotify_add_watch(watcher->inotify_fd, path, mask);
+}
+#endif
+
+// #############################################################################
+// Building
+// #############################################################################
+
+static void build_unit(nshader_watcher_t* watcher, watch_unit_t* unit) {
+  nshader_error_list_free(&unit->errors);
+  nshader_free(unit->output_path);
+  unit->output_path = NULL;
+  unit->success = false;
+
+  // Track the stage sources and everything they include, stat'ed before
+  // the compiler reads them
+  watch_file_list_t files = {0};
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    if (unit->stage_paths[stage]) {
+      watch_file_t* file = add_file(&files, watcher_strdup(unit->stage_paths[stage]));
+      if (file && file->exists) {
+        nshader_compiler_scan_dependencies(file->path, watcher->include_dir, add_dependency, &files);
+      }
+    }
+  }
+  free_file_list(&unit->files);
+  unit->files = files;
+
+  nshader_compiler_stage_setup_t stages[NSHADER_STAGE_TYPE_COUNT];
+  char* sources[NSHADER_STAGE_TYPE_COUNT] = {NULL, NULL, NULL};
+  size_t num_stages = 0;
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    if (!unit->stage_paths[stage]) continue;
+    sources[stage] = (char*)SDL_LoadFile(unit->stage_paths[stage], NULL);
+    if (!sources[stage]) continue;  // Deleted since the scan
+
+    stages[num_stages].stage_type = (nshader_stage_type_t)stage;
+    stages[num_stages].entry_point = watcher->entry_point;
+    stages[num_stages].source_code = sources[stage];
+    stages[num_stages].defines = NULL;
+    stages[num_stages].num_defines = 0;
+    num_stages++;
+  }
+
+  nshader_t* shader = NULL;
+  if (num_stages == 0) {
+    nshader_error_list_push(&unit->errors, "No readable source file");
+  } else {
+    nshader_compiler_config_t config = watcher->compiler;
+    config.stages = stages;
+    config.num_stages = num_stages;
+    config.include_dir = watcher->include_dir;
+    shader = nshader_compiler_compile_hlsl(&config, &unit->errors);
+  }
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; stage++) {
+    SDL_free(sources[stage]);
+  }
+  if (!shader) {
+    return;
+  }
+
+  if (watcher->output_dir) {
+    size_t name_len = strlen(unit->name);
+    char* file_name = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_WATCHER, name_len + sizeof(".nshader"));
+    if (file_name) {
+      memcpy(file_name, unit->name, name_len);
+      memcpy(file_name + name_len, ".nshader", sizeof(".nshader"));
+      unit->output_path = join_path(watcher->output_dir, strlen(watcher->output_dir), file_name);
+      nshader_free(file_name);
+    }
+    const nshader_write_options_t* options = watcher->has_write_options ? &watcher->write_options : NULL;
+    if (!unit->output_path || !nshader_write_to_path_ex(shader, unit->output_path, options)) {
+      char message[512];
+      snprintf(message, sizeof(message), "Could not write '%s'", unit->output_path ? unit->output_path : unit->name);
+      nshader_error_list_push(&unit->errors, message);
+      nshader_free(unit->output_path);
+      unit->output_path = NULL;
+      nshader_destroy(shader);
+      return;
+    }
+  }
+
+  if (!publish(&unit->handle, shader, &unit->generation)) {
+    nshader_error_list_push(&unit->errors, "Out of memory");
+    nshader_destroy(shader);
+    return;
+  }
+  unit->success = true;
+}
+
+// Units of one rebuild, claimed in order by the build threads
+typedef struct build_batch_t {
+  nshader_watcher_t* watcher;
+  watch_unit_t** units;
+  int count;
+  SDL_AtomicInt next;
+} build_batch_t;
+
+static int build_worker(void* data) {
+  build_batch_t* batch = (build_batch_t*)data;
+  for (;;) {
+    int index = SDL_AddAtomicInt(&batch->next, 1);
+    if (index >= batch->count) {
+      break;
+    }
+    build_unit(batch->watcher, batch->units[index]);
+  }
+  return 0;
+}
+
+// Rebuild every dirty unit in parallel, then report the results in order
+static void build_dirty(nshader_watcher_t* watcher) {
+  size_t count = 0;
+  for (size_t i = 0; i < watcher->num_units; i++) {
+    if (watcher->units[i]->dirty) count++;
+  }
+  if (count == 0) {
+    return;
+  }
+  watch_unit_t** units = (watch_unit_t**)nshader_malloc_tagged(NSHADER_ALLOC_TAG_WATCHER, count * sizeof(watch_unit_t*));
+  if (!units) {
+    return;  // Retried on the next change
+  }
+  count = 0;
+  for (size_t i = 0; i < watcher->num_units; i++) {
+    if (watcher->units[i]->dirty) {
+      watcher->units[i]->dirty = false;
+      units[count++] = watcher->units[i];
+    }
+  }
+
+  build_batch_t batch;
+  batch.watcher = watcher;
+  batch.units = units;
+  batch.count = (int)count;
+  SDL_SetAtomicInt(&batch.next, 0);
+
+  uint32_t num_threads = watcher->num_threads;
+  if (num_threads > count) {
+    num_threads = (uint32_t)count;
+  }
+  SDL_Thread* threads[WATCHER_MAX_THREADS];
+  uint32_t num_started = 0;
+  for (uint32_t i = 1; i < num_threads; i++) {
+    SDL_Thread* thread = SDL_CreateThread(build_worker, "nshader_watch_build", &batch);
+    if (!thread) {
+      break;
+    }
+    threads[num_started++] = thread;
+  }
+  build_worker(&batch);
+  for (uint32_t i = 0; i < num_started; i++) {
+    SDL_WaitThread(threads[i], NULL);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    watch_unit_t* unit = units[i];
+#if WATCHER_INOTIFY
+    for (size_t f = 0; f < unit->files.count; f++) {
+      watch_dir(watcher, unit->files.files[f].path, dir_length(unit->files.files[f].path));
+    }
+#endif
+    if (watcher->callback) {
+      nshader_watcher_event_t event;
+      event.name = unit->name;
+      event.output_path = unit->output_path;
+      event.success = unit->success;
+      event.generation = unit->success ? unit->generation : 0;
+      event.errors = &unit->errors;
+      watcher->callback(watcher->user, &event);
+    }
+    nshader_error_list_free(&unit->errors);
+  }
+  nshader_free(units);
+}
+
+// #############################################################################
+// Watcher thread
+// #############################################################################
+
+// Sleep until a watched directory changes or timeout_ms passed.
+// Returns true if the files should be scanned.
+static bool wait_for_changes(nshader_watcher_t* watcher, uint32_t timeout_ms) {
+#if WATCHER_INOTIFY
+  if (watcher->inotify_fd >= 0) {
+    struct pollfd fd = {watcher->inotify_fd, POLLIN, 0};
+    if (poll(&fd, 1, (int)timeout_ms) <= 0) {
+      return false;
+    }
+    // The events only wake the thread, the scan finds what changed
+    char events[4096];
+    while (read(watcher->inotify_fd, events, sizeof(events)) > 0) {}
+    return true;
+  }
+#endif
+  // Sleep in slices so that destruction does not wait for a full interval
+  Uint64 start = SDL_GetTicks();
+  while (!SDL_GetAtomicInt(&watcher->stop)) {
+    Uint64 elapsed = SDL_GetTicks() - start;
+    if (elapsed >= timeout_ms) {
+      break;
+    }
+    Uint64 slice = timeout_ms - elapsed;
+    SDL_Delay((Uint32)(slice < WATCHER_WAKE_MS ? slice : WATCHER_WAKE_MS));
+  }
+  return true;
+}
+
+static int watcher_main(void* data) {
+  nshader_watcher_t* watcher = (nshader_watcher_t*)data;
+  bool pending = false;
+  Uint64 last_change = 0;
+  bool polling = true;
+#if WATCHER_INOTIFY
+  polling = watcher->inotify_fd < 0;
+#endif
+
+  while (!SDL_GetAtomicInt(&watcher->stop)) {
+    uint32_t timeout = polling ? watcher->poll_ms : WATCHER_WAKE_MS;
+    if (pending) {
+      Uint64 elapsed = SDL_GetTicks() - last_change;
+      uint32_t remaining = elapsed < watcher->debounce_ms ? (uint32_t)(watcher->debounce_ms - elapsed) : 0;
+      if (remaining < timeout) {
+        timeout = remaining;
+      }
+    }
+
+    bool woke = wait_for_changes(watcher, timeout);
+    if (SDL_GetAtomicInt(&watcher->stop)) {
+      break;
+    }
+    if ((woke || pending) && scan_changes(watcher)) {
+      last_change = SDL_GetTicks();
+      pending = true;
+    }
+    if (pending && SDL_GetTicks() - last_change >= watcher->debounce_ms) {
+      build_dirty(watcher);
+      pending = false;
+    }
+  }
+  return 0;
+}
+
+// #############################################################################
+// Public API
+// #############################################################################
+
+NSHADER_API nshader_watcher_t* nshader_watcher_create(const nshader_watcher_config_t* config) {
+  if (!config || !config->source_dir) {
+    return NULL;
+  }
+  SDL_PathInfo info;
+  if (!SDL_GetPathInfo(config->source_dir, &info) || info.type != SDL_PATHTYPE_DIRECTORY) {
+    return NULL;
+  }
+
+  nshader_watcher_t* watcher = (nshader_watcher_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_WATCHER, 1, sizeof(nshader_watcher_t));
+  if (!watcher) {
+    return NULL;
+  }
+#if WATCHER_INOTIFY
+  watcher->inotify_fd = -1;
+#endif
+
+  // Keep SDL_shadercross initialized between builds
+  if (!nshader_shadercross_init()) {
+    nshader_free(watcher);
+    return NULL;
+  }
+
+  watcher->source_dir = watcher_strdup(config->source_dir);
+  watcher->output_dir = watcher_strdup(config->output_dir);
+  watcher->include_dir = watcher_strdup(config->include_dir);
+  watcher->entry_point = watcher_strdup(config->entry_point ? config->entry_point : "main");
+  if (config->compiler) {
+    watcher->compiler = *config->compiler;
+  }
+  if (config->write_options) {
+    watcher->has_write_options = true;
+    watcher->write_options = *config->write_options;
+  }
+  watcher->debounce_ms = config->debounce_ms ? config->debounce_ms : WATCHER_DEFAULT_DEBOUNCE_MS;
+  watcher->poll_ms = config->poll_ms ? config->poll_ms : WATCHER_DEFAULT_POLL_MS;
+  watcher->num_threads = config->num_threads;
+  if (watcher->num_threads == 0) {
+    int num_cores = SDL_GetNumLogicalCPUCores();
+    watcher->num_threads = num_cores > 0 ? (uint32_t)num_cores : 1;
+    if (watcher->num_threads > WATCHER_MAX_DEFAULT_THREADS) {
+      watcher->num_threads = WATCHER_MAX_DEFAULT_THREADS;
+    }
+  }
+  if (watcher->num_threads > WATCHER_MAX_THREADS) {
+    watcher->num_threads = WATCHER_MAX_THREADS;
+  }
+  watcher->callback = config->callback;
+  watcher->user = config->user;
+  watcher->mutex = SDL_CreateMutex();
+  if (!watcher->source_dir || !watcher->entry_point || !watcher->mutex ||
+      (config->output_dir && !watcher->output_dir) || (config->include_dir && !watcher->include_dir)) {
+    nshader_watcher_destroy(watcher);
+    return NULL;
+  }
+
+#if WATCHER_INOTIFY
+  // Watches exist before the first build, so no change is missed
+  watcher->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  watch_dir(watcher, watcher->source_dir, strlen(watcher->source_dir));
+  if (watcher->include_dir) {
+    watch_dir(watcher, watcher->include_dir, strlen(watcher->include_dir));
+  }
+#endif
+
+  scan_changes(watcher);
+  build_dirty(watcher);
+
+  watcher->thread = SDL_CreateThread(watcher_main, "nshader_watcher", watcher);
+  if (!watcher->thread) {
+    nshader_watcher_destroy(watcher);
+    return NULL;
+  }
+  return watcher;
+}
+
+NSHADER_API void nshader_watcher_destroy(nshader_watcher_t* watcher) {
+  if (!watcher) {
+    return;
+  }
+
+  if (watcher->thread) {
+    SDL_SetAtomicInt(&watcher->stop, 1);
+    SDL_WaitThread(watcher->thread, NULL);
+  }
+
+#if WATCHER_INOTIFY
+  if (watcher->inotify_fd >= 0) {
+    close(watcher->inotify_fd);
+  }
+  for (size_t i = 0; i < watcher->num_watched_dirs; i++) {
+    nshader_free(watcher->watched_dirs[i]);
+  }
+  nshader_free(watcher->watched_dirs);
+#endif
+
+  for (size_t i = 0; i < watcher->num_units; i++) {
+    free_unit(watcher->units[i]);
+  }
+  nshader_free(watcher->units);
+  if (watcher->mutex) {
+    SDL_DestroyMutex(watcher->mutex);
+  }
+  nshader_free(watcher->source_dir);
+  nshader_free(watcher->output_dir);
+  nshader_free(watcher->include_dir);
+  nshader_free(watcher->entry_point);
+  nshader_free(watcher);
+  nshader_shadercross_quit();
+}
+
+NSHADER_API nshader_watcher_handle_t* nshader_watcher_get_handle(nshader_watcher_t* watcher, const char* name) {
+  if (!watcher || !name) {
+    return NULL;
+  }
+  SDL_LockMutex(watcher->mutex);
+  watch_unit_t* unit = find_unit(watcher, name, strlen(name));
+  SDL_UnlockMutex(watcher->mutex);
+  return unit ? &unit->handle : NULL;
+}
+
+NSHADER_API uint32_t nshader_watcher_handle_get_generation(const nshader_watcher_handle_t* handle) {
+  if (!handle) {
+    return 0;
+  }
+  return (uint32_t)SDL_GetAtomicInt((SDL_AtomicInt*)&handle->generation);
+}
+
+NSHADER_API bool nshader_watcher_handle_acquire(nshader_watcher_handle_t* handle, nshader_watcher_ref_t* out_ref) {
+  if (!handle || !out_ref) {
+    return false;
+  }
+
+  // Keeps replaced versions alive until the reference is taken
+  SDL_AddAtomicInt(&handle->readers, 1);
+  watch_version_t* version;
+  for (;;) {
+    version = (watch_version_t*)SDL_GetAtomicPointer(&handle->current);
+    if (!version) {
+      break;
+    }
+
+    // Only add to a count that is not zero: a version that dropped to zero
+    // was replaced and its shader freed
+    int refs = SDL_GetAtomicInt(&version->refs);
+    while (refs > 0 && !SDL_CompareAndSwapAtomicInt(&version->refs, refs, refs + 1)) {
+      refs = SDL_GetAtomicInt(&version->refs);
+    }
+    if (refs > 0) {
+      break;
+    }
+  }
+  SDL_AddAtomicInt(&handle->readers, -1);
+
+  if (!version) {
+    return false;
+  }
+  out_ref->shader = version->shader;
+  out_ref->generation = version->generation;
+  out_ref->version = version;
+  return true;
+}
+
+NSHADER_API void nshader_watcher_ref_release(nshader_watcher_ref_t* ref) {
+  if (!ref || !ref->version) {
+    return;
+  }
+  release_version((watch_version_t*)ref->version);
+  ref->shader = NULL;
+  ref->generation = 0;
+  ref->version = NULL;
+}
@@ -25,9 +25,15 @@ SOFTWARE.
 #pragma once
 #include "nshader/nshader_base.h"
 #include "nshader/nshader_info.h"
+#include "nshader/nshader_io.h"
+#include "nshader/nshader_loader.h"
+#include "nshader/nshader_patch.h"
 #include "nshader/nshader_reader.h"
+#include "nshader/nshader_string_pool.h"
+#include "nshader/nshader_strip.h"
 #include "nshader/nshader_type.h"
 #include "nshader/nshader_writer.h"
+#include "nshader/nshader_validator.h"
 
 #ifdef NSHADER_SDL3_GPU
 #  include "nshader/nshader_sdl3_gpu.h"
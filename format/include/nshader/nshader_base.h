@@ -73,7 +73,14 @@ NSHADER_HEADER_BEGIN;
 #define NSHADER_MAGIC 0x5244534E
 
 // Current version of the nshader binary format
-#define NSHADER_VERSION 1
+// Version 2 adds header flags and aligned blob payloads, version 1 files are still read
+#define NSHADER_VERSION 2
+
+// Default alignment of blob payloads, in files and in memory
+#define NSHADER_DEFAULT_BLOB_ALIGNMENT 16
+
+// Largest supported blob alignment
+#define NSHADER_MAX_BLOB_ALIGNMENT 128
 
 // #############################################################################
 // Memory allocator
@@ -99,6 +106,81 @@ NSHADER_API void nshader_set_memory_fns(
   nshader_calloc_fn calloc_fn,
   nshader_realloc_fn realloc_fn);
 
+// #############################################################################
+// Context-carrying allocator
+// #############################################################################
+
+// Allocate size bytes aligned to align (a power of two, at most 128).
+// Returns NULL on failure.
+typedef void* (*nshader_allocator_alloc_fn)(void* user, size_t size, size_t align);
+
+// Free memory returned by the matching alloc callback.
+// size is the exact size that was passed to alloc.
+typedef void (*nshader_allocator_free_fn)(void* user, void* ptr, size_t size);
+
+// Allocator that can be passed per call to the reader, writer and compiler.
+// Objects created with an allocator remember it and are freed through it,
+// so the allocator (and its user context) must outlive them.
+typedef struct nshader_allocator_t {
+  void* user;                       // Passed back to every callback
+  nshader_allocator_alloc_fn alloc;
+  nshader_allocator_free_fn free;
+} nshader_allocator_t;
+
+// Allocator routing through the functions set with nshader_set_memory_fns().
+// Used wherever an API accepts a NULL allocator.
+NSHADER_API const nshader_allocator_t* nshader_default_allocator(void);
+
+// #############################################################################
+// Allocation tracking
+// #############################################################################
+
+// Call-site tags used to attribute allocations made by the library.
+typedef enum nshader_alloc_tag_t {
+  NSHADER_ALLOC_TAG_GENERAL,           // Untagged allocations (nshader_malloc & co.)
+  NSHADER_ALLOC_TAG_SHADER,            // nshader_t objects, stage and backend arrays
+  NSHADER_ALLOC_TAG_READER_BLOB,       // Blob payloads created by the reader
+  NSHADER_ALLOC_TAG_READER_METADATA,   // Entry points and bindings created by the reader
+  NSHADER_ALLOC_TAG_READER_STAGING,    // Temporary buffers used while reading files
+  NSHADER_ALLOC_TAG_WRITER_STAGING,    // Temporary buffers used while writing files
+  NSHADER_ALLOC_TAG_COMPILER_DEFINES,  // Define arrays handed to SDL_shadercross
+  NSHADER_ALLOC_TAG_COMPILER_STAGING,  // Intermediate per-stage compilation results
+  NSHADER_ALLOC_TAG_COMPILER_OUTPUT,   // Blobs and metadata of compiled shaders
+  NSHADER_ALLOC_TAG_ERROR_LIST,        // Error list arrays and messages
+  NSHADER_ALLOC_TAG_LOADER,            // Asynchronous loader state and requests
+  NSHADER_ALLOC_TAG_STRING_POOL,       // Shared string pools and their strings
+  NSHADER_ALLOC_TAG_WATCHER,           // Hot-reload watcher state and dependency lists
+  NSHADER_ALLOC_TAG_SERVER,            // Compile server messages and cache entries
+  NSHADER_ALLOC_TAG_PATCH,             // Delta buffers and indices of nshader_diff/nshader_patch
+  NSHADER_ALLOC_TAG_COUNT
+} nshader_alloc_tag_t;
+
+typedef struct nshader_alloc_counters_t {
+  uint64_t num_allocs;  // Number of allocations since the last reset
+  uint64_t num_frees;   // Number of frees since the last reset
+  uint64_t live_bytes;  // Bytes currently allocated
+  uint64_t peak_bytes;  // Highest value of live_bytes since the last reset
+} nshader_alloc_counters_t;
+
+typedef struct nshader_alloc_stats_t {
+  nshader_alloc_counters_t total;                          // Sum over all tags
+  nshader_alloc_counters_t tags[NSHADER_ALLOC_TAG_COUNT];  // Per call-site tag
+} nshader_alloc_stats_t;
+
+// Returns true if the library was built with NSHADER_ALLOC_TRACKING.
+// When tracking is disabled, the stats below are always zero.
+NSHADER_API bool nshader_alloc_tracking_enabled(void);
+
+// Copy the current allocation counters into out_stats. Thread safe.
+NSHADER_API void nshader_get_alloc_stats(nshader_alloc_stats_t* out_stats);
+
+// Reset allocation and free counts, and set peak bytes to the current live bytes.
+// Live bytes are kept, since outstanding allocations will still be freed later.
+NSHADER_API void nshader_reset_alloc_stats(void);
+
+// Utility to convert allocation tag enum to string
+NSHADER_API const char* nshader_alloc_tag_to_string(nshader_alloc_tag_t tag);
+
 // #############################################################################
 NSHADER_HEADER_END;
 // #############################################################################
\ No newline at end of file
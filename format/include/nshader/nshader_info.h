@@ -80,7 +80,8 @@ typedef enum nshader_binding_type_t {
   NSHADER_BINDING_TYPE_UINT64,
   NSHADER_BINDING_TYPE_FLOAT16,
   NSHADER_BINDING_TYPE_FLOAT32,
-  NSHADER_BINDING_TYPE_FLOAT64
+  NSHADER_BINDING_TYPE_FLOAT64,
+  NSHADER_BINDING_TYPE_COUNT
 } nshader_binding_type_t;
 
 // Utility to convert binding type enum to string
@@ -89,7 +90,7 @@ NSHADER_API const char* nshader_binding_type_to_string(nshader_binding_type_t bi
 // #############################################################################
 
 typedef struct nshader_stage_binding_t {
-  char* name;                   // The UTF-8 name of the variable.
+  char* name;                   // The UTF-8 name of the variable, NULL after nshader_strip_names() and "" when read back from a stripped file.
   uint32_t location;            // The location of the variable.
   uint32_t vector_size;         // The number of components in the vector type of the variable.
   nshader_binding_type_t type;  // The vector type of the variable.
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "nshader_base.h"
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+typedef enum nshader_io_whence_t {
+  NSHADER_IO_SEEK_SET,  // Offset from the start of the stream
+  NSHADER_IO_SEEK_CUR,  // Offset from the current position
+  NSHADER_IO_SEEK_END   // Offset from the end of the stream
+} nshader_io_whence_t;
+
+// Callback based byte stream, used to read and write shaders from any source.
+// Unused callbacks can be NULL: readers need read, writers need write.
+typedef struct nshader_io_t {
+  void* user;  // Passed back to every callback
+
+  // Read up to size bytes into data, returns the number of bytes read
+  // Returning fewer bytes is allowed, 0 means end of stream or error
+  size_t (*read)(void* user, void* data, size_t size);
+
+  // Write size bytes from data, returns the number of bytes written
+  size_t (*write)(void* user, const void* data, size_t size);
+
+  // Optional: seek and return the new absolute position, or -1 on failure
+  int64_t (*seek)(void* user, int64_t offset, nshader_io_whence_t whence);
+
+  // Optional: total size of the stream in bytes, or -1 if unknown
+  // Together with seek it lets the reader reject corrupt sizes before allocating
+  int64_t (*size)(void* user);
+} nshader_io_t;
+
+// State of a memory stream, owned by the caller for the lifetime of the stream
+typedef struct nshader_io_memory_t {
+  const uint8_t* data;
+  size_t size;
+  size_t offset;
+} nshader_io_memory_t;
+
+// Stream reading from a FILE*, starting at its current position
+NSHADER_API nshader_io_t nshader_io_from_file(FILE* file);
+
+// Read-only stream over a memory buffer
+NSHADER_API nshader_io_t nshader_io_from_memory(nshader_io_memory_t* state, const void* data, size_t size);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
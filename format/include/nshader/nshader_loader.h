@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "nshader_reader.h"
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Opaque asynchronous loader, owns a worker pool or feeds a user job system
+typedef struct nshader_loader_t nshader_loader_t;
+
+// Identifies a request submitted to a loader, 0 is never a valid id
+typedef uint64_t nshader_load_id_t;
+
+typedef enum nshader_load_status_t {
+  NSHADER_LOAD_STATUS_OK,        // shader is valid and owned by the callback
+  NSHADER_LOAD_STATUS_FAILED,    // File missing or invalid, shader is NULL
+  NSHADER_LOAD_STATUS_CANCELED,  // Canceled before completion, shader is NULL
+} nshader_load_status_t;
+
+// Completion callback, called exactly once per request.
+// Runs on a worker thread, or on the thread calling nshader_load_cancel()
+// or nshader_loader_destroy() for canceled requests.
+// The callback takes ownership of shader and frees it with nshader_destroy().
+typedef void (*nshader_load_callback_t)(void* user, nshader_load_id_t id, nshader_load_status_t status, nshader_t* shader);
+
+// Job function handed to a user job system
+typedef void (*nshader_job_fn)(void* job_data);
+
+// User-supplied worker pool: submit must eventually run fn(job_data) on any thread
+typedef struct nshader_job_system_t {
+  void* user;
+  void (*submit)(void* user, nshader_job_fn fn, void* job_data);
+} nshader_job_system_t;
+
+typedef struct nshader_loader_config_t {
+  // Number of internal worker threads (0 picks one per logical core, up to 8)
+  // Ignored when job_system is set
+  uint32_t num_threads;
+
+  // Optional job system to run loads on instead of internal threads
+  // Copied by the loader, its user context must outlive the loader
+  const nshader_job_system_t* job_system;
+} nshader_loader_config_t;
+
+// Single request of a batch submission
+typedef struct nshader_load_desc_t {
+  const char* path;
+  nshader_load_callback_t callback;
+  void* user;
+} nshader_load_desc_t;
+
+// Create a loader, config can be NULL for defaults
+// Returns NULL on failure
+NSHADER_API nshader_loader_t* nshader_loader_create(const nshader_loader_config_t* config);
+
+// Cancel queued requests, wait for running ones and free the loader
+NSHADER_API void nshader_loader_destroy(nshader_loader_t* loader);
+
+// Load a shader from path without blocking, the result is delivered to callback
+// Requests for a path that is already queued or being read share one file read,
+// each request still receives its own parsed shader, in the order they were made.
+// options is copied (NULL for defaults), borrow_blobs is ignored.
+// Returns the request id, or 0 if the request could not be queued
+NSHADER_API nshader_load_id_t nshader_load_async(
+  nshader_loader_t* loader,
+  const char* path,
+  const nshader_read_options_t* options,
+  nshader_load_callback_t callback,
+  void* user);
+
+// Submit many requests at once with a single wake-up of the workers
+// out_ids is optional and receives one id per desc (0 for failed submissions)
+// Returns the number of requests queued
+NSHADER_API size_t nshader_load_async_batch(
+  nshader_loader_t* loader,
+  const nshader_load_desc_t* descs,
+  size_t num_descs,
+  const nshader_read_options_t* options,
+  nshader_load_id_t* out_ids);
+
+// Load many files and block until every request has been delivered.
+// On Linux builds with NSHADER_IO_URING, the opens, stats and reads of all paths
+// are submitted through io_uring and each file is parsed on the calling thread
+// as soon as its read completes, so callbacks run on the calling thread.
+// Elsewhere, or when io_uring is unavailable, the requests go through
+// nshader_load_async_batch() and this waits for the loader to become idle.
+// Bulk requests cannot be canceled while io_uring is in use.
+// Returns the number of requests queued, out_ids works as for the batch call
+NSHADER_API size_t nshader_load_bulk(
+  nshader_loader_t* loader,
+  const nshader_load_desc_t* descs,
+  size_t num_descs,
+  const nshader_read_options_t* options,
+  nshader_load_id_t* out_ids);
+
+// Cancel a request that has not been delivered yet, its callback is called
+// with NSHADER_LOAD_STATUS_CANCELED before this function returns.
+// Returns false if the request already completed or is being delivered.
+NSHADER_API bool nshader_load_cancel(nshader_loader_t* loader, nshader_load_id_t id);
+
+// Block until every submitted request has been delivered
+NSHADER_API void nshader_loader_wait_idle(nshader_loader_t* loader);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
@@ -0,0 +1,61 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "nshader_type.h"
+#include "nshader_io.h"
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Magic number of patch files: "NSPT" in little-endian
+#define NSHADER_PATCH_MAGIC 0x5450534E
+
+// Version of the patch format
+#define NSHADER_PATCH_VERSION 1
+
+// Write a patch turning old_shader into new_shader. The patch holds the
+// metadata of new_shader, and for every blob either nothing (the old blob is
+// unchanged), a byte-level delta against the old blob of the same stage and
+// backend, or the whole blob when a delta would not be smaller.
+// Both shaders need their blobs, shaders read with skip_blobs fail.
+// buffer can be NULL to query the size; computing the deltas is the expensive
+// part, so a size query costs as much as the diff itself.
+// Returns the number of bytes written, or 0 on failure
+NSHADER_API size_t nshader_diff_to_memory(const nshader_t* old_shader, const nshader_t* new_shader, void* buffer, size_t buffer_size);
+
+// Same as above, writing to a stream
+NSHADER_API bool nshader_diff_to_io(const nshader_t* old_shader, const nshader_t* new_shader, const nshader_io_t* io);
+
+// Apply a patch to the shader it was created from. The content hash of
+// old_shader must match the one recorded in the patch, and the result is
+// checked against the hash of the new shader.
+// Returns the new shader, or NULL if the patch is invalid or does not apply
+// Caller must free the shader using nshader_destroy()
+NSHADER_API nshader_t* nshader_patch(const nshader_t* old_shader, const void* patch, size_t patch_size);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
@@ -25,6 +25,8 @@ SOFTWARE.
 #pragma once
 
 #include "nshader_type.h"
+#include "nshader_io.h"
+#include "nshader_string_pool.h"
 
 // #############################################################################
 NSHADER_HEADER_BEGIN;
@@ -45,6 +47,59 @@ NSHADER_API nshader_t* nshader_read_from_file(FILE* file);
 // Caller must free returned shader with nshader_destroy()
 NSHADER_API nshader_t* nshader_read_from_path(const char* filepath);
 
+// Verification of checksums stored by nshader_write_options_t::checksums
+// Files written without checksums load the same way in every mode
+typedef enum nshader_verify_mode_t {
+  NSHADER_VERIFY_NONE,     // Ignore stored checksums
+  NSHADER_VERIFY_ON_LOAD,  // Check metadata and every blob while reading, fail on mismatch
+  NSHADER_VERIFY_LAZY,     // Check metadata while reading, each blob on its first nshader_get_blob()
+} nshader_verify_mode_t;
+
+// Options for the _ex variants, a NULL options pointer selects the defaults
+typedef struct nshader_read_options_t {
+  // Allocator for the shader and temporary buffers (NULL for nshader_default_allocator())
+  // The shader keeps a copy of it and frees through it in nshader_destroy()
+  const nshader_allocator_t* allocator;
+
+  // In-memory alignment of copied blob payloads, a power of two up to
+  // NSHADER_MAX_BLOB_ALIGNMENT (0 for NSHADER_DEFAULT_BLOB_ALIGNMENT)
+  uint32_t blob_alignment;
+
+  // Point blobs into the source buffer instead of copying them (memory reads only)
+  // The buffer must outlive the shader, blobs keep the alignment they were
+  // written with as long as the buffer itself is aligned (e.g. mmap'd files)
+  bool borrow_blobs;
+
+  // How stored checksums are verified (NSHADER_VERIFY_NONE by default)
+  nshader_verify_mode_t verify;
+
+  // Intern entry points and binding names in a pool shared across shaders
+  // Without a pool, equal names are still shared within one file
+  // The pool must outlive the shader
+  nshader_string_pool_t* string_pool;
+
+  // Backends to load, bit (1u << backend) per nshader_backend_t (0 loads all)
+  // Other backends are dropped from nshader_info_t and their blobs are skipped,
+  // see nshader_sdl3_gpu_context_get_backend_mask()
+  uint32_t backend_mask;
+
+  // Read metadata only: blob payloads are skipped (seeked past in files) and
+  // nshader_get_blob() returns NULL, while nshader_info_t still lists every
+  // stored backend. Such shaders cannot be written, and nshader_hash() only
+  // succeeds when the file stores the hash.
+  bool skip_blobs;
+} nshader_read_options_t;
+
+// Same as above with per-call options
+NSHADER_API nshader_t* nshader_read_from_memory_ex(const void* buffer, size_t buffer_size, const nshader_read_options_t* options);
+NSHADER_API nshader_t* nshader_read_from_file_ex(FILE* file, const nshader_read_options_t* options);
+NSHADER_API nshader_t* nshader_read_from_path_ex(const char* filepath, const nshader_read_options_t* options);
+
+// Read nshader from a stream, pulling bytes incrementally from io->read
+// Blob payloads are read straight into their final allocation, borrow_blobs is ignored
+// Returns nshader_t* on success, NULL on failure
+NSHADER_API nshader_t* nshader_read_from_io(const nshader_io_t* io, const nshader_read_options_t* options);
+
 // Destroy nshader and free all associated memory
 NSHADER_API void nshader_destroy(nshader_t* shader);
 
@@ -52,6 +52,171 @@ NSHADER_API SDL_GPUComputePipeline* nshader_sdl3_gpu_create_compute_pipeline(
   SDL_GPUDevice* device,
   const nshader_t* shader);
 
+// Options for nshader_sdl3_gpu_create_graphics_pipeline()
+typedef struct nshader_sdl3_gpu_graphics_pipeline_desc_t {
+  // Pipeline state (primitive type, rasterizer, targets, ...).
+  // vertex_shader, fragment_shader and vertex_input_state are ignored and
+  // filled in from the nshader.
+  SDL_GPUGraphicsPipelineCreateInfo pipeline;
+
+  // Optional vertex buffer slot of each vertex input, indexed by location.
+  // Inputs past num_buffer_slots (or all of them when NULL) use slot 0.
+  const uint32_t* buffer_slots;
+  uint32_t num_buffer_slots;
+
+  // Bit mask of buffer slots stepped per instance instead of per vertex
+  uint32_t instance_slot_mask;
+} nshader_sdl3_gpu_graphics_pipeline_desc_t;
+
+// Vertex element format matching a reflected vertex input.
+// Returns SDL_GPU_VERTEXELEMENTFORMAT_INVALID for combinations SDL_GPU has
+// no format for (e.g. 3-component 8 and 16-bit types, 64-bit types).
+NSHADER_API SDL_GPUVertexElementFormat nshader_sdl3_gpu_get_vertex_element_format(
+  nshader_binding_type_t type,
+  uint32_t vector_size);
+
+// Creates an SDL_GPUGraphicsPipeline from a graphics nshader.
+// Both stages are created with one backend selection, and the vertex input
+// state is derived from the reflected vertex inputs: attributes are packed
+// in location order into their buffer slot, and each slot's pitch is the
+// sum of its attribute sizes.
+// Returns SDL_GPUGraphicsPipeline* on success, NULL on failure.
+// Caller must release the pipeline using SDL_ReleaseGPUGraphicsPipeline().
+NSHADER_API SDL_GPUGraphicsPipeline* nshader_sdl3_gpu_create_graphics_pipeline(
+  SDL_GPUDevice* device,
+  const nshader_t* shader,
+  const nshader_sdl3_gpu_graphics_pipeline_desc_t* desc);
+
+// #############################################################################
+// Device context
+// #############################################################################
+
+// Opaque per-device state: the shader formats the device accepts and the
+// backend to pick for every combination of backends a shader may contain.
+// The functions above resolve this on every call, the context does it once.
+typedef struct nshader_sdl3_gpu_context_t nshader_sdl3_gpu_context_t;
+
+// SDL_GPU functions called through a context. Members left NULL call the
+// SDL function of the same name, so a test can replace the device with a
+// mock without a GPU.
+typedef struct nshader_sdl3_gpu_device_fns_t {
+  SDL_GPUShaderFormat (*get_shader_formats)(SDL_GPUDevice* device);
+  const char* (*get_device_driver)(SDL_GPUDevice* device);
+  SDL_GPUShader* (*create_shader)(SDL_GPUDevice* device, const SDL_GPUShaderCreateInfo* create_info);
+  void (*release_shader)(SDL_GPUDevice* device, SDL_GPUShader* shader);
+  SDL_GPUComputePipeline* (*create_compute_pipeline)(SDL_GPUDevice* device, const SDL_GPUComputePipelineCreateInfo* create_info);
+  SDL_GPUGraphicsPipeline* (*create_graphics_pipeline)(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* create_info);
+} nshader_sdl3_gpu_device_fns_t;
+
+typedef struct nshader_sdl3_gpu_context_config_t {
+  // Backends in order of preference, NULL for DXIL > SPV > MSL > DXBC
+  // Backends left out are never selected
+  const nshader_backend_t* backend_priority;
+  size_t num_backend_priority;
+
+  // Device functions, NULL for the SDL ones. Copied into the context.
+  const nshader_sdl3_gpu_device_fns_t* device_fns;
+} nshader_sdl3_gpu_context_config_t;
+
+// Create a context for a device, config can be NULL for defaults
+// The device must outlive the context
+// Returns NULL on failure
+NSHADER_API nshader_sdl3_gpu_context_t* nshader_sdl3_gpu_context_create(
+  SDL_GPUDevice* device,
+  const nshader_sdl3_gpu_context_config_t* config);
+
+NSHADER_API void nshader_sdl3_gpu_context_destroy(nshader_sdl3_gpu_context_t* context);
+
+// Backend the context would use for a shader, NSHADER_BACKEND_COUNT if none
+NSHADER_API nshader_backend_t nshader_sdl3_gpu_context_select_backend(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader);
+
+// Backends the device accepts, bit (1u << backend) per nshader_backend_t.
+// Pass it as nshader_read_options_t::backend_mask to skip other blobs on load.
+NSHADER_API uint32_t nshader_sdl3_gpu_context_get_backend_mask(const nshader_sdl3_gpu_context_t* context);
+
+// Same as the functions above with the backend resolved through the context.
+// Thread safe, the context is not modified after creation.
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_context_create_shader(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type);
+
+NSHADER_API SDL_GPUComputePipeline* nshader_sdl3_gpu_context_create_compute_pipeline(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader);
+
+NSHADER_API SDL_GPUGraphicsPipeline* nshader_sdl3_gpu_context_create_graphics_pipeline(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  const nshader_sdl3_gpu_graphics_pipeline_desc_t* desc);
+
+// Creates a compute pipeline for each of count shaders, out_pipelines[i]
+// receives the pipeline of shaders[i] or NULL if it failed.
+// Backend selection and create infos are resolved for the whole batch on the
+// calling thread, then the pipelines are created by up to num_threads threads
+// (0 for one per core, at most 8) when the device driver allows concurrent
+// creation (Vulkan, Direct3D 12, Metal), and on the calling thread otherwise.
+// Returns the number of pipelines created.
+NSHADER_API size_t nshader_sdl3_gpu_context_create_compute_pipelines(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* const* shaders,
+  size_t count,
+  uint32_t num_threads,
+  SDL_GPUComputePipeline** out_pipelines);
+
+// #############################################################################
+// Shader object cache
+// #############################################################################
+
+// Opaque refcounted cache of SDL_GPUShader objects keyed by content hash
+// (see nshader_hash()), stage and backend, so shaders shared by many
+// pipelines are compiled by the driver once. Thread safe.
+typedef struct nshader_sdl3_gpu_shader_cache_t nshader_sdl3_gpu_shader_cache_t;
+
+// Create a cache creating shaders through context
+// The context must outlive the cache
+// Returns NULL on failure
+NSHADER_API nshader_sdl3_gpu_shader_cache_t* nshader_sdl3_gpu_shader_cache_create(
+  const nshader_sdl3_gpu_context_t* context);
+
+// Release every cached shader, including those still acquired
+NSHADER_API void nshader_sdl3_gpu_shader_cache_destroy(nshader_sdl3_gpu_shader_cache_t* cache);
+
+// Return the shader for a vertex or fragment stage, creating it on first use,
+// and add a reference to it. Every successful call is paired with
+// nshader_sdl3_gpu_shader_cache_release().
+// Returns NULL on failure
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_shader_cache_acquire(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type);
+
+// Drop a reference. Shaders without references stay cached until trimmed
+// or evicted.
+NSHADER_API void nshader_sdl3_gpu_shader_cache_release(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  SDL_GPUShader* gpu_shader);
+
+// Release the least recently used shaders without references until at most
+// max_unused of them are left, 0 releases all of them
+// Returns the number of shaders released
+NSHADER_API size_t nshader_sdl3_gpu_shader_cache_trim(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  size_t max_unused);
+
+// Remove every stage and backend of a shader from the cache, e.g. after it
+// was reloaded. Shaders without references are released now, acquired ones
+// when their last reference is released.
+// Returns the number of entries removed
+NSHADER_API size_t nshader_sdl3_gpu_shader_cache_evict(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  const nshader_t* shader);
+
+// Number of shaders held by the cache, with or without references
+NSHADER_API size_t nshader_sdl3_gpu_shader_cache_count(const nshader_sdl3_gpu_shader_cache_t* cache);
+
 // #############################################################################
 NSHADER_HEADER_END;
 // #############################################################################
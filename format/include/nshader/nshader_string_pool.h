@@ -0,0 +1,57 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "nshader_base.h"
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Opaque set of interned strings, shared by every shader read with it
+// (see nshader_read_options_t::string_pool). Equal strings interned in the
+// same pool share one pointer, so names can be compared by address.
+typedef struct nshader_string_pool_t nshader_string_pool_t;
+
+// Create an empty pool, allocator can be NULL for nshader_default_allocator()
+// The allocator must outlive the pool
+// Returns NULL on failure
+NSHADER_API nshader_string_pool_t* nshader_string_pool_create(const nshader_allocator_t* allocator);
+
+// Free the pool and every string in it
+// Shaders read with the pool must be destroyed first
+NSHADER_API void nshader_string_pool_destroy(nshader_string_pool_t* pool);
+
+// Return the pooled copy of str, adding it on first use. Thread safe.
+// The returned string lives until the pool is destroyed
+// Returns NULL on allocation failure
+NSHADER_API const char* nshader_string_pool_intern(nshader_string_pool_t* pool, const char* str);
+
+// Number of distinct strings in the pool. Thread safe.
+NSHADER_API size_t nshader_string_pool_count(const nshader_string_pool_t* pool);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
@@ -0,0 +1,63 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "nshader_type.h"
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Remove every backend not in backend_mask, bit (1u << backend) per
+// nshader_backend_t, and free its blobs. The stored content hash is dropped
+// and recomputed on demand. To skip other backends when loading instead, see
+// nshader_read_options_t::backend_mask.
+// Returns false if shader is NULL or none of its backends are in the mask,
+// in which case the shader is unchanged
+NSHADER_API bool nshader_strip_backends(nshader_t* shader, uint32_t backend_mask);
+
+// Remove debug instructions from the SPIR-V blobs (see
+// nshader_spirv_strip_debug_info()). Other backends are left as they are.
+// Blobs that fail their lazy checksum are left untouched.
+// Returns false if shader is NULL, its blobs are borrowed or an allocation fails
+NSHADER_API bool nshader_strip_debug_info(nshader_t* shader);
+
+// Remove the names of vertex and fragment inputs and outputs, they become
+// NULL and are written as empty strings, which read back as "". Entry points
+// are kept.
+// Returns false if shader is NULL
+NSHADER_API bool nshader_strip_names(nshader_t* shader);
+
+// Copy a SPIR-V module without its debug instructions: OpSource,
+// OpSourceContinued, OpSourceExtension, OpName, OpMemberName, OpString,
+// OpLine, OpNoLine and OpModuleProcessed. OpString is kept in modules that
+// import a NonSemantic instruction set, whose instructions may refer to it.
+// out can be NULL to query the stripped size, out and spirv may be the same.
+// Returns the size of the stripped module, 0 if spirv is not a valid module
+// or out_size is too small
+NSHADER_API size_t nshader_spirv_strip_debug_info(const void* spirv, size_t size, void* out, size_t out_size);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
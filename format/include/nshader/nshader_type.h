@@ -38,12 +38,29 @@ typedef struct nshader_blob_t {
   const uint8_t* data;
 } nshader_blob_t;
 
+// 128-bit content hash, usable as a cache or dedupe key
+typedef struct nshader_hash_t {
+  uint64_t lo;
+  uint64_t hi;
+} nshader_hash_t;
+
 // Info getters & utility functions
 NSHADER_API const nshader_info_t* nshader_get_info(const nshader_t* shader);
 NSHADER_API const nshader_blob_t* nshader_get_blob(const nshader_t* shader, nshader_stage_type_t stage, nshader_backend_t backend);
 NSHADER_API bool nshader_has_backend(const nshader_t* shader, nshader_backend_t backend);
 NSHADER_API bool nshader_has_stage(const nshader_t* shader, nshader_stage_type_t stage_type);
 
+// Size of a blob in bytes, 0 if there is none. Also answers for shaders read
+// with nshader_read_options_t::skip_blobs, whose payloads were not loaded.
+NSHADER_API size_t nshader_get_blob_size(const nshader_t* shader, nshader_stage_type_t stage, nshader_backend_t backend);
+
+// Stable hash over the metadata and every blob, independent of write options
+// (alignment, checksums) and of the host. Shaders read from files that store
+// it and freshly compiled shaders return a cached value without rehashing.
+// Returns false if shader is NULL, or if it was read with skip_blobs from a
+// file that stores no hash
+NSHADER_API bool nshader_hash(const nshader_t* shader, nshader_hash_t* out_hash);
+
 // #############################################################################
 NSHADER_HEADER_END;
 // #############################################################################
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "nshader_base.h"
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+typedef enum nshader_validate_status_t {
+  NSHADER_VALIDATE_OK,
+  NSHADER_VALIDATE_TRUNCATED,    // A field or payload runs past the end of the buffer
+  NSHADER_VALIDATE_BAD_MAGIC,    // Not an nshader file
+  NSHADER_VALIDATE_BAD_VERSION,  // Format version not supported by this library
+  NSHADER_VALIDATE_BAD_HEADER,   // Unknown format flags or invalid blob alignment
+  NSHADER_VALIDATE_BAD_ENUM,     // Shader, stage, backend or binding type out of range
+  NSHADER_VALIDATE_BAD_COUNT,    // Stage, backend or binding count out of range
+  NSHADER_VALIDATE_BAD_STRING,   // String with an embedded NUL character
+  NSHADER_VALIDATE_STATUS_COUNT
+} nshader_validate_status_t;
+
+typedef struct nshader_validate_report_t {
+  nshader_validate_status_t status;
+  size_t error_offset;   // Offset of the field that failed, 0 on success
+  size_t size;           // Bytes taken by the shader, trailing bytes are not checked
+  uint32_t version;      // Format version from the header
+  uint32_t num_stages;
+  uint32_t num_backends;
+  uint32_t num_blobs;
+  uint64_t blob_bytes;   // Sum of all blob payload sizes
+  bool has_checksums;    // Checksums are stored (they are not verified here)
+} nshader_validate_report_t;
+
+// Check that buffer holds a shader nshader_read_from_memory() would accept,
+// without allocating or copying anything. Blob payloads are bounds-checked
+// but not read, so the cost depends on the metadata size only.
+// report is optional and describes the shader or the first error found.
+// version and has_checksums are set once the header passed, so the first
+// bytes of a file are enough to query them.
+// Returns true if the buffer is valid
+NSHADER_API bool nshader_validate_memory(const void* buffer, size_t buffer_size, nshader_validate_report_t* report);
+
+// Utility to convert validation status enum to string
+NSHADER_API const char* nshader_validate_status_to_string(nshader_validate_status_t status);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
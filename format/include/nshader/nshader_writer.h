@@ -25,6 +25,7 @@ SOFTWARE.
 #pragma once
 
 #include "nshader_type.h"
+#include "nshader_io.h"
 
 // #############################################################################
 NSHADER_HEADER_BEGIN;
@@ -43,6 +44,29 @@ NSHADER_API bool nshader_write_to_file(const nshader_t* shader, FILE* file);
 // Returns true on success, false on failure
 NSHADER_API bool nshader_write_to_path(const nshader_t* shader, const char* filepath);
 
+// Options for the _ex variants, a NULL options pointer selects the defaults
+typedef struct nshader_write_options_t {
+  // Allocator for temporary buffers (NULL for nshader_default_allocator())
+  const nshader_allocator_t* allocator;
+
+  // Alignment of blob payloads relative to the start of the output, a power of
+  // two up to NSHADER_MAX_BLOB_ALIGNMENT (0 for NSHADER_DEFAULT_BLOB_ALIGNMENT)
+  uint32_t blob_alignment;
+
+  // Store CRC-32C checksums of the metadata and of every blob payload
+  bool checksums;
+} nshader_write_options_t;
+
+// Same as above with per-call options
+NSHADER_API size_t nshader_write_to_memory_ex(const nshader_t* shader, void* buffer, size_t buffer_size, const nshader_write_options_t* options);
+NSHADER_API bool nshader_write_to_file_ex(const nshader_t* shader, FILE* file, const nshader_write_options_t* options);
+NSHADER_API bool nshader_write_to_path_ex(const nshader_t* shader, const char* filepath, const nshader_write_options_t* options);
+
+// Write nshader to a stream through io->write
+// Metadata is staged in a small buffer, blob payloads are written from their storage
+// Returns true on success, false on failure
+NSHADER_API bool nshader_write_to_io(const nshader_t* shader, const nshader_io_t* io, const nshader_write_options_t* options);
+
 // #############################################################################
 NSHADER_HEADER_END;
 // #############################################################################
\ No newline at end of file
@@ -23,7 +23,14 @@ SOFTWARE.
 */
 
 #include <nshader/nshader_base.h>
+#include "nshader_base_internal.h"
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef NSHADER_ALLOC_TRACKING
+#  include <SDL3/SDL_atomic.h>
+#endif
 
 // Stored function pointers for memory functions
 // They default to the standard library functions
@@ -32,20 +39,341 @@ static nshader_free_fn g_free_fn = free;
 static nshader_calloc_fn g_calloc_fn = calloc;
 static nshader_realloc_fn g_realloc_fn = realloc;
 
-NSHADER_API void* nshader_malloc(size_t size) {
+// #############################################################################
+// Allocation tracking
+// #############################################################################
+
+#ifdef NSHADER_ALLOC_TRACKING
+
+// Every tracked allocation is prefixed with a header recording its size and tag.
+// The header is padded to 16 bytes so the returned pointer keeps malloc's alignment.
+typedef union alloc_header_t {
+    struct {
+        size_t size;
+        uint32_t tag;
+    } info;
+    uint8_t padding[16];
+} alloc_header_t;
+
+static nshader_alloc_stats_t g_alloc_stats;
+static SDL_SpinLock g_alloc_stats_lock;
+
+static void counters_on_alloc(nshader_alloc_counters_t* counters, size_t size) {
+    counters->num_allocs++;
+    counters->live_bytes += size;
+    if (counters->live_bytes > counters->peak_bytes) {
+        counters->peak_bytes = counters->live_bytes;
+    }
+}
+
+static void counters_on_free(nshader_alloc_counters_t* counters, size_t size) {
+    counters->num_frees++;
+    counters->live_bytes -= size;
+}
+
+static void counters_on_resize(nshader_alloc_counters_t* counters, size_t old_size, size_t new_size) {
+    counters->live_bytes = counters->live_bytes - old_size + new_size;
+    if (counters->live_bytes > counters->peak_bytes) {
+        counters->peak_bytes = counters->live_bytes;
+    }
+}
+
+static void reset_counters(nshader_alloc_counters_t* counters) {
+    counters->num_allocs = 0;
+    counters->num_frees = 0;
+    counters->peak_bytes = counters->live_bytes;
+}
+
+static void track_alloc(nshader_alloc_tag_t tag, size_t size) {
+    SDL_LockSpinlock(&g_alloc_stats_lock);
+    counters_on_alloc(&g_alloc_stats.total, size);
+    counters_on_alloc(&g_alloc_stats.tags[tag], size);
+    SDL_UnlockSpinlock(&g_alloc_stats_lock);
+}
+
+static void track_free(nshader_alloc_tag_t tag, size_t size) {
+    SDL_LockSpinlock(&g_alloc_stats_lock);
+    counters_on_free(&g_alloc_stats.total, size);
+    counters_on_free(&g_alloc_stats.tags[tag], size);
+    SDL_UnlockSpinlock(&g_alloc_stats_lock);
+}
+
+static void track_resize(nshader_alloc_tag_t tag, size_t old_size, size_t new_size) {
+    SDL_LockSpinlock(&g_alloc_stats_lock);
+    counters_on_resize(&g_alloc_stats.total, old_size, new_size);
+    counters_on_resize(&g_alloc_stats.tags[tag], old_size, new_size);
+    SDL_UnlockSpinlock(&g_alloc_stats_lock);
+}
+
+static void* header_to_user(alloc_header_t* header, nshader_alloc_tag_t tag, size_t size) {
+    header->info.size = size;
+    header->info.tag = (uint32_t)tag;
+    return header + 1;
+}
+
+static alloc_header_t* user_to_header(void* ptr) {
+    return (alloc_header_t*)ptr - 1;
+}
+
+#endif
+
+NSHADER_API bool nshader_alloc_tracking_enabled(void) {
+#ifdef NSHADER_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+NSHADER_API void nshader_get_alloc_stats(nshader_alloc_stats_t* out_stats) {
+    if (!out_stats) {
+        return;
+    }
+#ifdef NSHADER_ALLOC_TRACKING
+    SDL_LockSpinlock(&g_alloc_stats_lock);
+    *out_stats = g_alloc_stats;
+    SDL_UnlockSpinlock(&g_alloc_stats_lock);
+#else
+    memset(out_stats, 0, sizeof(*out_stats));
+#endif
+}
+
+NSHADER_API void nshader_reset_alloc_stats(void) {
+#ifdef NSHADER_ALLOC_TRACKING
+    SDL_LockSpinlock(&g_alloc_stats_lock);
+    reset_counters(&g_alloc_stats.total);
+    for (size_t i = 0; i < NSHADER_ALLOC_TAG_COUNT; ++i) {
+        reset_counters(&g_alloc_stats.tags[i]);
+    }
+    SDL_UnlockSpinlock(&g_alloc_stats_lock);
+#endif
+}
+
+NSHADER_API const char* nshader_alloc_tag_to_string(nshader_alloc_tag_t tag) {
+    switch (tag) {
+        case NSHADER_ALLOC_TAG_GENERAL:
+            return "general";
+        case NSHADER_ALLOC_TAG_SHADER:
+            return "shader";
+        case NSHADER_ALLOC_TAG_READER_BLOB:
+            return "reader blob";
+        case NSHADER_ALLOC_TAG_READER_METADATA:
+            return "reader metadata";
+        case NSHADER_ALLOC_TAG_READER_STAGING:
+            return "reader staging";
+        case NSHADER_ALLOC_TAG_WRITER_STAGING:
+            return "writer staging";
+        case NSHADER_ALLOC_TAG_COMPILER_DEFINES:
+            return "compiler defines";
+        case NSHADER_ALLOC_TAG_COMPILER_STAGING:
+            return "compiler staging";
+        case NSHADER_ALLOC_TAG_COMPILER_OUTPUT:
+            return "compiler output";
+        case NSHADER_ALLOC_TAG_ERROR_LIST:
+            return "error list";
+        case NSHADER_ALLOC_TAG_LOADER:
+            return "loader";
+        case NSHADER_ALLOC_TAG_STRING_POOL:
+            return "string pool";
+        case NSHADER_ALLOC_TAG_WATCHER:
+            return "watcher";
+        case NSHADER_ALLOC_TAG_SERVER:
+            return "server";
+        case NSHADER_ALLOC_TAG_PATCH:
+            return "patch";
+        default:
+            return "unknown";
+    }
+}
+
+// #############################################################################
+// Memory functions
+// #############################################################################
+
+NSHADER_API void* nshader_malloc_tagged(nshader_alloc_tag_t tag, size_t size) {
+#ifdef NSHADER_ALLOC_TRACKING
+    alloc_header_t* header = (alloc_header_t*)g_malloc_fn(sizeof(alloc_header_t) + size);
+    if (!header) {
+        return NULL;
+    }
+    track_alloc(tag, size);
+    return header_to_user(header, tag, size);
+#else
+    (void)tag;
     return g_malloc_fn(size);
+#endif
+}
+
+NSHADER_API void* nshader_calloc_tagged(nshader_alloc_tag_t tag, size_t num, size_t size) {
+#ifdef NSHADER_ALLOC_TRACKING
+    if (size != 0 && num > (SIZE_MAX - sizeof(alloc_header_t)) / size) {
+        return NULL;
+    }
+    size_t total = num * size;
+    alloc_header_t* header = (alloc_header_t*)g_calloc_fn(1, sizeof(alloc_header_t) + total);
+    if (!header) {
+        return NULL;
+    }
+    track_alloc(tag, total);
+    return header_to_user(header, tag, total);
+#else
+    (void)tag;
+    return g_calloc_fn(num, size);
+#endif
+}
+
+NSHADER_API void* nshader_realloc_tagged(nshader_alloc_tag_t tag, void* ptr, size_t new_size) {
+#ifdef NSHADER_ALLOC_TRACKING
+    if (!ptr) {
+        return nshader_malloc_tagged(tag, new_size);
+    }
+    alloc_header_t* old_header = user_to_header(ptr);
+    size_t old_size = old_header->info.size;
+    nshader_alloc_tag_t old_tag = (nshader_alloc_tag_t)old_header->info.tag;
+    alloc_header_t* header = (alloc_header_t*)g_realloc_fn(old_header, sizeof(alloc_header_t) + new_size);
+    if (!header) {
+        return NULL;
+    }
+    track_resize(old_tag, old_size, new_size);
+    return header_to_user(header, old_tag, new_size);
+#else
+    (void)tag;
+    return g_realloc_fn(ptr, new_size);
+#endif
+}
+
+NSHADER_API void* nshader_malloc(size_t size) {
+    return nshader_malloc_tagged(NSHADER_ALLOC_TAG_GENERAL, size);
 }
 
 NSHADER_API void  nshader_free(void* ptr) {
+#ifdef NSHADER_ALLOC_TRACKING
+    if (!ptr) {
+        return;
+    }
+    alloc_header_t* header = user_to_header(ptr);
+    track_free((nshader_alloc_tag_t)header->info.tag, header->info.size);
+    g_free_fn(header);
+#else
     g_free_fn(ptr);
+#endif
 }
 
 NSHADER_API void* nshader_calloc(size_t num, size_t size) {
-    return g_calloc_fn(num, size);
+    return nshader_calloc_tagged(NSHADER_ALLOC_TAG_GENERAL, num, size);
 }
 
 NSHADER_API void* nshader_realloc(void* ptr, size_t new_size) {
-    return g_realloc_fn(ptr, new_size);
+    return nshader_realloc_tagged(NSHADER_ALLOC_TAG_GENERAL, ptr, new_size);
+}
+
+// #############################################################################
+// Context-carrying allocator
+// #############################################################################
+
+// Largest alignment the default allocator supports, the offset to the raw
+// pointer is stored in the byte just before the aligned pointer.
+#define DEFAULT_ALLOCATOR_MAX_ALIGN 128
+
+static void* default_allocator_alloc(void* user, size_t size, size_t align) {
+    (void)user;
+    if (align > DEFAULT_ALLOCATOR_MAX_ALIGN || (align & (align - 1)) != 0) {
+        return NULL;
+    }
+    // Never return less than malloc's natural alignment
+    if (align < _Alignof(max_align_t)) {
+        align = _Alignof(max_align_t);
+    }
+    if (size > SIZE_MAX - align) {
+        return NULL;
+    }
+    uint8_t* raw = (uint8_t*)g_malloc_fn(size + align);
+    if (!raw) {
+        return NULL;
+    }
+    uintptr_t aligned = ((uintptr_t)raw + align) & ~(uintptr_t)(align - 1);
+    uint8_t* ptr = (uint8_t*)aligned;
+    ptr[-1] = (uint8_t)(ptr - raw - 1);
+    return ptr;
+}
+
+static void default_allocator_free(void* user, void* ptr, size_t size) {
+    (void)user;
+    (void)size;
+    if (!ptr) {
+        return;
+    }
+    uint8_t* p = (uint8_t*)ptr;
+    g_free_fn(p - p[-1] - 1);
+}
+
+static const nshader_allocator_t g_default_allocator = {
+    NULL,
+    default_allocator_alloc,
+    default_allocator_free,
+};
+
+NSHADER_API const nshader_allocator_t* nshader_default_allocator(void) {
+    return &g_default_allocator;
+}
+
+NSHADER_API void* nshader_allocator_alloc(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, size_t size, size_t align) {
+    if (!allocator) {
+        allocator = &g_default_allocator;
+    }
+    void* ptr = allocator->alloc(allocator->user, size, align);
+#ifdef NSHADER_ALLOC_TRACKING
+    if (ptr) {
+        track_alloc(tag, size);
+    }
+#else
+    (void)tag;
+#endif
+    return ptr;
+}
+
+NSHADER_API void* nshader_allocator_calloc(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, size_t num, size_t size, size_t align) {
+    if (size != 0 && num > SIZE_MAX / size) {
+        return NULL;
+    }
+    void* ptr = nshader_allocator_alloc(allocator, tag, num * size, align);
+    if (ptr) {
+        memset(ptr, 0, num * size);
+    }
+    return ptr;
+}
+
+NSHADER_API void nshader_allocator_free(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, void* ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+    if (!allocator) {
+        allocator = &g_default_allocator;
+    }
+#ifdef NSHADER_ALLOC_TRACKING
+    track_free(tag, size);
+#else
+    (void)tag;
+#endif
+    allocator->free(allocator->user, ptr, size);
+}
+
+NSHADER_API char* nshader_allocator_strdup(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, const char* str) {
+    if (!str) {
+        return NULL;
+    }
+    size_t len = strlen(str);
+    char* copy = (char*)nshader_allocator_alloc(allocator, tag, len + 1, 1);
+    if (copy) {
+        memcpy(copy, str, len + 1);
+    }
+    return copy;
+}
+
+NSHADER_API void nshader_allocator_free_string(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, char* str) {
+    if (str) {
+        nshader_allocator_free(allocator, tag, str, strlen(str) + 1);
+    }
 }
 
 NSHADER_API void nshader_set_memory_fns(
@@ -65,4 +393,4 @@ NSHADER_API void nshader_set_memory_fns(
     if (realloc_fn) {
         g_realloc_fn = realloc_fn;
     }
-  }
\ No newline at end of file
+  }
@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <nshader/nshader_base.h>
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Tagged variants of the memory functions, used by the library itself so that
+// allocations can be attributed to a call site when NSHADER_ALLOC_TRACKING is on.
+// Memory returned by these functions is released with nshader_free().
+NSHADER_API void* nshader_malloc_tagged(nshader_alloc_tag_t tag, size_t size);
+NSHADER_API void* nshader_calloc_tagged(nshader_alloc_tag_t tag, size_t num, size_t size);
+NSHADER_API void* nshader_realloc_tagged(nshader_alloc_tag_t tag, void* ptr, size_t new_size);
+
+// Allocation through an nshader_allocator_t, NULL selects the default allocator.
+// Memory must be released with nshader_allocator_free() and the same size.
+NSHADER_API void* nshader_allocator_alloc(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, size_t size, size_t align);
+NSHADER_API void* nshader_allocator_calloc(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, size_t num, size_t size, size_t align);
+NSHADER_API void  nshader_allocator_free(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, void* ptr, size_t size);
+
+// Duplicate a string through an allocator, it is freed with a size of strlen(str) + 1.
+NSHADER_API char* nshader_allocator_strdup(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, const char* str);
+NSHADER_API void  nshader_allocator_free_string(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, char* str);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <nshader/nshader_base.h>
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// CRC-32C (Castagnoli) of size bytes, continuing from a previous result
+// Start with crc = 0. Uses SSE4.2 or ARMv8 CRC instructions when available.
+uint32_t nshader_crc32c(uint32_t crc, const void* data, size_t size);
+
+// Streaming MurmurHash3 x64_128, the result does not depend on how the input is split
+typedef struct nshader_hash_state_t {
+  uint64_t h1;
+  uint64_t h2;
+  uint8_t tail[16];   // Bytes not forming a full block yet
+  size_t tail_size;
+  uint64_t total_size;
+} nshader_hash_state_t;
+
+void nshader_hash_init(nshader_hash_state_t* state);
+void nshader_hash_update(nshader_hash_state_t* state, const void* data, size_t size);
+void nshader_hash_final(nshader_hash_state_t* state, uint64_t* out_lo, uint64_t* out_hi);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
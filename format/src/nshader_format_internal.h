@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <nshader/nshader_base.h>
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+// Serialized layout, all integers little-endian:
+//
+//   u32 magic, u32 version
+//   v2+: u32 flags, u32 blob_alignment
+//   NSHADER_FORMAT_FLAG_HASH: u64 hash lo, u64 hash hi (see nshader_hash())
+//   NSHADER_FORMAT_FLAG_STRINGS: u32 num_strings, strings... (u32 length, bytes),
+//   every later string (entry points, binding names) is then a u32 table index
+//   u8 shader type, u32 num_stages, stages..., u32 num_backends, u8 backends...
+//   NSHADER_FORMAT_FLAG_CHECKSUMS: u32 CRC-32C of every byte above
+//   per stage type x backend: u8 has_blob [, u32 size, NSHADER_FORMAT_FLAG_CHECKSUMS:
+//   u32 CRC-32C of the payload, v2+: zero padding up to blob_alignment measured
+//   from the start of the file, size bytes]
+
+// Oldest format version the reader still accepts
+#define NSHADER_VERSION_MIN 1
+
+// Format flags stored in the v2+ header, bits the reader does not know are rejected
+#define NSHADER_FORMAT_FLAG_CHECKSUMS (1u << 0)  // Metadata and blob CRC-32C values are stored
+#define NSHADER_FORMAT_FLAG_HASH      (1u << 1)  // Content hash is stored in the header
+#define NSHADER_FORMAT_FLAG_STRINGS   (1u << 2)  // Strings are stored once in a table and referenced by index
+#define NSHADER_FORMAT_KNOWN_FLAGS (NSHADER_FORMAT_FLAG_CHECKSUMS | NSHADER_FORMAT_FLAG_HASH | NSHADER_FORMAT_FLAG_STRINGS)
+
+// Largest input or output binding count accepted per stage
+#define NSHADER_MAX_BINDINGS 1024
+
+// Largest string table accepted, enough for the entry point and bindings of every stage
+#define NSHADER_MAX_STRINGS 8192
+
+// Smallest serialized binding: u32 name length, u32 location, u32 vector size, u32 type
+#define NSHADER_MIN_BINDING_SIZE 16
+
+static inline uint32_t nshader_le32(uint32_t val) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return ((val & 0xFF000000) >> 24) |
+         ((val & 0x00FF0000) >> 8)  |
+         ((val & 0x0000FF00) << 8)  |
+         ((val & 0x000000FF) << 24);
+#else
+  return val;  // Already little-endian
+#endif
+}
+
+static inline uint64_t nshader_le64(uint64_t val) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return ((uint64_t)nshader_le32((uint32_t)val) << 32) | nshader_le32((uint32_t)(val >> 32));
+#else
+  return val;  // Already little-endian
+#endif
+}
+
+static inline bool nshader_is_valid_blob_alignment(uint32_t alignment) {
+  return alignment != 0 && alignment <= NSHADER_MAX_BLOB_ALIGNMENT && (alignment & (alignment - 1)) == 0;
+}
+
+// Counts are checked against hard limits and the bytes left before anything is allocated
+static inline bool nshader_is_valid_binding_count(uint32_t count, bool bounded, size_t remaining) {
+  return count <= NSHADER_MAX_BINDINGS && (!bounded || (size_t)count * NSHADER_MIN_BINDING_SIZE <= remaining);
+}
+
+static inline bool nshader_is_valid_string_count(uint32_t count, bool bounded, size_t remaining) {
+  return count <= NSHADER_MAX_STRINGS && (!bounded || (size_t)count * sizeof(uint32_t) <= remaining);
+}
+
+// Number of padding bytes needed to align offset to alignment (a power of two)
+static inline size_t nshader_align_padding(size_t offset, size_t alignment) {
+  return (alignment - (offset & (alignment - 1))) & (alignment - 1);
+}
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
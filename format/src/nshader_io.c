@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_io.h>
+#include <string.h>
+
+// #############################################################################
+// FILE* stream
+// #############################################################################
+
+static size_t file_read(void* user, void* data, size_t size) {
+  return fread(data, 1, size, (FILE*)user);
+}
+
+static size_t file_write(void* user, const void* data, size_t size) {
+  return fwrite(data, 1, size, (FILE*)user);
+}
+
+static int64_t file_seek(void* user, int64_t offset, nshader_io_whence_t whence) {
+  FILE* file = (FILE*)user;
+  int origin = whence == NSHADER_IO_SEEK_SET ? SEEK_SET : whence == NSHADER_IO_SEEK_CUR ? SEEK_CUR : SEEK_END;
+  if (fseek(file, (long)offset, origin) != 0) {
+    return -1;
+  }
+  return (int64_t)ftell(file);
+}
+
+static int64_t file_size(void* user) {
+  FILE* file = (FILE*)user;
+  long pos = ftell(file);
+  if (pos < 0 || fseek(file, 0, SEEK_END) != 0) {
+    return -1;
+  }
+  long end = ftell(file);
+  if (fseek(file, pos, SEEK_SET) != 0) {
+    return -1;
+  }
+  return (int64_t)end;
+}
+
+NSHADER_API nshader_io_t nshader_io_from_file(FILE* file) {
+  nshader_io_t io = {0};
+  io.user = file;
+  io.read = file_read;
+  io.write = file_write;
+  io.seek = file_seek;
+  io.size = file_size;
+  return io;
+}
+
+// #############################################################################
+// Memory stream
+// #############################################################################
+
+static size_t memory_read(void* user, void* data, size_t size) {
+  nshader_io_memory_t* state = (nshader_io_memory_t*)user;
+  size_t available = state->size - state->offset;
+  if (size > available) {
+    size = available;
+  }
+  memcpy(data, state->data + state->offset, size);
+  state->offset += size;
+  return size;
+}
+
+static int64_t memory_seek(void* user, int64_t offset, nshader_io_whence_t whence) {
+  nshader_io_memory_t* state = (nshader_io_memory_t*)user;
+  int64_t base = whence == NSHADER_IO_SEEK_SET ? 0 : whence == NSHADER_IO_SEEK_CUR ? (int64_t)state->offset : (int64_t)state->size;
+  int64_t pos = base + offset;
+  if (pos < 0 || (uint64_t)pos > state->size) {
+    return -1;
+  }
+  state->offset = (size_t)pos;
+  return pos;
+}
+
+static int64_t memory_size(void* user) {
+  return (int64_t)((nshader_io_memory_t*)user)->size;
+}
+
+NSHADER_API nshader_io_t nshader_io_from_memory(nshader_io_memory_t* state, const void* data, size_t size) {
+  state->data = (const uint8_t*)data;
+  state->size = data ? size : 0;
+  state->offset = 0;
+
+  nshader_io_t io = {0};
+  io.user = state;
+  io.read = memory_read;
+  io.seek = memory_seek;
+  io.size = memory_size;
+  return io;
+}
@@ -0,0 +1,550 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_loader.h>
+#include "nshader_base_internal.h"
+#include "nshader_uring_internal.h"
+#include <SDL3/SDL.h>
+#include <string.h>
+
+// Upper bound for the default number of worker threads, loading is mostly I/O
+#define LOADER_MAX_DEFAULT_THREADS 8
+
+// Buckets of the path table used to coalesce duplicate requests
+#define LOADER_HASH_BUCKETS 256
+
+typedef struct load_request_t {
+  nshader_load_id_t id;
+  nshader_read_options_t options;
+  nshader_load_callback_t callback;
+  void* user;
+  struct load_request_t* next;
+} load_request_t;
+
+// One file read, shared by every request for the same path
+typedef struct load_job_t {
+  nshader_loader_t* loader;
+  char* path;
+  uint32_t hash;
+  load_request_t* requests;            // Waiting requests in submission order, guarded by the loader mutex
+  load_request_t** requests_tail;      // Link the next request is appended at
+  struct load_job_t* next_queued;      // Internal queue or pending job system submission
+  struct load_job_t* next_in_bucket;   // Path table chain, only while requests can attach
+} load_job_t;
+
+struct nshader_loader_t {
+  SDL_Mutex* mutex;
+  SDL_Condition* work_cond;  // Signaled when jobs are queued or on shutdown
+  SDL_Condition* idle_cond;  // Signaled when the last job finishes
+  SDL_Thread** threads;
+  uint32_t num_threads;
+  nshader_job_system_t job_system;
+  bool use_job_system;
+  bool quit;
+
+  load_job_t* queue_head;
+  load_job_t* queue_tail;
+  load_job_t* buckets[LOADER_HASH_BUCKETS];
+  size_t num_jobs;  // Jobs submitted and not finished yet
+  nshader_load_id_t next_id;
+};
+
+// #############################################################################
+// Path table
+// #############################################################################
+
+static uint32_t hash_path(const char* path) {
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (const unsigned char* c = (const unsigned char*)path; *c; ++c) {
+    hash ^= *c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static load_job_t* find_job(nshader_loader_t* loader, const char* path, uint32_t hash) {
+  for (load_job_t* job = loader->buckets[hash % LOADER_HASH_BUCKETS]; job; job = job->next_in_bucket) {
+    if (job->hash == hash && strcmp(job->path, path) == 0) {
+      return job;
+    }
+  }
+  return NULL;
+}
+
+static void unlink_job(nshader_loader_t* loader, load_job_t* job) {
+  load_job_t** link = &loader->buckets[job->hash % LOADER_HASH_BUCKETS];
+  while (*link) {
+    if (*link == job) {
+      *link = job->next_in_bucket;
+      job->next_in_bucket = NULL;
+      return;
+    }
+    link = &(*link)->next_in_bucket;
+  }
+}
+
+// #############################################################################
+// Job execution
+// #############################################################################
+
+static void* read_whole_file(const char* path, size_t* out_size) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+
+  void* buffer = NULL;
+  long size = -1;
+  if (fseek(file, 0, SEEK_END) == 0) {
+    size = ftell(file);
+  }
+  if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+    buffer = nshader_malloc_tagged(NSHADER_ALLOC_TAG_READER_STAGING, (size_t)size);
+    if (buffer && fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+      nshader_free(buffer);
+      buffer = NULL;
+    }
+  }
+  fclose(file);
+
+  *out_size = buffer ? (size_t)size : 0;
+  return buffer;
+}
+
+static void finish_job(load_job_t* job) {
+  nshader_loader_t* loader = job->loader;
+  nshader_free(job->path);
+  nshader_free(job);
+
+  SDL_LockMutex(loader->mutex);
+  if (--loader->num_jobs == 0) {
+    SDL_BroadcastCondition(loader->idle_cond);
+  }
+  SDL_UnlockMutex(loader->mutex);
+}
+
+static void run_job(load_job_t* job) {
+  nshader_loader_t* loader = job->loader;
+
+  // Every request may have been canceled while the job was queued
+  SDL_LockMutex(loader->mutex);
+  bool has_requests = job->requests != NULL;
+  if (!has_requests) {
+    unlink_job(loader, job);
+  }
+  SDL_UnlockMutex(loader->mutex);
+
+  if (!has_requests) {
+    finish_job(job);
+    return;
+  }
+
+  size_t size = 0;
+  void* buffer = read_whole_file(job->path, &size);
+
+  // Take the requests, later requests for the same path start a new read
+  SDL_LockMutex(loader->mutex);
+  load_request_t* requests = job->requests;
+  job->requests = NULL;
+  job->requests_tail = &job->requests;
+  unlink_job(loader, job);
+  SDL_UnlockMutex(loader->mutex);
+
+  while (requests) {
+    load_request_t* request = requests;
+    requests = request->next;
+
+    nshader_t* shader = buffer ? nshader_read_from_memory_ex(buffer, size, &request->options) : NULL;
+    request->callback(request->user, request->id, shader ? NSHADER_LOAD_STATUS_OK : NSHADER_LOAD_STATUS_FAILED, shader);
+    nshader_free(request);
+  }
+
+  nshader_free(buffer);
+  finish_job(job);
+}
+
+static void job_entry(void* job_data) {
+  run_job((load_job_t*)job_data);
+}
+
+static int worker_main(void* data) {
+  nshader_loader_t* loader = (nshader_loader_t*)data;
+  for (;;) {
+    SDL_LockMutex(loader->mutex);
+    while (!loader->quit && !loader->queue_head) {
+      SDL_WaitCondition(loader->work_cond, loader->mutex);
+    }
+    load_job_t* job = loader->queue_head;
+    if (!job) {
+      SDL_UnlockMutex(loader->mutex);
+      break;
+    }
+    loader->queue_head = job->next_queued;
+    if (!loader->queue_head) {
+      loader->queue_tail = NULL;
+    }
+    job->next_queued = NULL;
+    SDL_UnlockMutex(loader->mutex);
+
+    run_job(job);
+  }
+  return 0;
+}
+
+// #############################################################################
+// Submission
+// #############################################################################
+
+// Queue one request with the mutex held, new jobs are appended to new_jobs
+static nshader_load_id_t submit_locked(
+  nshader_loader_t* loader,
+  const char* path,
+  const nshader_read_options_t* options,
+  nshader_load_callback_t callback,
+  void* user,
+  load_job_t** new_jobs) {
+
+  if (!path || !callback) {
+    return 0;
+  }
+
+  load_request_t* request = (load_request_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, 1, sizeof(load_request_t));
+  if (!request) {
+    return 0;
+  }
+  if (options) {
+    request->options = *options;
+  }
+  request->options.borrow_blobs = false;
+  request->callback = callback;
+  request->user = user;
+
+  uint32_t hash = hash_path(path);
+  load_job_t* job = find_job(loader, path, hash);
+  if (!job) {
+    job = (load_job_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, 1, sizeof(load_job_t));
+    size_t path_len = strlen(path);
+    char* path_copy = (char*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_LOADER, path_len + 1);
+    if (!job || !path_copy) {
+      nshader_free(job);
+      nshader_free(path_copy);
+      nshader_free(request);
+      return 0;
+    }
+    memcpy(path_copy, path, path_len + 1);
+    job->loader = loader;
+    job->path = path_copy;
+    job->hash = hash;
+    job->requests_tail = &job->requests;
+    job->next_in_bucket = loader->buckets[hash % LOADER_HASH_BUCKETS];
+    loader->buckets[hash % LOADER_HASH_BUCKETS] = job;
+    loader->num_jobs++;
+
+    job->next_queued = *new_jobs;
+    *new_jobs = job;
+  }
+
+  // Appended, so coalesced requests are answered in the order they came in
+  request->id = loader->next_id++;
+  request->next = NULL;
+  *job->requests_tail = request;
+  job->requests_tail = &request->next;
+  return request->id;
+}
+
+// Hand jobs created by submit_locked() to the workers, called without the mutex
+static void dispatch_jobs(nshader_loader_t* loader, load_job_t* new_jobs) {
+  if (!new_jobs) {
+    return;
+  }
+
+  if (loader->use_job_system) {
+    while (new_jobs) {
+      load_job_t* job = new_jobs;
+      new_jobs = job->next_queued;
+      job->next_queued = NULL;
+      loader->job_system.submit(loader->job_system.user, job_entry, job);
+    }
+    return;
+  }
+
+  // new_jobs is in reverse submission order, keep the queue FIFO
+  load_job_t* ordered = NULL;
+  load_job_t* last = new_jobs;
+  while (new_jobs) {
+    load_job_t* job = new_jobs;
+    new_jobs = job->next_queued;
+    job->next_queued = ordered;
+    ordered = job;
+  }
+
+  SDL_LockMutex(loader->mutex);
+  if (loader->queue_tail) {
+    loader->queue_tail->next_queued = ordered;
+  } else {
+    loader->queue_head = ordered;
+  }
+  loader->queue_tail = last;
+  SDL_BroadcastCondition(loader->work_cond);
+  SDL_UnlockMutex(loader->mutex);
+}
+
+NSHADER_API nshader_load_id_t nshader_load_async(
+  nshader_loader_t* loader,
+  const char* path,
+  const nshader_read_options_t* options,
+  nshader_load_callback_t callback,
+  void* user) {
+
+  if (!loader) {
+    return 0;
+  }
+
+  load_job_t* new_jobs = NULL;
+  SDL_LockMutex(loader->mutex);
+  nshader_load_id_t id = submit_locked(loader, path, options, callback, user, &new_jobs);
+  SDL_UnlockMutex(loader->mutex);
+
+  dispatch_jobs(loader, new_jobs);
+  return id;
+}
+
+NSHADER_API size_t nshader_load_async_batch(
+  nshader_loader_t* loader,
+  const nshader_load_desc_t* descs,
+  size_t num_descs,
+  const nshader_read_options_t* options,
+  nshader_load_id_t* out_ids) {
+
+  if (!loader || !descs) {
+    return 0;
+  }
+
+  size_t num_queued = 0;
+  load_job_t* new_jobs = NULL;
+  SDL_LockMutex(loader->mutex);
+  for (size_t i = 0; i < num_descs; ++i) {
+    nshader_load_id_t id = submit_locked(loader, descs[i].path, options, descs[i].callback, descs[i].user, &new_jobs);
+    if (out_ids) {
+      out_ids[i] = id;
+    }
+    if (id != 0) {
+      num_queued++;
+    }
+  }
+  SDL_UnlockMutex(loader->mutex);
+
+  dispatch_jobs(loader, new_jobs);
+  return num_queued;
+}
+
+NSHADER_API size_t nshader_load_bulk(
+  nshader_loader_t* loader,
+  const nshader_load_desc_t* descs,
+  size_t num_descs,
+  const nshader_read_options_t* options,
+  nshader_load_id_t* out_ids) {
+
+  if (!loader || !descs) {
+    return 0;
+  }
+
+  // Reserve one id per desc so that io_uring completions can be reported directly
+  SDL_LockMutex(loader->mutex);
+  nshader_load_id_t first_id = loader->next_id;
+  loader->next_id += num_descs;
+  SDL_UnlockMutex(loader->mutex);
+
+  if (nshader_uring_load_bulk(descs, num_descs, options, first_id)) {
+    size_t num_queued = 0;
+    for (size_t i = 0; i < num_descs; ++i) {
+      bool valid = descs[i].path && descs[i].callback;
+      if (out_ids) {
+        out_ids[i] = valid ? first_id + i : 0;
+      }
+      num_queued += valid ? 1 : 0;
+    }
+    return num_queued;
+  }
+
+  size_t num_queued = nshader_load_async_batch(loader, descs, num_descs, options, out_ids);
+  nshader_loader_wait_idle(loader);
+  return num_queued;
+}
+
+// #############################################################################
+// Cancellation & lifetime
+// #############################################################################
+
+NSHADER_API bool nshader_load_cancel(nshader_loader_t* loader, nshader_load_id_t id) {
+  if (!loader || id == 0) {
+    return false;
+  }
+
+  // Only jobs in the path table still own their requests
+  load_request_t* found = NULL;
+  SDL_LockMutex(loader->mutex);
+  for (size_t i = 0; i < LOADER_HASH_BUCKETS && !found; ++i) {
+    for (load_job_t* job = loader->buckets[i]; job && !found; job = job->next_in_bucket) {
+      for (load_request_t** link = &job->requests; *link; link = &(*link)->next) {
+        if ((*link)->id == id) {
+          found = *link;
+          *link = found->next;
+          if (job->requests_tail == &found->next) {
+            job->requests_tail = link;
+          }
+          break;
+        }
+      }
+    }
+  }
+  SDL_UnlockMutex(loader->mutex);
+
+  if (!found) {
+    return false;
+  }
+
+  found->callback(found->user, found->id, NSHADER_LOAD_STATUS_CANCELED, NULL);
+  nshader_free(found);
+  return true;
+}
+
+NSHADER_API void nshader_loader_wait_idle(nshader_loader_t* loader) {
+  if (!loader) {
+    return;
+  }
+
+  SDL_LockMutex(loader->mutex);
+  while (loader->num_jobs > 0) {
+    SDL_WaitCondition(loader->idle_cond, loader->mutex);
+  }
+  SDL_UnlockMutex(loader->mutex);
+}
+
+NSHADER_API nshader_loader_t* nshader_loader_create(const nshader_loader_config_t* config) {
+  nshader_loader_t* loader = (nshader_loader_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, 1, sizeof(nshader_loader_t));
+  if (!loader) {
+    return NULL;
+  }
+
+  loader->next_id = 1;
+  loader->mutex = SDL_CreateMutex();
+  loader->work_cond = SDL_CreateCondition();
+  loader->idle_cond = SDL_CreateCondition();
+  if (!loader->mutex || !loader->work_cond || !loader->idle_cond) {
+    nshader_loader_destroy(loader);
+    return NULL;
+  }
+
+  if (config && config->job_system && config->job_system->submit) {
+    loader->job_system = *config->job_system;
+    loader->use_job_system = true;
+    return loader;
+  }
+
+  uint32_t num_threads = config ? config->num_threads : 0;
+  if (num_threads == 0) {
+    int num_cores = SDL_GetNumLogicalCPUCores();
+    num_threads = num_cores > 0 ? (uint32_t)num_cores : 1;
+    if (num_threads > LOADER_MAX_DEFAULT_THREADS) {
+      num_threads = LOADER_MAX_DEFAULT_THREADS;
+    }
+  }
+
+  loader->threads = (SDL_Thread**)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, num_threads, sizeof(SDL_Thread*));
+  if (!loader->threads) {
+    nshader_loader_destroy(loader);
+    return NULL;
+  }
+
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    loader->threads[i] = SDL_CreateThread(worker_main, "nshader_loader", loader);
+    if (!loader->threads[i]) {
+      nshader_loader_destroy(loader);
+      return NULL;
+    }
+    loader->num_threads++;
+  }
+
+  return loader;
+}
+
+NSHADER_API void nshader_loader_destroy(nshader_loader_t* loader) {
+  if (!loader) {
+    return;
+  }
+
+  if (loader->mutex) {
+    // Cancel every request that has not been delivered yet
+    load_request_t* canceled = NULL;
+    SDL_LockMutex(loader->mutex);
+    for (size_t i = 0; i < LOADER_HASH_BUCKETS; ++i) {
+      for (load_job_t* job = loader->buckets[i]; job; job = job->next_in_bucket) {
+        while (job->requests) {
+          load_request_t* request = job->requests;
+          job->requests = request->next;
+          request->next = canceled;
+          canceled = request;
+        }
+        job->requests_tail = &job->requests;
+      }
+    }
+    SDL_UnlockMutex(loader->mutex);
+
+    while (canceled) {
+      load_request_t* request = canceled;
+      canceled = request->next;
+      request->callback(request->user, request->id, NSHADER_LOAD_STATUS_CANCELED, NULL);
+      nshader_free(request);
+    }
+
+    if (loader->idle_cond) {
+      nshader_loader_wait_idle(loader);
+    }
+
+    SDL_LockMutex(loader->mutex);
+    loader->quit = true;
+    if (loader->work_cond) {
+      SDL_BroadcastCondition(loader->work_cond);
+    }
+    SDL_UnlockMutex(loader->mutex);
+  }
+
+  for (uint32_t i = 0; i < loader->num_threads; ++i) {
+    SDL_WaitThread(loader->threads[i], NULL);
+  }
+  nshader_free(loader->threads);
+
+  if (loader->idle_cond) {
+    SDL_DestroyCondition(loader->idle_cond);
+  }
+  if (loader->work_cond) {
+    SDL_DestroyCondition(loader->work_cond);
+  }
+  if (loader->mutex) {
+    SDL_DestroyMutex(loader->mutex);
+  }
+  nshader_free(loader);
+}
@@ -0,0 +1,498 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <nshader/nshader_patch.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_type_internal.h"
+#include "nshader_base_internal.h"
+#include "nshader_format_internal.h"
+#include <string.h>
+
+// What the patch stores for one stage and backend
+typedef enum patch_blob_op_t {
+  PATCH_BLOB_NONE,     // The new shader has no blob
+  PATCH_BLOB_KEEP,     // The old blob is unchanged
+  PATCH_BLOB_LITERAL,  // u32 size, then the blob
+  PATCH_BLOB_DELTA,    // u32 size, then delta operations up to PATCH_DELTA_END
+} patch_blob_op_t;
+
+typedef enum patch_delta_op_t {
+  PATCH_DELTA_END,
+  PATCH_DELTA_COPY,    // u32 offset and u32 length in the old blob
+  PATCH_DELTA_INSERT,  // u32 length, then the bytes
+} patch_delta_op_t;
+
+// Old blobs are indexed in blocks of this size, shorter matches are not used
+#define PATCH_BLOCK_SIZE 16
+#define PATCH_HASH_PRIME 0x01000193u
+
+// #############################################################################
+// Diff
+// #############################################################################
+
+// Patch output, to a stream, a buffer, or counting only when both are NULL
+typedef struct patch_writer_t {
+  const nshader_io_t* io;
+  uint8_t* buffer;
+  size_t capacity;
+  size_t written;
+} patch_writer_t;
+
+static bool patch_write(patch_writer_t* writer, const void* data, size_t size) {
+  if (writer->io) {
+    if (size > 0 && writer->io->write(writer->io->user, data, size) != size) {
+      return false;
+    }
+  } else if (writer->buffer) {
+    if (size > writer->capacity - writer->written) {
+      return false;
+    }
+    memcpy(writer->buffer + writer->written, data, size);
+  }
+  writer->written += size;
+  return true;
+}
+
+static bool patch_write_u8(patch_writer_t* writer, uint8_t value) {
+  return patch_write(writer, &value, sizeof(value));
+}
+
+static bool patch_write_u32(patch_writer_t* writer, uint32_t value) {
+  value = nshader_le32(value);
+  return patch_write(writer, &value, sizeof(value));
+}
+
+static bool patch_write_u64(patch_writer_t* writer, uint64_t value) {
+  value = nshader_le64(value);
+  return patch_write(writer, &value, sizeof(value));
+}
+
+// Growable buffer the delta of one blob is encoded into
+typedef struct delta_buffer_t {
+  uint8_t* data;
+  size_t size;
+  size_t capacity;
+  bool failed;
+} delta_buffer_t;
+
+static void delta_append(delta_buffer_t* buffer, const void* data, size_t size) {
+  if (buffer->failed) {
+    return;
+  }
+  if (size > buffer->capacity - buffer->size) {
+    size_t capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+    while (capacity - buffer->size < size) {
+      capacity *= 2;
+    }
+    uint8_t* grown = (uint8_t*)nshader_realloc_tagged(NSHADER_ALLOC_TAG_PATCH, buffer->data, capacity);
+    if (!grown) {
+      buffer->failed = true;
+      return;
+    }
+    buffer->data = grown;
+    buffer->capacity = capacity;
+  }
+  memcpy(buffer->data + buffer->size, data, size);
+  buffer->size += size;
+}
+
+static void delta_append_op(delta_buffer_t* buffer, patch_delta_op_t op, uint32_t a, uint32_t b, bool has_b) {
+  uint8_t code = (uint8_t)op;
+  delta_append(buffer, &code, sizeof(code));
+  uint32_t value = nshader_le32(a);
+  delta_append(buffer, &value, sizeof(value));
+  if (has_b) {
+    value = nshader_le32(b);
+    delta_append(buffer, &value, sizeof(value));
+  }
+}
+
+static void delta_insert(delta_buffer_t* buffer, const uint8_t* data, size_t size) {
+  if (size > 0) {
+    delta_append_op(buffer, PATCH_DELTA_INSERT, (uint32_t)size, 0, false);
+    delta_append(buffer, data, size);
+  }
+}
+
+static uint32_t block_hash(const uint8_t* data) {
+  uint32_t hash = 0;
+  for (size_t i = 0; i < PATCH_BLOCK_SIZE; i++) {
+    hash = hash * PATCH_HASH_PRIME + data[i];
+  }
+  return hash;
+}
+
+// Block of the old blob in the open-addressing index, offset + 1 (0 is empty)
+typedef struct delta_slot_t {
+  uint32_t hash;
+  uint32_t offset;
+} delta_slot_t;
+
+// Encode new_data as copies from old_data and inserted bytes. Old blocks are
+// indexed at block-aligned offsets, and a rolling hash looks them up at every
+// offset of the new data, so insertions and removals keep the rest matching.
+static bool encode_delta(const uint8_t* old_data, size_t old_size, const uint8_t* new_data, size_t new_size, delta_buffer_t* out) {
+  size_t num_blocks = old_size / PATCH_BLOCK_SIZE;
+  size_t table_size = 1;
+  while (table_size < num_blocks * 2) {
+    table_size <<= 1;
+  }
+  size_t mask = table_size - 1;
+  delta_slot_t* table = (delta_slot_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_PATCH, table_size, sizeof(delta_slot_t));
+  if (!table) {
+    return false;
+  }
+  for (size_t block = 0; block < num_blocks; block++) {
+    const uint8_t* data = old_data + block * PATCH_BLOCK_SIZE;
+    uint32_t hash = block_hash(data);
+    size_t i = hash & mask;
+    bool duplicate = false;
+    while (table[i].offset && !duplicate) {
+      duplicate = table[i].hash == hash && memcmp(old_data + table[i].offset - 1, data, PATCH_BLOCK_SIZE) == 0;
+      i = (i + 1) & mask;
+    }
+    if (!duplicate) {
+      table[i].hash = hash;
+      table[i].offset = (uint32_t)(block * PATCH_BLOCK_SIZE + 1);
+    }
+  }
+
+  // Weight of the byte leaving the window
+  uint32_t factor = 1;
+  for (size_t i = 1; i < PATCH_BLOCK_SIZE; i++) {
+    factor *= PATCH_HASH_PRIME;
+  }
+
+  size_t literal_start = 0;
+  size_t pos = 0;
+  uint32_t hash = 0;
+  bool has_hash = false;
+  while (num_blocks > 0 && pos + PATCH_BLOCK_SIZE <= new_size) {
+    if (!has_hash) {
+      hash = block_hash(new_data + pos);
+      has_hash = true;
+    }
+
+    size_t match = 0;
+    for (size_t i = hash & mask; table[i].offset; i = (i + 1) & mask) {
+      if (table[i].hash == hash && memcmp(old_data + table[i].offset - 1, new_data + pos, PATCH_BLOCK_SIZE) == 0) {
+        match = table[i].offset;
+        break;
+      }
+    }
+
+    if (match) {
+      // Extend the match both ways, backwards only into pending literal bytes
+      size_t offset = match - 1;
+      size_t start = pos;
+      size_t length = PATCH_BLOCK_SIZE;
+      while (start + length < new_size && offset + length < old_size && old_data[offset + length] == new_data[start + length]) {
+        length++;
+      }
+      while (start > literal_start && offset > 0 && old_data[offset - 1] == new_data[start - 1]) {
+        start--;
+        offset--;
+        length++;
+      }
+      delta_insert(out, new_data + literal_start, start - literal_start);
+      delta_append_op(out, PATCH_DELTA_COPY, (uint32_t)offset, (uint32_t)length, true);
+      pos = start + length;
+      literal_start = pos;
+      has_hash = false;
+      continue;
+    }
+
+    if (pos + PATCH_BLOCK_SIZE < new_size) {
+      hash = (hash - new_data[pos] * factor) * PATCH_HASH_PRIME + new_data[pos + PATCH_BLOCK_SIZE];
+    }
+    pos++;
+  }
+  delta_insert(out, new_data + literal_start, new_size - literal_start);
+  uint8_t end = PATCH_DELTA_END;
+  delta_append(out, &end, sizeof(end));
+
+  nshader_free(table);
+  return !out->failed;
+}
+
+static bool write_blob_op(const nshader_blob_t* old_blob, const nshader_blob_t* new_blob, patch_writer_t* writer) {
+  if (!new_blob || new_blob->size == 0) {
+    return patch_write_u8(writer, PATCH_BLOB_NONE);
+  }
+  if (old_blob && old_blob->size == new_blob->size && memcmp(old_blob->data, new_blob->data, new_blob->size) == 0) {
+    return patch_write_u8(writer, PATCH_BLOB_KEEP);
+  }
+
+  // Delta against the old blob, if it is smaller than the blob itself
+  if (old_blob && old_blob->size > 0) {
+    delta_buffer_t delta = {0};
+    if (!encode_delta(old_blob->data, old_blob->size, new_blob->data, new_blob->size, &delta)) {
+      nshader_free(delta.data);
+      return false;
+    }
+    if (delta.size < new_blob->size) {
+      bool result = patch_write_u8(writer, PATCH_BLOB_DELTA) &&
+                    patch_write_u32(writer, (uint32_t)new_blob->size) &&
+                    patch_write(writer, delta.data, delta.size);
+      nshader_free(delta.data);
+      return result;
+    }
+    nshader_free(delta.data);
+  }
+
+  return patch_write_u8(writer, PATCH_BLOB_LITERAL) &&
+         patch_write_u32(writer, (uint32_t)new_blob->size) &&
+         patch_write(writer, new_blob->data, new_blob->size);
+}
+
+static bool write_diff(const nshader_t* old_shader, const nshader_t* new_shader, patch_writer_t* writer) {
+  if (!old_shader || !new_shader || old_shader->skipped_blobs || new_shader->skipped_blobs) {
+    return false;
+  }
+  nshader_hash_t old_hash, new_hash;
+  if (!nshader_hash(old_shader, &old_hash) || !nshader_hash(new_shader, &new_hash)) {
+    return false;
+  }
+
+  // The metadata is the new shader written without blobs, with the hash of
+  // the full shader so the patched result can be checked
+  nshader_t view = *new_shader;
+  memset(view.blobs, 0, sizeof(view.blobs));
+  view.has_hash = true;
+  view.hash = new_hash;
+  size_t metadata_size = nshader_write_to_memory(&view, NULL, 0);
+  uint8_t* metadata = metadata_size ? (uint8_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_PATCH, metadata_size) : NULL;
+  if (!metadata) {
+    return false;
+  }
+  bool result = nshader_write_to_memory(&view, metadata, metadata_size) == metadata_size &&
+                patch_write_u32(writer, NSHADER_PATCH_MAGIC) &&
+                patch_write_u32(writer, NSHADER_PATCH_VERSION) &&
+                patch_write_u64(writer, old_hash.lo) &&
+                patch_write_u64(writer, old_hash.hi) &&
+                patch_write_u32(writer, (uint32_t)metadata_size) &&
+                patch_write(writer, metadata, metadata_size);
+  nshader_free(metadata);
+
+  for (size_t stage_idx = 0; result && stage_idx < NSHADER_STAGE_TYPE_COUNT; stage_idx++) {
+    for (size_t backend_idx = 0; result && backend_idx < NSHADER_BACKEND_COUNT; backend_idx++) {
+      const nshader_blob_t* old_blob = nshader_get_blob(old_shader, (nshader_stage_type_t)stage_idx, (nshader_backend_t)backend_idx);
+      const nshader_blob_t* new_blob = nshader_get_blob(new_shader, (nshader_stage_type_t)stage_idx, (nshader_backend_t)backend_idx);
+      result = write_blob_op(old_blob, new_blob, writer);
+    }
+  }
+  return result;
+}
+
+NSHADER_API size_t nshader_diff_to_memory(const nshader_t* old_shader, const nshader_t* new_shader, void* buffer, size_t buffer_size) {
+  patch_writer_t writer = {0};
+  writer.buffer = (uint8_t*)buffer;
+  writer.capacity = buffer_size;
+  return write_diff(old_shader, new_shader, &writer) ? writer.written : 0;
+}
+
+NSHADER_API bool nshader_diff_to_io(const nshader_t* old_shader, const nshader_t* new_shader, const nshader_io_t* io) {
+  if (!io || !io->write) {
+    return false;
+  }
+  patch_writer_t writer = {0};
+  writer.io = io;
+  return write_diff(old_shader, new_shader, &writer);
+}
+
+// #############################################################################
+// Patch
+// #############################################################################
+
+typedef struct patch_reader_t {
+  const uint8_t* data;
+  size_t remaining;
+} patch_reader_t;
+
+static const uint8_t* patch_read(patch_reader_t* reader, size_t size) {
+  if (size > reader->remaining) {
+    return NULL;
+  }
+  const uint8_t* data = reader->data;
+  reader->data += size;
+  reader->remaining -= size;
+  return data;
+}
+
+static bool patch_read_u8(patch_reader_t* reader, uint8_t* out_value) {
+  const uint8_t* data = patch_read(reader, sizeof(*out_value));
+  if (!data) return false;
+  *out_value = *data;
+  return true;
+}
+
+static bool patch_read_u32(patch_reader_t* reader, uint32_t* out_value) {
+  const uint8_t* data = patch_read(reader, sizeof(*out_value));
+  if (!data) return false;
+  memcpy(out_value, data, sizeof(*out_value));
+  *out_value = nshader_le32(*out_value);
+  return true;
+}
+
+static bool patch_read_u64(patch_reader_t* reader, uint64_t* out_value) {
+  const uint8_t* data = patch_read(reader, sizeof(*out_value));
+  if (!data) return false;
+  memcpy(out_value, data, sizeof(*out_value));
+  *out_value = nshader_le64(*out_value);
+  return true;
+}
+
+// Allocate an owned blob of size bytes for a stage and backend
+static uint8_t* add_blob(nshader_t* shader, size_t stage_idx, size_t backend_idx, size_t size) {
+  if (size == 0) {
+    return NULL;
+  }
+  nshader_blob_t* blob = (nshader_blob_t*)nshader_allocator_calloc(&shader->allocator, shader->blob_tag, 1, sizeof(nshader_blob_t), _Alignof(nshader_blob_t));
+  if (!blob) {
+    return NULL;
+  }
+  uint8_t* data = (uint8_t*)nshader_allocator_alloc(&shader->allocator, shader->blob_tag, size, NSHADER_DEFAULT_BLOB_ALIGNMENT);
+  if (!data) {
+    nshader_allocator_free(&shader->allocator, shader->blob_tag, blob, sizeof(nshader_blob_t));
+    return NULL;
+  }
+  blob->data = data;
+  blob->size = size;
+  shader->blobs[stage_idx][backend_idx] = blob;
+  return data;
+}
+
+static bool apply_delta(const nshader_blob_t* old_blob, uint8_t* out, size_t out_size, patch_reader_t* reader) {
+  size_t written = 0;
+  for (;;) {
+    uint8_t op;
+    uint32_t a, b;
+    if (!patch_read_u8(reader, &op)) return false;
+    switch (op) {
+      case PATCH_DELTA_END:
+        return written == out_size;
+      case PATCH_DELTA_COPY:
+        if (!patch_read_u32(reader, &a) || !patch_read_u32(reader, &b)) return false;
+        if (a > old_blob->size || b > old_blob->size - a || b > out_size - written) return false;
+        memcpy(out + written, old_blob->data + a, b);
+        written += b;
+        break;
+      case PATCH_DELTA_INSERT: {
+        if (!patch_read_u32(reader, &a) || a > out_size - written) return false;
+        const uint8_t* data = patch_read(reader, a);
+        if (!data) return false;
+        memcpy(out + written, data, a);
+        written += a;
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
+static bool apply_blob_op(const nshader_t* old_shader, nshader_t* shader, size_t stage_idx, size_t backend_idx, patch_reader_t* reader) {
+  const nshader_blob_t* old_blob = nshader_get_blob(old_shader, (nshader_stage_type_t)stage_idx, (nshader_backend_t)backend_idx);
+  uint8_t op;
+  uint32_t size;
+  if (!patch_read_u8(reader, &op)) return false;
+  switch (op) {
+    case PATCH_BLOB_NONE:
+      return true;
+    case PATCH_BLOB_KEEP: {
+      if (!old_blob) return false;
+      uint8_t* data = add_blob(shader, stage_idx, backend_idx, old_blob->size);
+      if (!data) return false;
+      memcpy(data, old_blob->data, old_blob->size);
+      return true;
+    }
+    case PATCH_BLOB_LITERAL: {
+      if (!patch_read_u32(reader, &size)) return false;
+      const uint8_t* bytes = patch_read(reader, size);
+      uint8_t* data = bytes ? add_blob(shader, stage_idx, backend_idx, size) : NULL;
+      if (!data) return false;
+      memcpy(data, bytes, size);
+      return true;
+    }
+    case PATCH_BLOB_DELTA: {
+      if (!old_blob || !patch_read_u32(reader, &size)) return false;
+      uint8_t* data = add_blob(shader, stage_idx, backend_idx, size);
+      return data && apply_delta(old_blob, data, size, reader);
+    }
+    default:
+      return false;
+  }
+}
+
+NSHADER_API nshader_t* nshader_patch(const nshader_t* old_shader, const void* patch, size_t patch_size) {
+  if (!old_shader || !patch) {
+    return NULL;
+  }
+
+  patch_reader_t reader = {(const uint8_t*)patch, patch_size};
+  uint32_t magic, version, metadata_size;
+  nshader_hash_t recorded_hash, old_hash;
+  if (!patch_read_u32(&reader, &magic) || magic != NSHADER_PATCH_MAGIC ||
+      !patch_read_u32(&reader, &version) || version != NSHADER_PATCH_VERSION ||
+      !patch_read_u64(&reader, &recorded_hash.lo) || !patch_read_u64(&reader, &recorded_hash.hi) ||
+      !patch_read_u32(&reader, &metadata_size)) {
+    return NULL;
+  }
+
+  // The patch only applies to the shader it was created from
+  if (!nshader_hash(old_shader, &old_hash) || old_hash.lo != recorded_hash.lo || old_hash.hi != recorded_hash.hi) {
+    return NULL;
+  }
+
+  const uint8_t* metadata = patch_read(&reader, metadata_size);
+  nshader_t* shader = metadata ? nshader_read_from_memory(metadata, metadata_size) : NULL;
+  if (!shader || !shader->has_hash) {
+    nshader_destroy(shader);
+    return NULL;
+  }
+
+  bool result = true;
+  for (size_t stage_idx = 0; result && stage_idx < NSHADER_STAGE_TYPE_COUNT; stage_idx++) {
+    for (size_t backend_idx = 0; result && backend_idx < NSHADER_BACKEND_COUNT; backend_idx++) {
+      result = apply_blob_op(old_shader, shader, stage_idx, backend_idx, &reader);
+    }
+  }
+
+  // Hash what was rebuilt and compare it with the hash of the new shader
+  if (result && reader.remaining == 0) {
+    nshader_hash_t expected = shader->hash;
+    nshader_hash_t actual;
+    shader->has_hash = false;
+    result = nshader_hash(shader, &actual) && actual.lo == expected.lo && actual.hi == expected.hi;
+    shader->has_hash = true;
+  } else {
+    result = false;
+  }
+
+  if (!result) {
+    nshader_destroy(shader);
+    return NULL;
+  }
+  return shader;
+}
@@ -24,110 +24,234 @@ SOFTWARE.
 
 #include <nshader/nshader_reader.h>
 #include "nshader_type_internal.h"
+#include "nshader_base_internal.h"
+#include "nshader_format_internal.h"
+#include "nshader_checksum_internal.h"
 #include <nshader/nshader_base.h>
 #include <string.h>
 
-// Endianness conversion helpers - always read as little-endian
-static uint32_t from_le32(uint32_t val) {
-#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-  return ((val & 0xFF000000) >> 24) |
-         ((val & 0x00FF0000) >> 8)  |
-         ((val & 0x0000FF00) << 8)  |
-         ((val & 0x000000FF) << 24);
-#else
-  return val;  // Already little-endian
-#endif
+// Source of serialized bytes, either a memory buffer or an nshader_io_t stream
+typedef struct reader_t {
+  const uint8_t* data;     // Memory source, NULL when reading from io
+  const nshader_io_t* io;  // Stream source
+  bool bounded;            // remaining is known
+  size_t remaining;        // Bytes left in the source
+  size_t offset;           // Bytes consumed since the start of the shader
+  bool checksum;           // Accumulate crc over every byte read
+  uint32_t crc;            // CRC-32C of the bytes read while checksum was set
+  bool string_table;       // Names are read as indices into strings
+  char* const* strings;
+  size_t num_strings;
+  nshader_string_pool_t* string_pool;  // Pool names are interned in, if any
+} reader_t;
+
+static bool reader_has(const reader_t* reader, size_t size) {
+  return !reader->bounded || reader->remaining >= size;
 }
 
-// Helper to read data from buffer with bounds checking
-static bool read_data(void* data, size_t size, const void** buffer, size_t* remaining) {
-  if (*remaining < size) {
+// Helper to read data with bounds checking
+static bool read_data(void* data, size_t size, reader_t* reader) {
+  if (!reader_has(reader, size)) {
     return false;
   }
-  memcpy(data, *buffer, size);
-  *buffer = (const uint8_t*)*buffer + size;
-  *remaining -= size;
+  if (reader->data) {
+    memcpy(data, reader->data, size);
+    reader->data += size;
+  } else {
+    // Streams may return fewer bytes than requested
+    uint8_t* dst = (uint8_t*)data;
+    size_t left = size;
+    while (left > 0) {
+      size_t n = reader->io->read(reader->io->user, dst, left);
+      if (n == 0 || n > left) {
+        return false;
+      }
+      dst += n;
+      left -= n;
+    }
+  }
+  if (reader->checksum) {
+    reader->crc = nshader_crc32c(reader->crc, data, size);
+  }
+  if (reader->bounded) {
+    reader->remaining -= size;
+  }
+  reader->offset += size;
   return true;
 }
 
-// Helper macros for reading primitives (with endianness conversion)
-#define READ_U8(val) do { uint8_t tmp; if (!read_data(&tmp, sizeof(tmp), &buffer, &remaining)) goto error; (val) = tmp; } while(0)
-#define READ_U32(val) do { uint32_t tmp; if (!read_data(&tmp, sizeof(tmp), &buffer, &remaining)) goto error; (val) = from_le32(tmp); } while(0)
-#define READ_BYTES(ptr, len) do { if (!read_data((ptr), (len), &buffer, &remaining)) goto error; } while(0)
+static bool skip_data(size_t size, reader_t* reader) {
+  if (!reader_has(reader, size)) {
+    return false;
+  }
+  if (reader->data) {
+    reader->data += size;
+  } else if (reader->io->seek) {
+    if (reader->io->seek(reader->io->user, (int64_t)size, NSHADER_IO_SEEK_CUR) < 0) {
+      return false;
+    }
+  } else {
+    // Streams without seek are skipped through a scratch buffer
+    uint8_t scratch[256];
+    while (size > 0) {
+      size_t chunk = size < sizeof(scratch) ? size : sizeof(scratch);
+      if (!read_data(scratch, chunk, reader)) {
+        return false;
+      }
+      size -= chunk;
+    }
+    return true;
+  }
+  if (reader->bounded) {
+    reader->remaining -= size;
+  }
+  reader->offset += size;
+  return true;
+}
 
-static char* read_string(const void** buffer, size_t* remaining) {
-  uint32_t len_le;
-  if (!read_data(&len_le, sizeof(len_le), buffer, remaining)) return NULL;
-  uint32_t len = from_le32(len_le);
+// Largest piece allocated from a stream of unknown size before its bytes arrived
+#define READER_STREAM_CHUNK_SIZE ((size_t)1 << 20)
 
-  if (len == 0) {
-    // Allocate empty string instead of returning NULL
-    char* str = (char*)nshader_malloc(1);
-    if (!str) return NULL;
-    str[0] = '\0';
-    return str;
+// Read size bytes into a new allocation of alloc_size bytes. A stream of
+// unknown size may end long before a corrupt size, so large payloads of such
+// streams are staged in chunks and only allocated in full once they arrived.
+static void* read_allocated(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, size_t size, size_t alloc_size, size_t alignment, reader_t* reader) {
+  if (!reader_has(reader, size)) {
+    return NULL;
   }
 
-  char* str = (char*)nshader_malloc(len + 1);
-  if (!str) {
+  if (reader->bounded || size <= READER_STREAM_CHUNK_SIZE) {
+    void* data = nshader_allocator_alloc(allocator, tag, alloc_size, alignment);
+    if (data && !read_data(data, size, reader)) {
+      nshader_allocator_free(allocator, tag, data, alloc_size);
+      return NULL;
+    }
+    return data;
+  }
+
+  size_t num_chunks = (size + READER_STREAM_CHUNK_SIZE - 1) / READER_STREAM_CHUNK_SIZE;
+  uint8_t** chunks = (uint8_t**)nshader_allocator_calloc(allocator, tag, num_chunks, sizeof(uint8_t*), _Alignof(uint8_t*));
+  if (!chunks) {
     return NULL;
   }
+  bool ok = true;
+  for (size_t i = 0; i < num_chunks && ok; i++) {
+    size_t chunk_size = i + 1 < num_chunks ? READER_STREAM_CHUNK_SIZE : size - i * READER_STREAM_CHUNK_SIZE;
+    chunks[i] = (uint8_t*)nshader_allocator_alloc(allocator, tag, chunk_size, 1);
+    ok = chunks[i] && read_data(chunks[i], chunk_size, reader);
+  }
+
+  uint8_t* data = ok ? (uint8_t*)nshader_allocator_alloc(allocator, tag, alloc_size, alignment) : NULL;
+  for (size_t i = 0; i < num_chunks && chunks[i]; i++) {
+    size_t chunk_size = i + 1 < num_chunks ? READER_STREAM_CHUNK_SIZE : size - i * READER_STREAM_CHUNK_SIZE;
+    if (data) {
+      memcpy(data + i * READER_STREAM_CHUNK_SIZE, chunks[i], chunk_size);
+    }
+    nshader_allocator_free(allocator, tag, chunks[i], chunk_size);
+  }
+  nshader_allocator_free(allocator, tag, chunks, num_chunks * sizeof(uint8_t*));
+  return data;
+}
+
+static const nshader_allocator_t* read_options_allocator(const nshader_read_options_t* options) {
+  if (options && options->allocator) {
+    return options->allocator;
+  }
+  return nshader_default_allocator();
+}
+
+// Helper macros for reading primitives (with endianness conversion)
+#define READ_U8(val) do { uint8_t tmp; if (!read_data(&tmp, sizeof(tmp), reader)) goto error; (val) = tmp; } while(0)
+#define READ_U32(val) do { uint32_t tmp; if (!read_data(&tmp, sizeof(tmp), reader)) goto error; (val) = nshader_le32(tmp); } while(0)
+#define READ_U64(val) do { uint64_t tmp; if (!read_data(&tmp, sizeof(tmp), reader)) goto error; (val) = nshader_le64(tmp); } while(0)
+#define READ_BYTES(ptr, len) do { if (!read_data((ptr), (len), reader)) goto error; } while(0)
+
+static char* read_string(const nshader_allocator_t* allocator, reader_t* reader) {
+  uint32_t len_le;
+  if (!read_data(&len_le, sizeof(len_le), reader)) return NULL;
+  uint32_t len = nshader_le32(len_le);
 
-  if (!read_data(str, len, buffer, remaining)) {
-    nshader_free(str);
+  char* str = (char*)read_allocated(allocator, NSHADER_ALLOC_TAG_READER_METADATA, len, (size_t)len + 1, 1, reader);
+  if (!str) {
     return NULL;
   }
   str[len] = '\0';
+
+  // Strings are freed with strlen() + 1, so embedded terminators are rejected
+  if (memchr(str, '\0', len)) {
+    nshader_allocator_free(allocator, NSHADER_ALLOC_TAG_READER_METADATA, str, (size_t)len + 1);
+    return NULL;
+  }
   return str;
 }
 
-static bool read_binding(nshader_stage_binding_t* binding, const void** buffer, size_t* remaining) {
+// Read an entry point or binding name, owned by the shader unless it comes
+// from the string table or the string pool
+static char* read_name(const nshader_allocator_t* allocator, reader_t* reader) {
+  if (reader->string_table) {
+    uint32_t index;
+    if (!read_data(&index, sizeof(index), reader)) return NULL;
+    index = nshader_le32(index);
+    return index < reader->num_strings ? reader->strings[index] : NULL;
+  }
+
+  char* str = read_string(allocator, reader);
+  if (str && reader->string_pool) {
+    char* interned = (char*)nshader_string_pool_intern(reader->string_pool, str);
+    nshader_allocator_free_string(allocator, NSHADER_ALLOC_TAG_READER_METADATA, str);
+    return interned;
+  }
+  return str;
+}
+
+// Bindings read so far are freed by nshader_destroy() on failure
+static bool read_binding(const nshader_allocator_t* allocator, nshader_stage_binding_t* binding, reader_t* reader) {
   uint32_t tmp;
-  binding->name = read_string(buffer, remaining);
+  binding->name = read_name(allocator, reader);
   if (!binding->name) goto error;
-  if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error;
-  binding->location = from_le32(tmp);
-  if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error;
-  binding->vector_size = from_le32(tmp);
-  if (!read_data(&binding->type, sizeof(binding->type), buffer, remaining)) goto error;
+  if (!read_data(&tmp, sizeof(tmp), reader)) goto error;
+  binding->location = nshader_le32(tmp);
+  if (!read_data(&tmp, sizeof(tmp), reader)) goto error;
+  binding->vector_size = nshader_le32(tmp);
+  if (!read_data(&tmp, sizeof(tmp), reader)) goto error;
+  if (nshader_le32(tmp) >= NSHADER_BINDING_TYPE_COUNT) goto error;
+  binding->type = (nshader_binding_type_t)nshader_le32(tmp);
   return true;
 
 error:
-  if (binding->name) {
-    nshader_free(binding->name);
-    binding->name = NULL;
-  }
   return false;
 }
 
-static bool read_stage_metadata(nshader_stage_type_t stage_type, nshader_stage_metadata_t* metadata, const void** buffer, size_t* remaining) {
+static bool read_stage_metadata(const nshader_allocator_t* allocator, nshader_stage_type_t stage_type, nshader_stage_metadata_t* metadata, reader_t* reader) {
   uint32_t tmp;
   switch (stage_type) {
     case NSHADER_STAGE_TYPE_VERTEX: {
       nshader_stage_metadata_vertex_t* vert = &metadata->vertex;
       uint32_t input_count, output_count;
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; vert->num_samplers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; vert->num_storage_textures = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; vert->num_storage_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; vert->num_uniform_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; input_count = from_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; vert->num_samplers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; vert->num_storage_textures = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; vert->num_storage_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; vert->num_uniform_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; input_count = nshader_le32(tmp);
+      if (!nshader_is_valid_binding_count(input_count, reader->bounded, reader->remaining)) goto error;
       vert->input_count = input_count;
 
       if (vert->input_count > 0) {
-        vert->inputs = (nshader_stage_binding_t*)nshader_calloc(vert->input_count, sizeof(nshader_stage_binding_t));
+        vert->inputs = (nshader_stage_binding_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_READER_METADATA, vert->input_count, sizeof(nshader_stage_binding_t), _Alignof(nshader_stage_binding_t));
         if (!vert->inputs) goto error;
         for (size_t i = 0; i < vert->input_count; i++) {
-          if (!read_binding(&vert->inputs[i], buffer, remaining)) goto error;
+          if (!read_binding(allocator, &vert->inputs[i], reader)) goto error;
         }
       }
 
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; output_count = from_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; output_count = nshader_le32(tmp);
+      if (!nshader_is_valid_binding_count(output_count, reader->bounded, reader->remaining)) goto error;
       vert->output_count = output_count;
       if (vert->output_count > 0) {
-        vert->outputs = (nshader_stage_binding_t*)nshader_calloc(vert->output_count, sizeof(nshader_stage_binding_t));
+        vert->outputs = (nshader_stage_binding_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_READER_METADATA, vert->output_count, sizeof(nshader_stage_binding_t), _Alignof(nshader_stage_binding_t));
         if (!vert->outputs) goto error;
         for (size_t i = 0; i < vert->output_count; i++) {
-          if (!read_binding(&vert->outputs[i], buffer, remaining)) goto error;
+          if (!read_binding(allocator, &vert->outputs[i], reader)) goto error;
         }
       }
       break;
@@ -135,43 +259,45 @@ static bool read_stage_metadata(nshader_stage_type_t stage_type, nshader_stage_m
     case NSHADER_STAGE_TYPE_FRAGMENT: {
       nshader_stage_metadata_fragment_t* frag = &metadata->fragment;
       uint32_t input_count, output_count;
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; frag->num_samplers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; frag->num_storage_textures = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; frag->num_storage_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; frag->num_uniform_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; input_count = from_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; frag->num_samplers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; frag->num_storage_textures = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; frag->num_storage_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; frag->num_uniform_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; input_count = nshader_le32(tmp);
+      if (!nshader_is_valid_binding_count(input_count, reader->bounded, reader->remaining)) goto error;
       frag->input_count = input_count;
 
       if (frag->input_count > 0) {
-        frag->inputs = (nshader_stage_binding_t*)nshader_calloc(frag->input_count, sizeof(nshader_stage_binding_t));
+        frag->inputs = (nshader_stage_binding_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_READER_METADATA, frag->input_count, sizeof(nshader_stage_binding_t), _Alignof(nshader_stage_binding_t));
         if (!frag->inputs) goto error;
         for (size_t i = 0; i < frag->input_count; i++) {
-          if (!read_binding(&frag->inputs[i], buffer, remaining)) goto error;
+          if (!read_binding(allocator, &frag->inputs[i], reader)) goto error;
         }
       }
 
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; output_count = from_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; output_count = nshader_le32(tmp);
+      if (!nshader_is_valid_binding_count(output_count, reader->bounded, reader->remaining)) goto error;
       frag->output_count = output_count;
       if (frag->output_count > 0) {
-        frag->outputs = (nshader_stage_binding_t*)nshader_calloc(frag->output_count, sizeof(nshader_stage_binding_t));
+        frag->outputs = (nshader_stage_binding_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_READER_METADATA, frag->output_count, sizeof(nshader_stage_binding_t), _Alignof(nshader_stage_binding_t));
         if (!frag->outputs) goto error;
         for (size_t i = 0; i < frag->output_count; i++) {
-          if (!read_binding(&frag->outputs[i], buffer, remaining)) goto error;
+          if (!read_binding(allocator, &frag->outputs[i], reader)) goto error;
         }
       }
       break;
     }
     case NSHADER_STAGE_TYPE_COMPUTE: {
       nshader_stage_metadata_compute_t* comp = &metadata->compute;
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->num_samplers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->num_readonly_storage_textures = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->num_readonly_storage_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->num_readwrite_storage_textures = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->num_readwrite_storage_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->num_uniform_buffers = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->threadcount_x = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->threadcount_y = from_le32(tmp);
-      if (!read_data(&tmp, sizeof(tmp), buffer, remaining)) goto error; comp->threadcount_z = from_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->num_samplers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->num_readonly_storage_textures = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->num_readonly_storage_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->num_readwrite_storage_textures = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->num_readwrite_storage_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->num_uniform_buffers = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->threadcount_x = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->threadcount_y = nshader_le32(tmp);
+      if (!read_data(&tmp, sizeof(tmp), reader)) goto error; comp->threadcount_z = nshader_le32(tmp);
       break;
     }
     default:
@@ -184,13 +310,26 @@ error:
 }
 
 NSHADER_API nshader_t* nshader_read_from_memory(const void* buffer, size_t buffer_size) {
-  if (!buffer || buffer_size == 0) {
+  return nshader_read_from_memory_ex(buffer, buffer_size, NULL);
+}
+
+static nshader_t* read_shader(reader_t* reader, const nshader_read_options_t* options) {
+  const nshader_allocator_t* allocator = read_options_allocator(options);
+  uint32_t memory_alignment = options && options->blob_alignment ? options->blob_alignment : NSHADER_DEFAULT_BLOB_ALIGNMENT;
+  bool borrow_blobs = options && options->borrow_blobs && reader->data;
+  nshader_verify_mode_t verify = options ? options->verify : NSHADER_VERIFY_NONE;
+  uint32_t backend_mask = options && options->backend_mask ? options->backend_mask : UINT32_MAX;
+  bool skip_blobs = options && options->skip_blobs;
+  if (!nshader_is_valid_blob_alignment(memory_alignment)) {
     return NULL;
   }
 
-  size_t remaining = buffer_size;
   nshader_t* shader = NULL;
 
+  // The metadata checksum covers everything up to the end of the backend list
+  reader->checksum = verify != NSHADER_VERIFY_NONE;
+  reader->crc = 0;
+
   // Read and validate header
   uint32_t magic, version;
   READ_U32(magic);
@@ -198,54 +337,132 @@ NSHADER_API nshader_t* nshader_read_from_memory(const void* buffer, size_t buffe
     goto error;
   }
   READ_U32(version);
-  if (version != NSHADER_VERSION) {
+  if (version < NSHADER_VERSION_MIN || version > NSHADER_VERSION) {
     goto error;
   }
 
+  // Version 1 has no flags and stores blobs unaligned
+  uint32_t flags = 0;
+  uint32_t file_alignment = 1;
+  if (version >= 2) {
+    READ_U32(flags);
+    READ_U32(file_alignment);
+    if ((flags & ~NSHADER_FORMAT_KNOWN_FLAGS) != 0 || !nshader_is_valid_blob_alignment(file_alignment)) {
+      goto error;
+    }
+  }
+  if ((flags & NSHADER_FORMAT_FLAG_CHECKSUMS) == 0) {
+    reader->checksum = false;
+  }
+
+  nshader_hash_t hash = {0};
+  if (flags & NSHADER_FORMAT_FLAG_HASH) {
+    READ_U64(hash.lo);
+    READ_U64(hash.hi);
+  }
+
   // Allocate shader
-  shader = (nshader_t*)nshader_calloc(1, sizeof(nshader_t));
+  shader = (nshader_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_SHADER, 1, sizeof(nshader_t), _Alignof(nshader_t));
   if (!shader) {
     goto error;
   }
+  shader->allocator = *allocator;
+  shader->metadata_tag = NSHADER_ALLOC_TAG_READER_METADATA;
+  shader->blob_tag = NSHADER_ALLOC_TAG_READER_BLOB;
+  shader->borrowed_blobs = borrow_blobs;
+  shader->has_hash = (flags & NSHADER_FORMAT_FLAG_HASH) != 0;
+  shader->skipped_blobs = skip_blobs;
+  shader->hash = hash;
+  shader->pooled_strings = options && options->string_pool;
+  allocator = &shader->allocator;
+  reader->string_pool = options ? options->string_pool : NULL;
+
+  // Read the string table, later names are indices into it
+  if (flags & NSHADER_FORMAT_FLAG_STRINGS) {
+    uint32_t num_strings;
+    READ_U32(num_strings);
+    if (!nshader_is_valid_string_count(num_strings, reader->bounded, reader->remaining)) goto error;
+    if (num_strings > 0) {
+      shader->strings = (char**)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_READER_METADATA, num_strings, sizeof(char*), _Alignof(char*));
+      if (!shader->strings) goto error;
+      shader->num_strings = num_strings;
+      for (size_t i = 0; i < shader->num_strings; i++) {
+        shader->strings[i] = read_name(allocator, reader);
+        if (!shader->strings[i]) goto error;
+      }
+    }
+    reader->string_table = true;
+    reader->strings = shader->strings;
+    reader->num_strings = shader->num_strings;
+  }
 
   // Read shader info
   nshader_info_t* info = &shader->info;
   uint32_t num_stages, num_backends;
-  READ_U8(info->type);
+  uint8_t shader_type;
+  READ_U8(shader_type);
+  if (shader_type >= NSHADER_SHADER_TYPE_COUNT) goto error;
+  info->type = (nshader_type_t)shader_type;
   READ_U32(num_stages);
+  if (num_stages > NSHADER_STAGE_TYPE_COUNT) goto error;
   info->num_stages = num_stages;
 
   // Read stages
   if (info->num_stages > 0) {
-    info->stages = (nshader_stage_t*)nshader_calloc(info->num_stages, sizeof(nshader_stage_t));
+    info->stages = (nshader_stage_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_SHADER, info->num_stages, sizeof(nshader_stage_t), _Alignof(nshader_stage_t));
     if (!info->stages) goto error;
 
     for (size_t i = 0; i < info->num_stages; i++) {
       nshader_stage_t* stage = &info->stages[i];
       READ_U8(stage->type);
 
-      char* entry_point = read_string(&buffer, &remaining);
+      char* entry_point = read_name(allocator, reader);
       if (!entry_point) goto error;
       stage->entry_point = entry_point;
 
-      if (!read_stage_metadata(stage->type, &stage->metadata, &buffer, &remaining)) {
+      if (!read_stage_metadata(allocator, stage->type, &stage->metadata, reader)) {
         goto error;
       }
     }
   }
 
-  // Read backends
+  // Read backends, keeping those selected by the backend mask
+  uint8_t backends[NSHADER_BACKEND_COUNT];
+  size_t num_kept_backends = 0;
   READ_U32(num_backends);
-  info->num_backends = num_backends;
-  if (info->num_backends > 0) {
-    info->backends = (nshader_backend_t*)nshader_calloc(info->num_backends, sizeof(nshader_backend_t));
+  if (num_backends > NSHADER_BACKEND_COUNT) goto error;
+  for (uint32_t i = 0; i < num_backends; i++) {
+    uint8_t backend;
+    READ_U8(backend);
+    if (backend >= NSHADER_BACKEND_COUNT) goto error;
+    if (backend_mask & (1u << backend)) {
+      backends[num_kept_backends++] = backend;
+    }
+  }
+  if (num_kept_backends > 0) {
+    info->backends = (nshader_backend_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_SHADER, num_kept_backends, sizeof(nshader_backend_t), _Alignof(nshader_backend_t));
     if (!info->backends) goto error;
-
-    for (size_t i = 0; i < info->num_backends; i++) {
-      READ_U8(info->backends[i]);
+    info->num_backends = num_kept_backends;
+    for (size_t i = 0; i < num_kept_backends; i++) {
+      info->backends[i] = (nshader_backend_t)backends[i];
     }
   }
 
+  // The stored hash describes every backend, a filtered shader is hashed again on demand
+  if (num_kept_backends != num_backends) {
+    shader->has_hash = false;
+  }
+
+  bool checksums = (flags & NSHADER_FORMAT_FLAG_CHECKSUMS) != 0;
+  if (checksums) {
+    uint32_t computed_crc = reader->crc;
+    uint32_t stored_crc;
+    reader->checksum = false;
+    READ_U32(stored_crc);
+    if (verify != NSHADER_VERIFY_NONE && stored_crc != computed_crc) goto error;
+  }
+  reader->checksum = false;
+
   // Read blobs
   for (size_t stage_idx = 0; stage_idx < NSHADER_STAGE_TYPE_COUNT; stage_idx++) {
     for (size_t backend_idx = 0; backend_idx < NSHADER_BACKEND_COUNT; backend_idx++) {
@@ -253,22 +470,52 @@ NSHADER_API nshader_t* nshader_read_from_memory(const void* buffer, size_t buffe
       READ_U8(has_blob);
 
       if (has_blob) {
-        nshader_blob_t* blob = (nshader_blob_t*)nshader_malloc(sizeof(nshader_blob_t));
-        if (!blob) goto error;
-
-        uint32_t blob_size;
+        uint32_t blob_size, blob_crc = 0;
         READ_U32(blob_size);
-        blob->size = blob_size;
+        if (checksums) {
+          READ_U32(blob_crc);
+        }
 
-        uint8_t* data = (uint8_t*)nshader_malloc(blob->size);
-        if (!data) {
-          nshader_free(blob);
-          goto error;
+        // Skip padding up to the file alignment of the payload
+        if (!skip_data(nshader_align_padding(reader->offset, file_alignment), reader)) goto error;
+        if (!reader_has(reader, blob_size)) goto error;
+
+        // Blobs of filtered backends are skipped without being read
+        if ((backend_mask & (1u << backend_idx)) == 0) {
+          if (!skip_data(blob_size, reader)) goto error;
+          shader->has_hash = false;
+          continue;
+        }
+
+        // Metadata-only reads skip every payload, the stored hash still describes them
+        if (skip_blobs) {
+          if (!skip_data(blob_size, reader)) goto error;
+          shader->skipped_blob_sizes[stage_idx][backend_idx] = blob_size;
+          continue;
         }
 
-        READ_BYTES(data, blob->size);
-        blob->data = data;
+        nshader_blob_t* blob = (nshader_blob_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_READER_BLOB, 1, sizeof(nshader_blob_t), _Alignof(nshader_blob_t));
+        if (!blob) goto error;
         shader->blobs[stage_idx][backend_idx] = blob;
+
+        if (borrow_blobs) {
+          blob->data = reader->data;
+          blob->size = blob_size;
+          if (!skip_data(blob_size, reader)) goto error;
+        } else {
+          // Streams of known size read straight into the final allocation
+          uint8_t* data = (uint8_t*)read_allocated(allocator, NSHADER_ALLOC_TAG_READER_BLOB, blob_size, blob_size, memory_alignment, reader);
+          if (!data) goto error;
+          blob->data = data;
+          blob->size = blob_size;
+        }
+
+        if (checksums && verify == NSHADER_VERIFY_ON_LOAD) {
+          if (nshader_crc32c(0, blob->data, blob->size) != blob_crc) goto error;
+        } else if (checksums && verify == NSHADER_VERIFY_LAZY) {
+          shader->blob_crcs[stage_idx][backend_idx] = blob_crc;
+          SDL_SetAtomicInt(&shader->blob_checks[stage_idx][backend_idx], NSHADER_BLOB_CHECK_PENDING);
+        }
       }
     }
   }
@@ -282,42 +529,57 @@ error:
   return NULL;
 }
 
-NSHADER_API nshader_t* nshader_read_from_file(FILE* file) {
-  if (!file) {
+NSHADER_API nshader_t* nshader_read_from_memory_ex(const void* buffer, size_t buffer_size, const nshader_read_options_t* options) {
+  if (!buffer || buffer_size == 0) {
     return NULL;
   }
 
-  // Get file size
-  long start_pos = ftell(file);
-  if (fseek(file, 0, SEEK_END) != 0) {
-    return NULL;
-  }
-  long end_pos = ftell(file);
-  if (end_pos < 0 || fseek(file, start_pos, SEEK_SET) != 0) {
+  reader_t reader = {0};
+  reader.data = (const uint8_t*)buffer;
+  reader.bounded = true;
+  reader.remaining = buffer_size;
+  return read_shader(&reader, options);
+}
+
+NSHADER_API nshader_t* nshader_read_from_io(const nshader_io_t* io, const nshader_read_options_t* options) {
+  if (!io || !io->read) {
     return NULL;
   }
-  size_t size = (size_t)(end_pos - start_pos);
 
-  // Read file into buffer
-  void* buffer = nshader_malloc(size);
-  if (!buffer) {
-    return NULL;
+  reader_t reader = {0};
+  reader.io = io;
+
+  // Bound the parse by the stream size when it is known
+  if (io->seek && io->size) {
+    int64_t size = io->size(io->user);
+    int64_t pos = io->seek(io->user, 0, NSHADER_IO_SEEK_CUR);
+    if (size >= 0 && pos >= 0 && pos <= size) {
+      reader.bounded = true;
+      reader.remaining = (size_t)(size - pos);
+    }
   }
 
-  size_t read_size = fread(buffer, 1, size, file);
-  if (read_size != size) {
-    nshader_free(buffer);
+  return read_shader(&reader, options);
+}
+
+NSHADER_API nshader_t* nshader_read_from_file(FILE* file) {
+  return nshader_read_from_file_ex(file, NULL);
+}
+
+NSHADER_API nshader_t* nshader_read_from_file_ex(FILE* file, const nshader_read_options_t* options) {
+  if (!file) {
     return NULL;
   }
 
-  // Parse from memory
-  nshader_t* shader = nshader_read_from_memory(buffer, size);
-  nshader_free(buffer);
-
-  return shader;
+  nshader_io_t io = nshader_io_from_file(file);
+  return nshader_read_from_io(&io, options);
 }
 
 NSHADER_API nshader_t* nshader_read_from_path(const char* filepath) {
+  return nshader_read_from_path_ex(filepath, NULL);
+}
+
+NSHADER_API nshader_t* nshader_read_from_path_ex(const char* filepath, const nshader_read_options_t* options) {
   if (!filepath) {
     return NULL;
   }
@@ -327,44 +589,34 @@ NSHADER_API nshader_t* nshader_read_from_path(const char* filepath) {
     return NULL;
   }
 
-  nshader_t* shader = nshader_read_from_file(file);
+  nshader_t* shader = nshader_read_from_file_ex(file, options);
   fclose(file);
 
   return shader;
 }
 
-static void free_stage_metadata(nshader_stage_type_t stage_type, nshader_stage_metadata_t* metadata) {
+static void free_bindings(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, nshader_stage_binding_t* bindings, size_t count, bool owned_names) {
+  if (!bindings) {
+    return;
+  }
+  for (size_t i = 0; owned_names && i < count; i++) {
+    nshader_allocator_free_string(allocator, tag, bindings[i].name);
+  }
+  nshader_allocator_free(allocator, tag, bindings, count * sizeof(nshader_stage_binding_t));
+}
+
+static void free_stage_metadata(const nshader_allocator_t* allocator, nshader_alloc_tag_t tag, nshader_stage_type_t stage_type, nshader_stage_metadata_t* metadata, bool owned_names) {
   switch (stage_type) {
     case NSHADER_STAGE_TYPE_VERTEX: {
       nshader_stage_metadata_vertex_t* vert = &metadata->vertex;
-      if (vert->inputs) {
-        for (size_t i = 0; i < vert->input_count; i++) {
-          nshader_free(vert->inputs[i].name);
-        }
-        nshader_free(vert->inputs);
-      }
-      if (vert->outputs) {
-        for (size_t i = 0; i < vert->output_count; i++) {
-          nshader_free(vert->outputs[i].name);
-        }
-        nshader_free(vert->outputs);
-      }
+      free_bindings(allocator, tag, vert->inputs, vert->input_count, owned_names);
+      free_bindings(allocator, tag, vert->outputs, vert->output_count, owned_names);
       break;
     }
     case NSHADER_STAGE_TYPE_FRAGMENT: {
       nshader_stage_metadata_fragment_t* frag = &metadata->fragment;
-      if (frag->inputs) {
-        for (size_t i = 0; i < frag->input_count; i++) {
-          nshader_free(frag->inputs[i].name);
-        }
-        nshader_free(frag->inputs);
-      }
-      if (frag->outputs) {
-        for (size_t i = 0; i < frag->output_count; i++) {
-          nshader_free(frag->outputs[i].name);
-        }
-        nshader_free(frag->outputs);
-      }
+      free_bindings(allocator, tag, frag->inputs, frag->input_count, owned_names);
+      free_bindings(allocator, tag, frag->outputs, frag->output_count, owned_names);
       break;
     }
     case NSHADER_STAGE_TYPE_COMPUTE:
@@ -380,21 +632,34 @@ NSHADER_API void nshader_destroy(nshader_t* shader) {
     return;
   }
 
+  // Copy the allocator, the shader itself is freed through it last
+  nshader_allocator_t allocator = shader->allocator;
   nshader_info_t* info = &shader->info;
+  bool owned_names = !shader->strings && !shader->pooled_strings;
 
   // Free stages
   if (info->stages) {
     for (size_t i = 0; i < info->num_stages; i++) {
       nshader_stage_t* stage = &info->stages[i];
-      nshader_free((void*)stage->entry_point);
-      free_stage_metadata(stage->type, &stage->metadata);
+      if (owned_names) {
+        nshader_allocator_free_string(&allocator, shader->metadata_tag, (char*)stage->entry_point);
+      }
+      free_stage_metadata(&allocator, shader->metadata_tag, stage->type, &stage->metadata, owned_names);
     }
-    nshader_free(info->stages);
+    nshader_allocator_free(&allocator, NSHADER_ALLOC_TAG_SHADER, info->stages, info->num_stages * sizeof(nshader_stage_t));
+  }
+
+  // Free the string table, names above point into it
+  if (shader->strings) {
+    for (size_t i = 0; !shader->pooled_strings && i < shader->num_strings; i++) {
+      nshader_allocator_free_string(&allocator, shader->metadata_tag, shader->strings[i]);
+    }
+    nshader_allocator_free(&allocator, shader->metadata_tag, shader->strings, shader->num_strings * sizeof(char*));
   }
 
   // Free backends
   if (info->backends) {
-    nshader_free(info->backends);
+    nshader_allocator_free(&allocator, NSHADER_ALLOC_TAG_SHADER, info->backends, info->num_backends * sizeof(nshader_backend_t));
   }
 
   // Free blobs
@@ -402,11 +667,13 @@ NSHADER_API void nshader_destroy(nshader_t* shader) {
     for (size_t backend_idx = 0; backend_idx < NSHADER_BACKEND_COUNT; backend_idx++) {
       nshader_blob_t* blob = shader->blobs[stage_idx][backend_idx];
       if (blob) {
-        nshader_free((void*)blob->data);
-        nshader_free(blob);
+        if (!shader->borrowed_blobs) {
+          nshader_allocator_free(&allocator, shader->blob_tag, (void*)blob->data, blob->size);
+        }
+        nshader_allocator_free(&allocator, shader->blob_tag, blob, sizeof(nshader_blob_t));
       }
     }
   }
 
-  nshader_free(shader);
-}
\ No newline at end of file
+  nshader_allocator_free(&allocator, NSHADER_ALLOC_TAG_SHADER, shader, sizeof(nshader_t));
+}
@@ -26,6 +26,21 @@ SOFTWARE.
 #include <nshader/nshader_type.h>
 #include <nshader/nshader_info.h>
 #include "nshader_type_internal.h"
+#include "nshader_base_internal.h"
+#include "nshader_sdl3_gpu_internal.h"
+#include <SDL3/SDL.h>
+#include <limits.h>
+#include <string.h>
+
+// Limits of the vertex input state built on the stack, above what SDL_GPU
+// backends support
+#define MAX_VERTEX_ATTRIBUTES 32
+#define MAX_VERTEX_BUFFERS 32
+
+// Worker threads of a batch when the caller lets the library choose, and
+// the hard limit of the thread array on the stack
+#define BATCH_MAX_DEFAULT_THREADS 8
+#define BATCH_MAX_THREADS 64
 
 // Map nshader backend to SDL GPU shader format
 static SDL_GPUShaderFormat nshader_backend_to_sdl_format(nshader_backend_t backend) {
@@ -43,34 +58,115 @@ static SDL_GPUShaderFormat nshader_backend_to_sdl_format(nshader_backend_t backe
   }
 }
 
-// Select the best backend for the device
-static nshader_backend_t select_backend_for_device(SDL_GPUDevice* device, const nshader_t* shader) {
-  if (!device || !shader) {
-    return NSHADER_BACKEND_COUNT;
+// Preference used when the context config gives none
+static const nshader_backend_t g_default_backend_priority[] = {
+  NSHADER_BACKEND_DXIL,
+  NSHADER_BACKEND_SPV,
+  NSHADER_BACKEND_MSL,
+  NSHADER_BACKEND_DXBC
+};
+
+// Drivers whose shader and pipeline creation may run on several threads at once
+static const char* const g_parallel_drivers[] = {
+  "vulkan",
+  "direct3d12",
+  "metal"
+};
+
+// Default device functions, wrapped so that the table does not depend on the
+// calling convention of the SDL entry points
+static SDL_GPUShaderFormat sdl_get_shader_formats(SDL_GPUDevice* device) {
+  return SDL_GetGPUShaderFormats(device);
+}
+
+static const char* sdl_get_device_driver(SDL_GPUDevice* device) {
+  return SDL_GetGPUDeviceDriver(device);
+}
+
+static SDL_GPUShader* sdl_create_shader(SDL_GPUDevice* device, const SDL_GPUShaderCreateInfo* create_info) {
+  return SDL_CreateGPUShader(device, create_info);
+}
+
+static void sdl_release_shader(SDL_GPUDevice* device, SDL_GPUShader* shader) {
+  SDL_ReleaseGPUShader(device, shader);
+}
+
+static SDL_GPUComputePipeline* sdl_create_compute_pipeline(SDL_GPUDevice* device, const SDL_GPUComputePipelineCreateInfo* create_info) {
+  return SDL_CreateGPUComputePipeline(device, create_info);
+}
+
+static SDL_GPUGraphicsPipeline* sdl_create_graphics_pipeline(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* create_info) {
+  return SDL_CreateGPUGraphicsPipeline(device, create_info);
+}
+
+static void init_device_fns(nshader_sdl3_gpu_device_fns_t* fns, const nshader_sdl3_gpu_device_fns_t* overrides) {
+  if (overrides) {
+    *fns = *overrides;
+  } else {
+    memset(fns, 0, sizeof(*fns));
   }
+  if (!fns->get_shader_formats) fns->get_shader_formats = sdl_get_shader_formats;
+  if (!fns->get_device_driver) fns->get_device_driver = sdl_get_device_driver;
+  if (!fns->create_shader) fns->create_shader = sdl_create_shader;
+  if (!fns->release_shader) fns->release_shader = sdl_release_shader;
+  if (!fns->create_compute_pipeline) fns->create_compute_pipeline = sdl_create_compute_pipeline;
+  if (!fns->create_graphics_pipeline) fns->create_graphics_pipeline = sdl_create_graphics_pipeline;
+}
 
-  // Get supported shader formats from the device
-  SDL_GPUShaderFormat supported_formats = SDL_GetGPUShaderFormats(device);
+// Query the device once and resolve every possible selection up front
+static void init_context(nshader_sdl3_gpu_context_t* context, SDL_GPUDevice* device, const nshader_sdl3_gpu_context_config_t* config) {
+  const nshader_backend_t* priority = g_default_backend_priority;
+  size_t num_priority = sizeof(g_default_backend_priority) / sizeof(g_default_backend_priority[0]);
+  if (config && config->backend_priority) {
+    priority = config->backend_priority;
+    num_priority = config->num_backend_priority;
+  }
 
-  // Priority order: DXIL > SPV > MSL > DXBC
-  const nshader_backend_t backend_priority[] = {
-    NSHADER_BACKEND_DXIL,
-    NSHADER_BACKEND_SPV,
-    NSHADER_BACKEND_MSL,
-    NSHADER_BACKEND_DXBC
-  };
+  context->device = device;
+  init_device_fns(&context->fns, config ? config->device_fns : NULL);
+  context->backend_mask = 0;
+  SDL_GPUShaderFormat supported_formats = context->fns.get_shader_formats(device);
+  for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+    if (supported_formats & nshader_backend_to_sdl_format((nshader_backend_t)backend)) {
+      context->backend_mask |= 1u << backend;
+    }
+  }
 
-  // Find the first backend that is both supported by the device and available in the shader
-  for (size_t i = 0; i < sizeof(backend_priority) / sizeof(backend_priority[0]); i++) {
-    nshader_backend_t backend = backend_priority[i];
-    SDL_GPUShaderFormat format = nshader_backend_to_sdl_format(backend);
+  for (uint32_t shader_mask = 0; shader_mask < (1u << NSHADER_BACKEND_COUNT); shader_mask++) {
+    context->selection[shader_mask] = NSHADER_BACKEND_COUNT;
+    for (size_t i = 0; i < num_priority; i++) {
+      nshader_backend_t backend = priority[i];
+      if ((uint32_t)backend < NSHADER_BACKEND_COUNT && (context->backend_mask & shader_mask & (1u << backend))) {
+        context->selection[shader_mask] = (uint8_t)backend;
+        break;
+      }
+    }
+  }
 
-    if ((supported_formats & format) && nshader_has_backend(shader, backend)) {
-      return backend;
+  context->parallel_creation = false;
+  const char* driver = context->fns.get_device_driver(device);
+  for (size_t i = 0; driver && i < sizeof(g_parallel_drivers) / sizeof(g_parallel_drivers[0]); i++) {
+    if (strcmp(driver, g_parallel_drivers[i]) == 0) {
+      context->parallel_creation = true;
+      break;
     }
   }
+}
+
+// Select the best backend for the device, a table lookup on the shader's backends
+static nshader_backend_t select_backend(const nshader_sdl3_gpu_context_t* context, const nshader_t* shader) {
+  const nshader_info_t* info = nshader_get_info(shader);
+  if (!info) {
+    return NSHADER_BACKEND_COUNT;
+  }
 
-  return NSHADER_BACKEND_COUNT; // No compatible backend found
+  uint32_t shader_mask = 0;
+  for (size_t i = 0; i < info->num_backends; i++) {
+    if ((uint32_t)info->backends[i] < NSHADER_BACKEND_COUNT) {
+      shader_mask |= 1u << info->backends[i];
+    }
+  }
+  return (nshader_backend_t)context->selection[shader_mask];
 }
 
 // Get the stage metadata for a specific stage type
@@ -93,31 +189,12 @@ static const nshader_stage_t* get_stage(const nshader_t* shader, nshader_stage_t
   return NULL;
 }
 
-NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_create_shader(
-  SDL_GPUDevice* device,
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_create_stage_shader(
+  const nshader_sdl3_gpu_context_t* context,
   const nshader_t* shader,
-  nshader_stage_type_t stage_type)
+  nshader_stage_type_t stage_type,
+  nshader_backend_t backend)
 {
-  if (!device || !shader) {
-    return NULL;
-  }
-
-  // Validate stage type for graphics shaders
-  if (stage_type != NSHADER_STAGE_TYPE_VERTEX && stage_type != NSHADER_STAGE_TYPE_FRAGMENT) {
-    return NULL;
-  }
-
-  // Check if the shader has the requested stage
-  if (!nshader_has_stage(shader, stage_type)) {
-    return NULL;
-  }
-
-  // Select the appropriate backend
-  nshader_backend_t backend = select_backend_for_device(device, shader);
-  if (backend == NSHADER_BACKEND_COUNT) {
-    return NULL; // No compatible backend found
-  }
-
   // Get the shader blob for the selected backend and stage
   const nshader_blob_t* blob = nshader_get_blob(shader, stage_type, backend);
   if (!blob || !blob->data || blob->size == 0) {
@@ -158,44 +235,275 @@ NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_create_shader(
   create_info.props = 0;
 
   // Create the SDL GPU shader
-  return SDL_CreateGPUShader(device, &create_info);
+  return context->fns.create_shader(context->device, &create_info);
 }
 
-NSHADER_API SDL_GPUComputePipeline* nshader_sdl3_gpu_create_compute_pipeline(
-  SDL_GPUDevice* device,
-  const nshader_t* shader)
+static SDL_GPUShader* context_create_shader(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type)
+{
+  if (!shader) {
+    return NULL;
+  }
+
+  // Validate stage type for graphics shaders
+  if (stage_type != NSHADER_STAGE_TYPE_VERTEX && stage_type != NSHADER_STAGE_TYPE_FRAGMENT) {
+    return NULL;
+  }
+
+  // Check if the shader has the requested stage
+  if (!nshader_has_stage(shader, stage_type)) {
+    return NULL;
+  }
+
+  // Select the appropriate backend
+  nshader_backend_t backend = select_backend(context, shader);
+  if (backend == NSHADER_BACKEND_COUNT) {
+    return NULL; // No compatible backend found
+  }
+
+  return nshader_sdl3_gpu_create_stage_shader(context, shader, stage_type, backend);
+}
+
+NSHADER_API SDL_GPUVertexElementFormat nshader_sdl3_gpu_get_vertex_element_format(
+  nshader_binding_type_t type,
+  uint32_t vector_size)
+{
+  switch (type) {
+    case NSHADER_BINDING_TYPE_FLOAT32:
+      switch (vector_size) {
+        case 1: return SDL_GPU_VERTEXELEMENTFORMAT_FLOAT;
+        case 2: return SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2;
+        case 3: return SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3;
+        case 4: return SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4;
+        default: break;
+      }
+      break;
+    case NSHADER_BINDING_TYPE_INT32:
+      switch (vector_size) {
+        case 1: return SDL_GPU_VERTEXELEMENTFORMAT_INT;
+        case 2: return SDL_GPU_VERTEXELEMENTFORMAT_INT2;
+        case 3: return SDL_GPU_VERTEXELEMENTFORMAT_INT3;
+        case 4: return SDL_GPU_VERTEXELEMENTFORMAT_INT4;
+        default: break;
+      }
+      break;
+    case NSHADER_BINDING_TYPE_UINT32:
+      switch (vector_size) {
+        case 1: return SDL_GPU_VERTEXELEMENTFORMAT_UINT;
+        case 2: return SDL_GPU_VERTEXELEMENTFORMAT_UINT2;
+        case 3: return SDL_GPU_VERTEXELEMENTFORMAT_UINT3;
+        case 4: return SDL_GPU_VERTEXELEMENTFORMAT_UINT4;
+        default: break;
+      }
+      break;
+    case NSHADER_BINDING_TYPE_FLOAT16:
+      if (vector_size == 2) return SDL_GPU_VERTEXELEMENTFORMAT_HALF2;
+      if (vector_size == 4) return SDL_GPU_VERTEXELEMENTFORMAT_HALF4;
+      break;
+    case NSHADER_BINDING_TYPE_INT16:
+      if (vector_size == 2) return SDL_GPU_VERTEXELEMENTFORMAT_SHORT2;
+      if (vector_size == 4) return SDL_GPU_VERTEXELEMENTFORMAT_SHORT4;
+      break;
+    case NSHADER_BINDING_TYPE_UINT16:
+      if (vector_size == 2) return SDL_GPU_VERTEXELEMENTFORMAT_USHORT2;
+      if (vector_size == 4) return SDL_GPU_VERTEXELEMENTFORMAT_USHORT4;
+      break;
+    case NSHADER_BINDING_TYPE_INT8:
+      if (vector_size == 2) return SDL_GPU_VERTEXELEMENTFORMAT_BYTE2;
+      if (vector_size == 4) return SDL_GPU_VERTEXELEMENTFORMAT_BYTE4;
+      break;
+    case NSHADER_BINDING_TYPE_UINT8:
+      if (vector_size == 2) return SDL_GPU_VERTEXELEMENTFORMAT_UBYTE2;
+      if (vector_size == 4) return SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4;
+      break;
+    default:
+      break;
+  }
+  return SDL_GPU_VERTEXELEMENTFORMAT_INVALID;
+}
+
+// Size in bytes of one component of a vertex input type
+static uint32_t binding_type_size(nshader_binding_type_t type) {
+  switch (type) {
+    case NSHADER_BINDING_TYPE_INT8:
+    case NSHADER_BINDING_TYPE_UINT8:
+      return 1;
+    case NSHADER_BINDING_TYPE_INT16:
+    case NSHADER_BINDING_TYPE_UINT16:
+    case NSHADER_BINDING_TYPE_FLOAT16:
+      return 2;
+    case NSHADER_BINDING_TYPE_INT32:
+    case NSHADER_BINDING_TYPE_UINT32:
+    case NSHADER_BINDING_TYPE_FLOAT32:
+      return 4;
+    default:
+      return 8;
+  }
+}
+
+// Fill attributes and buffer descriptions from the reflected vertex inputs
+static bool build_vertex_input_state(
+  const nshader_stage_metadata_vertex_t* vert,
+  const nshader_sdl3_gpu_graphics_pipeline_desc_t* desc,
+  SDL_GPUVertexAttribute* attributes,
+  SDL_GPUVertexBufferDescription* buffers,
+  SDL_GPUVertexInputState* out_state)
 {
-  if (!device || !shader) {
+  if (vert->input_count > MAX_VERTEX_ATTRIBUTES) {
+    return false;
+  }
+
+  uint32_t pitches[MAX_VERTEX_BUFFERS] = {0};
+  uint32_t used_slots = 0;
+  uint32_t last_location = 0;
+
+  // Inputs are packed in location order, the stored order is sorted but
+  // shaders built in memory may not be
+  for (size_t n = 0; n < vert->input_count; n++) {
+    const nshader_stage_binding_t* input = NULL;
+    for (size_t i = 0; i < vert->input_count; i++) {
+      const nshader_stage_binding_t* candidate = &vert->inputs[i];
+      if (n > 0 && candidate->location <= last_location) continue;
+      if (!input || candidate->location < input->location) {
+        input = candidate;
+      }
+    }
+    if (!input) {
+      return false;  // Duplicate locations
+    }
+    last_location = input->location;
+
+    uint32_t slot = 0;
+    if (desc && desc->buffer_slots && input->location < desc->num_buffer_slots) {
+      slot = desc->buffer_slots[input->location];
+    }
+    SDL_GPUVertexElementFormat format = nshader_sdl3_gpu_get_vertex_element_format(input->type, input->vector_size);
+    if (slot >= MAX_VERTEX_BUFFERS || format == SDL_GPU_VERTEXELEMENTFORMAT_INVALID) {
+      return false;
+    }
+
+    SDL_GPUVertexAttribute* attribute = &attributes[n];
+    attribute->location = input->location;
+    attribute->buffer_slot = slot;
+    attribute->format = format;
+    attribute->offset = pitches[slot];
+    pitches[slot] += binding_type_size(input->type) * input->vector_size;
+    used_slots |= 1u << slot;
+  }
+
+  // One buffer description per slot that has attributes
+  uint32_t num_buffers = 0;
+  for (uint32_t slot = 0; slot < MAX_VERTEX_BUFFERS; slot++) {
+    if ((used_slots & (1u << slot)) == 0) continue;
+    SDL_GPUVertexBufferDescription* buffer = &buffers[num_buffers++];
+    buffer->slot = slot;
+    buffer->pitch = pitches[slot];
+    buffer->input_rate = desc && (desc->instance_slot_mask & (1u << slot))
+                         ? SDL_GPU_VERTEXINPUTRATE_INSTANCE
+                         : SDL_GPU_VERTEXINPUTRATE_VERTEX;
+    buffer->instance_step_rate = 0;
+  }
+
+  out_state->vertex_attributes = attributes;
+  out_state->num_vertex_attributes = (Uint32)vert->input_count;
+  out_state->vertex_buffer_descriptions = buffers;
+  out_state->num_vertex_buffers = num_buffers;
+  return true;
+}
+
+static SDL_GPUGraphicsPipeline* context_create_graphics_pipeline(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  const nshader_sdl3_gpu_graphics_pipeline_desc_t* desc)
+{
+  if (!shader) {
+    return NULL;
+  }
+
+  // Verify this is a graphics shader with both stages
+  const nshader_info_t* info = nshader_get_info(shader);
+  const nshader_stage_t* vertex_stage = get_stage(shader, NSHADER_STAGE_TYPE_VERTEX);
+  if (!info || info->type != NSHADER_SHADER_TYPE_GRAPHICS || !vertex_stage ||
+      !nshader_has_stage(shader, NSHADER_STAGE_TYPE_FRAGMENT)) {
     return NULL;
   }
 
+  // Derive the vertex input state before creating any GPU object
+  SDL_GPUVertexAttribute attributes[MAX_VERTEX_ATTRIBUTES];
+  SDL_GPUVertexBufferDescription buffers[MAX_VERTEX_BUFFERS];
+  SDL_GPUGraphicsPipelineCreateInfo create_info = {0};
+  if (desc) {
+    create_info = desc->pipeline;
+  }
+  if (!build_vertex_input_state(&vertex_stage->metadata.vertex, desc, attributes, buffers, &create_info.vertex_input_state)) {
+    return NULL;
+  }
+
+  // Both stages come from the same backend
+  nshader_backend_t backend = select_backend(context, shader);
+  if (backend == NSHADER_BACKEND_COUNT) {
+    return NULL; // No compatible backend found
+  }
+
+  SDL_GPUShader* vertex_shader = nshader_sdl3_gpu_create_stage_shader(context, shader, NSHADER_STAGE_TYPE_VERTEX, backend);
+  SDL_GPUShader* fragment_shader = nshader_sdl3_gpu_create_stage_shader(context, shader, NSHADER_STAGE_TYPE_FRAGMENT, backend);
+  SDL_GPUGraphicsPipeline* pipeline = NULL;
+  if (vertex_shader && fragment_shader) {
+    create_info.vertex_shader = vertex_shader;
+    create_info.fragment_shader = fragment_shader;
+    pipeline = context->fns.create_graphics_pipeline(context->device, &create_info);
+  }
+
+  // The pipeline keeps what it needs from the shaders
+  if (vertex_shader) {
+    context->fns.release_shader(context->device, vertex_shader);
+  }
+  if (fragment_shader) {
+    context->fns.release_shader(context->device, fragment_shader);
+  }
+  return pipeline;
+}
+
+// Fill the create info of a compute pipeline, returns false if the shader
+// cannot be used on the device
+static bool build_compute_create_info(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  SDL_GPUComputePipelineCreateInfo* out_create_info)
+{
+  if (!shader) {
+    return false;
+  }
+
   // Verify this is a compute shader
   const nshader_info_t* info = nshader_get_info(shader);
   if (!info || info->type != NSHADER_SHADER_TYPE_COMPUTE) {
-    return NULL;
+    return false;
   }
 
   // Check if the shader has a compute stage
   if (!nshader_has_stage(shader, NSHADER_STAGE_TYPE_COMPUTE)) {
-    return NULL;
+    return false;
   }
 
   // Select the appropriate backend
-  nshader_backend_t backend = select_backend_for_device(device, shader);
+  nshader_backend_t backend = select_backend(context, shader);
   if (backend == NSHADER_BACKEND_COUNT) {
-    return NULL; // No compatible backend found
+    return false; // No compatible backend found
   }
 
   // Get the compute shader blob
   const nshader_blob_t* blob = nshader_get_blob(shader, NSHADER_STAGE_TYPE_COMPUTE, backend);
   if (!blob || !blob->data || blob->size == 0) {
-    return NULL;
+    return false;
   }
 
   // Get the compute stage metadata
   const nshader_stage_t* stage = get_stage(shader, NSHADER_STAGE_TYPE_COMPUTE);
   if (!stage) {
-    return NULL;
+    return false;
   }
 
   const nshader_stage_metadata_compute_t* compute = &stage->metadata.compute;
@@ -217,6 +525,237 @@ NSHADER_API SDL_GPUComputePipeline* nshader_sdl3_gpu_create_compute_pipeline(
   create_info.threadcount_z = compute->threadcount_z;
   create_info.props = 0;
 
+  *out_create_info = create_info;
+  return true;
+}
+
+static SDL_GPUComputePipeline* context_create_compute_pipeline(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader)
+{
+  SDL_GPUComputePipelineCreateInfo create_info;
+  if (!build_compute_create_info(context, shader, &create_info)) {
+    return NULL;
+  }
+
   // Create the SDL GPU compute pipeline
-  return SDL_CreateGPUComputePipeline(device, &create_info);
+  return context->fns.create_compute_pipeline(context->device, &create_info);
+}
+
+// #############################################################################
+// Batch pipeline creation
+// #############################################################################
+
+// Work shared by the threads of a batch, items are claimed in index order
+typedef struct compute_batch_t {
+  const nshader_sdl3_gpu_context_t* context;
+  const SDL_GPUComputePipelineCreateInfo* create_infos;  // code is NULL for unusable shaders
+  SDL_GPUComputePipeline** pipelines;
+  int count;
+  SDL_AtomicInt next;
+  SDL_AtomicInt created;
+} compute_batch_t;
+
+static int compute_batch_worker(void* data) {
+  compute_batch_t* batch = (compute_batch_t*)data;
+  for (;;) {
+    int index = SDL_AddAtomicInt(&batch->next, 1);
+    if (index >= batch->count) {
+      break;
+    }
+    const SDL_GPUComputePipelineCreateInfo* create_info = &batch->create_infos[index];
+    if (!create_info->code) {
+      continue;
+    }
+    batch->pipelines[index] = batch->context->fns.create_compute_pipeline(batch->context->device, create_info);
+    if (batch->pipelines[index]) {
+      SDL_AddAtomicInt(&batch->created, 1);
+    }
+  }
+  return 0;
+}
+
+static size_t context_create_compute_pipelines(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* const* shaders,
+  size_t count,
+  uint32_t num_threads,
+  SDL_GPUComputePipeline** out_pipelines)
+{
+  for (size_t i = 0; i < count; i++) {
+    out_pipelines[i] = NULL;
+  }
+  if (count == 0 || count > (size_t)INT_MAX || count > SIZE_MAX / sizeof(SDL_GPUComputePipelineCreateInfo)) {
+    return 0;
+  }
+
+  // Everything that does not touch the device is done once, up front
+  SDL_GPUComputePipelineCreateInfo* create_infos = (SDL_GPUComputePipelineCreateInfo*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_GENERAL, count * sizeof(SDL_GPUComputePipelineCreateInfo));
+  if (!create_infos) {
+    return 0;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!build_compute_create_info(context, shaders[i], &create_infos[i])) {
+      create_infos[i].code = NULL;
+    }
+  }
+
+  compute_batch_t batch;
+  batch.context = context;
+  batch.create_infos = create_infos;
+  batch.pipelines = out_pipelines;
+  batch.count = (int)count;
+  SDL_SetAtomicInt(&batch.next, 0);
+  SDL_SetAtomicInt(&batch.created, 0);
+
+  if (!context->parallel_creation) {
+    num_threads = 1;
+  } else if (num_threads == 0) {
+    int num_cores = SDL_GetNumLogicalCPUCores();
+    num_threads = num_cores > 0 ? (uint32_t)num_cores : 1;
+    if (num_threads > BATCH_MAX_DEFAULT_THREADS) {
+      num_threads = BATCH_MAX_DEFAULT_THREADS;
+    }
+  }
+  if (num_threads > BATCH_MAX_THREADS) {
+    num_threads = BATCH_MAX_THREADS;
+  }
+  if (num_threads > count) {
+    num_threads = (uint32_t)count;
+  }
+
+  // The calling thread works too, so a thread that fails to start only
+  // costs parallelism
+  SDL_Thread* threads[BATCH_MAX_THREADS];
+  uint32_t num_started = 0;
+  for (uint32_t i = 1; i < num_threads; i++) {
+    SDL_Thread* thread = SDL_CreateThread(compute_batch_worker, "nshader_pipelines", &batch);
+    if (!thread) {
+      break;
+    }
+    threads[num_started++] = thread;
+  }
+  compute_batch_worker(&batch);
+  for (uint32_t i = 0; i < num_started; i++) {
+    SDL_WaitThread(threads[i], NULL);
+  }
+
+  nshader_free(create_infos);
+  return (size_t)SDL_GetAtomicInt(&batch.created);
+}
+
+// #############################################################################
+// Device-free entry points, backend selection is resolved on every call
+// #############################################################################
+
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_create_shader(
+  SDL_GPUDevice* device,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type)
+{
+  if (!device) {
+    return NULL;
+  }
+  nshader_sdl3_gpu_context_t context;
+  init_context(&context, device, NULL);
+  return context_create_shader(&context, shader, stage_type);
+}
+
+NSHADER_API SDL_GPUComputePipeline* nshader_sdl3_gpu_create_compute_pipeline(
+  SDL_GPUDevice* device,
+  const nshader_t* shader)
+{
+  if (!device) {
+    return NULL;
+  }
+  nshader_sdl3_gpu_context_t context;
+  init_context(&context, device, NULL);
+  return context_create_compute_pipeline(&context, shader);
+}
+
+NSHADER_API SDL_GPUGraphicsPipeline* nshader_sdl3_gpu_create_graphics_pipeline(
+  SDL_GPUDevice* device,
+  const nshader_t* shader,
+  const nshader_sdl3_gpu_graphics_pipeline_desc_t* desc)
+{
+  if (!device) {
+    return NULL;
+  }
+  nshader_sdl3_gpu_context_t context;
+  init_context(&context, device, NULL);
+  return context_create_graphics_pipeline(&context, shader, desc);
+}
+
+// #############################################################################
+// Device context
+// #############################################################################
+
+NSHADER_API nshader_sdl3_gpu_context_t* nshader_sdl3_gpu_context_create(
+  SDL_GPUDevice* device,
+  const nshader_sdl3_gpu_context_config_t* config)
+{
+  if (!device) {
+    return NULL;
+  }
+
+  nshader_sdl3_gpu_context_t* context = (nshader_sdl3_gpu_context_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_GENERAL, sizeof(nshader_sdl3_gpu_context_t));
+  if (!context) {
+    return NULL;
+  }
+  init_context(context, device, config);
+  return context;
+}
+
+NSHADER_API void nshader_sdl3_gpu_context_destroy(nshader_sdl3_gpu_context_t* context) {
+  nshader_free(context);
+}
+
+NSHADER_API nshader_backend_t nshader_sdl3_gpu_context_select_backend(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader)
+{
+  if (!context || !shader) {
+    return NSHADER_BACKEND_COUNT;
+  }
+  return select_backend(context, shader);
+}
+
+NSHADER_API uint32_t nshader_sdl3_gpu_context_get_backend_mask(const nshader_sdl3_gpu_context_t* context) {
+  return context ? context->backend_mask : 0;
+}
+
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_context_create_shader(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type)
+{
+  return context ? context_create_shader(context, shader, stage_type) : NULL;
+}
+
+NSHADER_API SDL_GPUComputePipeline* nshader_sdl3_gpu_context_create_compute_pipeline(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader)
+{
+  return context ? context_create_compute_pipeline(context, shader) : NULL;
+}
+
+NSHADER_API SDL_GPUGraphicsPipeline* nshader_sdl3_gpu_context_create_graphics_pipeline(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  const nshader_sdl3_gpu_graphics_pipeline_desc_t* desc)
+{
+  return context ? context_create_graphics_pipeline(context, shader, desc) : NULL;
+}
+
+NSHADER_API size_t nshader_sdl3_gpu_context_create_compute_pipelines(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* const* shaders,
+  size_t count,
+  uint32_t num_threads,
+  SDL_GPUComputePipeline** out_pipelines)
+{
+  if (!context || (count > 0 && (!shaders || !out_pipelines))) {
+    return 0;
+  }
+  return context_create_compute_pipelines(context, shaders, count, num_threads, out_pipelines);
 }
\ No newline at end of file
@@ -0,0 +1,366 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_sdl3_gpu.h>
+#include "nshader_sdl3_gpu_internal.h"
+#include "nshader_base_internal.h"
+#include <SDL3/SDL_mutex.h>
+
+// Buckets of the key and object tables
+#define CACHE_BUCKETS 256
+
+typedef struct cache_entry_t {
+  nshader_hash_t hash;
+  nshader_stage_type_t stage_type;
+  nshader_backend_t backend;
+  SDL_GPUShader* gpu_shader;
+  uint32_t refs;
+  bool evicted;                          // Out of the key table, released with its last reference
+  struct cache_entry_t* next_by_key;     // Key table chain, unless evicted
+  struct cache_entry_t* next_by_object;  // Object table chain, used by release
+  struct cache_entry_t* lru_prev;        // Unused list, only while refs is 0
+  struct cache_entry_t* lru_next;
+} cache_entry_t;
+
+struct nshader_sdl3_gpu_shader_cache_t {
+  const nshader_sdl3_gpu_context_t* context;
+  SDL_Mutex* mutex;
+  cache_entry_t* by_key[CACHE_BUCKETS];
+  cache_entry_t* by_object[CACHE_BUCKETS];
+  cache_entry_t* lru_head;  // Least recently released first
+  cache_entry_t* lru_tail;
+  size_t count;
+  size_t num_unused;
+};
+
+// #############################################################################
+// Tables
+// #############################################################################
+
+static size_t key_bucket(nshader_hash_t hash, nshader_stage_type_t stage_type, nshader_backend_t backend) {
+  uint64_t key = hash.lo ^ (hash.hi * 31) ^ ((uint64_t)stage_type * 7) ^ (uint64_t)backend;
+  return (size_t)(key % CACHE_BUCKETS);
+}
+
+static size_t object_bucket(const SDL_GPUShader* gpu_shader) {
+  return (size_t)(((uintptr_t)gpu_shader >> 4) % CACHE_BUCKETS);
+}
+
+static cache_entry_t* find_entry(nshader_sdl3_gpu_shader_cache_t* cache, nshader_hash_t hash, nshader_stage_type_t stage_type, nshader_backend_t backend) {
+  for (cache_entry_t* entry = cache->by_key[key_bucket(hash, stage_type, backend)]; entry; entry = entry->next_by_key) {
+    if (entry->hash.lo == hash.lo && entry->hash.hi == hash.hi &&
+        entry->stage_type == stage_type && entry->backend == backend) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+static void unlink_key(nshader_sdl3_gpu_shader_cache_t* cache, cache_entry_t* entry) {
+  cache_entry_t** link = &cache->by_key[key_bucket(entry->hash, entry->stage_type, entry->backend)];
+  while (*link) {
+    if (*link == entry) {
+      *link = entry->next_by_key;
+      entry->next_by_key = NULL;
+      return;
+    }
+    link = &(*link)->next_by_key;
+  }
+}
+
+static void unlink_object(nshader_sdl3_gpu_shader_cache_t* cache, cache_entry_t* entry) {
+  cache_entry_t** link = &cache->by_object[object_bucket(entry->gpu_shader)];
+  while (*link) {
+    if (*link == entry) {
+      *link = entry->next_by_object;
+      entry->next_by_object = NULL;
+      return;
+    }
+    link = &(*link)->next_by_object;
+  }
+}
+
+static void lru_push(nshader_sdl3_gpu_shader_cache_t* cache, cache_entry_t* entry) {
+  entry->lru_prev = cache->lru_tail;
+  entry->lru_next = NULL;
+  if (cache->lru_tail) {
+    cache->lru_tail->lru_next = entry;
+  } else {
+    cache->lru_head = entry;
+  }
+  cache->lru_tail = entry;
+  cache->num_unused++;
+}
+
+static void lru_remove(nshader_sdl3_gpu_shader_cache_t* cache, cache_entry_t* entry) {
+  if (entry->lru_prev) {
+    entry->lru_prev->lru_next = entry->lru_next;
+  } else {
+    cache->lru_head = entry->lru_next;
+  }
+  if (entry->lru_next) {
+    entry->lru_next->lru_prev = entry->lru_prev;
+  } else {
+    cache->lru_tail = entry->lru_prev;
+  }
+  entry->lru_prev = NULL;
+  entry->lru_next = NULL;
+  cache->num_unused--;
+}
+
+// Take a reference on an entry found under the lock
+static SDL_GPUShader* add_ref(nshader_sdl3_gpu_shader_cache_t* cache, cache_entry_t* entry) {
+  if (entry->refs++ == 0) {
+    lru_remove(cache, entry);
+  }
+  return entry->gpu_shader;
+}
+
+// Release entries unlinked from every table, called without the lock held
+// (chained through next_by_key)
+static size_t release_entries(nshader_sdl3_gpu_shader_cache_t* cache, cache_entry_t* entries) {
+  size_t count = 0;
+  while (entries) {
+    cache_entry_t* next = entries->next_by_key;
+    cache->context->fns.release_shader(cache->context->device, entries->gpu_shader);
+    nshader_free(entries);
+    entries = next;
+    count++;
+  }
+  return count;
+}
+
+// #############################################################################
+// API
+// #############################################################################
+
+NSHADER_API nshader_sdl3_gpu_shader_cache_t* nshader_sdl3_gpu_shader_cache_create(
+  const nshader_sdl3_gpu_context_t* context)
+{
+  if (!context) {
+    return NULL;
+  }
+
+  nshader_sdl3_gpu_shader_cache_t* cache = (nshader_sdl3_gpu_shader_cache_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_GENERAL, 1, sizeof(nshader_sdl3_gpu_shader_cache_t));
+  if (!cache) {
+    return NULL;
+  }
+  cache->context = context;
+
+  cache->mutex = SDL_CreateMutex();
+  if (!cache->mutex) {
+    nshader_free(cache);
+    return NULL;
+  }
+  return cache;
+}
+
+NSHADER_API void nshader_sdl3_gpu_shader_cache_destroy(nshader_sdl3_gpu_shader_cache_t* cache) {
+  if (!cache) {
+    return;
+  }
+
+  // The object table holds every entry, evicted ones included
+  for (size_t i = 0; i < CACHE_BUCKETS; i++) {
+    cache_entry_t* entry = cache->by_object[i];
+    while (entry) {
+      cache_entry_t* next = entry->next_by_object;
+      cache->context->fns.release_shader(cache->context->device, entry->gpu_shader);
+      nshader_free(entry);
+      entry = next;
+    }
+  }
+
+  SDL_DestroyMutex(cache->mutex);
+  nshader_free(cache);
+}
+
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_shader_cache_acquire(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type)
+{
+  if (!cache || !shader) {
+    return NULL;
+  }
+  if (stage_type != NSHADER_STAGE_TYPE_VERTEX && stage_type != NSHADER_STAGE_TYPE_FRAGMENT) {
+    return NULL;
+  }
+
+  nshader_hash_t hash;
+  if (!nshader_hash(shader, &hash)) {
+    return NULL;
+  }
+  nshader_backend_t backend = nshader_sdl3_gpu_context_select_backend(cache->context, shader);
+  if (backend == NSHADER_BACKEND_COUNT) {
+    return NULL; // No compatible backend found
+  }
+
+  SDL_LockMutex(cache->mutex);
+  cache_entry_t* entry = find_entry(cache, hash, stage_type, backend);
+  if (entry) {
+    SDL_GPUShader* gpu_shader = add_ref(cache, entry);
+    SDL_UnlockMutex(cache->mutex);
+    return gpu_shader;
+  }
+  SDL_UnlockMutex(cache->mutex);
+
+  // Driver compilation is slow, it runs without the lock held
+  SDL_GPUShader* gpu_shader = nshader_sdl3_gpu_create_stage_shader(cache->context, shader, stage_type, backend);
+  if (!gpu_shader) {
+    return NULL;
+  }
+  cache_entry_t* created = (cache_entry_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_GENERAL, 1, sizeof(cache_entry_t));
+  if (!created) {
+    cache->context->fns.release_shader(cache->context->device, gpu_shader);
+    return NULL;
+  }
+  created->hash = hash;
+  created->stage_type = stage_type;
+  created->backend = backend;
+  created->gpu_shader = gpu_shader;
+  created->refs = 1;
+
+  SDL_LockMutex(cache->mutex);
+
+  // Another thread may have created the same shader in the meantime
+  entry = find_entry(cache, hash, stage_type, backend);
+  if (entry) {
+    SDL_GPUShader* existing = add_ref(cache, entry);
+    SDL_UnlockMutex(cache->mutex);
+    cache->context->fns.release_shader(cache->context->device, gpu_shader);
+    nshader_free(created);
+    return existing;
+  }
+
+  size_t bucket = key_bucket(hash, stage_type, backend);
+  created->next_by_key = cache->by_key[bucket];
+  cache->by_key[bucket] = created;
+  bucket = object_bucket(gpu_shader);
+  created->next_by_object = cache->by_object[bucket];
+  cache->by_object[bucket] = created;
+  cache->count++;
+
+  SDL_UnlockMutex(cache->mutex);
+  return gpu_shader;
+}
+
+NSHADER_API void nshader_sdl3_gpu_shader_cache_release(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  SDL_GPUShader* gpu_shader)
+{
+  if (!cache || !gpu_shader) {
+    return;
+  }
+
+  cache_entry_t* released = NULL;
+  SDL_LockMutex(cache->mutex);
+  for (cache_entry_t* entry = cache->by_object[object_bucket(gpu_shader)]; entry; entry = entry->next_by_object) {
+    if (entry->gpu_shader != gpu_shader || entry->refs == 0) continue;
+    if (--entry->refs == 0) {
+      if (entry->evicted) {
+        unlink_object(cache, entry);
+        cache->count--;
+        released = entry;
+      } else {
+        lru_push(cache, entry);
+      }
+    }
+    break;
+  }
+  SDL_UnlockMutex(cache->mutex);
+
+  release_entries(cache, released);
+}
+
+NSHADER_API size_t nshader_sdl3_gpu_shader_cache_trim(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  size_t max_unused)
+{
+  if (!cache) {
+    return 0;
+  }
+
+  cache_entry_t* released = NULL;
+  SDL_LockMutex(cache->mutex);
+  while (cache->num_unused > max_unused) {
+    cache_entry_t* entry = cache->lru_head;
+    lru_remove(cache, entry);
+    unlink_key(cache, entry);
+    unlink_object(cache, entry);
+    cache->count--;
+    entry->next_by_key = released;
+    released = entry;
+  }
+  SDL_UnlockMutex(cache->mutex);
+
+  return release_entries(cache, released);
+}
+
+NSHADER_API size_t nshader_sdl3_gpu_shader_cache_evict(
+  nshader_sdl3_gpu_shader_cache_t* cache,
+  const nshader_t* shader)
+{
+  nshader_hash_t hash;
+  if (!cache || !shader || !nshader_hash(shader, &hash)) {
+    return 0;
+  }
+
+  size_t num_evicted = 0;
+  cache_entry_t* released = NULL;
+  SDL_LockMutex(cache->mutex);
+  for (int stage_type = 0; stage_type < NSHADER_STAGE_TYPE_COUNT; stage_type++) {
+    for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+      cache_entry_t* entry = find_entry(cache, hash, (nshader_stage_type_t)stage_type, (nshader_backend_t)backend);
+      if (!entry) continue;
+
+      unlink_key(cache, entry);
+      num_evicted++;
+      if (entry->refs > 0) {
+        entry->evicted = true;
+        continue;
+      }
+      lru_remove(cache, entry);
+      unlink_object(cache, entry);
+      cache->count--;
+      entry->next_by_key = released;
+      released = entry;
+    }
+  }
+  SDL_UnlockMutex(cache->mutex);
+
+  release_entries(cache, released);
+  return num_evicted;
+}
+
+NSHADER_API size_t nshader_sdl3_gpu_shader_cache_count(const nshader_sdl3_gpu_shader_cache_t* cache) {
+  if (!cache) {
+    return 0;
+  }
+
+  SDL_LockMutex(cache->mutex);
+  size_t count = cache->count;
+  SDL_UnlockMutex(cache->mutex);
+  return count;
+}
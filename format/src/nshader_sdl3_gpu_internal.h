@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <nshader/nshader_sdl3_gpu.h>
+
+// #############################################################################
+NSHADER_HEADER_BEGIN;
+// #############################################################################
+
+struct nshader_sdl3_gpu_context_t {
+  SDL_GPUDevice* device;
+  nshader_sdl3_gpu_device_fns_t fns;  // Every member is set
+  uint32_t backend_mask;              // Backends the device accepts, bit (1u << backend)
+  bool parallel_creation;             // The driver creates pipelines from several threads
+
+  // Backend to use for every set of backends a shader may contain, indexed by
+  // the shader's backend mask, NSHADER_BACKEND_COUNT when none is usable
+  uint8_t selection[1u << NSHADER_BACKEND_COUNT];
+};
+
+// Create a vertex or fragment shader with an already selected backend
+NSHADER_API SDL_GPUShader* nshader_sdl3_gpu_create_stage_shader(
+  const nshader_sdl3_gpu_context_t* context,
+  const nshader_t* shader,
+  nshader_stage_type_t stage_type,
+  nshader_backend_t backend);
+
+// #############################################################################
+NSHADER_HEADER_END;
+// #############################################################################
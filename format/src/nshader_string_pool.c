@@ -0,0 +1,213 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_string_pool.h>
+#include "nshader_base_internal.h"
+#include <SDL3/SDL_mutex.h>
+#include <string.h>
+
+// Size of the blocks strings are packed into, longer strings get their own block
+#define POOL_BLOCK_SIZE 4096
+
+// Initial number of hash slots, always a power of two
+#define POOL_MIN_SLOTS 64
+
+typedef struct pool_block_t {
+  struct pool_block_t* next;
+  size_t size;  // Bytes available in data
+  size_t used;
+} pool_block_t;
+
+typedef struct pool_slot_t {
+  uint32_t hash;
+  const char* str;  // NULL for an empty slot
+} pool_slot_t;
+
+struct nshader_string_pool_t {
+  nshader_allocator_t allocator;
+  SDL_Mutex* mutex;
+  pool_slot_t* slots;  // Open addressing with linear probing
+  size_t num_slots;
+  size_t count;
+  pool_block_t* blocks;  // Most recent block first
+};
+
+static uint32_t hash_string(const char* str, size_t len) {
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (unsigned char)str[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static char* pool_block_data(pool_block_t* block) {
+  return (char*)(block + 1);
+}
+
+// Copy a string into the current block, or a new one if it does not fit
+static const char* pool_store(nshader_string_pool_t* pool, const char* str, size_t len) {
+  pool_block_t* block = pool->blocks;
+  if (!block || block->size - block->used < len + 1) {
+    size_t size = len + 1 > POOL_BLOCK_SIZE ? len + 1 : POOL_BLOCK_SIZE;
+    block = (pool_block_t*)nshader_allocator_alloc(&pool->allocator, NSHADER_ALLOC_TAG_STRING_POOL, sizeof(pool_block_t) + size, _Alignof(pool_block_t));
+    if (!block) {
+      return NULL;
+    }
+    block->size = size;
+    block->used = 0;
+
+    // Keep filling the current block when the new one is a dedicated large block
+    if (pool->blocks && size > POOL_BLOCK_SIZE) {
+      block->next = pool->blocks->next;
+      pool->blocks->next = block;
+    } else {
+      block->next = pool->blocks;
+      pool->blocks = block;
+    }
+  }
+
+  char* copy = pool_block_data(block) + block->used;
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  block->used += len + 1;
+  return copy;
+}
+
+static bool pool_grow(nshader_string_pool_t* pool) {
+  size_t num_slots = pool->num_slots ? pool->num_slots * 2 : POOL_MIN_SLOTS;
+  pool_slot_t* slots = (pool_slot_t*)nshader_allocator_calloc(&pool->allocator, NSHADER_ALLOC_TAG_STRING_POOL, num_slots, sizeof(pool_slot_t), _Alignof(pool_slot_t));
+  if (!slots) {
+    return false;
+  }
+
+  for (size_t i = 0; i < pool->num_slots; i++) {
+    if (!pool->slots[i].str) continue;
+    size_t index = pool->slots[i].hash & (num_slots - 1);
+    while (slots[index].str) {
+      index = (index + 1) & (num_slots - 1);
+    }
+    slots[index] = pool->slots[i];
+  }
+
+  if (pool->slots) {
+    nshader_allocator_free(&pool->allocator, NSHADER_ALLOC_TAG_STRING_POOL, pool->slots, pool->num_slots * sizeof(pool_slot_t));
+  }
+  pool->slots = slots;
+  pool->num_slots = num_slots;
+  return true;
+}
+
+NSHADER_API nshader_string_pool_t* nshader_string_pool_create(const nshader_allocator_t* allocator) {
+  if (!allocator) {
+    allocator = nshader_default_allocator();
+  }
+
+  nshader_string_pool_t* pool = (nshader_string_pool_t*)nshader_allocator_calloc(allocator, NSHADER_ALLOC_TAG_STRING_POOL, 1, sizeof(nshader_string_pool_t), _Alignof(nshader_string_pool_t));
+  if (!pool) {
+    return NULL;
+  }
+  pool->allocator = *allocator;
+
+  pool->mutex = SDL_CreateMutex();
+  if (!pool->mutex || !pool_grow(pool)) {
+    nshader_string_pool_destroy(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+NSHADER_API void nshader_string_pool_destroy(nshader_string_pool_t* pool) {
+  if (!pool) {
+    return;
+  }
+
+  // Copy the allocator, the pool itself is freed through it last
+  nshader_allocator_t allocator = pool->allocator;
+
+  pool_block_t* block = pool->blocks;
+  while (block) {
+    pool_block_t* next = block->next;
+    nshader_allocator_free(&allocator, NSHADER_ALLOC_TAG_STRING_POOL, block, sizeof(pool_block_t) + block->size);
+    block = next;
+  }
+  if (pool->slots) {
+    nshader_allocator_free(&allocator, NSHADER_ALLOC_TAG_STRING_POOL, pool->slots, pool->num_slots * sizeof(pool_slot_t));
+  }
+  if (pool->mutex) {
+    SDL_DestroyMutex(pool->mutex);
+  }
+  nshader_allocator_free(&allocator, NSHADER_ALLOC_TAG_STRING_POOL, pool, sizeof(nshader_string_pool_t));
+}
+
+NSHADER_API const char* nshader_string_pool_intern(nshader_string_pool_t* pool, const char* str) {
+  if (!pool || !str) {
+    return NULL;
+  }
+
+  size_t len = strlen(str);
+  uint32_t hash = hash_string(str, len);
+  const char* result = NULL;
+
+  SDL_LockMutex(pool->mutex);
+
+  // Grow before inserting, the load factor stays below 3/4
+  if ((pool->count + 1) * 4 > pool->num_slots * 3 && !pool_grow(pool)) {
+    SDL_UnlockMutex(pool->mutex);
+    return NULL;
+  }
+
+  size_t index = hash & (pool->num_slots - 1);
+  while (pool->slots[index].str) {
+    if (pool->slots[index].hash == hash && strcmp(pool->slots[index].str, str) == 0) {
+      result = pool->slots[index].str;
+      break;
+    }
+    index = (index + 1) & (pool->num_slots - 1);
+  }
+
+  if (!result) {
+    result = pool_store(pool, str, len);
+    if (result) {
+      pool->slots[index].hash = hash;
+      pool->slots[index].str = result;
+      pool->count++;
+    }
+  }
+
+  SDL_UnlockMutex(pool->mutex);
+  return result;
+}
+
+NSHADER_API size_t nshader_string_pool_count(const nshader_string_pool_t* pool) {
+  if (!pool) {
+    return 0;
+  }
+
+  SDL_LockMutex(pool->mutex);
+  size_t count = pool->count;
+  SDL_UnlockMutex(pool->mutex);
+  return count;
+}
@@ -0,0 +1,250 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <nshader/nshader_strip.h>
+#include "nshader_type_internal.h"
+#include "nshader_base_internal.h"
+#include "nshader_format_internal.h"
+#include <string.h>
+
+#define SPIRV_MAGIC 0x07230203u
+#define SPIRV_HEADER_WORDS 5
+
+// Debug opcodes removed by nshader_spirv_strip_debug_info()
+#define SPIRV_OP_SOURCE_CONTINUED 2
+#define SPIRV_OP_SOURCE 3
+#define SPIRV_OP_SOURCE_EXTENSION 4
+#define SPIRV_OP_NAME 5
+#define SPIRV_OP_MEMBER_NAME 6
+#define SPIRV_OP_STRING 7
+#define SPIRV_OP_LINE 8
+#define SPIRV_OP_EXT_INST_IMPORT 11
+#define SPIRV_OP_NO_LINE 317
+#define SPIRV_OP_MODULE_PROCESSED 330
+
+static uint32_t spirv_word(const uint8_t* data, size_t index) {
+  uint32_t word;
+  memcpy(&word, data + index * 4, sizeof(word));
+  return nshader_le32(word);
+}
+
+static bool spirv_is_debug_op(uint32_t opcode, bool keep_strings) {
+  switch (opcode) {
+    case SPIRV_OP_SOURCE_CONTINUED:
+    case SPIRV_OP_SOURCE:
+    case SPIRV_OP_SOURCE_EXTENSION:
+    case SPIRV_OP_NAME:
+    case SPIRV_OP_MEMBER_NAME:
+    case SPIRV_OP_LINE:
+    case SPIRV_OP_NO_LINE:
+    case SPIRV_OP_MODULE_PROCESSED:
+      return true;
+    case SPIRV_OP_STRING:
+      return !keep_strings;
+    default:
+      return false;
+  }
+}
+
+NSHADER_API size_t nshader_spirv_strip_debug_info(const void* spirv, size_t size, void* out, size_t out_size) {
+  if (!spirv || size % 4 != 0 || size < SPIRV_HEADER_WORDS * 4) {
+    return 0;
+  }
+  const uint8_t* data = (const uint8_t*)spirv;
+  size_t num_words = size / 4;
+  if (spirv_word(data, 0) != SPIRV_MAGIC) {
+    return 0;
+  }
+
+  // First pass: validate the instruction stream and size the result
+  static const char non_semantic[] = "NonSemantic.";
+  bool keep_strings = false;
+  for (size_t i = SPIRV_HEADER_WORDS; i < num_words;) {
+    uint32_t word = spirv_word(data, i);
+    uint32_t word_count = word >> 16;
+    if (word_count == 0 || word_count > num_words - i) {
+      return 0;
+    }
+    if ((word & 0xFFFFu) == SPIRV_OP_EXT_INST_IMPORT && word_count * 4 >= 8 + sizeof(non_semantic) - 1 &&
+        memcmp(data + (i + 2) * 4, non_semantic, sizeof(non_semantic) - 1) == 0) {
+      keep_strings = true;
+    }
+    i += word_count;
+  }
+
+  size_t stripped_size = SPIRV_HEADER_WORDS * 4;
+  for (size_t i = SPIRV_HEADER_WORDS; i < num_words;) {
+    uint32_t word = spirv_word(data, i);
+    uint32_t word_count = word >> 16;
+    if (!spirv_is_debug_op(word & 0xFFFFu, keep_strings)) {
+      stripped_size += (size_t)word_count * 4;
+    }
+    i += word_count;
+  }
+  if (!out) {
+    return stripped_size;
+  }
+  if (out_size < stripped_size) {
+    return 0;
+  }
+
+  // Second pass: copy the kept instructions, the output never overtakes the input
+  uint8_t* dst = (uint8_t*)out;
+  memmove(dst, data, SPIRV_HEADER_WORDS * 4);
+  size_t written = SPIRV_HEADER_WORDS * 4;
+  for (size_t i = SPIRV_HEADER_WORDS; i < num_words;) {
+    uint32_t word = spirv_word(data, i);
+    uint32_t word_count = word >> 16;
+    if (!spirv_is_debug_op(word & 0xFFFFu, keep_strings)) {
+      memmove(dst + written, data + i * 4, (size_t)word_count * 4);
+      written += (size_t)word_count * 4;
+    }
+    i += word_count;
+  }
+  return written;
+}
+
+static void free_blob(nshader_t* shader, size_t stage_idx, size_t backend_idx) {
+  shader->skipped_blob_sizes[stage_idx][backend_idx] = 0;
+  nshader_blob_t* blob = shader->blobs[stage_idx][backend_idx];
+  if (!blob) {
+    return;
+  }
+  if (!shader->borrowed_blobs) {
+    nshader_allocator_free(&shader->allocator, shader->blob_tag, (void*)blob->data, blob->size);
+  }
+  nshader_allocator_free(&shader->allocator, shader->blob_tag, blob, sizeof(nshader_blob_t));
+  shader->blobs[stage_idx][backend_idx] = NULL;
+  SDL_SetAtomicInt(&shader->blob_checks[stage_idx][backend_idx], NSHADER_BLOB_CHECK_NONE);
+}
+
+NSHADER_API bool nshader_strip_backends(nshader_t* shader, uint32_t backend_mask) {
+  if (!shader) {
+    return false;
+  }
+
+  nshader_info_t* info = &shader->info;
+  size_t num_kept = 0;
+  for (size_t i = 0; i < info->num_backends; i++) {
+    if (backend_mask & (1u << info->backends[i])) {
+      num_kept++;
+    }
+  }
+  if (num_kept == 0) {
+    return false;
+  }
+  if (num_kept == info->num_backends) {
+    return true;
+  }
+
+  // The backend list is sized exactly, so the kept backends move to a new one
+  nshader_backend_t* backends = (nshader_backend_t*)nshader_allocator_calloc(&shader->allocator, NSHADER_ALLOC_TAG_SHADER, num_kept, sizeof(nshader_backend_t), _Alignof(nshader_backend_t));
+  if (!backends) {
+    return false;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i < info->num_backends; i++) {
+    if (backend_mask & (1u << info->backends[i])) {
+      backends[count++] = info->backends[i];
+    }
+  }
+  nshader_allocator_free(&shader->allocator, NSHADER_ALLOC_TAG_SHADER, info->backends, info->num_backends * sizeof(nshader_backend_t));
+  info->backends = backends;
+  info->num_backends = num_kept;
+
+  for (size_t stage_idx = 0; stage_idx < NSHADER_STAGE_TYPE_COUNT; stage_idx++) {
+    for (size_t backend_idx = 0; backend_idx < NSHADER_BACKEND_COUNT; backend_idx++) {
+      if ((backend_mask & (1u << backend_idx)) == 0) {
+        free_blob(shader, stage_idx, backend_idx);
+      }
+    }
+  }
+
+  shader->has_hash = false;
+  return true;
+}
+
+NSHADER_API bool nshader_strip_debug_info(nshader_t* shader) {
+  if (!shader || shader->borrowed_blobs) {
+    return false;
+  }
+
+  for (size_t stage_idx = 0; stage_idx < NSHADER_STAGE_TYPE_COUNT; stage_idx++) {
+    // Resolves a pending lazy checksum, corrupt blobs are hidden and kept as they are
+    const nshader_blob_t* checked = nshader_get_blob(shader, (nshader_stage_type_t)stage_idx, NSHADER_BACKEND_SPV);
+    if (!checked) {
+      continue;
+    }
+    nshader_blob_t* blob = shader->blobs[stage_idx][NSHADER_BACKEND_SPV];
+    size_t stripped_size = nshader_spirv_strip_debug_info(blob->data, blob->size, NULL, 0);
+    if (stripped_size == 0 || stripped_size == blob->size) {
+      continue;
+    }
+
+    // Blobs are freed with their exact size, so the result gets its own allocation
+    uint8_t* data = (uint8_t*)nshader_allocator_alloc(&shader->allocator, shader->blob_tag, stripped_size, NSHADER_DEFAULT_BLOB_ALIGNMENT);
+    if (!data) {
+      return false;
+    }
+    nshader_spirv_strip_debug_info(blob->data, blob->size, data, stripped_size);
+    nshader_allocator_free(&shader->allocator, shader->blob_tag, (void*)blob->data, blob->size);
+    blob->data = data;
+    blob->size = stripped_size;
+    shader->has_hash = false;
+  }
+  return true;
+}
+
+static void strip_binding_names(nshader_t* shader, nshader_stage_binding_t* bindings, size_t count, bool owned_names) {
+  for (size_t i = 0; i < count; i++) {
+    if (owned_names) {
+      nshader_allocator_free_string(&shader->allocator, shader->metadata_tag, bindings[i].name);
+    }
+    bindings[i].name = NULL;
+  }
+}
+
+NSHADER_API bool nshader_strip_names(nshader_t* shader) {
+  if (!shader) {
+    return false;
+  }
+
+  // Names in a string table or pool are freed with it, owned ones right away
+  bool owned_names = !shader->strings && !shader->pooled_strings;
+  nshader_info_t* info = &shader->info;
+  for (size_t i = 0; i < info->num_stages; i++) {
+    nshader_stage_t* stage = &info->stages[i];
+    if (stage->type == NSHADER_STAGE_TYPE_VERTEX) {
+      nshader_stage_metadata_vertex_t* meta = &stage->metadata.vertex;
+      strip_binding_names(shader, meta->inputs, meta->input_count, owned_names);
+      strip_binding_names(shader, meta->outputs, meta->output_count, owned_names);
+    } else if (stage->type == NSHADER_STAGE_TYPE_FRAGMENT) {
+      nshader_stage_metadata_fragment_t* meta = &stage->metadata.fragment;
+      strip_binding_names(shader, meta->inputs, meta->input_count, owned_names);
+      strip_binding_names(shader, meta->outputs, meta->output_count, owned_names);
+    }
+  }
+
+  shader->has_hash = false;
+  return true;
+}
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "nshader_type_internal.h"
+#include "nshader_checksum_internal.h"
 
 NSHADER_API const nshader_info_t* nshader_get_info(const nshader_t* shader) {
   return shader ? &shader->info : NULL;
@@ -37,7 +38,26 @@ NSHADER_API const nshader_blob_t* nshader_get_blob(const nshader_t* shader, nsha
     return NULL;
   }
 
-  return shader->blobs[stage_type][backend];
+  const nshader_blob_t* blob = shader->blobs[stage_type][backend];
+
+  // Lazily verified blobs are checked once, concurrent first calls may both compute it
+  SDL_AtomicInt* check = (SDL_AtomicInt*)&shader->blob_checks[stage_type][backend];
+  int state = SDL_GetAtomicInt(check);
+  if (state == NSHADER_BLOB_CHECK_PENDING) {
+    bool valid = nshader_crc32c(0, blob->data, blob->size) == shader->blob_crcs[stage_type][backend];
+    state = valid ? NSHADER_BLOB_CHECK_NONE : NSHADER_BLOB_CHECK_FAILED;
+    SDL_SetAtomicInt(check, state);
+  }
+  return state == NSHADER_BLOB_CHECK_FAILED ? NULL : blob;
+}
+
+NSHADER_API size_t nshader_get_blob_size(const nshader_t* shader, nshader_stage_type_t stage_type, nshader_backend_t backend) {
+  if (!shader || stage_type >= NSHADER_STAGE_TYPE_COUNT || backend >= NSHADER_BACKEND_COUNT) {
+    return 0;
+  }
+
+  const nshader_blob_t* blob = shader->blobs[stage_type][backend];
+  return blob ? blob->size : shader->skipped_blob_sizes[stage_type][backend];
 }
 
 NSHADER_API bool nshader_has_backend(const nshader_t* shader, nshader_backend_t backend) {
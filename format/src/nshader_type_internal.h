@@ -25,14 +25,35 @@ SOFTWARE.
 #pragma once
 
 #include <nshader/nshader_type.h>
+#include <SDL3/SDL_atomic.h>
 
 // #############################################################################
 NSHADER_HEADER_BEGIN;
 // #############################################################################
 
+// State of a blob checksum with NSHADER_VERIFY_LAZY
+typedef enum nshader_blob_check_t {
+  NSHADER_BLOB_CHECK_NONE,     // Verified or nothing to verify
+  NSHADER_BLOB_CHECK_PENDING,  // Checked on the first nshader_get_blob()
+  NSHADER_BLOB_CHECK_FAILED,   // Checksum mismatch, the blob is hidden
+} nshader_blob_check_t;
+
 typedef struct nshader_t {
+  nshader_allocator_t allocator;      // Allocator owning every allocation below
+  nshader_alloc_tag_t metadata_tag;   // Tag of entry points and bindings
+  nshader_alloc_tag_t blob_tag;       // Tag of blobs and their payloads
+  bool borrowed_blobs;                // Blob payloads point into caller memory
+  bool skipped_blobs;                 // Read with skip_blobs, blobs holds nothing
+  char** strings;                     // String table the entry points and binding names point into, NULL if each is owned
+  size_t num_strings;
+  bool pooled_strings;                // Entry points, binding names and table strings belong to a string pool
   nshader_info_t info;
   nshader_blob_t* blobs[NSHADER_STAGE_TYPE_COUNT][NSHADER_BACKEND_COUNT];
+  SDL_AtomicInt blob_checks[NSHADER_STAGE_TYPE_COUNT][NSHADER_BACKEND_COUNT];  // nshader_blob_check_t
+  uint32_t blob_crcs[NSHADER_STAGE_TYPE_COUNT][NSHADER_BACKEND_COUNT];         // Expected CRC-32C of pending blobs
+  uint32_t skipped_blob_sizes[NSHADER_STAGE_TYPE_COUNT][NSHADER_BACKEND_COUNT];  // Payload sizes when read with skip_blobs
+  bool has_hash;                      // hash holds the content hash
+  nshader_hash_t hash;
 } nshader_t;
 
 // #############################################################################
@@ -0,0 +1,516 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#if defined(__linux__) && defined(NSHADER_IO_URING)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "nshader_uring_internal.h"
+#include "nshader_base_internal.h"
+
+#if defined(__linux__) && defined(NSHADER_IO_URING)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+
+// Submission queue size, files in flight are capped so that the queue never overflows
+#define URING_ENTRIES 256
+#define URING_MAX_FILES_IN_FLIGHT (URING_ENTRIES / 2)
+
+// Largest single read, bigger files continue through the short-read path
+#define URING_MAX_READ_SIZE ((uint32_t)1 << 30)
+
+// User data of cancel requests, file indices never reach it
+#define URING_CANCEL_USER_DATA UINT64_MAX
+
+// Operation kind, stored in the low bits of the user data next to the file index
+typedef enum uring_op_t {
+  URING_OP_OPEN,
+  URING_OP_STATX,
+  URING_OP_READ,
+  URING_OP_CLOSE,
+} uring_op_t;
+
+typedef struct uring_t {
+  int fd;
+  void* sq_ptr;
+  size_t sq_size;
+  void* cq_ptr;
+  size_t cq_size;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+
+  unsigned to_submit;
+} uring_t;
+
+// Per-file state while its operations are in flight
+typedef struct uring_file_t {
+  int fd;
+  int pending;   // Operations submitted and not completed yet
+  bool failed;
+  uint8_t* buffer;
+  uint64_t size;
+  uint64_t offset;  // Bytes read so far
+  struct statx stx;
+} uring_file_t;
+
+// #############################################################################
+// Ring setup
+// #############################################################################
+
+static void uring_close(uring_t* ring) {
+  if (ring->sqes) {
+    munmap(ring->sqes, ring->sqes_size);
+  }
+  if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr) {
+    munmap(ring->cq_ptr, ring->cq_size);
+  }
+  if (ring->sq_ptr) {
+    munmap(ring->sq_ptr, ring->sq_size);
+  }
+  if (ring->fd >= 0) {
+    close(ring->fd);
+  }
+}
+
+static bool uring_supports_ops(int fd) {
+  const size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+  struct io_uring_probe* probe = (struct io_uring_probe*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, 1, probe_size);
+  if (!probe) {
+    return false;
+  }
+
+  bool supported = false;
+  if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) >= 0) {
+    const int ops[] = { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE, IORING_OP_ASYNC_CANCEL };
+    supported = true;
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); ++i) {
+      if (ops[i] > probe->last_op || !(probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED)) {
+        supported = false;
+      }
+    }
+  }
+
+  nshader_free(probe);
+  return supported;
+}
+
+static bool uring_open(uring_t* ring) {
+  memset(ring, 0, sizeof(*ring));
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring->fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+  if (ring->fd < 0) {
+    return false;
+  }
+  if (!uring_supports_ops(ring->fd)) {
+    uring_close(ring);
+    return false;
+  }
+
+  ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap && ring->cq_size > ring->sq_size) {
+    ring->sq_size = ring->cq_size;
+  }
+
+  ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ptr == MAP_FAILED) {
+    ring->sq_ptr = NULL;
+    uring_close(ring);
+    return false;
+  }
+
+  if (single_mmap) {
+    ring->cq_ptr = ring->sq_ptr;
+  } else {
+    ring->cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ptr == MAP_FAILED) {
+      ring->cq_ptr = NULL;
+      uring_close(ring);
+      return false;
+    }
+  }
+
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED) {
+    ring->sqes = NULL;
+    uring_close(ring);
+    return false;
+  }
+
+  uint8_t* sq = (uint8_t*)ring->sq_ptr;
+  uint8_t* cq = (uint8_t*)ring->cq_ptr;
+  ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+  ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+  ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+  ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+  ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+  ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+  return true;
+}
+
+// #############################################################################
+// Submission & completion
+// #############################################################################
+
+static struct io_uring_sqe* uring_get_sqe(uring_t* ring, size_t file_index, uring_op_t op) {
+  unsigned tail = *ring->sq_tail;
+  unsigned index = tail & *ring->sq_mask;
+  struct io_uring_sqe* sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->user_data = ((uint64_t)file_index << 2) | (uint64_t)op;
+
+  ring->sq_array[index] = index;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  ring->to_submit++;
+  return sqe;
+}
+
+static bool uring_submit_and_wait(uring_t* ring, unsigned min_complete) {
+  for (;;) {
+    long result = syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, min_complete, IORING_ENTER_GETEVENTS, NULL, 0);
+    if (result >= 0) {
+      ring->to_submit -= (unsigned)result;
+      return true;
+    }
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+}
+
+static void submit_read(uring_t* ring, uring_file_t* file, size_t file_index) {
+  struct io_uring_sqe* sqe = uring_get_sqe(ring, file_index, URING_OP_READ);
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = file->fd;
+  sqe->addr = (uint64_t)(uintptr_t)(file->buffer + file->offset);
+  uint64_t remaining = file->size - file->offset;
+  sqe->len = remaining > URING_MAX_READ_SIZE ? URING_MAX_READ_SIZE : (uint32_t)remaining;
+  sqe->off = file->offset;
+  file->pending++;
+}
+
+static void submit_close(uring_t* ring, uring_file_t* file, size_t file_index) {
+  struct io_uring_sqe* sqe = uring_get_sqe(ring, file_index, URING_OP_CLOSE);
+  sqe->opcode = IORING_OP_CLOSE;
+  sqe->fd = file->fd;
+  file->fd = -1;
+  file->pending++;
+}
+
+static void submit_open(uring_t* ring, uring_file_t* file, const char* path, size_t file_index) {
+  // Open and stat run in parallel, the read is submitted once both completed
+  struct io_uring_sqe* sqe = uring_get_sqe(ring, file_index, URING_OP_OPEN);
+  sqe->opcode = IORING_OP_OPENAT;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uint64_t)(uintptr_t)path;
+  sqe->open_flags = O_RDONLY | O_CLOEXEC;
+
+  sqe = uring_get_sqe(ring, file_index, URING_OP_STATX);
+  sqe->opcode = IORING_OP_STATX;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uint64_t)(uintptr_t)path;
+  sqe->len = STATX_SIZE;
+  sqe->off = (uint64_t)(uintptr_t)&file->stx;
+
+  file->pending += 2;
+}
+
+// Handle one completion, returns true once the file has no more work
+static bool handle_completion(uring_t* ring, uring_file_t* file, size_t file_index, uring_op_t op, int result) {
+  file->pending--;
+
+  switch (op) {
+    case URING_OP_OPEN:
+      if (result < 0) {
+        file->failed = true;
+      } else {
+        file->fd = result;
+      }
+      break;
+    case URING_OP_STATX:
+      if (result < 0 || file->stx.stx_size == 0 || file->stx.stx_size > SIZE_MAX) {
+        file->failed = true;
+      } else {
+        file->size = file->stx.stx_size;
+      }
+      break;
+    case URING_OP_READ:
+      if (result <= 0) {
+        file->failed = true;
+      } else {
+        file->offset += (uint64_t)result;
+      }
+      break;
+    case URING_OP_CLOSE:
+      break;
+  }
+
+  if (file->pending > 0) {
+    return false;
+  }
+
+  if (!file->failed && file->fd >= 0) {
+    if (!file->buffer) {
+      file->buffer = (uint8_t*)nshader_malloc_tagged(NSHADER_ALLOC_TAG_READER_STAGING, (size_t)file->size);
+      file->failed = file->buffer == NULL;
+    }
+    if (!file->failed && file->offset < file->size) {
+      submit_read(ring, file, file_index);
+      return false;
+    }
+  }
+
+  // Done reading or failed, the close completes before the file is retired
+  if (file->fd >= 0) {
+    submit_close(ring, file, file_index);
+    return false;
+  }
+  return true;
+}
+
+// Cancel every operation still in flight and wait until all of them completed,
+// the kernel writes into file buffers and statx results until then, also after
+// the ring is closed. Returns false if the ring fails again, the files must
+// then be leaked rather than freed.
+static bool uring_cancel_and_drain(uring_t* ring, uring_file_t* files, const bool* busy) {
+  size_t num_pending = 0;
+  for (size_t slot = 0; slot < URING_MAX_FILES_IN_FLIGHT; ++slot) {
+    if (!busy[slot] || files[slot].pending == 0) {
+      continue;
+    }
+    num_pending += (size_t)files[slot].pending;
+
+    // A file waits on open and statx, a read, or a close
+    const uring_op_t ops[] = { URING_OP_OPEN, URING_OP_STATX, URING_OP_READ };
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); ++i) {
+      if (ring->to_submit >= URING_ENTRIES / 2 && !uring_submit_and_wait(ring, 0)) {
+        return false;
+      }
+      struct io_uring_sqe* sqe = uring_get_sqe(ring, 0, URING_OP_OPEN);
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = ((uint64_t)slot << 2) | (uint64_t)ops[i];
+      sqe->user_data = URING_CANCEL_USER_DATA;
+    }
+  }
+
+  while (num_pending > 0 || ring->to_submit > 0) {
+    if (!uring_submit_and_wait(ring, num_pending > 0 ? 1 : 0)) {
+      return false;
+    }
+
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+      if (cqe->user_data == URING_CANCEL_USER_DATA) {
+        continue;
+      }
+      uring_file_t* file = &files[cqe->user_data >> 2];
+      if ((uring_op_t)(cqe->user_data & 3) == URING_OP_OPEN && cqe->res >= 0) {
+        file->fd = cqe->res;
+      }
+      file->pending--;
+      num_pending--;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+  }
+  return true;
+}
+
+// #############################################################################
+// Bulk loading
+// #############################################################################
+
+bool nshader_uring_load_bulk(
+  const nshader_load_desc_t* descs,
+  size_t num_descs,
+  const nshader_read_options_t* options,
+  nshader_load_id_t first_id) {
+
+  uring_t ring;
+  if (!uring_open(&ring)) {
+    return false;
+  }
+
+  nshader_read_options_t read_options = { 0 };
+  if (options) {
+    read_options = *options;
+  }
+  read_options.borrow_blobs = false;
+
+  // Slots for the files in flight, indexed by user data
+  uring_file_t* files = (uring_file_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, URING_MAX_FILES_IN_FLIGHT, sizeof(uring_file_t));
+  size_t* slot_desc = (size_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, URING_MAX_FILES_IN_FLIGHT, sizeof(size_t));
+  size_t* free_slots = (size_t*)nshader_calloc_tagged(NSHADER_ALLOC_TAG_LOADER, URING_MAX_FILES_IN_FLIGHT, sizeof(size_t));
+  if (!files || !slot_desc || !free_slots) {
+    nshader_free(files);
+    nshader_free(slot_desc);
+    nshader_free(free_slots);
+    uring_close(&ring);
+    return false;
+  }
+
+  size_t num_free = URING_MAX_FILES_IN_FLIGHT;
+  for (size_t i = 0; i < num_free; ++i) {
+    free_slots[i] = num_free - 1 - i;
+  }
+
+  size_t next_desc = 0;
+  size_t in_flight = 0;
+  bool ring_failed = false;
+  for (;;) {
+    // Top up the ring with new files
+    while (next_desc < num_descs && num_free > 0) {
+      const nshader_load_desc_t* desc = &descs[next_desc];
+      if (desc->path && desc->callback) {
+        size_t slot = free_slots[--num_free];
+        memset(&files[slot], 0, sizeof(uring_file_t));
+        files[slot].fd = -1;
+        slot_desc[slot] = next_desc;
+        submit_open(&ring, &files[slot], desc->path, slot);
+        in_flight++;
+      }
+      next_desc++;
+    }
+
+    if (in_flight == 0) {
+      break;
+    }
+
+    if (!uring_submit_and_wait(&ring, 1)) {
+      ring_failed = true;
+      break;
+    }
+
+    unsigned head = *ring.cq_head;
+    unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+      size_t slot = (size_t)(cqe->user_data >> 2);
+      uring_op_t op = (uring_op_t)(cqe->user_data & 3);
+      uring_file_t* file = &files[slot];
+      if (!handle_completion(&ring, file, slot, op, cqe->res)) {
+        continue;
+      }
+
+      // Parse as soon as the file is in memory
+      const nshader_load_desc_t* desc = &descs[slot_desc[slot]];
+      nshader_t* shader = NULL;
+      if (!file->failed) {
+        shader = nshader_read_from_memory_ex(file->buffer, (size_t)file->size, &read_options);
+      }
+      nshader_free(file->buffer);
+      file->buffer = NULL;
+
+      desc->callback(desc->user, first_id + slot_desc[slot], shader ? NSHADER_LOAD_STATUS_OK : NSHADER_LOAD_STATUS_FAILED, shader);
+      free_slots[num_free++] = slot;
+      in_flight--;
+    }
+    __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+  }
+
+  // Report the requests left behind by a failed ring as failed. Their
+  // operations are cancelled and drained first, closing the ring does not
+  // wait for operations already handed to kernel workers.
+  bool drained = true;
+  if (ring_failed) {
+    bool busy[URING_MAX_FILES_IN_FLIGHT];
+    memset(busy, 1, sizeof(busy));
+    for (size_t i = 0; i < num_free; ++i) {
+      busy[free_slots[i]] = false;
+    }
+    drained = uring_cancel_and_drain(&ring, files, busy);
+    uring_close(&ring);
+
+    for (size_t slot = 0; slot < URING_MAX_FILES_IN_FLIGHT; ++slot) {
+      if (!busy[slot]) {
+        continue;
+      }
+      if (drained) {
+        if (files[slot].fd >= 0) {
+          close(files[slot].fd);
+        }
+        nshader_free(files[slot].buffer);
+      }
+      const nshader_load_desc_t* desc = &descs[slot_desc[slot]];
+      desc->callback(desc->user, first_id + slot_desc[slot], NSHADER_LOAD_STATUS_FAILED, NULL);
+    }
+    for (; next_desc < num_descs; ++next_desc) {
+      const nshader_load_desc_t* desc = &descs[next_desc];
+      if (desc->path && desc->callback) {
+        desc->callback(desc->user, first_id + next_desc, NSHADER_LOAD_STATUS_FAILED, NULL);
+      }
+    }
+  } else {
+    uring_close(&ring);
+  }
+
+  // Operations that could not be drained may still write into the files
+  if (drained) {
+    nshader_free(files);
+  }
+  nshader_free(slot_desc);
+  nshader_free(free_slots);
+  return true;
+}
+
+#else
+
+bool nshader_uring_load_bulk(
+  const nshader_load_desc_t* descs,
+  size_t num_descs,
+  const nshader_read_options_t* options,
+  nshader_load_id_t first_id) {
+  (void)descs;
+  (void)num_descs;
+  (void)options;
+  (void)first_id;
+  return false;
+}
+
+#endif
@@ -0,0 +1,282 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <nshader/nshader_validator.h>
+#include <nshader/nshader_info.h>
+#include "nshader_format_internal.h"
+#include <string.h>
+
+// Read-only cursor over the buffer, mirrors the reader without allocating
+typedef struct cursor_t {
+  const uint8_t* start;
+  const uint8_t* data;
+  size_t remaining;
+  nshader_validate_report_t* report;
+  bool string_table;     // Names are indices into a string table
+  uint32_t num_strings;
+} cursor_t;
+
+static bool fail(cursor_t* cursor, const uint8_t* at, nshader_validate_status_t status) {
+  cursor->report->status = status;
+  cursor->report->error_offset = (size_t)(at - cursor->start);
+  return false;
+}
+
+static bool skip(cursor_t* cursor, size_t size) {
+  if (cursor->remaining < size) {
+    return fail(cursor, cursor->data, NSHADER_VALIDATE_TRUNCATED);
+  }
+  cursor->data += size;
+  cursor->remaining -= size;
+  return true;
+}
+
+static bool take_u8(cursor_t* cursor, uint8_t* out) {
+  const uint8_t* at = cursor->data;
+  if (!skip(cursor, sizeof(uint8_t))) return false;
+  *out = *at;
+  return true;
+}
+
+static bool take_u32(cursor_t* cursor, uint32_t* out) {
+  const uint8_t* at = cursor->data;
+  if (!skip(cursor, sizeof(uint32_t))) return false;
+  uint32_t tmp;
+  memcpy(&tmp, at, sizeof(tmp));
+  *out = nshader_le32(tmp);
+  return true;
+}
+
+#define TAKE_U8(val) do { if (!take_u8(cursor, &(val))) return false; } while(0)
+#define TAKE_U32(val) do { if (!take_u32(cursor, &(val))) return false; } while(0)
+
+static bool check_string(cursor_t* cursor) {
+  uint32_t len;
+  TAKE_U32(len);
+  const uint8_t* str = cursor->data;
+  if (!skip(cursor, len)) return false;
+  if (memchr(str, '\0', len)) {
+    return fail(cursor, str, NSHADER_VALIDATE_BAD_STRING);
+  }
+  return true;
+}
+
+static bool check_name(cursor_t* cursor) {
+  if (!cursor->string_table) {
+    return check_string(cursor);
+  }
+  const uint8_t* at = cursor->data;
+  uint32_t index;
+  TAKE_U32(index);
+  if (index >= cursor->num_strings) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_STRING);
+  }
+  return true;
+}
+
+static bool check_bindings(cursor_t* cursor) {
+  const uint8_t* at = cursor->data;
+  uint32_t count;
+  TAKE_U32(count);
+  if (count > NSHADER_MAX_BINDINGS) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_COUNT);
+  }
+  if (!nshader_is_valid_binding_count(count, true, cursor->remaining)) {
+    return fail(cursor, at, NSHADER_VALIDATE_TRUNCATED);
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t location, vector_size, type;
+    if (!check_name(cursor)) return false;
+    TAKE_U32(location);
+    TAKE_U32(vector_size);
+    at = cursor->data;
+    TAKE_U32(type);
+    if (type >= NSHADER_BINDING_TYPE_COUNT) {
+      return fail(cursor, at, NSHADER_VALIDATE_BAD_ENUM);
+    }
+  }
+  return true;
+}
+
+static bool check_stage(cursor_t* cursor) {
+  const uint8_t* at = cursor->data;
+  uint8_t stage_type;
+  TAKE_U8(stage_type);
+  if (stage_type >= NSHADER_STAGE_TYPE_COUNT) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_ENUM);
+  }
+  if (!check_name(cursor)) return false;
+
+  if (stage_type == NSHADER_STAGE_TYPE_COMPUTE) {
+    // Resource counts and thread counts
+    return skip(cursor, 9 * sizeof(uint32_t));
+  }
+
+  // Vertex and fragment: resource counts, then inputs and outputs
+  if (!skip(cursor, 4 * sizeof(uint32_t))) return false;
+  return check_bindings(cursor) && check_bindings(cursor);
+}
+
+static bool check_shader(cursor_t* cursor) {
+  nshader_validate_report_t* report = cursor->report;
+  const uint8_t* at = cursor->data;
+
+  uint32_t magic;
+  TAKE_U32(magic);
+  if (magic != NSHADER_MAGIC) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_MAGIC);
+  }
+
+  at = cursor->data;
+  TAKE_U32(report->version);
+  if (report->version < NSHADER_VERSION_MIN || report->version > NSHADER_VERSION) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_VERSION);
+  }
+
+  uint32_t flags = 0;
+  uint32_t file_alignment = 1;
+  if (report->version >= 2) {
+    at = cursor->data;
+    TAKE_U32(flags);
+    TAKE_U32(file_alignment);
+    if ((flags & ~NSHADER_FORMAT_KNOWN_FLAGS) != 0 || !nshader_is_valid_blob_alignment(file_alignment)) {
+      return fail(cursor, at, NSHADER_VALIDATE_BAD_HEADER);
+    }
+  }
+  report->has_checksums = (flags & NSHADER_FORMAT_FLAG_CHECKSUMS) != 0;
+  if ((flags & NSHADER_FORMAT_FLAG_HASH) && !skip(cursor, 2 * sizeof(uint64_t))) return false;
+
+  if (flags & NSHADER_FORMAT_FLAG_STRINGS) {
+    at = cursor->data;
+    TAKE_U32(cursor->num_strings);
+    if (cursor->num_strings > NSHADER_MAX_STRINGS) {
+      return fail(cursor, at, NSHADER_VALIDATE_BAD_COUNT);
+    }
+    if (!nshader_is_valid_string_count(cursor->num_strings, true, cursor->remaining)) {
+      return fail(cursor, at, NSHADER_VALIDATE_TRUNCATED);
+    }
+    for (uint32_t i = 0; i < cursor->num_strings; i++) {
+      if (!check_string(cursor)) return false;
+    }
+    cursor->string_table = true;
+  }
+
+  at = cursor->data;
+  uint8_t shader_type;
+  TAKE_U8(shader_type);
+  if (shader_type >= NSHADER_SHADER_TYPE_COUNT) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_ENUM);
+  }
+
+  at = cursor->data;
+  TAKE_U32(report->num_stages);
+  if (report->num_stages > NSHADER_STAGE_TYPE_COUNT) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_COUNT);
+  }
+  for (uint32_t i = 0; i < report->num_stages; i++) {
+    if (!check_stage(cursor)) return false;
+  }
+
+  at = cursor->data;
+  TAKE_U32(report->num_backends);
+  if (report->num_backends > NSHADER_BACKEND_COUNT) {
+    return fail(cursor, at, NSHADER_VALIDATE_BAD_COUNT);
+  }
+  for (uint32_t i = 0; i < report->num_backends; i++) {
+    at = cursor->data;
+    uint8_t backend;
+    TAKE_U8(backend);
+    if (backend >= NSHADER_BACKEND_COUNT) {
+      return fail(cursor, at, NSHADER_VALIDATE_BAD_ENUM);
+    }
+  }
+
+  // Stored checksums are not verified, see nshader_read_options_t::verify
+  if (report->has_checksums && !skip(cursor, sizeof(uint32_t))) return false;
+
+  // Blob payloads are only bounds-checked
+  for (size_t i = 0; i < (size_t)NSHADER_STAGE_TYPE_COUNT * NSHADER_BACKEND_COUNT; i++) {
+    uint8_t has_blob;
+    TAKE_U8(has_blob);
+    if (has_blob) {
+      uint32_t blob_size;
+      TAKE_U32(blob_size);
+      if (report->has_checksums && !skip(cursor, sizeof(uint32_t))) return false;
+      size_t offset = (size_t)(cursor->data - cursor->start);
+      if (!skip(cursor, nshader_align_padding(offset, file_alignment))) return false;
+      if (!skip(cursor, blob_size)) return false;
+      report->num_blobs++;
+      report->blob_bytes += blob_size;
+    }
+  }
+
+  report->size = (size_t)(cursor->data - cursor->start);
+  return true;
+}
+
+NSHADER_API bool nshader_validate_memory(const void* buffer, size_t buffer_size, nshader_validate_report_t* report) {
+  nshader_validate_report_t local_report;
+  if (!report) {
+    report = &local_report;
+  }
+  memset(report, 0, sizeof(*report));
+
+  if (!buffer) {
+    report->status = NSHADER_VALIDATE_TRUNCATED;
+    return false;
+  }
+
+  cursor_t cursor;
+  cursor.start = (const uint8_t*)buffer;
+  cursor.data = cursor.start;
+  cursor.remaining = buffer_size;
+  cursor.report = report;
+  cursor.string_table = false;
+  cursor.num_strings = 0;
+  return check_shader(&cursor);
+}
+
+NSHADER_API const char* nshader_validate_status_to_string(nshader_validate_status_t status) {
+  switch (status) {
+    case NSHADER_VALIDATE_OK:
+      return "ok";
+    case NSHADER_VALIDATE_TRUNCATED:
+      return "truncated";
+    case NSHADER_VALIDATE_BAD_MAGIC:
+      return "bad magic";
+    case NSHADER_VALIDATE_BAD_VERSION:
+      return "unsupported version";
+    case NSHADER_VALIDATE_BAD_HEADER:
+      return "bad header";
+    case NSHADER_VALIDATE_BAD_ENUM:
+      return "enum out of range";
+    case NSHADER_VALIDATE_BAD_COUNT:
+      return "count out of range";
+    case NSHADER_VALIDATE_BAD_STRING:
+      return "bad string";
+    default:
+      return "unknown";
+  }
+}
@@ -25,108 +25,284 @@ SOFTWARE.
 
 #include <nshader/nshader_writer.h>
 #include "nshader_type_internal.h"
+#include "nshader_base_internal.h"
+#include "nshader_format_internal.h"
+#include "nshader_checksum_internal.h"
 #include <nshader/nshader_base.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
-// Endianness conversion helpers - always write as little-endian
-static uint32_t to_le32(uint32_t val) {
-#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-  return ((val & 0xFF000000) >> 24) |
-         ((val & 0x00FF0000) >> 8)  |
-         ((val & 0x0000FF00) << 8)  |
-         ((val & 0x000000FF) << 24);
-#else
-  return val;  // Already little-endian
-#endif
-}
-
-// Helper to write data to buffer with bounds checking
-static bool write_data(const void* data, size_t size, void** buffer, size_t* remaining, size_t* written) {
-  if (*buffer) {
-    if (*remaining < size) {
+// Size of the staging buffer used when streaming to a file, metadata is
+// gathered here while large blob payloads bypass it
+#define WRITER_STAGING_SIZE 4096
+
+// Distinct entry points and binding names of a shader, sorted so that the
+// table only depends on the content
+typedef struct string_table_t {
+  const char** strings;
+  size_t count;
+  size_t capacity;  // Allocated entries, one per name before removing duplicates
+} string_table_t;
+
+// Serialization target, either a memory buffer (or NULL to only count bytes)
+// or a stream fed through a small staging buffer
+typedef struct writer_t {
+  uint8_t* buffer;         // Destination in memory mode, staging buffer in stream mode
+  size_t capacity;         // Size of buffer
+  size_t used;             // Bytes pending in the staging buffer (stream mode)
+  size_t written;          // Total bytes emitted so far
+  const nshader_io_t* io;  // Destination in stream mode, NULL in memory mode
+  bool checksum;           // Accumulate crc over every byte written
+  uint32_t crc;            // CRC-32C of the bytes written while checksum was set
+  nshader_hash_state_t* hash;  // Feed every byte to a hash instead of storing it
+  const string_table_t* strings;  // Write names as indices into this table, if set
+} writer_t;
+
+// Size queries write nothing, so checksums are not computed
+static bool writer_is_counting(const writer_t* writer) {
+  return !writer->buffer && !writer->io && !writer->hash;
+}
+
+static bool io_write_all(const nshader_io_t* io, const void* data, size_t size) {
+  const uint8_t* src = (const uint8_t*)data;
+  while (size > 0) {
+    size_t n = io->write(io->user, src, size);
+    if (n == 0 || n > size) {
+      return false;
+    }
+    src += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool writer_flush(writer_t* writer) {
+  if (writer->used > 0) {
+    if (!io_write_all(writer->io, writer->buffer, writer->used)) {
       return false;
     }
-    memcpy(*buffer, data, size);
-    *buffer = (uint8_t*)*buffer + size;
-    *remaining -= size;
+    writer->used = 0;
   }
-  *written += size;
+  return true;
+}
+
+// Helper to write data with bounds checking
+static bool write_data(const void* data, size_t size, writer_t* writer) {
+  if (writer->hash) {
+    nshader_hash_update(writer->hash, data, size);
+  } else if (writer->io) {
+    if (size > writer->capacity - writer->used) {
+      if (!writer_flush(writer)) {
+        return false;
+      }
+    }
+    if (size >= writer->capacity) {
+      // Write large payloads directly from their storage
+      if (!io_write_all(writer->io, data, size)) {
+        return false;
+      }
+    } else {
+      memcpy(writer->buffer + writer->used, data, size);
+      writer->used += size;
+    }
+  } else if (writer->buffer) {
+    if (writer->capacity - writer->written < size) {
+      return false;
+    }
+    memcpy(writer->buffer + writer->written, data, size);
+  }
+  if (writer->checksum && !writer_is_counting(writer)) {
+    writer->crc = nshader_crc32c(writer->crc, data, size);
+  }
+  writer->written += size;
   return true;
 }
 
 // Helper macros for writing primitives (with endianness conversion)
-#define WRITE_U8(val) do { uint8_t v = (val); if (!write_data(&v, sizeof(v), &buffer, &remaining, &written)) return 0; } while(0)
-#define WRITE_U32(val) do { uint32_t v = to_le32(val); if (!write_data(&v, sizeof(v), &buffer, &remaining, &written)) return 0; } while(0)
-#define WRITE_BYTES(ptr, len) do { if (!write_data((ptr), (len), &buffer, &remaining, &written)) return 0; } while(0)
+#define WRITE_U8(val) do { uint8_t v = (val); if (!write_data(&v, sizeof(v), writer)) return false; } while(0)
+#define WRITE_U32(val) do { uint32_t v = nshader_le32(val); if (!write_data(&v, sizeof(v), writer)) return false; } while(0)
+#define WRITE_U64(val) do { uint64_t v = nshader_le64(val); if (!write_data(&v, sizeof(v), writer)) return false; } while(0)
+#define WRITE_BYTES(ptr, len) do { if (!write_data((ptr), (len), writer)) return false; } while(0)
+
+// Zero padding written in front of blob payloads
+static const uint8_t g_zero_padding[NSHADER_MAX_BLOB_ALIGNMENT];
 
-static bool write_string(const char* str, void** buffer, size_t* remaining, size_t* written) {
+static bool write_string(const char* str, writer_t* writer) {
   uint32_t len = str ? (uint32_t)strlen(str) : 0;
-  uint32_t len_le = to_le32(len);
-  if (!write_data(&len_le, sizeof(len_le), buffer, remaining, written)) return false;
+  uint32_t len_le = nshader_le32(len);
+  if (!write_data(&len_le, sizeof(len_le), writer)) return false;
   if (len > 0) {
-    if (!write_data(str, len, buffer, remaining, written)) return false;
+    if (!write_data(str, len, writer)) return false;
   }
   return true;
 }
 
-static bool write_binding(const nshader_stage_binding_t* binding, void** buffer, size_t* remaining, size_t* written) {
-  if (!write_string(binding->name, buffer, remaining, written)) return false;
-  uint32_t loc = to_le32(binding->location);
-  uint32_t vec = to_le32(binding->vector_size);
-  if (!write_data(&loc, sizeof(loc), buffer, remaining, written)) return false;
-  if (!write_data(&vec, sizeof(vec), buffer, remaining, written)) return false;
-  if (!write_data(&binding->type, sizeof(binding->type), buffer, remaining, written)) return false;
+static int compare_strings(const void* a, const void* b) {
+  return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+static const char* table_string(const char* str) {
+  return str ? str : "";
+}
+
+static void add_binding_names(string_table_t* table, const nshader_stage_binding_t* bindings, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    table->strings[table->count++] = table_string(bindings[i].name);
+  }
+}
+
+static size_t count_binding_names(const nshader_stage_t* stage) {
+  switch (stage->type) {
+    case NSHADER_STAGE_TYPE_VERTEX:
+      return stage->metadata.vertex.input_count + stage->metadata.vertex.output_count;
+    case NSHADER_STAGE_TYPE_FRAGMENT:
+      return stage->metadata.fragment.input_count + stage->metadata.fragment.output_count;
+    default:
+      return 0;
+  }
+}
+
+// Gather every name, sort and drop duplicates
+static bool build_string_table(const nshader_t* shader, const nshader_allocator_t* allocator, string_table_t* table) {
+  const nshader_info_t* info = &shader->info;
+  memset(table, 0, sizeof(*table));
+  for (size_t i = 0; i < info->num_stages; i++) {
+    table->capacity += 1 + count_binding_names(&info->stages[i]);
+  }
+  if (table->capacity == 0) {
+    return true;
+  }
+
+  table->strings = (const char**)nshader_allocator_alloc(allocator, NSHADER_ALLOC_TAG_WRITER_STAGING, table->capacity * sizeof(const char*), _Alignof(const char*));
+  if (!table->strings) {
+    return false;
+  }
+
+  for (size_t i = 0; i < info->num_stages; i++) {
+    const nshader_stage_t* stage = &info->stages[i];
+    table->strings[table->count++] = table_string(stage->entry_point);
+    if (stage->type == NSHADER_STAGE_TYPE_VERTEX) {
+      add_binding_names(table, stage->metadata.vertex.inputs, stage->metadata.vertex.input_count);
+      add_binding_names(table, stage->metadata.vertex.outputs, stage->metadata.vertex.output_count);
+    } else if (stage->type == NSHADER_STAGE_TYPE_FRAGMENT) {
+      add_binding_names(table, stage->metadata.fragment.inputs, stage->metadata.fragment.input_count);
+      add_binding_names(table, stage->metadata.fragment.outputs, stage->metadata.fragment.output_count);
+    }
+  }
+
+  qsort(table->strings, table->count, sizeof(const char*), compare_strings);
+  size_t unique = 1;
+  for (size_t i = 1; i < table->count; i++) {
+    if (strcmp(table->strings[i], table->strings[unique - 1]) != 0) {
+      table->strings[unique++] = table->strings[i];
+    }
+  }
+  table->count = unique;
+  return true;
+}
+
+static void free_string_table(const nshader_allocator_t* allocator, string_table_t* table) {
+  if (table->strings) {
+    nshader_allocator_free(allocator, NSHADER_ALLOC_TAG_WRITER_STAGING, (void*)table->strings, table->capacity * sizeof(const char*));
+  }
+}
+
+// Write an entry point or binding name, inline or as a string table index
+static bool write_name(const char* str, writer_t* writer) {
+  if (!writer->strings) {
+    return write_string(str, writer);
+  }
+
+  str = table_string(str);
+  const char** found = (const char**)bsearch(&str, writer->strings->strings, writer->strings->count, sizeof(const char*), compare_strings);
+  if (!found) {
+    return false;
+  }
+  uint32_t index = nshader_le32((uint32_t)(found - writer->strings->strings));
+  return write_data(&index, sizeof(index), writer);
+}
+
+static bool write_binding(const nshader_stage_binding_t* binding, writer_t* writer) {
+  if (!write_name(binding->name, writer)) return false;
+  uint32_t loc = nshader_le32(binding->location);
+  uint32_t vec = nshader_le32(binding->vector_size);
+  uint32_t type = nshader_le32((uint32_t)binding->type);
+  if (!write_data(&loc, sizeof(loc), writer)) return false;
+  if (!write_data(&vec, sizeof(vec), writer)) return false;
+  if (!write_data(&type, sizeof(type), writer)) return false;
   return true;
 }
 
-static bool write_stage_metadata(nshader_stage_type_t stage_type, const nshader_stage_metadata_t* metadata, void** buffer, size_t* remaining, size_t* written) {
+// Canonical binding order: location, then name, then original index
+static bool binding_less(const nshader_stage_binding_t* bindings, size_t a, size_t b) {
+  if (bindings[a].location != bindings[b].location) {
+    return bindings[a].location < bindings[b].location;
+  }
+  int cmp = strcmp(bindings[a].name ? bindings[a].name : "", bindings[b].name ? bindings[b].name : "");
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  return a < b;
+}
+
+// Write count and bindings in canonical order, selecting the next binding on
+// each step so that no scratch memory is needed (binding lists are short)
+static bool write_bindings(const nshader_stage_binding_t* bindings, size_t count, writer_t* writer) {
+  uint32_t tmp = nshader_le32((uint32_t)count);
+  if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+
+  size_t last = SIZE_MAX;
+  for (size_t n = 0; n < count; n++) {
+    size_t next = SIZE_MAX;
+    for (size_t i = 0; i < count; i++) {
+      if (last != SIZE_MAX && !binding_less(bindings, last, i)) continue;
+      if (next == SIZE_MAX || binding_less(bindings, i, next)) {
+        next = i;
+      }
+    }
+    if (!write_binding(&bindings[next], writer)) return false;
+    last = next;
+  }
+  return true;
+}
+
+static bool write_stage_metadata(nshader_stage_type_t stage_type, const nshader_stage_metadata_t* metadata, writer_t* writer) {
   switch (stage_type) {
     case NSHADER_STAGE_TYPE_VERTEX: {
       const nshader_stage_metadata_vertex_t* vert = &metadata->vertex;
       uint32_t tmp;
-      tmp = to_le32(vert->num_samplers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(vert->num_storage_textures); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(vert->num_storage_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(vert->num_uniform_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32((uint32_t)vert->input_count); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      for (size_t i = 0; i < vert->input_count; i++) {
-        if (!write_binding(&vert->inputs[i], buffer, remaining, written)) return false;
-      }
-      tmp = to_le32((uint32_t)vert->output_count); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      for (size_t i = 0; i < vert->output_count; i++) {
-        if (!write_binding(&vert->outputs[i], buffer, remaining, written)) return false;
-      }
+      tmp = nshader_le32(vert->num_samplers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(vert->num_storage_textures); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(vert->num_storage_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(vert->num_uniform_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      if (!write_bindings(vert->inputs, vert->input_count, writer)) return false;
+      if (!write_bindings(vert->outputs, vert->output_count, writer)) return false;
       break;
     }
     case NSHADER_STAGE_TYPE_FRAGMENT: {
       const nshader_stage_metadata_fragment_t* frag = &metadata->fragment;
       uint32_t tmp;
-      tmp = to_le32(frag->num_samplers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(frag->num_storage_textures); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(frag->num_storage_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(frag->num_uniform_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32((uint32_t)frag->input_count); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      for (size_t i = 0; i < frag->input_count; i++) {
-        if (!write_binding(&frag->inputs[i], buffer, remaining, written)) return false;
-      }
-      tmp = to_le32((uint32_t)frag->output_count); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      for (size_t i = 0; i < frag->output_count; i++) {
-        if (!write_binding(&frag->outputs[i], buffer, remaining, written)) return false;
-      }
+      tmp = nshader_le32(frag->num_samplers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(frag->num_storage_textures); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(frag->num_storage_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(frag->num_uniform_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      if (!write_bindings(frag->inputs, frag->input_count, writer)) return false;
+      if (!write_bindings(frag->outputs, frag->output_count, writer)) return false;
       break;
     }
     case NSHADER_STAGE_TYPE_COMPUTE: {
       const nshader_stage_metadata_compute_t* comp = &metadata->compute;
       uint32_t tmp;
-      tmp = to_le32(comp->num_samplers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->num_readonly_storage_textures); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->num_readonly_storage_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->num_readwrite_storage_textures); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->num_readwrite_storage_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->num_uniform_buffers); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->threadcount_x); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->threadcount_y); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
-      tmp = to_le32(comp->threadcount_z); if (!write_data(&tmp, sizeof(tmp), buffer, remaining, written)) return false;
+      tmp = nshader_le32(comp->num_samplers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->num_readonly_storage_textures); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->num_readonly_storage_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->num_readwrite_storage_textures); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->num_readwrite_storage_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->num_uniform_buffers); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->threadcount_x); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->threadcount_y); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
+      tmp = nshader_le32(comp->threadcount_z); if (!write_data(&tmp, sizeof(tmp), writer)) return false;
       break;
     }
     default:
@@ -135,37 +311,69 @@ static bool write_stage_metadata(nshader_stage_type_t stage_type, const nshader_
   return true;
 }
 
-NSHADER_API size_t nshader_write_to_memory(const nshader_t* shader, void* buffer, size_t buffer_size) {
-  if (!shader) {
-    return 0;
+// Shader info, stages, backends and blobs, everything after the header
+// Stages and backends are written in enum order, so the stored counts only
+// match what is written if every entry is in range and appears once
+static bool has_canonical_entries(const nshader_info_t* info) {
+  bool seen_stages[NSHADER_STAGE_TYPE_COUNT] = {0};
+  for (size_t i = 0; i < info->num_stages; i++) {
+    if ((unsigned)info->stages[i].type >= NSHADER_STAGE_TYPE_COUNT || seen_stages[info->stages[i].type]) {
+      return false;
+    }
+    seen_stages[info->stages[i].type] = true;
   }
+  bool seen_backends[NSHADER_BACKEND_COUNT] = {0};
+  for (size_t i = 0; i < info->num_backends; i++) {
+    if ((unsigned)info->backends[i] >= NSHADER_BACKEND_COUNT || seen_backends[info->backends[i]]) {
+      return false;
+    }
+    seen_backends[info->backends[i]] = true;
+  }
+  return true;
+}
 
-  size_t written = 0;
-  size_t remaining = buffer_size;
-  void* orig_buffer = buffer;
+static bool write_body(const nshader_t* shader, uint32_t blob_alignment, bool checksums, writer_t* writer) {
+  if (!has_canonical_entries(&shader->info)) {
+    return false;
+  }
 
-  // Write header
-  uint32_t magic = NSHADER_MAGIC;
-  WRITE_U32(magic);
-  WRITE_U32(NSHADER_VERSION);
+  // Write the string table, names below are indices into it
+  if (writer->strings) {
+    WRITE_U32((uint32_t)writer->strings->count);
+    for (size_t i = 0; i < writer->strings->count; i++) {
+      if (!write_string(writer->strings->strings[i], writer)) return false;
+    }
+  }
 
   // Write shader info
   const nshader_info_t* info = &shader->info;
   WRITE_U8(info->type);
   WRITE_U32((uint32_t)info->num_stages);
 
-  // Write stages
-  for (size_t i = 0; i < info->num_stages; i++) {
-    const nshader_stage_t* stage = &info->stages[i];
-    WRITE_U8(stage->type);
-    if (!write_string(stage->entry_point, &buffer, &remaining, &written)) return 0;
-    if (!write_stage_metadata(stage->type, &stage->metadata, &buffer, &remaining, &written)) return 0;
+  // Write stages in stage type order, whatever order they were compiled in
+  for (int stage_type = 0; stage_type < NSHADER_STAGE_TYPE_COUNT; stage_type++) {
+    for (size_t i = 0; i < info->num_stages; i++) {
+      const nshader_stage_t* stage = &info->stages[i];
+      if ((int)stage->type != stage_type) continue;
+      WRITE_U8(stage->type);
+      if (!write_name(stage->entry_point, writer)) return false;
+      if (!write_stage_metadata(stage->type, &stage->metadata, writer)) return false;
+    }
   }
 
-  // Write backends
+  // Write backends in backend order
   WRITE_U32((uint32_t)info->num_backends);
-  for (size_t i = 0; i < info->num_backends; i++) {
-    WRITE_U8(info->backends[i]);
+  for (int backend = 0; backend < NSHADER_BACKEND_COUNT; backend++) {
+    for (size_t i = 0; i < info->num_backends; i++) {
+      if ((int)info->backends[i] != backend) continue;
+      WRITE_U8(info->backends[i]);
+    }
+  }
+
+  // Metadata checksum covers everything written so far
+  if (checksums) {
+    writer->checksum = false;
+    WRITE_U32(writer->crc);
   }
 
   // Write blobs
@@ -175,6 +383,10 @@ NSHADER_API size_t nshader_write_to_memory(const nshader_t* shader, void* buffer
       if (blob && blob->data && blob->size > 0) {
         WRITE_U8(1);  // Has blob
         WRITE_U32((uint32_t)blob->size);
+        if (checksums) {
+          WRITE_U32(writer_is_counting(writer) ? 0 : nshader_crc32c(0, blob->data, blob->size));
+        }
+        WRITE_BYTES(g_zero_padding, nshader_align_padding(writer->written, blob_alignment));
         WRITE_BYTES(blob->data, blob->size);
       } else {
         WRITE_U8(0);  // No blob
@@ -182,41 +394,154 @@ NSHADER_API size_t nshader_write_to_memory(const nshader_t* shader, void* buffer
     }
   }
 
-  return written;
+  return true;
 }
 
-NSHADER_API bool nshader_write_to_file(const nshader_t* shader, FILE* file) {
-  if (!shader || !file) {
+static bool write_shader(const nshader_t* shader, uint32_t blob_alignment, uint32_t flags, const nshader_allocator_t* allocator, writer_t* writer) {
+  bool checksums = (flags & NSHADER_FORMAT_FLAG_CHECKSUMS) != 0;
+  writer->checksum = checksums;
+  writer->crc = 0;
+
+  // The hash is computed before anything is written, size queries skip it
+  nshader_hash_t hash = {0};
+  if (!writer_is_counting(writer) && !nshader_hash(shader, &hash)) {
     return false;
   }
 
-  // Calculate size needed
-  size_t size = nshader_write_to_memory(shader, NULL, 0);
-  if (size == 0) {
+  // Write header
+  uint32_t magic = NSHADER_MAGIC;
+  WRITE_U32(magic);
+  WRITE_U32(NSHADER_VERSION);
+  WRITE_U32(flags);
+  WRITE_U32(blob_alignment);
+  if (flags & NSHADER_FORMAT_FLAG_HASH) {
+    WRITE_U64(hash.lo);
+    WRITE_U64(hash.hi);
+  }
+
+  if ((flags & NSHADER_FORMAT_FLAG_STRINGS) == 0) {
+    return write_body(shader, blob_alignment, checksums, writer);
+  }
+
+  string_table_t strings;
+  if (!build_string_table(shader, allocator, &strings)) {
     return false;
   }
+  writer->strings = &strings;
+  bool result = write_body(shader, blob_alignment, checksums, writer);
+  writer->strings = NULL;
+  free_string_table(allocator, &strings);
+  return result;
+}
 
-  // Allocate buffer
-  void* buffer = nshader_malloc(size);
-  if (!buffer) {
+// The hash covers the body serialized without padding or checksums, so it does
+// not depend on write options
+NSHADER_API bool nshader_hash(const nshader_t* shader, nshader_hash_t* out_hash) {
+  if (!shader || !out_hash) {
     return false;
   }
 
-  // Write to buffer
-  size_t written = nshader_write_to_memory(shader, buffer, size);
-  if (written != size) {
-    nshader_free(buffer);
+  if (shader->has_hash) {
+    *out_hash = shader->hash;
+    return true;
+  }
+  if (shader->skipped_blobs) {
     return false;
   }
 
-  // Write to file
-  size_t result = fwrite(buffer, 1, size, file);
-  nshader_free(buffer);
+  nshader_hash_state_t state;
+  nshader_hash_init(&state);
+  writer_t writer = {0};
+  writer.hash = &state;
+  if (!write_body(shader, 1, false, &writer)) {
+    return false;
+  }
+  nshader_hash_final(&state, &out_hash->lo, &out_hash->hi);
+  return true;
+}
 
-  return result == size;
+static uint32_t write_options_blob_alignment(const nshader_write_options_t* options) {
+  return options && options->blob_alignment ? options->blob_alignment : NSHADER_DEFAULT_BLOB_ALIGNMENT;
+}
+
+static uint32_t write_options_flags(const nshader_write_options_t* options) {
+  uint32_t flags = NSHADER_FORMAT_FLAG_HASH | NSHADER_FORMAT_FLAG_STRINGS;
+  if (options && options->checksums) {
+    flags |= NSHADER_FORMAT_FLAG_CHECKSUMS;
+  }
+  return flags;
+}
+
+NSHADER_API size_t nshader_write_to_memory(const nshader_t* shader, void* buffer, size_t buffer_size) {
+  return nshader_write_to_memory_ex(shader, buffer, buffer_size, NULL);
+}
+
+NSHADER_API size_t nshader_write_to_memory_ex(const nshader_t* shader, void* buffer, size_t buffer_size, const nshader_write_options_t* options) {
+  if (!shader || shader->skipped_blobs) {
+    return 0;
+  }
+
+  uint32_t blob_alignment = write_options_blob_alignment(options);
+  if (!nshader_is_valid_blob_alignment(blob_alignment)) {
+    return 0;
+  }
+
+  writer_t writer = {0};
+  writer.buffer = (uint8_t*)buffer;
+  writer.capacity = buffer_size;
+  if (!write_shader(shader, blob_alignment, write_options_flags(options), options ? options->allocator : NULL, &writer)) {
+    return 0;
+  }
+
+  return writer.written;
+}
+
+NSHADER_API bool nshader_write_to_io(const nshader_t* shader, const nshader_io_t* io, const nshader_write_options_t* options) {
+  if (!shader || shader->skipped_blobs || !io || !io->write) {
+    return false;
+  }
+
+  uint32_t blob_alignment = write_options_blob_alignment(options);
+  if (!nshader_is_valid_blob_alignment(blob_alignment)) {
+    return false;
+  }
+
+  // Allocate staging buffer, peak memory stays independent of the blob sizes
+  const nshader_allocator_t* allocator = options ? options->allocator : NULL;
+  void* staging = nshader_allocator_alloc(allocator, NSHADER_ALLOC_TAG_WRITER_STAGING, WRITER_STAGING_SIZE, 1);
+  if (!staging) {
+    return false;
+  }
+
+  writer_t writer = {0};
+  writer.buffer = (uint8_t*)staging;
+  writer.capacity = WRITER_STAGING_SIZE;
+  writer.io = io;
+  bool result = write_shader(shader, blob_alignment, write_options_flags(options), allocator, &writer) && writer_flush(&writer);
+
+  nshader_allocator_free(allocator, NSHADER_ALLOC_TAG_WRITER_STAGING, staging, WRITER_STAGING_SIZE);
+
+  return result;
+}
+
+NSHADER_API bool nshader_write_to_file(const nshader_t* shader, FILE* file) {
+  return nshader_write_to_file_ex(shader, file, NULL);
+}
+
+NSHADER_API bool nshader_write_to_file_ex(const nshader_t* shader, FILE* file, const nshader_write_options_t* options) {
+  if (!file) {
+    return false;
+  }
+
+  nshader_io_t io = nshader_io_from_file(file);
+  return nshader_write_to_io(shader, &io, options);
 }
 
 NSHADER_API bool nshader_write_to_path(const nshader_t* shader, const char* filepath) {
+  return nshader_write_to_path_ex(shader, filepath, NULL);
+}
+
+NSHADER_API bool nshader_write_to_path_ex(const nshader_t* shader, const char* filepath, const nshader_write_options_t* options) {
   if (!shader || !filepath) {
     return false;
   }
@@ -226,7 +551,7 @@ NSHADER_API bool nshader_write_to_path(const nshader_t* shader, const char* file
     return false;
   }
 
-  bool result = nshader_write_to_file(shader, file);
+  bool result = nshader_write_to_file_ex(shader, file, options);
   fclose(file);
 
   return result;
@@ -23,7 +23,9 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 
 extern "C" {
     #include <nshader/nshader_base.h>
@@ -72,3 +74,59 @@ TEST(NShaderBaseTests, CustomMemoryAllocator) {
     // Reset to default allocators
     nshader_set_memory_fns(malloc, free, calloc, realloc);
 }
+
+TEST(NShaderBaseTests, AllocTracking) {
+    if (!nshader_alloc_tracking_enabled()) {
+        GTEST_SKIP() << "nshader was built without NSHADER_ALLOC_TRACKING";
+    }
+
+    nshader_reset_alloc_stats();
+
+    nshader_alloc_stats_t before;
+    nshader_get_alloc_stats(&before);
+
+    void* ptr = nshader_malloc(64);
+    ASSERT_NE(ptr, nullptr);
+    ptr = nshader_realloc(ptr, 128);
+    ASSERT_NE(ptr, nullptr);
+
+    nshader_alloc_stats_t during;
+    nshader_get_alloc_stats(&during);
+    const nshader_alloc_counters_t* general = &during.tags[NSHADER_ALLOC_TAG_GENERAL];
+    EXPECT_EQ(1u, general->num_allocs);
+    EXPECT_EQ(before.tags[NSHADER_ALLOC_TAG_GENERAL].live_bytes + 128, general->live_bytes);
+
+    nshader_free(ptr);
+
+    nshader_alloc_stats_t after;
+    nshader_get_alloc_stats(&after);
+    general = &after.tags[NSHADER_ALLOC_TAG_GENERAL];
+    EXPECT_EQ(1u, general->num_frees);
+    EXPECT_EQ(before.tags[NSHADER_ALLOC_TAG_GENERAL].live_bytes, general->live_bytes);
+    EXPECT_GE(general->peak_bytes, 128u);
+}
+
+TEST(NShaderBaseTests, AllocTagToString) {
+    EXPECT_STREQ("reader blob", nshader_alloc_tag_to_string(NSHADER_ALLOC_TAG_READER_BLOB));
+    EXPECT_STREQ("error list", nshader_alloc_tag_to_string(NSHADER_ALLOC_TAG_ERROR_LIST));
+    EXPECT_STREQ("unknown", nshader_alloc_tag_to_string(NSHADER_ALLOC_TAG_COUNT));
+}
+
+TEST(NShaderBaseTests, DefaultAllocatorAlignment) {
+    const nshader_allocator_t* allocator = nshader_default_allocator();
+    ASSERT_NE(allocator, nullptr);
+
+    for (size_t align = 1; align <= 128; align *= 2) {
+        void* ptr = allocator->alloc(allocator->user, 100, align);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % align, 0u);
+        // Small alignments keep malloc's natural alignment
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0u);
+        memset(ptr, 0xAB, 100);
+        allocator->free(allocator->user, ptr, 100);
+    }
+
+    // Alignments must be powers of two within the supported range
+    EXPECT_EQ(allocator->alloc(allocator->user, 16, 256), nullptr);
+    EXPECT_EQ(allocator->alloc(allocator->user, 16, 24), nullptr);
+}
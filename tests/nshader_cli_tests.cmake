@@ -0,0 +1,78 @@
+#
+# Command line tests, run by CTest as
+#   cmake -DNSHADER_CLI=<nshader> -DSOURCE_DIR=<repo> -DWORK_DIR=<dir> -P nshader_cli_tests.cmake
+#
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+function(run_cli expected_result out_var)
+    execute_process(
+        COMMAND ${NSHADER_CLI} ${ARGN}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+    )
+    if(NOT result EQUAL expected_result)
+        message(FATAL_ERROR "nshader ${ARGN} exited with ${result}, expected ${expected_result}:\n${output}")
+    endif()
+    set(${out_var} "${output}" PARENT_SCOPE)
+endfunction()
+
+#
+# build: Flags on the command line win over the manifest
+#
+
+file(WRITE ${WORK_DIR}/manifest.json "{
+  \"checksums\": false,
+  \"shaders\": [
+    { \"output\": \"Fullscreen.nshader\", \"vertex\": \"${SOURCE_DIR}/samples/Fullscreen.vert.hlsl\" }
+  ]
+}
+")
+# Inputs from the same second as an output count as newer
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.1)
+
+run_cli(0 output build ${WORK_DIR}/manifest.json --checksums)
+run_cli(0 output verify ${WORK_DIR}/Fullscreen.nshader)
+if(output MATCHES "no checksums stored")
+    message(FATAL_ERROR "\"checksums\": false in the manifest overrode --checksums:\n${output}")
+endif()
+
+#
+# build: Changed options rebuild outputs that are otherwise up to date
+#
+
+run_cli(0 output build ${WORK_DIR}/manifest.json --checksums)
+if(NOT output MATCHES "Up to date: +1")
+    message(FATAL_ERROR "Unchanged shader was rebuilt:\n${output}")
+endif()
+run_cli(0 output build ${WORK_DIR}/manifest.json --checksums --strip-spirv)
+if(NOT output MATCHES "Built: +1")
+    message(FATAL_ERROR "Shader was not rebuilt after its options changed:\n${output}")
+endif()
+
+#
+# compile: An entry point list fails when an output cannot be written
+#
+
+file(WRITE ${WORK_DIR}/not_a_directory "")
+run_cli(1 output compile ${SOURCE_DIR}/samples/FillTexture.comp.hlsl --compute main,main -o ${WORK_DIR}/not_a_directory)
+if(output MATCHES "Compilation successful")
+    message(FATAL_ERROR "Unwritten outputs were reported as compiled:\n${output}")
+endif()
+
+#
+# build: Malformed manifest defines are reported
+#
+
+file(WRITE ${WORK_DIR}/bad_define.json "{
+  \"shaders\": [
+    { \"output\": \"BadDefine.nshader\", \"vertex\": \"${SOURCE_DIR}/samples/Fullscreen.vert.hlsl\", \"defines\": [\"=1\"] }
+  ]
+}
+")
+run_cli(1 output build ${WORK_DIR}/bad_define.json)
+if(NOT output MATCHES "invalid define '=1'")
+    message(FATAL_ERROR "Malformed define was not reported:\n${output}")
+endif()
@@ -0,0 +1,225 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_compiler.h>
+#include <nshader/nshader_reader.h>
+}
+
+#include "test_shaders.h"
+
+namespace fs = std::filesystem;
+
+// Results delivered to the batch callback
+struct BatchResults {
+  std::mutex mutex;
+  std::vector<size_t> indices;
+  std::vector<size_t> failed;
+
+  static void on_result(void* user, const nshader_compiler_result_t* result) {
+    BatchResults* results = static_cast<BatchResults*>(user);
+    std::lock_guard<std::mutex> lock(results->mutex);
+    results->indices.push_back(result->index);
+    if (result->shader) {
+      nshader_destroy(result->shader);
+    } else {
+      EXPECT_GT(result->errors->num_errors, 0u);
+      results->failed.push_back(result->index);
+    }
+  }
+};
+
+// Dependencies reported by the scan
+struct Dependencies {
+  std::vector<std::pair<std::string, bool>> files;
+
+  static void on_dependency(void* user, const char* path, bool exists) {
+    static_cast<Dependencies*>(user)->files.emplace_back(fs::path(path).lexically_normal().generic_string(), exists);
+  }
+
+  bool has(const std::string& path, bool exists) const {
+    for (const auto& file : files) {
+      if (file.first == path && file.second == exists) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+class NShaderCompilerBatchTests : public ::testing::Test {
+protected:
+  fs::path dir = "test_compiler_batch";
+
+  void SetUp() override {
+    fs::remove_all(dir);
+    fs::create_directories(dir / "include");
+  }
+
+  void TearDown() override {
+    fs::remove_all(dir);
+  }
+
+  void write(const fs::path& name, const std::string& text) {
+    std::ofstream file(dir / name, std::ios::binary | std::ios::trunc);
+    file << text;
+  }
+};
+
+TEST_F(NShaderCompilerBatchTests, CompileBatch) {
+  const char* broken_source = "#error broken\n";
+  const char* sources[5] = {COMPUTE_SHADER_SOURCE, COMPUTE_SHADER_SOURCE, broken_source, COMPUTE_SHADER_SOURCE, COMPUTE_SHADER_SOURCE};
+
+  nshader_compiler_stage_setup_t stages[5];
+  nshader_compiler_config_t configs[5];
+  for (int i = 0; i < 5; i++) {
+    stages[i] = {};
+    stages[i].stage_type = NSHADER_STAGE_TYPE_COMPUTE;
+    stages[i].entry_point = "main";
+    stages[i].source_code = sources[i];
+    configs[i] = {};
+    configs[i].stages = &stages[i];
+    configs[i].num_stages = 1;
+  }
+
+  ASSERT_TRUE(nshader_compiler_init());
+  BatchResults results;
+  size_t compiled = nshader_compiler_compile_batch(configs, 5, 3, BatchResults::on_result, &results);
+  nshader_compiler_quit();
+
+  EXPECT_EQ(compiled, 4u);
+  ASSERT_EQ(results.indices.size(), 5u);
+  std::sort(results.indices.begin(), results.indices.end());
+  for (size_t i = 0; i < 5; i++) {
+    EXPECT_EQ(results.indices[i], i);
+  }
+  ASSERT_EQ(results.failed.size(), 1u);
+  EXPECT_EQ(results.failed[0], 2u);
+}
+
+TEST_F(NShaderCompilerBatchTests, CompileBatchInvalidArguments) {
+  nshader_compiler_config_t config = {};
+  BatchResults results;
+  EXPECT_EQ(nshader_compiler_compile_batch(nullptr, 1, 0, BatchResults::on_result, &results), 0u);
+  EXPECT_EQ(nshader_compiler_compile_batch(&config, 1, 0, nullptr, nullptr), 0u);
+  EXPECT_EQ(nshader_compiler_compile_batch(&config, 0, 0, BatchResults::on_result, &results), 0u);
+  EXPECT_TRUE(results.indices.empty());
+}
+
+TEST_F(NShaderCompilerBatchTests, CompileEntryPoints) {
+  const char* source =
+      "RWTexture2D<float4> OutImage : register(u0, space1);\n"
+      "[numthreads(8, 8, 1)]\n"
+      "void Clear(uint3 id : SV_DispatchThreadID) { OutImage[id.xy] = float4(0, 0, 0, 1); }\n"
+      "[numthreads(8, 8, 1)]\n"
+      "void Fill(uint3 id : SV_DispatchThreadID) { OutImage[id.xy] = float4(VALUE, VALUE, VALUE, 1); }\n";
+  const char* entry_points[3] = {"Clear", "Missing", "Fill"};
+  nshader_compiler_define_t define = {"VALUE", "0.5"};
+
+  nshader_compiler_stage_setup_t stage = {};
+  stage.stage_type = NSHADER_STAGE_TYPE_COMPUTE;
+  stage.source_code = source;
+  stage.defines = &define;
+  stage.num_defines = 1;
+  nshader_compiler_config_t config = {};
+
+  struct EntryResults {
+    std::mutex mutex;
+    std::vector<std::pair<size_t, std::string>> compiled;
+    std::vector<size_t> failed;
+  } results;
+  auto on_result = [](void* user, const nshader_compiler_result_t* result) {
+    EntryResults* results = static_cast<EntryResults*>(user);
+    std::lock_guard<std::mutex> lock(results->mutex);
+    if (!result->shader) {
+      results->failed.push_back(result->index);
+      return;
+    }
+    const nshader_info_t* info = nshader_get_info(result->shader);
+    EXPECT_EQ(info->num_stages, 1u);
+    EXPECT_EQ(info->stages[0].type, NSHADER_STAGE_TYPE_COMPUTE);
+    results->compiled.emplace_back(result->index, info->stages[0].entry_point);
+    nshader_destroy(result->shader);
+  };
+
+  size_t compiled = nshader_compiler_compile_entry_points(&config, &stage, entry_points, 3, 2, on_result, &results);
+
+  EXPECT_EQ(compiled, 2u);
+  std::sort(results.compiled.begin(), results.compiled.end());
+  ASSERT_EQ(results.compiled.size(), 2u);
+  EXPECT_EQ(results.compiled[0], std::make_pair(size_t(0), std::string("Clear")));
+  EXPECT_EQ(results.compiled[1], std::make_pair(size_t(2), std::string("Fill")));
+  ASSERT_EQ(results.failed.size(), 1u);
+  EXPECT_EQ(results.failed[0], 1u);
+}
+
+TEST_F(NShaderCompilerBatchTests, CompileEntryPointsInvalidArguments) {
+  nshader_compiler_config_t config = {};
+  nshader_compiler_stage_setup_t stage = {};
+  stage.stage_type = NSHADER_STAGE_TYPE_COMPUTE;
+  stage.source_code = COMPUTE_SHADER_SOURCE;
+  const char* entry_points[2] = {"main", nullptr};
+  BatchResults results;
+  EXPECT_EQ(nshader_compiler_compile_entry_points(nullptr, &stage, entry_points, 1, 0, BatchResults::on_result, &results), 0u);
+  EXPECT_EQ(nshader_compiler_compile_entry_points(&config, nullptr, entry_points, 1, 0, BatchResults::on_result, &results), 0u);
+  EXPECT_EQ(nshader_compiler_compile_entry_points(&config, &stage, entry_points, 0, 0, BatchResults::on_result, &results), 0u);
+  EXPECT_EQ(nshader_compiler_compile_entry_points(&config, &stage, entry_points, 2, 0, BatchResults::on_result, &results), 0u);
+  EXPECT_EQ(nshader_compiler_compile_entry_points(&config, &stage, entry_points, 1, 0, nullptr, nullptr), 0u);
+  EXPECT_TRUE(results.indices.empty());
+}
+
+TEST_F(NShaderCompilerBatchTests, ScanDependencies) {
+  write("main.hlsl", "#include \"common.hlsl\"\n  #  include <shared.hlsl>\n#include \"missing.hlsl\"\nvoid main() {}\n");
+  write("common.hlsl", "#include \"main.hlsl\"\n#include \"common.hlsl\"\n");
+  write("include/shared.hlsl", "#include \"nested/deep.hlsl\"\n");
+  fs::create_directories(dir / "include/nested");
+  write("include/nested/deep.hlsl", "// leaf\n");
+
+  std::string source = (dir / "main.hlsl").string();
+  std::string include_dir = (dir / "include").string();
+  Dependencies deps;
+  ASSERT_TRUE(nshader_compiler_scan_dependencies(source.c_str(), include_dir.c_str(), Dependencies::on_dependency, &deps));
+
+  // Cycles back to the source and self includes are reported once
+  EXPECT_EQ(deps.files.size(), 4u);
+  EXPECT_TRUE(deps.has("test_compiler_batch/common.hlsl", true));
+  EXPECT_TRUE(deps.has("test_compiler_batch/include/shared.hlsl", true));
+  EXPECT_TRUE(deps.has("test_compiler_batch/include/nested/deep.hlsl", true));
+  EXPECT_TRUE(deps.has("test_compiler_batch/missing.hlsl", false));
+}
+
+TEST_F(NShaderCompilerBatchTests, ScanDependenciesMissingSource) {
+  Dependencies deps;
+  std::string source = (dir / "absent.hlsl").string();
+  EXPECT_FALSE(nshader_compiler_scan_dependencies(source.c_str(), nullptr, Dependencies::on_dependency, &deps));
+  EXPECT_TRUE(deps.files.empty());
+}
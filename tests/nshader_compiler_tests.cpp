@@ -29,6 +29,7 @@ extern "C" {
     #include "test_shaders.h"
     #include <nshader/nshader_compiler.h>
     #include <nshader/nshader_reader.h>
+    #include <nshader/nshader_strip.h>
 
     // Global test state - compiled shaders used by info/writer/reader tests
     nshader_t* g_graphics_shader = nullptr;
@@ -182,6 +183,69 @@ TEST_F(NShaderCompilerTests, CompileWithDefines) {
     nshader_error_list_free(&errors);
 }
 
+TEST_F(NShaderCompilerTests, CompileWithStripSpirv) {
+    ASSERT_NE(g_graphics_shader, nullptr);
+
+    nshader_compiler_stage_setup_t stages[2] = {
+        {
+            .stage_type = NSHADER_STAGE_TYPE_VERTEX,
+            .entry_point = "main",
+            .source_code = VERTEX_SHADER_SOURCE,
+            .defines = nullptr,
+            .num_defines = 0
+        },
+        {
+            .stage_type = NSHADER_STAGE_TYPE_FRAGMENT,
+            .entry_point = "main",
+            .source_code = FRAGMENT_SHADER_SOURCE,
+            .defines = nullptr,
+            .num_defines = 0
+        }
+    };
+
+    nshader_compiler_config_t config = {
+        .stages = stages,
+        .num_stages = 2,
+        .debug_name = "TestGraphicsShader",
+        .strip_spirv = true
+    };
+
+    nshader_error_list_t errors = {0};
+    nshader_t* shader = nshader_compiler_compile_hlsl(&config, &errors);
+    nshader_error_list_free(&errors);
+    ASSERT_NE(shader, nullptr);
+
+    const nshader_info_t* info = nshader_get_info(shader);
+    const nshader_info_t* unstripped_info = nshader_get_info(g_graphics_shader);
+    ASSERT_EQ(info->num_stages, unstripped_info->num_stages);
+    for (size_t i = 0; i < info->num_stages; i++) {
+        nshader_stage_type_t stage = info->stages[i].type;
+
+        // Nothing left to strip, and never larger than the unstripped module
+        const nshader_blob_t* spv = nshader_get_blob(shader, stage, NSHADER_BACKEND_SPV);
+        const nshader_blob_t* unstripped_spv = nshader_get_blob(g_graphics_shader, stage, NSHADER_BACKEND_SPV);
+        ASSERT_NE(spv, nullptr);
+        ASSERT_NE(unstripped_spv, nullptr);
+        EXPECT_LE(spv->size, unstripped_spv->size);
+        EXPECT_EQ(nshader_spirv_strip_debug_info(spv->data, spv->size, nullptr, 0), spv->size);
+
+        // Reflection ran on the unstripped module, so binding names are kept
+        bool vertex = stage == NSHADER_STAGE_TYPE_VERTEX;
+        const nshader_stage_metadata_t* metadata = &info->stages[i].metadata;
+        const nshader_stage_metadata_t* unstripped = &unstripped_info->stages[i].metadata;
+        size_t input_count = vertex ? metadata->vertex.input_count : metadata->fragment.input_count;
+        const nshader_stage_binding_t* inputs = vertex ? metadata->vertex.inputs : metadata->fragment.inputs;
+        const nshader_stage_binding_t* unstripped_inputs = vertex ? unstripped->vertex.inputs : unstripped->fragment.inputs;
+        ASSERT_EQ(input_count, vertex ? unstripped->vertex.input_count : unstripped->fragment.input_count);
+        for (size_t j = 0; j < input_count; j++) {
+            ASSERT_NE(inputs[j].name, nullptr);
+            EXPECT_STREQ(inputs[j].name, unstripped_inputs[j].name);
+        }
+    }
+
+    nshader_destroy(shader);
+}
+
 TEST_F(NShaderCompilerTests, CompileInvalidShader) {
     const char* invalid_source = "this is not valid HLSL code!!!";
 
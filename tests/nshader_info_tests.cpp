@@ -81,6 +81,18 @@ TEST(NShaderInfoTests, GetBlob) {
   }
 }
 
+TEST(NShaderInfoTests, GetBlobSize) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  for (int i = 0; i < NSHADER_BACKEND_COUNT; i++) {
+    const nshader_blob_t* blob = nshader_get_blob(g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX, (nshader_backend_t)i);
+    EXPECT_EQ(nshader_get_blob_size(g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX, (nshader_backend_t)i), blob ? blob->size : 0u);
+  }
+
+  EXPECT_EQ(nshader_get_blob_size(g_graphics_shader, NSHADER_STAGE_TYPE_COMPUTE, NSHADER_BACKEND_SPV), 0u);
+  EXPECT_EQ(nshader_get_blob_size(nullptr, NSHADER_STAGE_TYPE_VERTEX, NSHADER_BACKEND_SPV), 0u);
+}
+
 TEST(NShaderInfoTests, ComputeShaderMetadata) {
   ASSERT_NE(g_compute_shader, nullptr);
 
@@ -0,0 +1,169 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_io.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_compiler_tests.h"
+}
+#include "nshader_test_utils.h"
+
+// Stream that moves at most a few bytes per call and cannot seek
+struct ChunkedStream {
+  std::vector<uint8_t> data;
+  size_t offset = 0;
+  size_t chunk = 3;
+};
+
+static size_t chunked_read(void* user, void* data, size_t size) {
+  ChunkedStream* stream = static_cast<ChunkedStream*>(user);
+  size_t n = std::min({ size, stream->chunk, stream->data.size() - stream->offset });
+  memcpy(data, stream->data.data() + stream->offset, n);
+  stream->offset += n;
+  return n;
+}
+
+static size_t chunked_write(void* user, const void* data, size_t size) {
+  ChunkedStream* stream = static_cast<ChunkedStream*>(user);
+  size_t n = std::min(size, stream->chunk);
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  stream->data.insert(stream->data.end(), bytes, bytes + n);
+  return n;
+}
+
+TEST(NShaderIOTests, WriteToStream) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  ChunkedStream stream;
+  stream.chunk = 7;
+  nshader_io_t io = {};
+  io.user = &stream;
+  io.write = chunked_write;
+
+  ASSERT_TRUE(nshader_write_to_io(g_graphics_shader, &io, nullptr));
+  EXPECT_EQ(stream.data, write_to_vector(g_graphics_shader));
+}
+
+TEST(NShaderIOTests, ReadFromStream) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  ChunkedStream stream;
+  stream.data = write_to_vector(g_graphics_shader);
+  nshader_io_t io = {};
+  io.user = &stream;
+  io.read = chunked_read;
+
+  nshader_t* shader = nshader_read_from_io(&io, nullptr);
+  ASSERT_NE(shader, nullptr);
+  EXPECT_EQ(stream.offset, stream.data.size());
+  EXPECT_EQ(write_to_vector(shader), stream.data);
+  nshader_destroy(shader);
+
+  // Truncated streams fail cleanly
+  stream.data.resize(stream.data.size() - 1);
+  stream.offset = 0;
+  EXPECT_EQ(nshader_read_from_io(&io, nullptr), nullptr);
+}
+
+struct LargestAllocator {
+  size_t largest = 0;
+  size_t live_bytes = 0;
+};
+
+static void* largest_alloc(void* user, size_t size, size_t align) {
+  LargestAllocator* counter = static_cast<LargestAllocator*>(user);
+  counter->largest = std::max(counter->largest, size);
+  counter->live_bytes += size;
+  size_t rounded = size > 0 ? (size + align - 1) / align * align : align;
+  return aligned_alloc(align, rounded);
+}
+
+static void largest_free(void* user, void* ptr, size_t size) {
+  static_cast<LargestAllocator*>(user)->live_bytes -= size;
+  free(ptr);
+}
+
+TEST(NShaderIOTests, ReadCorruptBlobSizeFromStream) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  const nshader_blob_t* blob = nshader_get_blob(g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX, NSHADER_BACKEND_SPV);
+  ASSERT_NE(blob, nullptr);
+
+  // Claim a payload far larger than the stream and end it inside the payload
+  ChunkedStream stream;
+  stream.data = write_to_vector(g_graphics_shader);
+  auto payload = std::search(stream.data.begin(), stream.data.end(), blob->data, blob->data + blob->size);
+  ASSERT_NE(payload, stream.data.end());
+  uint32_t blob_size = (uint32_t)blob->size;
+  uint8_t size_bytes[4];
+  memcpy(size_bytes, &blob_size, sizeof(size_bytes));
+  auto size_field = std::find_end(stream.data.begin(), payload, size_bytes, size_bytes + 4);
+  ASSERT_NE(size_field, payload);
+  const uint32_t claimed_size = 0xF0000000u;
+  memcpy(&*size_field, &claimed_size, sizeof(claimed_size));
+  stream.data.resize((size_t)(payload - stream.data.begin()) + blob->size);
+  stream.chunk = 4096;
+
+  nshader_io_t io = {};
+  io.user = &stream;
+  io.read = chunked_read;
+  LargestAllocator counter;
+  nshader_allocator_t allocator = { &counter, largest_alloc, largest_free };
+  nshader_read_options_t options = {};
+  options.allocator = &allocator;
+
+  // Fails once the stream ends, without allocating the claimed size up front
+  EXPECT_EQ(nshader_read_from_io(&io, &options), nullptr);
+  EXPECT_LT(counter.largest, (size_t)claimed_size / 16);
+  EXPECT_EQ(counter.live_bytes, 0u);
+}
+
+TEST(NShaderIOTests, MemoryStream) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  std::vector<uint8_t> buffer = write_to_vector(g_graphics_shader);
+  nshader_io_memory_t state;
+  nshader_io_t io = nshader_io_from_memory(&state, buffer.data(), buffer.size());
+  EXPECT_EQ(io.size(io.user), (int64_t)buffer.size());
+
+  nshader_t* shader = nshader_read_from_io(&io, nullptr);
+  ASSERT_NE(shader, nullptr);
+  EXPECT_EQ(state.offset, buffer.size());
+  nshader_destroy(shader);
+
+  // Seeking is bounded by the buffer
+  io = nshader_io_from_memory(&state, buffer.data(), buffer.size());
+  EXPECT_EQ(io.seek(io.user, 0, NSHADER_IO_SEEK_END), (int64_t)buffer.size());
+  EXPECT_EQ(io.seek(io.user, 1, NSHADER_IO_SEEK_CUR), -1);
+  EXPECT_EQ(io.seek(io.user, 4, NSHADER_IO_SEEK_SET), 4);
+
+  // Truncated buffers fail before reading past the end
+  io = nshader_io_from_memory(&state, buffer.data(), buffer.size() / 2);
+  EXPECT_EQ(nshader_read_from_io(&io, nullptr), nullptr);
+}
@@ -0,0 +1,260 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_loader.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_compiler_tests.h"
+}
+
+// Collects the results delivered to the completion callback
+struct LoadResults {
+  std::mutex mutex;
+  std::vector<nshader_load_id_t> ids;
+  std::atomic<int> ok{0};
+  std::atomic<int> failed{0};
+  std::atomic<int> canceled{0};
+};
+
+static void on_load(void* user, nshader_load_id_t id, nshader_load_status_t status, nshader_t* shader) {
+  LoadResults* results = static_cast<LoadResults*>(user);
+  {
+    std::lock_guard<std::mutex> lock(results->mutex);
+    results->ids.push_back(id);
+  }
+  switch (status) {
+    case NSHADER_LOAD_STATUS_OK:
+      EXPECT_NE(shader, nullptr);
+      results->ok++;
+      break;
+    case NSHADER_LOAD_STATUS_FAILED:
+      EXPECT_EQ(shader, nullptr);
+      results->failed++;
+      break;
+    case NSHADER_LOAD_STATUS_CANCELED:
+      EXPECT_EQ(shader, nullptr);
+      results->canceled++;
+      break;
+  }
+  nshader_destroy(shader);
+}
+
+TEST(NShaderLoaderTests, LoadAsync) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  ASSERT_TRUE(nshader_write_to_path(g_graphics_shader, "test_loader.nsdr"));
+
+  nshader_loader_config_t config = {};
+  config.num_threads = 2;
+  nshader_loader_t* loader = nshader_loader_create(&config);
+  ASSERT_NE(loader, nullptr);
+
+  // Many requests for the same path share reads but each gets a shader
+  LoadResults results;
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_NE(nshader_load_async(loader, "test_loader.nsdr", nullptr, on_load, &results), 0u);
+  }
+  EXPECT_NE(nshader_load_async(loader, "missing_loader.nsdr", nullptr, on_load, &results), 0u);
+  EXPECT_EQ(nshader_load_async(loader, nullptr, nullptr, on_load, &results), 0u);
+
+  nshader_loader_wait_idle(loader);
+  EXPECT_EQ(results.ok, 32);
+  EXPECT_EQ(results.failed, 1);
+  EXPECT_EQ(results.ids.size(), 33u);
+
+  // Delivered requests can no longer be canceled
+  EXPECT_FALSE(nshader_load_cancel(loader, results.ids[0]));
+
+  nshader_loader_destroy(loader);
+  remove("test_loader.nsdr");
+}
+
+TEST(NShaderLoaderTests, LoadBatch) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  ASSERT_TRUE(nshader_write_to_path(g_graphics_shader, "test_loader_batch.nsdr"));
+
+  nshader_loader_t* loader = nshader_loader_create(nullptr);
+  ASSERT_NE(loader, nullptr);
+
+  LoadResults results;
+  std::vector<nshader_load_desc_t> descs(8);
+  for (nshader_load_desc_t& desc : descs) {
+    desc.path = "test_loader_batch.nsdr";
+    desc.callback = on_load;
+    desc.user = &results;
+  }
+  descs[3].path = nullptr;
+
+  std::vector<nshader_load_id_t> ids(descs.size());
+  EXPECT_EQ(nshader_load_async_batch(loader, descs.data(), descs.size(), nullptr, ids.data()), 7u);
+  EXPECT_EQ(ids[3], 0u);
+
+  nshader_loader_wait_idle(loader);
+  EXPECT_EQ(results.ok, 7);
+
+  nshader_loader_destroy(loader);
+  remove("test_loader_batch.nsdr");
+}
+
+TEST(NShaderLoaderTests, LoadBulk) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  ASSERT_TRUE(nshader_write_to_path(g_graphics_shader, "test_loader_bulk.nsdr"));
+
+  nshader_loader_t* loader = nshader_loader_create(nullptr);
+  ASSERT_NE(loader, nullptr);
+
+  // More files than io_uring keeps in flight at once
+  LoadResults results;
+  std::vector<nshader_load_desc_t> descs(300);
+  for (nshader_load_desc_t& desc : descs) {
+    desc.path = "test_loader_bulk.nsdr";
+    desc.callback = on_load;
+    desc.user = &results;
+  }
+  descs[10].path = "missing_loader_bulk.nsdr";
+  descs[20].path = nullptr;
+
+  std::vector<nshader_load_id_t> ids(descs.size());
+  EXPECT_EQ(nshader_load_bulk(loader, descs.data(), descs.size(), nullptr, ids.data()), 299u);
+  EXPECT_EQ(ids[20], 0u);
+
+  // Every callback ran before the call returned
+  EXPECT_EQ(results.ok, 298);
+  EXPECT_EQ(results.failed, 1);
+  std::vector<nshader_load_id_t> delivered = results.ids;
+  std::sort(delivered.begin(), delivered.end());
+  EXPECT_EQ(std::adjacent_find(delivered.begin(), delivered.end()), delivered.end());
+
+  nshader_loader_destroy(loader);
+  remove("test_loader_bulk.nsdr");
+}
+
+// Job system that holds jobs until flushed, so cancellation is deterministic
+struct DeferredJobs {
+  std::vector<std::pair<nshader_job_fn, void*>> jobs;
+};
+
+static void deferred_submit(void* user, nshader_job_fn fn, void* job_data) {
+  static_cast<DeferredJobs*>(user)->jobs.emplace_back(fn, job_data);
+}
+
+TEST(NShaderLoaderTests, JobSystemAndCancel) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  ASSERT_TRUE(nshader_write_to_path(g_graphics_shader, "test_loader_jobs.nsdr"));
+
+  DeferredJobs deferred;
+  nshader_job_system_t job_system = {};
+  job_system.user = &deferred;
+  job_system.submit = deferred_submit;
+
+  nshader_loader_config_t config = {};
+  config.job_system = &job_system;
+  nshader_loader_t* loader = nshader_loader_create(&config);
+  ASSERT_NE(loader, nullptr);
+
+  LoadResults results;
+  nshader_load_id_t first = nshader_load_async(loader, "test_loader_jobs.nsdr", nullptr, on_load, &results);
+  nshader_load_id_t second = nshader_load_async(loader, "test_loader_jobs.nsdr", nullptr, on_load, &results);
+  nshader_load_async(loader, "test_loader_jobs.nsdr", nullptr, on_load, &results);
+
+  // Duplicate paths were coalesced into one job
+  ASSERT_EQ(deferred.jobs.size(), 1u);
+
+  // Cancellation is delivered synchronously
+  EXPECT_TRUE(nshader_load_cancel(loader, first));
+  EXPECT_FALSE(nshader_load_cancel(loader, first));
+  EXPECT_EQ(results.canceled, 1);
+
+  // Run the job on another thread
+  std::thread worker([&] {
+    for (auto& job : deferred.jobs) {
+      job.first(job.second);
+    }
+  });
+  worker.join();
+  deferred.jobs.clear();
+
+  nshader_loader_wait_idle(loader);
+  EXPECT_EQ(results.ok, 2);
+  EXPECT_FALSE(nshader_load_cancel(loader, second));
+
+  // Destroying the loader cancels requests that were never run
+  nshader_load_async(loader, "test_loader_jobs.nsdr", nullptr, on_load, &results);
+  ASSERT_EQ(deferred.jobs.size(), 1u);
+  std::thread late_worker([&] {
+    // Wait for destroy to cancel the request, then let the job finish
+    while (results.canceled < 2) {
+      std::this_thread::yield();
+    }
+    deferred.jobs[0].first(deferred.jobs[0].second);
+  });
+  nshader_loader_destroy(loader);
+  late_worker.join();
+  EXPECT_EQ(results.canceled, 2);
+  EXPECT_EQ(results.ok, 2);
+
+  remove("test_loader_jobs.nsdr");
+}
+
+TEST(NShaderLoaderTests, CoalescedOrder) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  ASSERT_TRUE(nshader_write_to_path(g_graphics_shader, "test_loader_order.nsdr"));
+
+  DeferredJobs deferred;
+  nshader_job_system_t job_system = {};
+  job_system.user = &deferred;
+  job_system.submit = deferred_submit;
+
+  nshader_loader_config_t config = {};
+  config.job_system = &job_system;
+  nshader_loader_t* loader = nshader_loader_create(&config);
+  ASSERT_NE(loader, nullptr);
+
+  LoadResults results;
+  std::vector<nshader_load_id_t> expected;
+  for (int i = 0; i < 4; ++i) {
+    expected.push_back(nshader_load_async(loader, "test_loader_order.nsdr", nullptr, on_load, &results));
+  }
+
+  // Canceling the newest request keeps later ones in order
+  EXPECT_TRUE(nshader_load_cancel(loader, expected.back()));
+  expected.pop_back();
+  expected.push_back(nshader_load_async(loader, "test_loader_order.nsdr", nullptr, on_load, &results));
+  results.ids.clear();
+
+  ASSERT_EQ(deferred.jobs.size(), 1u);
+  deferred.jobs[0].first(deferred.jobs[0].second);
+  nshader_loader_wait_idle(loader);
+  EXPECT_EQ(results.ok, 4);
+  EXPECT_EQ(results.ids, expected);
+
+  nshader_loader_destroy(loader);
+  remove("test_loader_order.nsdr");
+}
@@ -0,0 +1,154 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_patch.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_strip.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_compiler_tests.h"
+}
+#include "nshader_test_utils.h"
+
+static std::vector<uint8_t> diff(const nshader_t* old_shader, const nshader_t* new_shader) {
+  std::vector<uint8_t> patch(nshader_diff_to_memory(old_shader, new_shader, nullptr, 0));
+  if (!patch.empty() && nshader_diff_to_memory(old_shader, new_shader, patch.data(), patch.size()) != patch.size()) {
+    patch.clear();
+  }
+  return patch;
+}
+
+TEST(NShaderPatchTests, RoundTrip) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* new_shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(new_shader, nullptr);
+  ASSERT_TRUE(nshader_strip_debug_info(new_shader));
+
+  std::vector<uint8_t> patch = diff(g_graphics_shader, new_shader);
+  ASSERT_FALSE(patch.empty());
+  EXPECT_LT(patch.size(), write_to_vector(new_shader).size());
+
+  nshader_t* patched = nshader_patch(g_graphics_shader, patch.data(), patch.size());
+  ASSERT_NE(patched, nullptr);
+  EXPECT_EQ(write_to_vector(patched), write_to_vector(new_shader));
+
+  nshader_destroy(patched);
+  nshader_destroy(new_shader);
+}
+
+TEST(NShaderPatchTests, UnchangedBlobs) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* new_shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(new_shader, nullptr);
+  ASSERT_TRUE(nshader_strip_names(new_shader));
+
+  // Only the metadata changed, so the patch carries no blob data
+  std::vector<uint8_t> patch = diff(g_graphics_shader, new_shader);
+  ASSERT_FALSE(patch.empty());
+  size_t blob_bytes = 0;
+  for (int s = 0; s < NSHADER_STAGE_TYPE_COUNT; s++) {
+    for (int b = 0; b < NSHADER_BACKEND_COUNT; b++) {
+      blob_bytes += nshader_get_blob_size(new_shader, (nshader_stage_type_t)s, (nshader_backend_t)b);
+    }
+  }
+  size_t header_and_ops = 28 + (size_t)NSHADER_STAGE_TYPE_COUNT * (size_t)NSHADER_BACKEND_COUNT;
+  EXPECT_LE(patch.size(), write_to_vector(new_shader).size() - blob_bytes + header_and_ops);
+
+  nshader_t* patched = nshader_patch(g_graphics_shader, patch.data(), patch.size());
+  ASSERT_NE(patched, nullptr);
+  EXPECT_EQ(write_to_vector(patched), write_to_vector(new_shader));
+
+  nshader_destroy(patched);
+  nshader_destroy(new_shader);
+}
+
+TEST(NShaderPatchTests, DiffToIo) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* new_shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(new_shader, nullptr);
+  ASSERT_TRUE(nshader_strip_debug_info(new_shader));
+
+  FILE* file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  nshader_io_t io = nshader_io_from_file(file);
+  ASSERT_TRUE(nshader_diff_to_io(g_graphics_shader, new_shader, &io));
+
+  std::vector<uint8_t> patch((size_t)ftell(file));
+  rewind(file);
+  ASSERT_EQ(fread(patch.data(), 1, patch.size(), file), patch.size());
+  fclose(file);
+  EXPECT_EQ(patch, diff(g_graphics_shader, new_shader));
+
+  nshader_destroy(new_shader);
+}
+
+TEST(NShaderPatchTests, WrongOldShader) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* new_shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(new_shader, nullptr);
+  ASSERT_TRUE(nshader_strip_names(new_shader));
+
+  std::vector<uint8_t> patch = diff(g_graphics_shader, new_shader);
+  ASSERT_FALSE(patch.empty());
+  EXPECT_EQ(nshader_patch(new_shader, patch.data(), patch.size()), nullptr);
+
+  nshader_destroy(new_shader);
+}
+
+TEST(NShaderPatchTests, CorruptPatch) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* new_shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(new_shader, nullptr);
+  ASSERT_TRUE(nshader_strip_debug_info(new_shader));
+
+  std::vector<uint8_t> patch = diff(g_graphics_shader, new_shader);
+  ASSERT_FALSE(patch.empty());
+
+  // Every truncation fails, and so does a flipped byte anywhere
+  for (size_t size = 0; size < patch.size(); size++) {
+    EXPECT_EQ(nshader_patch(g_graphics_shader, patch.data(), size), nullptr) << size;
+  }
+  for (size_t i = 0; i < patch.size(); i++) {
+    std::vector<uint8_t> corrupt = patch;
+    corrupt[i] ^= 0x5A;
+    nshader_t* patched = nshader_patch(g_graphics_shader, corrupt.data(), corrupt.size());
+    EXPECT_EQ(patched, nullptr) << i;
+    nshader_destroy(patched);
+  }
+
+  nshader_destroy(new_shader);
+}
+
+TEST(NShaderPatchTests, InvalidArguments) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  EXPECT_EQ(nshader_diff_to_memory(nullptr, g_graphics_shader, nullptr, 0), 0u);
+  EXPECT_EQ(nshader_diff_to_memory(g_graphics_shader, nullptr, nullptr, 0), 0u);
+  EXPECT_FALSE(nshader_diff_to_io(g_graphics_shader, g_graphics_shader, nullptr));
+  EXPECT_EQ(nshader_patch(nullptr, "x", 1), nullptr);
+  EXPECT_EQ(nshader_patch(g_graphics_shader, nullptr, 0), nullptr);
+}
@@ -23,9 +23,12 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <string>
+#include <vector>
 
 extern "C" {
 #include <nshader/nshader_reader.h>
@@ -144,3 +147,263 @@ TEST(NShaderReaderTests, RoundtripFile) {
   nshader_destroy(shader);
   remove(filename);
 }
+
+struct CountingAllocator {
+  size_t live_bytes = 0;
+  size_t num_allocs = 0;
+  size_t num_frees = 0;
+};
+
+static void* counting_alloc(void* user, size_t size, size_t align) {
+  CountingAllocator* counter = static_cast<CountingAllocator*>(user);
+  counter->live_bytes += size;
+  counter->num_allocs++;
+  size_t rounded = size > 0 ? (size + align - 1) / align * align : align;
+  return aligned_alloc(align, rounded);
+}
+
+static void counting_free(void* user, void* ptr, size_t size) {
+  CountingAllocator* counter = static_cast<CountingAllocator*>(user);
+  counter->live_bytes -= size;
+  counter->num_frees++;
+  free(ptr);
+}
+
+TEST(NShaderReaderTests, ReadWithAllocator) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  size_t size_needed = nshader_write_to_memory(g_graphics_shader, nullptr, 0);
+  void* buffer = malloc(size_needed);
+  nshader_write_to_memory(g_graphics_shader, buffer, size_needed);
+
+  CountingAllocator counter;
+  nshader_allocator_t allocator = { &counter, counting_alloc, counting_free };
+  nshader_read_options_t options = {};
+  options.allocator = &allocator;
+
+  nshader_t* read_shader = nshader_read_from_memory_ex(buffer, size_needed, &options);
+  ASSERT_NE(read_shader, nullptr);
+  EXPECT_GT(counter.num_allocs, 0u);
+  EXPECT_GT(counter.live_bytes, 0u);
+
+  // Writing through the same allocator releases its staging buffer
+  nshader_write_options_t write_options = {};
+  write_options.allocator = &allocator;
+  size_t live_before_write = counter.live_bytes;
+  EXPECT_TRUE(nshader_write_to_path_ex(read_shader, "test_allocator.nsdr", &write_options));
+  EXPECT_EQ(counter.live_bytes, live_before_write);
+
+  // Every free must report the size of its allocation
+  nshader_destroy(read_shader);
+  EXPECT_EQ(counter.live_bytes, 0u);
+  EXPECT_EQ(counter.num_allocs, counter.num_frees);
+
+  remove("test_allocator.nsdr");
+  free(buffer);
+}
+
+TEST(NShaderReaderTests, ReadVersion1) {
+  // Compute shader in the version 1 layout: no flags, unaligned blobs
+  const uint8_t spirv[5] = { 0x03, 0x02, 0x23, 0x07, 0xFF };
+  std::vector<uint8_t> data;
+  auto put_u8 = [&](uint8_t v) { data.push_back(v); };
+  auto put_u32 = [&](uint32_t v) { for (int i = 0; i < 4; ++i) data.push_back((uint8_t)(v >> (i * 8))); };
+
+  put_u32(NSHADER_MAGIC);
+  put_u32(1);
+  put_u8(NSHADER_SHADER_TYPE_COMPUTE);
+  put_u32(1);
+  put_u8(NSHADER_STAGE_TYPE_COMPUTE);
+  put_u32(4);
+  for (char c : std::string("main")) put_u8((uint8_t)c);
+  for (uint32_t i = 0; i < 9; ++i) put_u32(i + 1);
+  put_u32(1);
+  put_u8(NSHADER_BACKEND_SPV);
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; ++stage) {
+    for (int backend = 0; backend < NSHADER_BACKEND_COUNT; ++backend) {
+      bool has_blob = stage == NSHADER_STAGE_TYPE_COMPUTE && backend == NSHADER_BACKEND_SPV;
+      put_u8(has_blob ? 1 : 0);
+      if (has_blob) {
+        put_u32(sizeof(spirv));
+        data.insert(data.end(), spirv, spirv + sizeof(spirv));
+      }
+    }
+  }
+
+  nshader_t* shader = nshader_read_from_memory(data.data(), data.size());
+  ASSERT_NE(shader, nullptr);
+
+  const nshader_info_t* info = nshader_get_info(shader);
+  EXPECT_EQ(info->type, NSHADER_SHADER_TYPE_COMPUTE);
+  ASSERT_EQ(info->num_stages, 1u);
+  EXPECT_STREQ(info->stages[0].entry_point, "main");
+  EXPECT_EQ(info->stages[0].metadata.compute.threadcount_z, 9u);
+
+  const nshader_blob_t* blob = nshader_get_blob(shader, NSHADER_STAGE_TYPE_COMPUTE, NSHADER_BACKEND_SPV);
+  ASSERT_NE(blob, nullptr);
+  ASSERT_EQ(blob->size, sizeof(spirv));
+  EXPECT_EQ(memcmp(blob->data, spirv, sizeof(spirv)), 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(blob->data) % NSHADER_DEFAULT_BLOB_ALIGNMENT, 0u);
+
+  // Version 1 stores no hash, the value computed now is the one later files store
+  nshader_hash_t computed_hash, stored_hash;
+  ASSERT_TRUE(nshader_hash(shader, &computed_hash));
+  std::vector<uint8_t> rewritten(nshader_write_to_memory(shader, nullptr, 0));
+  ASSERT_EQ(nshader_write_to_memory(shader, rewritten.data(), rewritten.size()), rewritten.size());
+  nshader_destroy(shader);
+
+  shader = nshader_read_from_memory(rewritten.data(), rewritten.size());
+  ASSERT_NE(shader, nullptr);
+  ASSERT_TRUE(nshader_hash(shader, &stored_hash));
+  EXPECT_EQ(stored_hash.lo, computed_hash.lo);
+  EXPECT_EQ(stored_hash.hi, computed_hash.hi);
+  nshader_destroy(shader);
+
+  nshader_hash_t other_hash;
+  ASSERT_TRUE(nshader_hash(g_graphics_shader, &other_hash));
+  EXPECT_FALSE(other_hash.lo == computed_hash.lo && other_hash.hi == computed_hash.hi);
+
+  // Unknown versions are rejected
+  data[4] = NSHADER_VERSION + 1;
+  EXPECT_EQ(nshader_read_from_memory(data.data(), data.size()), nullptr);
+}
+
+TEST(NShaderReaderTests, VerifyChecksums) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  nshader_write_options_t write_options = {};
+  write_options.checksums = true;
+  std::vector<uint8_t> buffer(nshader_write_to_memory_ex(g_graphics_shader, nullptr, 0, &write_options));
+  ASSERT_EQ(nshader_write_to_memory_ex(g_graphics_shader, buffer.data(), buffer.size(), &write_options), buffer.size());
+
+  nshader_read_options_t options = {};
+  options.verify = NSHADER_VERIFY_ON_LOAD;
+  nshader_t* shader = nshader_read_from_memory_ex(buffer.data(), buffer.size(), &options);
+  ASSERT_NE(shader, nullptr);
+  nshader_destroy(shader);
+
+  // Find the last blob in stage/backend order, only has_blob markers follow it
+  nshader_stage_type_t last_stage = NSHADER_STAGE_TYPE_COUNT;
+  nshader_backend_t last_backend = NSHADER_BACKEND_COUNT;
+  for (int s = 0; s < NSHADER_STAGE_TYPE_COUNT; s++) {
+    for (int b = 0; b < NSHADER_BACKEND_COUNT; b++) {
+      if (nshader_get_blob(g_graphics_shader, (nshader_stage_type_t)s, (nshader_backend_t)b)) {
+        last_stage = (nshader_stage_type_t)s;
+        last_backend = (nshader_backend_t)b;
+      }
+    }
+  }
+  ASSERT_NE(last_stage, NSHADER_STAGE_TYPE_COUNT);
+
+  std::vector<uint8_t> corrupt_blob = buffer;
+  const size_t num_backends = NSHADER_BACKEND_COUNT;
+  const size_t num_trailing_markers = NSHADER_STAGE_TYPE_COUNT * num_backends - 1 - ((size_t)last_stage * num_backends + (size_t)last_backend);
+  corrupt_blob[corrupt_blob.size() - 1 - num_trailing_markers] ^= 0x01;
+  EXPECT_EQ(nshader_read_from_memory_ex(corrupt_blob.data(), corrupt_blob.size(), &options), nullptr);
+
+  // Lazy verification loads and hides the corrupt blob on access
+  options.verify = NSHADER_VERIFY_LAZY;
+  shader = nshader_read_from_memory_ex(corrupt_blob.data(), corrupt_blob.size(), &options);
+  ASSERT_NE(shader, nullptr);
+  EXPECT_EQ(nshader_get_blob(shader, last_stage, last_backend), nullptr);
+  EXPECT_EQ(nshader_get_blob(shader, last_stage, last_backend), nullptr);
+  const nshader_stage_type_t first_stage = nshader_get_info(shader)->stages[0].type;
+  EXPECT_TRUE(first_stage == last_stage || nshader_get_blob(shader, first_stage, last_backend) != nullptr);
+  nshader_destroy(shader);
+
+  // Without verification the checksums are ignored
+  options.verify = NSHADER_VERIFY_NONE;
+  shader = nshader_read_from_memory_ex(corrupt_blob.data(), corrupt_blob.size(), &options);
+  ASSERT_NE(shader, nullptr);
+  EXPECT_NE(nshader_get_blob(shader, last_stage, last_backend), nullptr);
+  nshader_destroy(shader);
+
+  // Metadata corruption fails in both verifying modes
+  const char* entry_point = nshader_get_info(g_graphics_shader)->stages[0].entry_point;
+  auto it = std::search(buffer.begin(), buffer.end(), entry_point, entry_point + strlen(entry_point));
+  ASSERT_NE(it, buffer.end());
+  std::vector<uint8_t> corrupt_metadata = buffer;
+  corrupt_metadata[it - buffer.begin()] ^= 0x20;
+  for (nshader_verify_mode_t mode : { NSHADER_VERIFY_ON_LOAD, NSHADER_VERIFY_LAZY }) {
+    options.verify = mode;
+    EXPECT_EQ(nshader_read_from_memory_ex(corrupt_metadata.data(), corrupt_metadata.size(), &options), nullptr);
+  }
+}
+
+TEST(NShaderReaderTests, BackendMask) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  if (!nshader_has_backend(g_graphics_shader, NSHADER_BACKEND_SPV)) {
+    GTEST_SKIP() << "SPIR-V backend not available";
+  }
+
+  std::vector<uint8_t> buffer(nshader_write_to_memory(g_graphics_shader, nullptr, 0));
+  ASSERT_EQ(nshader_write_to_memory(g_graphics_shader, buffer.data(), buffer.size()), buffer.size());
+
+  nshader_read_options_t options = {};
+  options.backend_mask = 1u << NSHADER_BACKEND_SPV;
+  nshader_t* shader = nshader_read_from_memory_ex(buffer.data(), buffer.size(), &options);
+  ASSERT_NE(shader, nullptr);
+
+  const nshader_info_t* info = nshader_get_info(shader);
+  ASSERT_EQ(info->num_backends, 1u);
+  EXPECT_EQ(info->backends[0], NSHADER_BACKEND_SPV);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    nshader_stage_type_t stage = info->stages[i].type;
+    for (int b = 0; b < NSHADER_BACKEND_COUNT; b++) {
+      const nshader_blob_t* blob = nshader_get_blob(shader, stage, (nshader_backend_t)b);
+      const nshader_blob_t* expected = nshader_get_blob(g_graphics_shader, stage, (nshader_backend_t)b);
+      if (b != NSHADER_BACKEND_SPV) {
+        EXPECT_EQ(blob, nullptr);
+        continue;
+      }
+      ASSERT_NE(blob, nullptr);
+      ASSERT_EQ(blob->size, expected->size);
+      EXPECT_EQ(memcmp(blob->data, expected->data, blob->size), 0);
+    }
+  }
+
+  // The filtered shader is hashed from what was kept
+  nshader_hash_t full_hash, filtered_hash;
+  ASSERT_TRUE(nshader_hash(g_graphics_shader, &full_hash));
+  ASSERT_TRUE(nshader_hash(shader, &filtered_hash));
+  EXPECT_TRUE(full_hash.lo != filtered_hash.lo || full_hash.hi != filtered_hash.hi);
+  nshader_destroy(shader);
+}
+
+TEST(NShaderReaderTests, SkipBlobs) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  std::vector<uint8_t> buffer(nshader_write_to_memory(g_graphics_shader, nullptr, 0));
+  ASSERT_EQ(nshader_write_to_memory(g_graphics_shader, buffer.data(), buffer.size()), buffer.size());
+
+  nshader_read_options_t options = {};
+  options.skip_blobs = true;
+  nshader_t* shader = nshader_read_from_memory_ex(buffer.data(), buffer.size(), &options);
+  ASSERT_NE(shader, nullptr);
+
+  // Metadata and backends are read, blobs are not
+  const nshader_info_t* info = nshader_get_info(shader);
+  const nshader_info_t* expected = nshader_get_info(g_graphics_shader);
+  EXPECT_EQ(info->type, expected->type);
+  ASSERT_EQ(info->num_stages, expected->num_stages);
+  EXPECT_EQ(info->num_backends, expected->num_backends);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    EXPECT_STREQ(info->stages[i].entry_point, expected->stages[i].entry_point);
+    for (int b = 0; b < NSHADER_BACKEND_COUNT; b++) {
+      nshader_stage_type_t stage = info->stages[i].type;
+      EXPECT_EQ(nshader_get_blob(shader, stage, (nshader_backend_t)b), nullptr);
+      EXPECT_EQ(nshader_get_blob_size(shader, stage, (nshader_backend_t)b), nshader_get_blob_size(g_graphics_shader, stage, (nshader_backend_t)b));
+    }
+  }
+
+  // The stored hash still describes the skipped payloads
+  nshader_hash_t full_hash, skipped_hash;
+  ASSERT_TRUE(nshader_hash(g_graphics_shader, &full_hash));
+  ASSERT_TRUE(nshader_hash(shader, &skipped_hash));
+  EXPECT_EQ(full_hash.lo, skipped_hash.lo);
+  EXPECT_EQ(full_hash.hi, skipped_hash.hi);
+
+  // A shader without payloads cannot be written back
+  EXPECT_EQ(nshader_write_to_memory(shader, nullptr, 0), 0u);
+  nshader_destroy(shader);
+}
@@ -0,0 +1,429 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_info.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_sdl3_gpu.h>
+#include <nshader/nshader_writer.h>
+#include <nshader/nshader_strip.h>
+#include "nshader_compiler_tests.h"
+}
+#include "nshader_test_utils.h"
+
+// Device standing in for a GPU, the SDL_GPUDevice pointer handed to the
+// library points at it
+struct MockDevice {
+  const char* driver = "vulkan";
+  SDL_GPUShaderFormat formats = SDL_GPU_SHADERFORMAT_SPIRV;
+
+  std::mutex mutex;
+  uintptr_t next_handle = 1;
+  std::map<uintptr_t, const void*> compute_code;  // Pipeline handle -> create_info->code
+  std::set<std::thread::id> compute_threads;
+  std::vector<SDL_GPUShader*> released_shaders;  // In release order
+  int live_shaders = 0;
+  int graphics_pipelines = 0;
+
+  // Vertex input state of the last graphics pipeline
+  std::vector<SDL_GPUVertexAttribute> vertex_attributes;
+  std::vector<SDL_GPUVertexBufferDescription> vertex_buffers;
+
+  SDL_GPUDevice* device() { return reinterpret_cast<SDL_GPUDevice*>(this); }
+  static MockDevice* from(SDL_GPUDevice* device) { return reinterpret_cast<MockDevice*>(device); }
+};
+
+static SDL_GPUShaderFormat mock_get_shader_formats(SDL_GPUDevice* device) {
+  return MockDevice::from(device)->formats;
+}
+
+static const char* mock_get_device_driver(SDL_GPUDevice* device) {
+  return MockDevice::from(device)->driver;
+}
+
+static SDL_GPUShader* mock_create_shader(SDL_GPUDevice* device, const SDL_GPUShaderCreateInfo* create_info) {
+  MockDevice* mock = MockDevice::from(device);
+  EXPECT_NE(create_info->code, nullptr);
+  std::lock_guard<std::mutex> lock(mock->mutex);
+  mock->live_shaders++;
+  return reinterpret_cast<SDL_GPUShader*>(mock->next_handle++);
+}
+
+static void mock_release_shader(SDL_GPUDevice* device, SDL_GPUShader* shader) {
+  MockDevice* mock = MockDevice::from(device);
+  EXPECT_NE(shader, nullptr);
+  std::lock_guard<std::mutex> lock(mock->mutex);
+  mock->released_shaders.push_back(shader);
+  mock->live_shaders--;
+}
+
+static SDL_GPUComputePipeline* mock_create_compute_pipeline(SDL_GPUDevice* device, const SDL_GPUComputePipelineCreateInfo* create_info) {
+  MockDevice* mock = MockDevice::from(device);
+  EXPECT_EQ(create_info->format, SDL_GPU_SHADERFORMAT_SPIRV);
+  std::lock_guard<std::mutex> lock(mock->mutex);
+  uintptr_t handle = mock->next_handle++;
+  mock->compute_code[handle] = create_info->code;
+  mock->compute_threads.insert(std::this_thread::get_id());
+  return reinterpret_cast<SDL_GPUComputePipeline*>(handle);
+}
+
+static SDL_GPUGraphicsPipeline* mock_create_graphics_pipeline(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* create_info) {
+  MockDevice* mock = MockDevice::from(device);
+  EXPECT_NE(create_info->vertex_shader, nullptr);
+  EXPECT_NE(create_info->fragment_shader, nullptr);
+  std::lock_guard<std::mutex> lock(mock->mutex);
+  mock->graphics_pipelines++;
+  const SDL_GPUVertexInputState* state = &create_info->vertex_input_state;
+  mock->vertex_attributes.assign(state->vertex_attributes, state->vertex_attributes + state->num_vertex_attributes);
+  mock->vertex_buffers.assign(state->vertex_buffer_descriptions, state->vertex_buffer_descriptions + state->num_vertex_buffers);
+  return reinterpret_cast<SDL_GPUGraphicsPipeline*>(mock->next_handle++);
+}
+
+static const nshader_sdl3_gpu_device_fns_t g_mock_fns = {
+  mock_get_shader_formats,
+  mock_get_device_driver,
+  mock_create_shader,
+  mock_release_shader,
+  mock_create_compute_pipeline,
+  mock_create_graphics_pipeline,
+};
+
+static nshader_sdl3_gpu_context_t* create_mock_context(MockDevice* mock) {
+  nshader_sdl3_gpu_context_config_t config = {};
+  config.device_fns = &g_mock_fns;
+  return nshader_sdl3_gpu_context_create(mock->device(), &config);
+}
+
+// Copies of the compute shader with their own blobs, so every pipeline can be
+// traced back to the shader it was created from
+static std::vector<nshader_t*> copy_compute_shader(size_t count) {
+  std::vector<uint8_t> buffer(nshader_write_to_memory(g_compute_shader, nullptr, 0));
+  EXPECT_EQ(nshader_write_to_memory(g_compute_shader, buffer.data(), buffer.size()), buffer.size());
+  std::vector<nshader_t*> copies;
+  for (size_t i = 0; i < count; i++) {
+    copies.push_back(nshader_read_from_memory(buffer.data(), buffer.size()));
+    EXPECT_NE(copies.back(), nullptr);
+  }
+  return copies;
+}
+
+// Create a batch where every fifth entry is a graphics shader, which cannot
+// become a compute pipeline, and check each result against its shader
+static void check_compute_batch(MockDevice* mock, uint32_t num_threads) {
+  nshader_sdl3_gpu_context_t* context = create_mock_context(mock);
+  ASSERT_NE(context, nullptr);
+
+  const size_t count = 64;
+  std::vector<nshader_t*> copies = copy_compute_shader(count);
+  std::vector<const nshader_t*> shaders(copies.begin(), copies.end());
+  size_t expected = count;
+  for (size_t i = 0; i < count; i += 5) {
+    shaders[i] = g_graphics_shader;
+    expected--;
+  }
+
+  std::vector<SDL_GPUComputePipeline*> pipelines(count);
+  EXPECT_EQ(nshader_sdl3_gpu_context_create_compute_pipelines(context, shaders.data(), count, num_threads, pipelines.data()), expected);
+  for (size_t i = 0; i < count; i++) {
+    if (shaders[i] == g_graphics_shader) {
+      EXPECT_EQ(pipelines[i], nullptr);
+      continue;
+    }
+    ASSERT_NE(pipelines[i], nullptr);
+    const nshader_blob_t* blob = nshader_get_blob(shaders[i], NSHADER_STAGE_TYPE_COMPUTE, NSHADER_BACKEND_SPV);
+    ASSERT_NE(blob, nullptr);
+    EXPECT_EQ(mock->compute_code[reinterpret_cast<uintptr_t>(pipelines[i])], blob->data);
+  }
+  EXPECT_EQ(mock->compute_code.size(), expected);
+
+  for (nshader_t* copy : copies) {
+    nshader_destroy(copy);
+  }
+  nshader_sdl3_gpu_context_destroy(context);
+}
+
+TEST(NShaderSDL3GPUTests, ContextUsesDeviceFns) {
+  MockDevice mock;
+  mock.formats = SDL_GPU_SHADERFORMAT_SPIRV | SDL_GPU_SHADERFORMAT_DXBC;
+  nshader_sdl3_gpu_context_t* context = create_mock_context(&mock);
+  ASSERT_NE(context, nullptr);
+
+  EXPECT_EQ(nshader_sdl3_gpu_context_get_backend_mask(context), (1u << NSHADER_BACKEND_SPV) | (1u << NSHADER_BACKEND_DXBC));
+  EXPECT_EQ(nshader_sdl3_gpu_context_select_backend(context, g_compute_shader), NSHADER_BACKEND_SPV);
+
+  SDL_GPUComputePipeline* pipeline = nshader_sdl3_gpu_context_create_compute_pipeline(context, g_compute_shader);
+  EXPECT_NE(pipeline, nullptr);
+  EXPECT_EQ(mock.compute_code.size(), 1u);
+
+  // Stage shaders of a graphics pipeline are released once it exists
+  SDL_GPUGraphicsPipeline* graphics = nshader_sdl3_gpu_context_create_graphics_pipeline(context, g_graphics_shader, nullptr);
+  EXPECT_NE(graphics, nullptr);
+  EXPECT_EQ(mock.graphics_pipelines, 1);
+  EXPECT_EQ(mock.live_shaders, 0);
+
+  nshader_sdl3_gpu_context_destroy(context);
+}
+
+TEST(NShaderSDL3GPUTests, CreateComputePipelinesInOrder) {
+  MockDevice mock;
+  check_compute_batch(&mock, 4);
+}
+
+TEST(NShaderSDL3GPUTests, CreateComputePipelinesDefaultThreads) {
+  MockDevice mock;
+  check_compute_batch(&mock, 0);
+}
+
+TEST(NShaderSDL3GPUTests, CreateComputePipelinesSerialDriver) {
+  // Drivers not known to allow concurrent creation stay on the calling thread
+  MockDevice mock;
+  mock.driver = "private";
+  check_compute_batch(&mock, 4);
+  ASSERT_EQ(mock.compute_threads.size(), 1u);
+  EXPECT_EQ(*mock.compute_threads.begin(), std::this_thread::get_id());
+}
+
+TEST(NShaderSDL3GPUTests, CreateComputePipelinesEmpty) {
+  MockDevice mock;
+  nshader_sdl3_gpu_context_t* context = create_mock_context(&mock);
+  ASSERT_NE(context, nullptr);
+  EXPECT_EQ(nshader_sdl3_gpu_context_create_compute_pipelines(context, nullptr, 0, 4, nullptr), 0u);
+  EXPECT_EQ(nshader_sdl3_gpu_context_create_compute_pipelines(nullptr, nullptr, 0, 4, nullptr), 0u);
+  EXPECT_TRUE(mock.compute_code.empty());
+  nshader_sdl3_gpu_context_destroy(context);
+}
+
+TEST(NShaderSDL3GPUTests, ShaderCacheRefcounting) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  MockDevice mock;
+  nshader_sdl3_gpu_context_t* context = create_mock_context(&mock);
+  ASSERT_NE(context, nullptr);
+  nshader_sdl3_gpu_shader_cache_t* cache = nshader_sdl3_gpu_shader_cache_create(context);
+  ASSERT_NE(cache, nullptr);
+
+  // The same key is created once and shared
+  SDL_GPUShader* vertex = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX);
+  ASSERT_NE(vertex, nullptr);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX), vertex);
+  SDL_GPUShader* fragment = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_FRAGMENT);
+  ASSERT_NE(fragment, nullptr);
+  EXPECT_NE(fragment, vertex);
+  EXPECT_EQ(mock.live_shaders, 2);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 2u);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_COMPUTE), nullptr);
+
+  // Shaders stay cached until their last reference is released and they are trimmed
+  nshader_sdl3_gpu_shader_cache_release(cache, vertex);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 0), 0u);
+  nshader_sdl3_gpu_shader_cache_release(cache, vertex);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 2u);
+  EXPECT_EQ(mock.live_shaders, 2);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 0), 1u);
+  EXPECT_EQ(mock.released_shaders, std::vector<SDL_GPUShader*>{ vertex });
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 1u);
+
+  // Releasing more often than acquired is ignored
+  nshader_sdl3_gpu_shader_cache_release(cache, vertex);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 1u);
+
+  // Destroying the cache releases shaders that are still acquired
+  nshader_sdl3_gpu_shader_cache_destroy(cache);
+  EXPECT_EQ(mock.live_shaders, 0);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(nullptr), 0u);
+  nshader_sdl3_gpu_context_destroy(context);
+}
+
+TEST(NShaderSDL3GPUTests, ShaderCacheTrimOrder) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  MockDevice mock;
+  nshader_sdl3_gpu_context_t* context = create_mock_context(&mock);
+  ASSERT_NE(context, nullptr);
+  nshader_sdl3_gpu_shader_cache_t* cache = nshader_sdl3_gpu_shader_cache_create(context);
+  ASSERT_NE(cache, nullptr);
+
+  // Stripping the names gives a second content hash
+  nshader_t* stripped = copy_shader(g_graphics_shader);
+  ASSERT_NE(stripped, nullptr);
+  ASSERT_TRUE(nshader_strip_names(stripped));
+
+  SDL_GPUShader* a = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX);
+  SDL_GPUShader* b = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_FRAGMENT);
+  SDL_GPUShader* c = nshader_sdl3_gpu_shader_cache_acquire(cache, stripped, NSHADER_STAGE_TYPE_VERTEX);
+  SDL_GPUShader* d = nshader_sdl3_gpu_shader_cache_acquire(cache, stripped, NSHADER_STAGE_TYPE_FRAGMENT);
+  ASSERT_TRUE(a && b && c && d);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 4u);
+
+  // Unused shaders are trimmed least recently released first, b is still acquired
+  nshader_sdl3_gpu_shader_cache_release(cache, c);
+  nshader_sdl3_gpu_shader_cache_release(cache, a);
+  nshader_sdl3_gpu_shader_cache_release(cache, d);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 1), 2u);
+  EXPECT_EQ(std::set<SDL_GPUShader*>(mock.released_shaders.begin(), mock.released_shaders.end()), (std::set<SDL_GPUShader*>{ a, c }));
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 2u);
+
+  // Acquiring an unused shader again takes it off the trim list without creating it
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_acquire(cache, stripped, NSHADER_STAGE_TYPE_FRAGMENT), d);
+  EXPECT_EQ(mock.live_shaders, 2);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 0), 0u);
+
+  nshader_sdl3_gpu_shader_cache_release(cache, b);
+  nshader_sdl3_gpu_shader_cache_release(cache, d);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 0), 2u);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 0u);
+  EXPECT_EQ(mock.live_shaders, 0);
+
+  nshader_destroy(stripped);
+  nshader_sdl3_gpu_shader_cache_destroy(cache);
+  nshader_sdl3_gpu_context_destroy(context);
+}
+
+TEST(NShaderSDL3GPUTests, ShaderCacheEvict) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  MockDevice mock;
+  nshader_sdl3_gpu_context_t* context = create_mock_context(&mock);
+  ASSERT_NE(context, nullptr);
+  nshader_sdl3_gpu_shader_cache_t* cache = nshader_sdl3_gpu_shader_cache_create(context);
+  ASSERT_NE(cache, nullptr);
+
+  SDL_GPUShader* vertex = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX);
+  SDL_GPUShader* fragment = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_FRAGMENT);
+  ASSERT_TRUE(vertex && fragment);
+  nshader_sdl3_gpu_shader_cache_release(cache, fragment);
+
+  // The unused fragment shader goes now, the acquired vertex shader stays alive
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_evict(cache, g_graphics_shader), 2u);
+  EXPECT_EQ(mock.released_shaders, std::vector<SDL_GPUShader*>{ fragment });
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 1u);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_evict(cache, g_graphics_shader), 0u);
+
+  // Evicted shaders are no longer found, the next acquire creates a new one
+  SDL_GPUShader* reloaded = nshader_sdl3_gpu_shader_cache_acquire(cache, g_graphics_shader, NSHADER_STAGE_TYPE_VERTEX);
+  ASSERT_NE(reloaded, nullptr);
+  EXPECT_NE(reloaded, vertex);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 2u);
+
+  // The evicted shader is released with its last reference, not kept for trimming
+  nshader_sdl3_gpu_shader_cache_release(cache, vertex);
+  EXPECT_EQ(mock.released_shaders, (std::vector<SDL_GPUShader*>{ fragment, vertex }));
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_count(cache), 1u);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 0), 0u);
+
+  nshader_sdl3_gpu_shader_cache_release(cache, reloaded);
+  EXPECT_EQ(nshader_sdl3_gpu_shader_cache_trim(cache, 0), 1u);
+  EXPECT_EQ(mock.live_shaders, 0);
+
+  nshader_sdl3_gpu_shader_cache_destroy(cache);
+  nshader_sdl3_gpu_context_destroy(context);
+}
+
+TEST(NShaderSDL3GPUTests, GraphicsPipelineVertexInputs) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  MockDevice mock;
+  nshader_sdl3_gpu_context_t* context = create_mock_context(&mock);
+  ASSERT_NE(context, nullptr);
+
+  // Swap the reflected inputs of a copy for a known layout, out of location order
+  nshader_t* shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(shader, nullptr);
+  nshader_info_t* info = const_cast<nshader_info_t*>(nshader_get_info(shader));
+  nshader_stage_metadata_vertex_t* vertex = nullptr;
+  for (size_t i = 0; i < info->num_stages; i++) {
+    if (info->stages[i].type == NSHADER_STAGE_TYPE_VERTEX) {
+      vertex = &info->stages[i].metadata.vertex;
+    }
+  }
+  ASSERT_NE(vertex, nullptr);
+  nshader_stage_binding_t inputs[] = {
+    { nullptr, 2, 4, NSHADER_BINDING_TYPE_FLOAT32 },
+    { nullptr, 0, 3, NSHADER_BINDING_TYPE_FLOAT32 },
+    { nullptr, 3, 2, NSHADER_BINDING_TYPE_FLOAT32 },
+    { nullptr, 1, 2, NSHADER_BINDING_TYPE_UINT32 },
+  };
+  nshader_stage_binding_t* reflected_inputs = vertex->inputs;
+  size_t reflected_count = vertex->input_count;
+  vertex->inputs = inputs;
+  vertex->input_count = 4;
+
+  // Without a desc every attribute is packed into slot 0 in location order
+  ASSERT_NE(nshader_sdl3_gpu_context_create_graphics_pipeline(context, shader, nullptr), nullptr);
+  ASSERT_EQ(mock.vertex_attributes.size(), 4u);
+  const SDL_GPUVertexElementFormat formats[] = {
+    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, SDL_GPU_VERTEXELEMENTFORMAT_UINT2,
+    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+  };
+  const uint32_t packed_offsets[] = { 0, 12, 20, 36 };
+  for (uint32_t i = 0; i < 4; i++) {
+    EXPECT_EQ(mock.vertex_attributes[i].location, i);
+    EXPECT_EQ(mock.vertex_attributes[i].buffer_slot, 0u);
+    EXPECT_EQ(mock.vertex_attributes[i].format, formats[i]);
+    EXPECT_EQ(mock.vertex_attributes[i].offset, packed_offsets[i]);
+  }
+  ASSERT_EQ(mock.vertex_buffers.size(), 1u);
+  EXPECT_EQ(mock.vertex_buffers[0].slot, 0u);
+  EXPECT_EQ(mock.vertex_buffers[0].pitch, 44u);
+  EXPECT_EQ(mock.vertex_buffers[0].input_rate, SDL_GPU_VERTEXINPUTRATE_VERTEX);
+
+  // Location 3 moves to an instanced slot 2, slots past num_buffer_slots stay at 0
+  const uint32_t buffer_slots[] = { 0, 0, 0, 2 };
+  nshader_sdl3_gpu_graphics_pipeline_desc_t desc = {};
+  desc.buffer_slots = buffer_slots;
+  desc.num_buffer_slots = 4;
+  desc.instance_slot_mask = 1u << 2;
+  ASSERT_NE(nshader_sdl3_gpu_context_create_graphics_pipeline(context, shader, &desc), nullptr);
+  ASSERT_EQ(mock.vertex_attributes.size(), 4u);
+  EXPECT_EQ(mock.vertex_attributes[2].offset, 20u);
+  EXPECT_EQ(mock.vertex_attributes[3].buffer_slot, 2u);
+  EXPECT_EQ(mock.vertex_attributes[3].offset, 0u);
+  ASSERT_EQ(mock.vertex_buffers.size(), 2u);
+  EXPECT_EQ(mock.vertex_buffers[0].slot, 0u);
+  EXPECT_EQ(mock.vertex_buffers[0].pitch, 36u);
+  EXPECT_EQ(mock.vertex_buffers[0].input_rate, SDL_GPU_VERTEXINPUTRATE_VERTEX);
+  EXPECT_EQ(mock.vertex_buffers[1].slot, 2u);
+  EXPECT_EQ(mock.vertex_buffers[1].pitch, 8u);
+  EXPECT_EQ(mock.vertex_buffers[1].input_rate, SDL_GPU_VERTEXINPUTRATE_INSTANCE);
+  desc.num_buffer_slots = 3;
+  ASSERT_NE(nshader_sdl3_gpu_context_create_graphics_pipeline(context, shader, &desc), nullptr);
+  EXPECT_EQ(mock.vertex_attributes[3].buffer_slot, 0u);
+  EXPECT_EQ(mock.vertex_buffers.size(), 1u);
+
+  // Duplicate locations are rejected before any GPU object is created
+  int pipelines = mock.graphics_pipelines;
+  size_t released = mock.released_shaders.size();
+  inputs[2].location = 2;
+  EXPECT_EQ(nshader_sdl3_gpu_context_create_graphics_pipeline(context, shader, nullptr), nullptr);
+  EXPECT_EQ(mock.graphics_pipelines, pipelines);
+  EXPECT_EQ(mock.released_shaders.size(), released);
+
+  vertex->inputs = reflected_inputs;
+  vertex->input_count = reflected_count;
+  nshader_destroy(shader);
+  nshader_sdl3_gpu_context_destroy(context);
+}
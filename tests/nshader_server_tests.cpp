@@ -0,0 +1,213 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_info.h>
+#include <nshader/nshader_type.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_server.h>
+}
+
+#include "test_shaders.h"
+
+namespace fs = std::filesystem;
+
+#ifndef _WIN32
+
+// Server on a socket in a fresh directory, removed with the fixture
+class NShaderServerTests : public ::testing::Test {
+protected:
+  fs::path dir = "test_server";
+  std::string socket_path = "test_server/nshader.sock";
+  nshader_server_t* server = nullptr;
+  nshader_compiler_stage_setup_t stage = {};
+  nshader_compiler_config_t config = {};
+
+  void SetUp() override {
+    fs::remove_all(dir);
+    fs::create_directories(dir / "include");
+
+    stage.stage_type = NSHADER_STAGE_TYPE_COMPUTE;
+    stage.entry_point = "main";
+    stage.source_code = COMPUTE_SHADER_SOURCE;
+    config.stages = &stage;
+    config.num_stages = 1;
+
+    nshader_server_config_t server_config = {};
+    server_config.socket_path = socket_path.c_str();
+    server_config.num_threads = 2;
+    server = nshader_server_create(&server_config);
+    ASSERT_NE(server, nullptr);
+  }
+
+  void TearDown() override {
+    nshader_server_destroy(server);
+    fs::remove_all(dir);
+  }
+
+  void write(const fs::path& name, const std::string& text) {
+    std::ofstream file(dir / name, std::ios::binary | std::ios::trunc);
+    file << text;
+  }
+
+  nshader_server_stats_t stats() {
+    nshader_server_stats_t out;
+    nshader_server_get_stats(server, &out);
+    return out;
+  }
+};
+
+TEST_F(NShaderServerTests, CompileThroughServer) {
+  nshader_error_list_t errors = {};
+  nshader_t* shader = nshader_server_compile(socket_path.c_str(), &config, &errors);
+  ASSERT_NE(shader, nullptr);
+  EXPECT_EQ(errors.num_errors, 0u);
+
+  const nshader_info_t* info = nshader_get_info(shader);
+  EXPECT_EQ(info->type, NSHADER_SHADER_TYPE_COMPUTE);
+  EXPECT_TRUE(nshader_has_stage(shader, NSHADER_STAGE_TYPE_COMPUTE));
+  nshader_destroy(shader);
+  nshader_error_list_free(&errors);
+
+  EXPECT_EQ(stats().requests, 1u);
+  EXPECT_EQ(stats().cache_entries, 1u);
+}
+
+TEST_F(NShaderServerTests, RepeatedRequestIsCached) {
+  for (int i = 0; i < 3; i++) {
+    nshader_t* shader = nshader_server_compile(socket_path.c_str(), &config, nullptr);
+    ASSERT_NE(shader, nullptr);
+    nshader_destroy(shader);
+  }
+  EXPECT_EQ(stats().requests, 3u);
+  EXPECT_EQ(stats().cache_hits, 2u);
+
+  // Different options are a different request
+  config.reproducible = true;
+  nshader_t* shader = nshader_server_compile(socket_path.c_str(), &config, nullptr);
+  ASSERT_NE(shader, nullptr);
+  nshader_destroy(shader);
+  EXPECT_EQ(stats().cache_hits, 2u);
+  EXPECT_EQ(stats().cache_entries, 2u);
+}
+
+TEST_F(NShaderServerTests, IncludeChangeInvalidatesCache) {
+  std::string source = std::string("#include \"common.hlsl\"\n") + COMPUTE_SHADER_SOURCE;
+  std::string include_dir = (dir / "include").string();
+  stage.source_code = source.c_str();
+  config.include_dir = include_dir.c_str();
+  write("include/common.hlsl", "// v1\n");
+
+  nshader_t* shader = nshader_server_compile(socket_path.c_str(), &config, nullptr);
+  ASSERT_NE(shader, nullptr);
+  nshader_destroy(shader);
+
+  write("include/common.hlsl", "// version 2, longer\n");
+  shader = nshader_server_compile(socket_path.c_str(), &config, nullptr);
+  ASSERT_NE(shader, nullptr);
+  nshader_destroy(shader);
+  EXPECT_EQ(stats().cache_hits, 0u);
+
+  shader = nshader_server_compile(socket_path.c_str(), &config, nullptr);
+  ASSERT_NE(shader, nullptr);
+  nshader_destroy(shader);
+  EXPECT_EQ(stats().cache_hits, 1u);
+}
+
+// The server scans request sources against the directory of the client
+static void collect_dependency(void* user, const char* path, bool exists) {
+  static_cast<std::vector<std::pair<std::string, bool>>*>(user)->emplace_back(path, exists);
+}
+
+TEST_F(NShaderServerTests, SourceDependenciesResolveInSourceDir) {
+  write("local.hlsl", "// local\n");
+  const char* source = "#include \"local.hlsl\"\n";
+
+  std::vector<std::pair<std::string, bool>> found;
+  std::string source_dir = dir.string();
+  nshader_compiler_scan_source_dependencies(source, source_dir.c_str(), nullptr, collect_dependency, &found);
+  ASSERT_EQ(found.size(), 1u);
+  EXPECT_TRUE(fs::equivalent(found[0].first, dir / "local.hlsl"));
+  EXPECT_TRUE(found[0].second);
+
+  // Without a directory quoted names resolve against the working directory
+  found.clear();
+  nshader_compiler_scan_source_dependencies(source, nullptr, nullptr, collect_dependency, &found);
+  ASSERT_EQ(found.size(), 1u);
+  EXPECT_EQ(found[0].first, "local.hlsl");
+  EXPECT_FALSE(found[0].second);
+}
+
+TEST_F(NShaderServerTests, CompileErrorsAreForwarded) {
+  stage.source_code = "#error broken\n";
+  nshader_error_list_t errors = {};
+  EXPECT_EQ(nshader_server_compile(socket_path.c_str(), &config, &errors), nullptr);
+  EXPECT_GT(errors.num_errors, 0u);
+  nshader_error_list_free(&errors);
+  EXPECT_EQ(stats().failures, 1u);
+  EXPECT_EQ(stats().cache_entries, 0u);
+}
+
+TEST_F(NShaderServerTests, ConcurrentClients) {
+  std::vector<std::thread> clients;
+  std::vector<int> compiled(8, 0);
+  for (int i = 0; i < 8; i++) {
+    clients.emplace_back([&, i] {
+      nshader_t* shader = nshader_server_compile(socket_path.c_str(), &config, nullptr);
+      compiled[i] = shader != nullptr;
+      nshader_destroy(shader);
+    });
+  }
+  for (std::thread& client : clients) {
+    client.join();
+  }
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(compiled[i], 1);
+  }
+  EXPECT_EQ(stats().requests, 8u);
+}
+
+TEST_F(NShaderServerTests, SecondServerOnSameSocketFails) {
+  nshader_server_config_t server_config = {};
+  server_config.socket_path = socket_path.c_str();
+  EXPECT_EQ(nshader_server_create(&server_config), nullptr);
+}
+
+TEST_F(NShaderServerTests, NoServerListening) {
+  nshader_server_destroy(server);
+  server = nullptr;
+  nshader_error_list_t errors = {};
+  EXPECT_EQ(nshader_server_compile(socket_path.c_str(), &config, &errors), nullptr);
+  EXPECT_EQ(errors.num_errors, 1u);
+  nshader_error_list_free(&errors);
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_string_pool.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_compiler_tests.h"
+}
+#include "nshader_test_utils.h"
+
+// Every name of a shader, entry points first
+static std::vector<const char*> collect_names(const nshader_t* shader) {
+  std::vector<const char*> names;
+  const nshader_info_t* info = nshader_get_info(shader);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    const nshader_stage_t* stage = &info->stages[i];
+    names.push_back(stage->entry_point);
+    const nshader_stage_binding_t* lists[2] = {};
+    size_t counts[2] = {};
+    if (stage->type == NSHADER_STAGE_TYPE_VERTEX) {
+      lists[0] = stage->metadata.vertex.inputs; counts[0] = stage->metadata.vertex.input_count;
+      lists[1] = stage->metadata.vertex.outputs; counts[1] = stage->metadata.vertex.output_count;
+    } else if (stage->type == NSHADER_STAGE_TYPE_FRAGMENT) {
+      lists[0] = stage->metadata.fragment.inputs; counts[0] = stage->metadata.fragment.input_count;
+      lists[1] = stage->metadata.fragment.outputs; counts[1] = stage->metadata.fragment.output_count;
+    }
+    for (int list = 0; list < 2; list++) {
+      for (size_t j = 0; j < counts[list]; j++) {
+        names.push_back(lists[list][j].name);
+      }
+    }
+  }
+  return names;
+}
+
+TEST(NShaderStringPoolTests, Intern) {
+  nshader_string_pool_t* pool = nshader_string_pool_create(nullptr);
+  ASSERT_NE(pool, nullptr);
+
+  std::string texcoord = "TEXCOORD0";
+  const char* a = nshader_string_pool_intern(pool, "TEXCOORD0");
+  const char* b = nshader_string_pool_intern(pool, texcoord.c_str());
+  const char* c = nshader_string_pool_intern(pool, "COLOR0");
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_NE(a, texcoord.c_str());
+  EXPECT_STREQ(c, "COLOR0");
+
+  // Strings longer than a block and enough entries to grow the table
+  std::string long_name(10000, 'x');
+  const char* long_a = nshader_string_pool_intern(pool, long_name.c_str());
+  for (int i = 0; i < 1000; i++) {
+    std::string name = "NAME" + std::to_string(i);
+    EXPECT_STREQ(nshader_string_pool_intern(pool, name.c_str()), name.c_str());
+  }
+  EXPECT_EQ(nshader_string_pool_intern(pool, long_name.c_str()), long_a);
+  EXPECT_EQ(nshader_string_pool_intern(pool, "TEXCOORD0"), a);
+  EXPECT_EQ(nshader_string_pool_count(pool), 1003u);
+
+  EXPECT_EQ(nshader_string_pool_intern(pool, nullptr), nullptr);
+  EXPECT_EQ(nshader_string_pool_intern(nullptr, "x"), nullptr);
+  nshader_string_pool_destroy(pool);
+}
+
+TEST(NShaderStringPoolTests, ConcurrentIntern) {
+  nshader_string_pool_t* pool = nshader_string_pool_create(nullptr);
+  ASSERT_NE(pool, nullptr);
+
+  // Every thread interns the same names, all of them must agree
+  const int num_names = 500;
+  std::vector<std::vector<const char*>> results(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < results.size(); t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < num_names; i++) {
+        results[t].push_back(nshader_string_pool_intern(pool, ("NAME" + std::to_string(i)).c_str()));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(nshader_string_pool_count(pool), (size_t)num_names);
+  for (size_t t = 1; t < results.size(); t++) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  nshader_string_pool_destroy(pool);
+}
+
+TEST(NShaderStringPoolTests, SharedWithinFile) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  std::vector<uint8_t> buffer = write_to_vector(g_graphics_shader);
+
+  nshader_t* shader = nshader_read_from_memory(buffer.data(), buffer.size());
+  ASSERT_NE(shader, nullptr);
+
+  // Equal names in one file point to the same string
+  std::vector<const char*> names = collect_names(shader);
+  for (const char* a : names) {
+    for (const char* b : names) {
+      EXPECT_EQ(strcmp(a, b) == 0, a == b) << a << " " << b;
+    }
+  }
+  nshader_destroy(shader);
+}
+
+TEST(NShaderStringPoolTests, SharedAcrossShaders) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  std::vector<uint8_t> buffer = write_to_vector(g_graphics_shader);
+
+  nshader_string_pool_t* pool = nshader_string_pool_create(nullptr);
+  ASSERT_NE(pool, nullptr);
+  nshader_read_options_t options = {};
+  options.string_pool = pool;
+
+  nshader_t* first = nshader_read_from_memory_ex(buffer.data(), buffer.size(), &options);
+  nshader_t* second = nshader_read_from_memory_ex(buffer.data(), buffer.size(), &options);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  size_t count = nshader_string_pool_count(pool);
+  EXPECT_GT(count, 0u);
+
+  std::vector<const char*> first_names = collect_names(first);
+  std::vector<const char*> second_names = collect_names(second);
+  EXPECT_EQ(first_names, second_names);
+  for (const char* name : first_names) {
+    EXPECT_EQ(nshader_string_pool_intern(pool, name), name);
+  }
+  EXPECT_EQ(nshader_string_pool_count(pool), count);
+
+  // Pooled names survive the shaders and are written back unchanged
+  EXPECT_EQ(write_to_vector(second), buffer);
+  nshader_destroy(first);
+  nshader_destroy(second);
+  nshader_string_pool_destroy(pool);
+}
@@ -0,0 +1,211 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_strip.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_compiler_tests.h"
+}
+#include "nshader_test_utils.h"
+
+static size_t written_size(const nshader_t* shader) {
+  return nshader_write_to_memory(shader, nullptr, 0);
+}
+
+static uint32_t op(uint32_t opcode, uint32_t word_count) {
+  return (word_count << 16) | opcode;
+}
+
+// Header followed by instructions, strings are packed little-endian
+static std::vector<uint32_t> spirv_module(std::initializer_list<uint32_t> instructions) {
+  std::vector<uint32_t> words = {0x07230203u, 0x00010000u, 0, 16, 0};
+  words.insert(words.end(), instructions);
+  return words;
+}
+
+TEST(NShaderStripTests, StripBackends) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  if (!nshader_has_backend(g_graphics_shader, NSHADER_BACKEND_SPV) || nshader_get_info(g_graphics_shader)->num_backends < 2) {
+    GTEST_SKIP() << "Needs SPIR-V and another backend";
+  }
+
+  nshader_t* shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(shader, nullptr);
+  ASSERT_TRUE(nshader_strip_backends(shader, 1u << NSHADER_BACKEND_SPV));
+
+  const nshader_info_t* info = nshader_get_info(shader);
+  ASSERT_EQ(info->num_backends, 1u);
+  EXPECT_EQ(info->backends[0], NSHADER_BACKEND_SPV);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    for (int b = 0; b < NSHADER_BACKEND_COUNT; b++) {
+      const nshader_blob_t* blob = nshader_get_blob(shader, info->stages[i].type, (nshader_backend_t)b);
+      EXPECT_EQ(blob != nullptr, b == NSHADER_BACKEND_SPV);
+    }
+  }
+  EXPECT_LT(written_size(shader), written_size(g_graphics_shader));
+
+  // The stored hash no longer applies
+  nshader_hash_t full_hash, stripped_hash;
+  ASSERT_TRUE(nshader_hash(g_graphics_shader, &full_hash));
+  ASSERT_TRUE(nshader_hash(shader, &stripped_hash));
+  EXPECT_TRUE(full_hash.lo != stripped_hash.lo || full_hash.hi != stripped_hash.hi);
+  nshader_destroy(shader);
+}
+
+TEST(NShaderStripTests, StripBackendsWithoutMatch) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(shader, nullptr);
+
+  size_t num_backends = nshader_get_info(shader)->num_backends;
+  EXPECT_FALSE(nshader_strip_backends(shader, 0));
+  EXPECT_EQ(nshader_get_info(shader)->num_backends, num_backends);
+  EXPECT_FALSE(nshader_strip_backends(nullptr, UINT32_MAX));
+  nshader_destroy(shader);
+}
+
+TEST(NShaderStripTests, StripNames) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(shader, nullptr);
+  ASSERT_TRUE(nshader_strip_names(shader));
+
+  const nshader_info_t* info = nshader_get_info(shader);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    const nshader_stage_t* stage = &info->stages[i];
+    EXPECT_NE(stage->entry_point, nullptr);
+    if (stage->type == NSHADER_STAGE_TYPE_VERTEX) {
+      for (size_t j = 0; j < stage->metadata.vertex.input_count; j++) {
+        EXPECT_EQ(stage->metadata.vertex.inputs[j].name, nullptr);
+      }
+    }
+  }
+
+  // Stripped names are written as empty strings
+  nshader_t* reread = copy_shader(shader);
+  ASSERT_NE(reread, nullptr);
+  const nshader_info_t* reread_info = nshader_get_info(reread);
+  for (size_t i = 0; i < reread_info->num_stages; i++) {
+    const nshader_stage_t* stage = &reread_info->stages[i];
+    if (stage->type == NSHADER_STAGE_TYPE_VERTEX) {
+      for (size_t j = 0; j < stage->metadata.vertex.input_count; j++) {
+        EXPECT_STREQ(stage->metadata.vertex.inputs[j].name, "");
+      }
+    }
+  }
+  EXPECT_LE(written_size(shader), written_size(g_graphics_shader));
+  nshader_destroy(reread);
+  nshader_destroy(shader);
+}
+
+TEST(NShaderStripTests, StripDebugInfo) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_t* shader = copy_shader(g_graphics_shader);
+  ASSERT_NE(shader, nullptr);
+  ASSERT_TRUE(nshader_strip_debug_info(shader));
+
+  // SPIR-V blobs match the standalone pass, other backends are untouched
+  const nshader_info_t* info = nshader_get_info(shader);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    nshader_stage_type_t stage = info->stages[i].type;
+    for (int b = 0; b < NSHADER_BACKEND_COUNT; b++) {
+      const nshader_blob_t* original = nshader_get_blob(g_graphics_shader, stage, (nshader_backend_t)b);
+      const nshader_blob_t* blob = nshader_get_blob(shader, stage, (nshader_backend_t)b);
+      if (!original) continue;
+      ASSERT_NE(blob, nullptr);
+      std::vector<uint8_t> expected(original->data, original->data + original->size);
+      if (b == NSHADER_BACKEND_SPV) {
+        size_t size = nshader_spirv_strip_debug_info(original->data, original->size, expected.data(), expected.size());
+        if (size > 0) expected.resize(size);
+      }
+      ASSERT_EQ(blob->size, expected.size());
+      EXPECT_EQ(memcmp(blob->data, expected.data(), blob->size), 0);
+    }
+  }
+  nshader_destroy(shader);
+}
+
+TEST(NShaderStripTests, SpirvStripDebugInfo) {
+  std::vector<uint32_t> module = spirv_module({
+    op(17, 2), 1,                            // OpCapability Shader
+    op(3, 3), 5, 600,                        // OpSource HLSL 600
+    op(7, 3), 2, 0x00612E61,                 // OpString %2 "a.a"
+    op(5, 3), 3, 0x00006F66,                 // OpName %3 "fo"
+    op(6, 4), 4, 0, 0x00000078,              // OpMemberName %4 0 "x"
+    op(14, 3), 0, 1,                         // OpMemoryModel Logical GLSL450
+    op(8, 4), 2, 1, 1,                       // OpLine %2 1 1
+    op(317, 1),                              // OpNoLine
+    op(330, 2), 0x00000064,                  // OpModuleProcessed "d"
+  });
+  std::vector<uint32_t> expected = spirv_module({
+    op(17, 2), 1,
+    op(14, 3), 0, 1,
+  });
+
+  size_t size = module.size() * 4;
+  ASSERT_EQ(nshader_spirv_strip_debug_info(module.data(), size, nullptr, 0), expected.size() * 4);
+
+  // Too small an output fails, in place works
+  std::vector<uint32_t> out(expected.size() - 1);
+  EXPECT_EQ(nshader_spirv_strip_debug_info(module.data(), size, out.data(), out.size() * 4), 0u);
+  ASSERT_EQ(nshader_spirv_strip_debug_info(module.data(), size, module.data(), size), expected.size() * 4);
+  module.resize(expected.size());
+  EXPECT_EQ(module, expected);
+}
+
+TEST(NShaderStripTests, SpirvKeepsStringsForNonSemantic) {
+  // OpExtInstImport %1 "NonSemantic.Shader.DebugInfo.100"
+  std::vector<uint32_t> module = spirv_module({
+    op(11, 11), 1, 0x536E6F4E, 0x6E616D65, 0x2E636974, 0x64616853, 0x442E7265,
+                   0x67756265, 0x6F666E49, 0x3030312E, 0x00000000,
+    op(7, 3), 2, 0x00612E61,                 // OpString %2 "a.a"
+    op(5, 3), 3, 0x00006F66,                 // OpName %3 "fo"
+  });
+  size_t stripped = nshader_spirv_strip_debug_info(module.data(), module.size() * 4, nullptr, 0);
+  EXPECT_EQ(stripped, (module.size() - 3) * 4);
+}
+
+TEST(NShaderStripTests, SpirvInvalid) {
+  std::vector<uint32_t> module = spirv_module({op(17, 2), 1});
+  EXPECT_EQ(nshader_spirv_strip_debug_info(nullptr, 0, nullptr, 0), 0u);
+  EXPECT_EQ(nshader_spirv_strip_debug_info(module.data(), module.size() * 4 - 2, nullptr, 0), 0u);
+
+  // Instruction running past the end
+  module[5] = op(17, 3);
+  EXPECT_EQ(nshader_spirv_strip_debug_info(module.data(), module.size() * 4, nullptr, 0), 0u);
+
+  // Zero word count
+  module[5] = op(17, 0);
+  EXPECT_EQ(nshader_spirv_strip_debug_info(module.data(), module.size() * 4, nullptr, 0), 0u);
+
+  // Wrong magic
+  module[5] = op(17, 2);
+  module[0] = 0;
+  EXPECT_EQ(nshader_spirv_strip_debug_info(module.data(), module.size() * 4, nullptr, 0), 0u);
+}
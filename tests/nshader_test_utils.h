@@ -0,0 +1,50 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_writer.h>
+}
+
+// Shared helpers for tests working on serialized shaders
+
+// Serialized shader, empty if writing failed
+static inline std::vector<uint8_t> write_to_vector(const nshader_t* shader) {
+  std::vector<uint8_t> buffer(nshader_write_to_memory(shader, nullptr, 0));
+  if (nshader_write_to_memory(shader, buffer.data(), buffer.size()) != buffer.size()) {
+    buffer.clear();
+  }
+  return buffer;
+}
+
+// Independent copy of a shader, so tests can modify it and leave the shared ones alone
+static inline nshader_t* copy_shader(const nshader_t* shader) {
+  std::vector<uint8_t> buffer = write_to_vector(shader);
+  return buffer.empty() ? nullptr : nshader_read_from_memory(buffer.data(), buffer.size());
+}
@@ -0,0 +1,123 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_validator.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_writer.h>
+#include "nshader_compiler_tests.h"
+}
+#include "nshader_test_utils.h"
+
+static bool reader_accepts(const std::vector<uint8_t>& buffer) {
+  nshader_t* shader = nshader_read_from_memory(buffer.data(), buffer.size());
+  nshader_destroy(shader);
+  return shader != nullptr;
+}
+
+TEST(NShaderValidatorTests, ValidShader) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  std::vector<uint8_t> buffer = write_to_vector(g_graphics_shader);
+
+  nshader_validate_report_t report;
+  ASSERT_TRUE(nshader_validate_memory(buffer.data(), buffer.size(), &report));
+  EXPECT_EQ(report.status, NSHADER_VALIDATE_OK);
+  EXPECT_EQ(report.version, (uint32_t)NSHADER_VERSION);
+  EXPECT_EQ(report.size, buffer.size());
+  EXPECT_EQ(report.num_stages, nshader_get_info(g_graphics_shader)->num_stages);
+  EXPECT_EQ(report.num_backends, nshader_get_info(g_graphics_shader)->num_backends);
+  EXPECT_GT(report.num_blobs, 0u);
+  EXPECT_GT(report.blob_bytes, 0u);
+
+  // The report is optional
+  EXPECT_TRUE(nshader_validate_memory(buffer.data(), buffer.size(), nullptr));
+  EXPECT_FALSE(nshader_validate_memory(nullptr, 0, nullptr));
+}
+
+TEST(NShaderValidatorTests, Truncated) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  std::vector<uint8_t> buffer = write_to_vector(g_graphics_shader);
+
+  for (size_t size = 0; size < buffer.size(); size++) {
+    nshader_validate_report_t report;
+    EXPECT_FALSE(nshader_validate_memory(buffer.data(), size, &report)) << size;
+    EXPECT_EQ(report.status, NSHADER_VALIDATE_TRUNCATED) << size;
+    EXPECT_LE(report.error_offset, size);
+  }
+}
+
+TEST(NShaderValidatorTests, HeaderFromPrefix) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  nshader_write_options_t options = {};
+  options.checksums = true;
+  std::vector<uint8_t> buffer(nshader_write_to_memory_ex(g_graphics_shader, nullptr, 0, &options));
+  ASSERT_EQ(nshader_write_to_memory_ex(g_graphics_shader, buffer.data(), buffer.size(), &options), buffer.size());
+
+  // The start of a file answers version and checksums even though it fails
+  nshader_validate_report_t report;
+  EXPECT_FALSE(nshader_validate_memory(buffer.data(), 64, &report));
+  EXPECT_EQ(report.version, (uint32_t)NSHADER_VERSION);
+  EXPECT_TRUE(report.has_checksums);
+
+  buffer = write_to_vector(g_graphics_shader);
+  EXPECT_FALSE(nshader_validate_memory(buffer.data(), 64, &report));
+  EXPECT_FALSE(report.has_checksums);
+}
+
+TEST(NShaderValidatorTests, AbsurdCounts) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  std::vector<uint8_t> buffer = write_to_vector(g_graphics_shader);
+
+  // The string count follows magic, version, flags, alignment and the hash
+  const size_t num_strings_offset = 32;
+  const uint32_t huge = 0x7FFFFFFF;
+  memcpy(buffer.data() + num_strings_offset, &huge, sizeof(huge));
+
+  nshader_validate_report_t report;
+  EXPECT_FALSE(nshader_validate_memory(buffer.data(), buffer.size(), &report));
+  EXPECT_EQ(report.status, NSHADER_VALIDATE_BAD_COUNT);
+  EXPECT_EQ(report.error_offset, num_strings_offset);
+  EXPECT_EQ(nshader_read_from_memory(buffer.data(), buffer.size()), nullptr);
+}
+
+TEST(NShaderValidatorTests, MatchesReader) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+  const std::vector<uint8_t> original = write_to_vector(g_graphics_shader);
+
+  // Corrupt every byte in turn, the validator must agree with the reader
+  for (size_t i = 0; i < original.size(); i++) {
+    for (uint8_t value : { (uint8_t)0x00, (uint8_t)0x7F, (uint8_t)0xFF }) {
+      std::vector<uint8_t> buffer = original;
+      buffer[i] = value;
+      nshader_validate_report_t report;
+      bool valid = nshader_validate_memory(buffer.data(), buffer.size(), &report);
+      EXPECT_EQ(valid, reader_accepts(buffer)) << "offset " << i << " value " << (int)value << " "
+                                               << nshader_validate_status_to_string(report.status);
+    }
+  }
+}
@@ -0,0 +1,236 @@
+/*
+MIT License
+
+Copyright (c) 2026 Christian Luppi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <nshader/nshader_base.h>
+#include <nshader/nshader_info.h>
+#include <nshader/nshader_reader.h>
+#include <nshader/nshader_watcher.h>
+}
+
+#include "test_shaders.h"
+
+namespace fs = std::filesystem;
+
+// Events delivered to the watcher callback
+struct WatchEvents {
+  std::mutex mutex;
+  std::vector<std::string> names;
+  int failures = 0;
+
+  static void on_event(void* user, const nshader_watcher_event_t* event) {
+    WatchEvents* events = static_cast<WatchEvents*>(user);
+    std::lock_guard<std::mutex> lock(events->mutex);
+    events->names.push_back(event->name);
+    if (!event->success) {
+      EXPECT_GT(event->errors->num_errors, 0u);
+      events->failures++;
+    }
+  }
+
+  int get_failures() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failures;
+  }
+};
+
+// Fresh source and output directories, removed with the fixture
+class NShaderWatcherTests : public ::testing::Test {
+protected:
+  fs::path dir = "test_watcher";
+  fs::path out = "test_watcher/out";
+  WatchEvents events;
+  nshader_watcher_t* watcher = nullptr;
+
+  void SetUp() override {
+    fs::remove_all(dir);
+    fs::create_directories(out);
+  }
+
+  void TearDown() override {
+    nshader_watcher_destroy(watcher);
+    fs::remove_all(dir);
+  }
+
+  void write(const char* name, const std::string& text) {
+    std::ofstream file(dir / name, std::ios::binary | std::ios::trunc);
+    file << text;
+  }
+
+  void start() {
+    std::string source_dir = dir.string();
+    std::string output_dir = out.string();
+    nshader_watcher_config_t config = {};
+    config.source_dir = source_dir.c_str();
+    config.output_dir = output_dir.c_str();
+    config.include_dir = source_dir.c_str();
+    config.debounce_ms = 20;
+    config.poll_ms = 20;
+    config.callback = WatchEvents::on_event;
+    config.user = &events;
+    watcher = nshader_watcher_create(&config);
+    ASSERT_NE(watcher, nullptr);
+  }
+};
+
+static bool wait_until(const std::function<bool()>& condition) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (condition()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return condition();
+}
+
+TEST_F(NShaderWatcherTests, RebuildsOnIncludeChange) {
+  write("common.hlsl", "#define FILL_SCALE 1.0\n");
+  write("Fill.comp.hlsl", std::string("#include \"common.hlsl\"\n") + COMPUTE_SHADER_SOURCE);
+  start();
+
+  // The initial build is done when create returns
+  nshader_watcher_handle_t* handle = nshader_watcher_get_handle(watcher, "Fill");
+  ASSERT_NE(handle, nullptr);
+  EXPECT_EQ(nshader_watcher_handle_get_generation(handle), 1u);
+  EXPECT_TRUE(fs::exists(out / "Fill.nshader"));
+
+  nshader_watcher_ref_t ref;
+  ASSERT_TRUE(nshader_watcher_handle_acquire(handle, &ref));
+  EXPECT_EQ(ref.generation, 1u);
+  EXPECT_EQ(nshader_get_info(ref.shader)->type, NSHADER_SHADER_TYPE_COMPUTE);
+
+  write("common.hlsl", "#define FILL_SCALE 2.00\n");
+  ASSERT_TRUE(wait_until([&] { return nshader_watcher_handle_get_generation(handle) == 2; }));
+
+  // A build held by a reference outlives its replacement
+  EXPECT_EQ(nshader_get_info(ref.shader)->type, NSHADER_SHADER_TYPE_COMPUTE);
+  nshader_watcher_ref_release(&ref);
+
+  // A broken include keeps the last good build published
+  write("common.hlsl", "#error broken\n");
+  ASSERT_TRUE(wait_until([&] { return events.get_failures() == 1; }));
+  EXPECT_EQ(nshader_watcher_handle_get_generation(handle), 2u);
+
+  write("common.hlsl", "#define FILL_SCALE 3.000\n");
+  ASSERT_TRUE(wait_until([&] { return nshader_watcher_handle_get_generation(handle) == 3; }));
+  ASSERT_TRUE(nshader_watcher_handle_acquire(handle, &ref));
+  EXPECT_EQ(ref.generation, 3u);
+  nshader_watcher_ref_release(&ref);
+}
+
+TEST_F(NShaderWatcherTests, ConcurrentReaders) {
+  write("Fill.comp.hlsl", COMPUTE_SHADER_SOURCE);
+  start();
+  nshader_watcher_handle_t* handle = nshader_watcher_get_handle(watcher, "Fill");
+  ASSERT_NE(handle, nullptr);
+
+  // Readers keep acquiring while builds are replaced under them
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&] {
+      uint32_t last = 0;
+      while (!done) {
+        nshader_watcher_ref_t ref;
+        ASSERT_TRUE(nshader_watcher_handle_acquire(handle, &ref));
+        EXPECT_GE(ref.generation, last);
+        EXPECT_EQ(nshader_get_info(ref.shader)->type, NSHADER_SHADER_TYPE_COMPUTE);
+        last = ref.generation;
+        nshader_watcher_ref_release(&ref);
+      }
+    });
+  }
+
+  std::string padding;
+  for (uint32_t generation = 2; generation <= 5; generation++) {
+    padding += "\n";
+    write("Fill.comp.hlsl", COMPUTE_SHADER_SOURCE + padding);
+    EXPECT_TRUE(wait_until([&] { return nshader_watcher_handle_get_generation(handle) >= generation; }));
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+}
+
+TEST_F(NShaderWatcherTests, FreesReplacedVersions) {
+  if (!nshader_alloc_tracking_enabled()) {
+    GTEST_SKIP() << "nshader was built without NSHADER_ALLOC_TRACKING";
+  }
+  write("Fill.comp.hlsl", COMPUTE_SHADER_SOURCE);
+  start();
+  nshader_watcher_handle_t* handle = nshader_watcher_get_handle(watcher, "Fill");
+  ASSERT_NE(handle, nullptr);
+
+  // Rebuilds nobody holds a reference to do not add up
+  std::string padding = "\n";
+  write("Fill.comp.hlsl", COMPUTE_SHADER_SOURCE + padding);
+  ASSERT_TRUE(wait_until([&] { return nshader_watcher_handle_get_generation(handle) == 2; }));
+  nshader_alloc_stats_t before;
+  nshader_get_alloc_stats(&before);
+
+  for (uint32_t generation = 3; generation <= 6; generation++) {
+    padding += "\n";
+    write("Fill.comp.hlsl", COMPUTE_SHADER_SOURCE + padding);
+    ASSERT_TRUE(wait_until([&] { return nshader_watcher_handle_get_generation(handle) == generation; }));
+  }
+  nshader_alloc_stats_t after;
+  nshader_get_alloc_stats(&after);
+  EXPECT_EQ(after.tags[NSHADER_ALLOC_TAG_WATCHER].live_bytes, before.tags[NSHADER_ALLOC_TAG_WATCHER].live_bytes);
+  EXPECT_EQ(after.total.live_bytes, before.total.live_bytes);
+}
+
+TEST_F(NShaderWatcherTests, PicksUpNewSources) {
+  write("First.comp.hlsl", COMPUTE_SHADER_SOURCE);
+  start();
+  EXPECT_EQ(nshader_watcher_get_handle(watcher, "Second"), nullptr);
+
+  write("Second.comp.hlsl", COMPUTE_SHADER_SOURCE);
+  ASSERT_TRUE(wait_until([&] {
+    return nshader_watcher_handle_get_generation(nshader_watcher_get_handle(watcher, "Second")) == 1;
+  }));
+  EXPECT_TRUE(fs::exists(out / "Second.nshader"));
+
+  // Unrelated shaders are not rebuilt
+  EXPECT_EQ(nshader_watcher_handle_get_generation(nshader_watcher_get_handle(watcher, "First")), 1u);
+}
+
+TEST_F(NShaderWatcherTests, MissingDirectory) {
+  nshader_watcher_config_t config = {};
+  config.source_dir = "test_watcher/does_not_exist";
+  EXPECT_EQ(nshader_watcher_create(&config), nullptr);
+  EXPECT_EQ(nshader_watcher_create(nullptr), nullptr);
+}
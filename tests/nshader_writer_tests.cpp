@@ -23,10 +23,14 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 extern "C" {
+#include <nshader/nshader_reader.h>
 #include <nshader/nshader_writer.h>
 #include "nshader_compiler_tests.h"
 }
@@ -72,3 +76,193 @@ TEST(NShaderWriterTests, WriteToPath) {
   // Clean up
   remove("test_shader_path.nsdr");
 }
+
+TEST(NShaderWriterTests, BlobAlignment) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  nshader_write_options_t options = {};
+  options.blob_alignment = 64;
+
+  size_t size_needed = nshader_write_to_memory_ex(g_graphics_shader, nullptr, 0, &options);
+  ASSERT_GT(size_needed, 0u);
+  EXPECT_GE(size_needed, nshader_write_to_memory(g_graphics_shader, nullptr, 0));
+
+  void* buffer = aligned_alloc(64, (size_needed + 63) / 64 * 64);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(nshader_write_to_memory_ex(g_graphics_shader, buffer, size_needed, &options), size_needed);
+
+  // Borrowed blobs keep the serialized alignment
+  nshader_read_options_t read_options = {};
+  read_options.borrow_blobs = true;
+  nshader_t* borrowed = nshader_read_from_memory_ex(buffer, size_needed, &read_options);
+  ASSERT_NE(borrowed, nullptr);
+
+  // Copied blobs get the requested in-memory alignment
+  read_options.borrow_blobs = false;
+  read_options.blob_alignment = 128;
+  nshader_t* copied = nshader_read_from_memory_ex(buffer, size_needed, &read_options);
+  ASSERT_NE(copied, nullptr);
+
+  size_t num_blobs = 0;
+  for (int stage = 0; stage < NSHADER_STAGE_TYPE_COUNT; ++stage) {
+    for (int backend = 0; backend < NSHADER_BACKEND_COUNT; ++backend) {
+      const nshader_blob_t* original = nshader_get_blob(g_graphics_shader, (nshader_stage_type_t)stage, (nshader_backend_t)backend);
+      const nshader_blob_t* a = nshader_get_blob(borrowed, (nshader_stage_type_t)stage, (nshader_backend_t)backend);
+      const nshader_blob_t* b = nshader_get_blob(copied, (nshader_stage_type_t)stage, (nshader_backend_t)backend);
+      if (!original) {
+        EXPECT_EQ(a, nullptr);
+        EXPECT_EQ(b, nullptr);
+        continue;
+      }
+      ASSERT_NE(a, nullptr);
+      ASSERT_NE(b, nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(a->data) % 64, 0u);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(b->data) % 128, 0u);
+      EXPECT_GE(a->data, static_cast<const uint8_t*>(buffer));
+      EXPECT_LT(a->data, static_cast<const uint8_t*>(buffer) + size_needed);
+      EXPECT_EQ(memcmp(a->data, original->data, original->size), 0);
+      EXPECT_EQ(memcmp(b->data, original->data, original->size), 0);
+      ++num_blobs;
+    }
+  }
+  EXPECT_GT(num_blobs, 0u);
+
+  nshader_destroy(borrowed);
+  nshader_destroy(copied);
+  free(buffer);
+}
+
+TEST(NShaderWriterTests, InvalidBlobAlignment) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  nshader_write_options_t options = {};
+  options.blob_alignment = 24;
+  EXPECT_EQ(nshader_write_to_memory_ex(g_graphics_shader, nullptr, 0, &options), 0u);
+
+  options.blob_alignment = NSHADER_MAX_BLOB_ALIGNMENT * 2;
+  EXPECT_EQ(nshader_write_to_memory_ex(g_graphics_shader, nullptr, 0, &options), 0u);
+}
+
+static size_t g_largest_staging_alloc = 0;
+
+static void* tracking_alloc(void* user, size_t size, size_t align) {
+  (void)user;
+  if (size > g_largest_staging_alloc) {
+    g_largest_staging_alloc = size;
+  }
+  return aligned_alloc(align, size > 0 ? (size + align - 1) / align * align : align);
+}
+
+static void tracking_free(void* user, void* ptr, size_t size) {
+  (void)user;
+  (void)size;
+  free(ptr);
+}
+
+TEST(NShaderWriterTests, StreamMatchesMemory) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  size_t size_needed = nshader_write_to_memory(g_graphics_shader, nullptr, 0);
+  std::vector<uint8_t> expected(size_needed);
+  ASSERT_EQ(nshader_write_to_memory(g_graphics_shader, expected.data(), expected.size()), size_needed);
+
+  // Stream to a file through a counting allocator
+  nshader_allocator_t allocator = { nullptr, tracking_alloc, tracking_free };
+  nshader_write_options_t options = {};
+  options.allocator = &allocator;
+  g_largest_staging_alloc = 0;
+  ASSERT_TRUE(nshader_write_to_path_ex(g_graphics_shader, "test_stream.nsdr", &options));
+
+  // Staging memory is bounded and does not scale with the output
+  EXPECT_GT(g_largest_staging_alloc, 0u);
+  EXPECT_LE(g_largest_staging_alloc, 4096u);
+
+  FILE* file = fopen("test_stream.nsdr", "rb");
+  ASSERT_NE(file, nullptr);
+  std::vector<uint8_t> actual(size_needed + 1);
+  size_t read_size = fread(actual.data(), 1, actual.size(), file);
+  fclose(file);
+  remove("test_stream.nsdr");
+
+  ASSERT_EQ(read_size, size_needed);
+  EXPECT_EQ(memcmp(actual.data(), expected.data(), size_needed), 0);
+}
+
+TEST(NShaderWriterTests, ContentHash) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  nshader_hash_t hash;
+  ASSERT_TRUE(nshader_hash(g_graphics_shader, &hash));
+  EXPECT_FALSE(nshader_hash(nullptr, &hash));
+
+  // Write options change the bytes but not the hash
+  nshader_write_options_t options = {};
+  options.blob_alignment = 128;
+  options.checksums = true;
+  std::vector<uint8_t> plain(nshader_write_to_memory(g_graphics_shader, nullptr, 0));
+  std::vector<uint8_t> aligned(nshader_write_to_memory_ex(g_graphics_shader, nullptr, 0, &options));
+  nshader_write_to_memory(g_graphics_shader, plain.data(), plain.size());
+  nshader_write_to_memory_ex(g_graphics_shader, aligned.data(), aligned.size(), &options);
+  EXPECT_NE(plain, aligned);
+
+  for (const std::vector<uint8_t>* buffer : { &plain, &aligned }) {
+    nshader_t* shader = nshader_read_from_memory(buffer->data(), buffer->size());
+    ASSERT_NE(shader, nullptr);
+    nshader_hash_t loaded_hash;
+    ASSERT_TRUE(nshader_hash(shader, &loaded_hash));
+    EXPECT_EQ(loaded_hash.lo, hash.lo);
+    EXPECT_EQ(loaded_hash.hi, hash.hi);
+    nshader_destroy(shader);
+  }
+}
+
+TEST(NShaderWriterTests, CanonicalOrder) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  std::vector<uint8_t> expected(nshader_write_to_memory(g_graphics_shader, nullptr, 0));
+  ASSERT_EQ(nshader_write_to_memory(g_graphics_shader, expected.data(), expected.size()), expected.size());
+
+  nshader_t* shader = nshader_read_from_memory(expected.data(), expected.size());
+  ASSERT_NE(shader, nullptr);
+
+  // Assemble the same content in a different order
+  nshader_info_t* info = const_cast<nshader_info_t*>(nshader_get_info(shader));
+  std::reverse(info->stages, info->stages + info->num_stages);
+  std::reverse(info->backends, info->backends + info->num_backends);
+  for (size_t i = 0; i < info->num_stages; i++) {
+    if (info->stages[i].type == NSHADER_STAGE_TYPE_VERTEX) {
+      nshader_stage_metadata_vertex_t* vertex = &info->stages[i].metadata.vertex;
+      std::reverse(vertex->inputs, vertex->inputs + vertex->input_count);
+      std::reverse(vertex->outputs, vertex->outputs + vertex->output_count);
+    }
+  }
+
+  std::vector<uint8_t> actual(nshader_write_to_memory(shader, nullptr, 0));
+  ASSERT_EQ(nshader_write_to_memory(shader, actual.data(), actual.size()), actual.size());
+  EXPECT_EQ(actual, expected);
+
+  nshader_destroy(shader);
+}
+
+TEST(NShaderWriterTests, RejectsInvalidStages) {
+  ASSERT_NE(g_graphics_shader, nullptr);
+
+  std::vector<uint8_t> buffer(nshader_write_to_memory(g_graphics_shader, nullptr, 0));
+  ASSERT_EQ(nshader_write_to_memory(g_graphics_shader, buffer.data(), buffer.size()), buffer.size());
+  nshader_t* shader = nshader_read_from_memory(buffer.data(), buffer.size());
+  ASSERT_NE(shader, nullptr);
+
+  // Counts would no longer match the entries written, so nothing is written
+  nshader_info_t* info = const_cast<nshader_info_t*>(nshader_get_info(shader));
+  ASSERT_GE(info->num_stages, 2u);
+  nshader_stage_type_t type = info->stages[0].type;
+  info->stages[0].type = NSHADER_STAGE_TYPE_COUNT;
+  EXPECT_EQ(nshader_write_to_memory(shader, nullptr, 0), 0u);
+  info->stages[0].type = info->stages[1].type;
+  EXPECT_EQ(nshader_write_to_memory(shader, nullptr, 0), 0u);
+
+  info->stages[0].type = type;
+  EXPECT_EQ(nshader_write_to_memory(shader, nullptr, 0), buffer.size());
+
+  nshader_destroy(shader);
+}